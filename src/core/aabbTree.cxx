@@ -0,0 +1,294 @@
+#include "aabbTree.h"
+
+#include "vec3.h"
+
+#include <algorithm>
+
+const int AabbTree::nullNode;
+
+/**
+ * constructor
+ *
+ * @param margin  amount leaf bounds are fattened by
+ */
+EXPLICIT AabbTree::AabbTree(double margin) :
+		m_root(nullNode), m_free(nullNode), m_margin(margin) {
+}
+
+/**
+ * destructor
+ */
+AabbTree::~AabbTree() {
+}
+
+/**
+ * get height of tree, zero for empty tree or single leaf
+ *
+ * @return  height of tree
+ */
+int AabbTree::getHeight() const {
+	return m_root == nullNode ? 0 : m_nodes[m_root].height;
+}
+
+/**
+ * add leaf
+ *
+ * @param bounds  bounds of leaf
+ * @param data    user data
+ *
+ * @return        leaf identifier
+ */
+int AabbTree::insert(const BoundingBox & bounds, size_t data) {
+	int leaf = allocateNode();
+	Vec3 margin(m_margin, m_margin, m_margin);
+	m_nodes[leaf].bounds = BoundingBox(bounds.getMin() - margin,
+			bounds.getMax() + margin);
+	m_nodes[leaf].data = data;
+	m_nodes[leaf].height = 0;
+	insertLeaf(leaf);
+	return leaf;
+}
+
+/**
+ * update bounds of leaf, only reinserted if bounds have escaped fattened
+ * bounds
+ *
+ * @param proxy   leaf identifier
+ * @param bounds  new bounds
+ *
+ * @return        true if leaf reinserted, false otherwise
+ */
+bool AabbTree::move(int proxy, const BoundingBox & bounds) {
+	assert(m_nodes[proxy].isLeaf());
+	if (m_nodes[proxy].bounds.contains(bounds)) {
+		return false;
+	}
+	removeLeaf(proxy);
+	Vec3 margin(m_margin, m_margin, m_margin);
+	m_nodes[proxy].bounds = BoundingBox(bounds.getMin() - margin,
+			bounds.getMax() + margin);
+	insertLeaf(proxy);
+	return true;
+}
+
+/**
+ * remove leaf
+ *
+ * @param proxy  leaf identifier
+ */
+void AabbTree::remove(int proxy) {
+	assert(m_nodes[proxy].isLeaf());
+	removeLeaf(proxy);
+	freeNode(proxy);
+}
+
+/**
+ * take node from free list, growing node pool if empty
+ *
+ * @return  node index
+ */
+PRIVATE int AabbTree::allocateNode() {
+	if (m_free == nullNode) {
+		m_free = static_cast<int>(m_nodes.size());
+		m_nodes.emplace_back();
+		m_nodes.back().parent = nullNode;
+	}
+	int node = m_free;
+	m_free = m_nodes[node].parent;
+	m_nodes[node] = Node();
+	return node;
+}
+
+/**
+ * return node to free list
+ *
+ * @param node  node index
+ */
+PRIVATE void AabbTree::freeNode(int node) {
+	m_nodes[node].parent = m_free;
+	m_nodes[node].height = -1;
+	m_free = node;
+}
+
+/**
+ * insert leaf, descending toward sibling with least increase in surface
+ * area, then refit and rebalance ancestors
+ *
+ * @param leaf  leaf node index
+ */
+PRIVATE void AabbTree::insertLeaf(int leaf) {
+	if (m_root == nullNode) {
+		m_root = leaf;
+		m_nodes[leaf].parent = nullNode;
+		return;
+	}
+
+	const auto leafBounds = m_nodes[leaf].bounds;
+
+	// find best sibling
+	int index = m_root;
+	while (m_nodes[index].isLeaf() == false) {
+		const auto & node = m_nodes[index];
+		double area = node.bounds.getSurfaceArea();
+		double combinedArea = (node.bounds + leafBounds).getSurfaceArea();
+
+		// cost of new parent for this node and leaf
+		double cost = 2 * combinedArea;
+
+		// minimum cost of pushing leaf further down
+		double inheritanceCost = 2 * (combinedArea - area);
+
+		double cost0 = (leafBounds + m_nodes[node.child0].bounds)
+				.getSurfaceArea() + inheritanceCost;
+		if (m_nodes[node.child0].isLeaf() == false) {
+			cost0 -= m_nodes[node.child0].bounds.getSurfaceArea();
+		}
+		double cost1 = (leafBounds + m_nodes[node.child1].bounds)
+				.getSurfaceArea() + inheritanceCost;
+		if (m_nodes[node.child1].isLeaf() == false) {
+			cost1 -= m_nodes[node.child1].bounds.getSurfaceArea();
+		}
+
+		if (cost < cost0 && cost < cost1) {
+			break;
+		}
+		index = cost0 < cost1 ? node.child0 : node.child1;
+	}
+	int sibling = index;
+
+	// new parent
+	int oldParent = m_nodes[sibling].parent;
+	int newParent = allocateNode();
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].bounds = leafBounds + m_nodes[sibling].bounds;
+	m_nodes[newParent].height = m_nodes[sibling].height + 1;
+	m_nodes[newParent].child0 = sibling;
+	m_nodes[newParent].child1 = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	if (oldParent == nullNode) {
+		m_root = newParent;
+	} else if (m_nodes[oldParent].child0 == sibling) {
+		m_nodes[oldParent].child0 = newParent;
+	} else {
+		m_nodes[oldParent].child1 = newParent;
+	}
+
+	// refit ancestors
+	for (index = m_nodes[leaf].parent; index != nullNode;
+			index = m_nodes[index].parent) {
+		index = balance(index);
+
+		auto & node = m_nodes[index];
+		const auto & child0 = m_nodes[node.child0];
+		const auto & child1 = m_nodes[node.child1];
+		node.height = 1 + std::max(child0.height, child1.height);
+		node.bounds = child0.bounds + child1.bounds;
+	}
+}
+
+/**
+ * detach leaf, replacing its parent with its sibling, then refit and
+ * rebalance ancestors
+ *
+ * @param leaf  leaf node index
+ */
+PRIVATE void AabbTree::removeLeaf(int leaf) {
+	if (leaf == m_root) {
+		m_root = nullNode;
+		return;
+	}
+
+	int parent = m_nodes[leaf].parent;
+	int grandParent = m_nodes[parent].parent;
+	int sibling = m_nodes[parent].child0 == leaf ?
+			m_nodes[parent].child1 : m_nodes[parent].child0;
+
+	if (grandParent == nullNode) {
+		m_root = sibling;
+		m_nodes[sibling].parent = nullNode;
+		freeNode(parent);
+		return;
+	}
+
+	if (m_nodes[grandParent].child0 == parent) {
+		m_nodes[grandParent].child0 = sibling;
+	} else {
+		m_nodes[grandParent].child1 = sibling;
+	}
+	m_nodes[sibling].parent = grandParent;
+	freeNode(parent);
+
+	// refit ancestors
+	for (int index = grandParent; index != nullNode;
+			index = m_nodes[index].parent) {
+		index = balance(index);
+
+		auto & node = m_nodes[index];
+		const auto & child0 = m_nodes[node.child0];
+		const auto & child1 = m_nodes[node.child1];
+		node.height = 1 + std::max(child0.height, child1.height);
+		node.bounds = child0.bounds + child1.bounds;
+	}
+}
+
+/**
+ * rotate taller grandchild up if children heights differ by more than one
+ *
+ * @param a  internal node index
+ *
+ * @return   index of node now at position of 'a'
+ */
+PRIVATE int AabbTree::balance(int a) {
+	auto & A = m_nodes[a];
+	if (A.isLeaf() || A.height < 2) {
+		return a;
+	}
+
+	int b = A.child0;
+	int c = A.child1;
+	int diff = m_nodes[c].height - m_nodes[b].height;
+
+	if (diff > 1 || diff < -1) {
+		// rotate taller child 'up' up
+		int up = diff > 1 ? c : b;
+		int other = diff > 1 ? b : c;
+		auto & U = m_nodes[up];
+		int f = U.child0;
+		int g = U.child1;
+
+		// swap 'a' and 'up'
+		U.child0 = a;
+		U.parent = A.parent;
+		A.parent = up;
+
+		if (U.parent == nullNode) {
+			m_root = up;
+		} else if (m_nodes[U.parent].child0 == a) {
+			m_nodes[U.parent].child0 = up;
+		} else {
+			m_nodes[U.parent].child1 = up;
+		}
+
+		// taller grandchild stays under 'up', other moves to 'a'
+		int keep = m_nodes[f].height > m_nodes[g].height ? f : g;
+		int move = keep == f ? g : f;
+		U.child1 = keep;
+		if (diff > 1) {
+			A.child1 = move;
+		} else {
+			A.child0 = move;
+		}
+		m_nodes[move].parent = a;
+
+		A.bounds = m_nodes[other].bounds + m_nodes[move].bounds;
+		A.height = 1 + std::max(m_nodes[other].height, m_nodes[move].height);
+		U.bounds = A.bounds + m_nodes[keep].bounds;
+		U.height = 1 + std::max(A.height, m_nodes[keep].height);
+
+		return up;
+	}
+	return a;
+}
+
@@ -0,0 +1,259 @@
+#pragma once
+
+#include "boundingBox.h"
+#include "normal.h"
+#include "vec3.h"
+
+#include <array>
+#include <cassert>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/*
+ * Dynamic bounding volume hierarchy of axis aligned boxes. Leaves are stored
+ * with fattened bounds so small movements don't touch the tree, and the tree
+ * is kept balanced with rotations as leaves are inserted and removed
+ */
+class AabbTree {
+public:
+
+	/**
+	 * constructor
+	 *
+	 * @param margin  amount leaf bounds are fattened by
+	 */
+	explicit AabbTree(double margin);
+
+	/**
+	 * destructor
+	 */
+	~AabbTree();
+
+	/**
+	 * get fattened bounds of leaf
+	 *
+	 * @param proxy  leaf identifier
+	 *
+	 * @return       fattened bounds
+	 */
+	inline const BoundingBox & getBounds(int proxy) const {
+		assert(proxy >= 0 && static_cast<size_t>(proxy) < m_nodes.size());
+		return m_nodes[proxy].bounds;
+	}
+
+	/**
+	 * get user data of leaf
+	 *
+	 * @param proxy  leaf identifier
+	 *
+	 * @return       user data
+	 */
+	inline size_t getData(int proxy) const {
+		assert(proxy >= 0 && static_cast<size_t>(proxy) < m_nodes.size());
+		return m_nodes[proxy].data;
+	}
+
+	/**
+	 * get height of tree, zero for empty tree or single leaf
+	 *
+	 * @return  height of tree
+	 */
+	int getHeight() const;
+
+	/**
+	 * add leaf
+	 *
+	 * @param bounds  bounds of leaf
+	 * @param data    user data
+	 *
+	 * @return        leaf identifier
+	 */
+	int insert(const BoundingBox & bounds, size_t data);
+
+	/**
+	 * update bounds of leaf, only reinserted if bounds have escaped fattened
+	 * bounds
+	 *
+	 * @param proxy   leaf identifier
+	 * @param bounds  new bounds
+	 *
+	 * @return        true if leaf reinserted, false otherwise
+	 */
+	bool move(int proxy, const BoundingBox & bounds);
+
+	/**
+	 * call function with identifier of each leaf whose fattened bounds
+	 * intersect given bounds
+	 *
+	 * @param bounds  bounds to test
+	 * @param fn      function taking leaf identifier
+	 */
+	template<typename FUNC>
+	void query(const BoundingBox & bounds, FUNC & fn) const {
+		if (m_root == nullNode) {
+			return;
+		}
+		// balanced, so depth bounded well within stack for any sane size
+		std::array<int, 2 * maxDepth> stack;
+		size_t top = 0;
+		stack[top++] = m_root;
+		while (top != 0) {
+			const auto & node = m_nodes[stack[--top]];
+			if (node.bounds.intersects(bounds) == false) {
+				continue;
+			}
+			if (node.isLeaf()) {
+				fn(stack[top]);
+			} else {
+				assert(top + 2 <= stack.size());
+				stack[top++] = node.child1;
+				stack[top++] = node.child0;
+			}
+		}
+	}
+
+	/**
+	 * call function with identifier of each leaf whose fattened bounds ray
+	 * passes through before limit, nearer subtrees first. Function returns
+	 * new limit, so closer hits clip the rest of the traversal, and negative
+	 * limit stops it
+	 *
+	 * @param start      start of ray
+	 * @param direction  direction of ray
+	 * @param limit      distance along ray to stop at, may be infinite
+	 * @param fn         function taking leaf identifier, returning limit
+	 */
+	template<typename FUNC>
+	void rayCast(const Vec3 & start, const Normal & direction, double limit,
+			FUNC & fn) const {
+		if (m_root == nullNode) {
+			return;
+		}
+		double o[3] = { start.getX(), start.getY(), start.getZ() };
+		double d[3] = { direction.getX(), direction.getY(),
+				direction.getZ() };
+		double inv[3];
+		for (int k = 0; k < 3; ++k) {
+			inv[k] = d[k] == 0 ? 0 : 1 / d[k];
+		}
+
+		std::array<std::pair<int, double>, 2 * maxDepth> stack;
+		size_t top = 0;
+		double entry = rayEntry(m_nodes[m_root].bounds, o, d, inv, limit);
+		if (entry <= limit) {
+			stack[top++] = std::make_pair(m_root, entry);
+		}
+		while (top != 0) {
+			auto item = stack[--top];
+			if (item.second > limit) {
+				// clipped since pushed
+				continue;
+			}
+			const auto & node = m_nodes[item.first];
+			if (node.isLeaf()) {
+				limit = fn(item.first);
+				if (limit < 0) {
+					return;
+				}
+				continue;
+			}
+			assert(top + 2 <= stack.size());
+			auto nearer = std::make_pair(node.child0,
+					rayEntry(m_nodes[node.child0].bounds, o, d, inv, limit));
+			auto further = std::make_pair(node.child1,
+					rayEntry(m_nodes[node.child1].bounds, o, d, inv, limit));
+			if (further.second < nearer.second) {
+				std::swap(nearer, further);
+			}
+			if (further.second <= limit) {
+				stack[top++] = further;
+			}
+			if (nearer.second <= limit) {
+				stack[top++] = nearer;
+			}
+		}
+	}
+
+	/**
+	 * remove leaf
+	 *
+	 * @param proxy  leaf identifier
+	 */
+	void remove(int proxy);
+
+	static const int nullNode = -1;
+
+private:
+	static const size_t maxDepth = 64;
+
+	struct Node {
+		BoundingBox bounds;
+		size_t data;
+		/** parent, or next free node when on free list */
+		int parent;
+		int child0;
+		int child1;
+		/** leaf 0, free -1 */
+		int height;
+
+		Node() :
+				bounds(BoundingBox::empty()),
+				data(0),
+				parent(nullNode),
+				child0(nullNode),
+				child1(nullNode),
+				height(-1) {
+		}
+
+		inline bool isLeaf() const {
+			return child0 == nullNode;
+		}
+	};
+
+	std::vector<Node> m_nodes;
+	int m_root;
+	int m_free;
+	double m_margin;
+
+	/*
+	 * distance along ray at which it enters bounds, zero if it starts
+	 * inside, infinite if it misses or enters beyond limit
+	 */
+	static inline double rayEntry(const BoundingBox & bounds,
+			const double * o, const double * d, const double * inv,
+			double limit) {
+		const auto & bmin = bounds.getMin();
+		const auto & bmax = bounds.getMax();
+		double lo[3] = { bmin.getX(), bmin.getY(), bmin.getZ() };
+		double hi[3] = { bmax.getX(), bmax.getY(), bmax.getZ() };
+		double tmin = 0;
+		double tmax = limit;
+		for (int k = 0; k < 3; ++k) {
+			if (d[k] == 0) {
+				if (o[k] < lo[k] || o[k] > hi[k]) {
+					return std::numeric_limits<double>::infinity();
+				}
+				continue;
+			}
+			double t0 = (lo[k] - o[k]) * inv[k];
+			double t1 = (hi[k] - o[k]) * inv[k];
+			if (t0 > t1) {
+				std::swap(t0, t1);
+			}
+			tmin = t0 > tmin ? t0 : tmin;
+			tmax = t1 < tmax ? t1 : tmax;
+			if (tmin > tmax) {
+				return std::numeric_limits<double>::infinity();
+			}
+		}
+		return tmin;
+	}
+
+	int allocateNode();
+	int balance(int a);
+	void freeNode(int node);
+	void insertLeaf(int leaf);
+	void removeLeaf(int leaf);
+};
+
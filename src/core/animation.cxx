@@ -3,13 +3,26 @@
 #include "bezier.h"
 #include "binary.h"
 #include "bone.h"
+#include "compressedCurves.h"
+#include "simd.h"
 
+#include "../scripting/bool.h"
 #include "../scripting/executable.h"
 #include "../scripting/kwarg.h"
 #include "../scripting/parameters.h"
+#include "../scripting/real.h"
 #include "../scripting/string.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
 
 namespace {
 	/*
@@ -28,6 +41,9 @@ namespace {
 			float eFrame;
 			float offset = 0;
 			float fps;
+			unsigned samplesPerFrame = 0;
+			float tolerance = 0;
+			std::shared_ptr<Binary> compressed;
 			std::vector<Bezier> beziers;
 			std::unordered_map<std::string, Bone> bones;
 			for (unsigned i = 0; i < nArgs; ++i) {
@@ -66,10 +82,35 @@ namespace {
 								"Duplicate fps");
 						fps = static_cast<float>(getNumericArg(stack, 1));
 						flags |= 0x10;
+					} else if (key == "samplesPerFrame") {
+						// 0010 0000
+						scriptExecutionAssert((flags & 0x20) == 0,
+								"Duplicate samplesPerFrame");
+						auto samples = getInt32Arg(stack, 1);
+						scriptExecutionAssert(samples >= 0,
+								"Require samplesPerFrame of at least 0");
+						samplesPerFrame = static_cast<unsigned>(samples);
+						flags |= 0x20;
+					} else if (key == "tolerance") {
+						// 0100 0000
+						scriptExecutionAssert((flags & 0x40) == 0,
+								"Duplicate tolerance");
+						tolerance = static_cast<float>(getNumericArg(stack, 1));
+						scriptExecutionAssert(tolerance >= 0,
+								"Require tolerance of at least 0");
+						flags |= 0x40;
+					} else if (key == "compressed") {
+						// 1000 0000
+						scriptExecutionAssert((flags & 0x80) == 0,
+								"Duplicate compressed");
+						compressed = std::make_shared<Binary>(
+								getArg<Binary>("Bezier", stack, 1));
+						flags |= 0x80;
 					} else {
 						scriptExecutionAssert(false,
-								"Require name, sFrame, eFrame, offset or fps got: '"
-										+ key + "'");
+								"Require name, sFrame, eFrame, offset, fps, "
+										"samplesPerFrame, tolerance or "
+										"compressed got: '" + key + "'");
 					}
 				} else if (typeid(*arg) == typeid(Binary)) {
 					beziers.emplace_back(
@@ -83,6 +124,14 @@ namespace {
 									+ i);
 				}
 			}
+			if (compressed != nullptr) {
+				// 1000 0001
+				scriptExecutionAssert(flags == 0x81 && beziers.empty()
+						&& bones.empty(),
+						"Require only name with compressed animation");
+				stack.push(std::make_shared<Animation>(name, *compressed));
+				return;
+			}
 			// 0001 0111
 			scriptExecutionAssert((flags & 0x17) == 0x17,
 					"Require name, sFrame, eFrame, and fps");
@@ -91,9 +140,214 @@ namespace {
 			}
 			stack.push(
 					std::make_shared<Animation>(name, sFrame, eFrame, offset,
-							fps, bones));
+							fps, bones, samplesPerFrame, tolerance));
+		}
+	};
+
+	/*
+	 * get bytes held to sample animation
+	 */
+	class GetByteCount: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			checkNumArgs(nArgs, 0);
+
+			auto animation = std::static_pointer_cast<Animation>(self);
+
+			scriptExecutionAssert(animation->validate(),
+					"Animation '" + animation->getName() + "' not loaded");
+
+			stack.push(std::make_shared<Real>(
+					static_cast<double>(animation->getByteCount())));
+		}
+	};
+
+	/*
+	 * save animation compressed to file, with optional tolerance
+	 */
+	class Save: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			if (nArgs != 2) {
+				checkNumArgs(nArgs, 1);
+			}
+
+			auto animation = std::static_pointer_cast<Animation>(self);
+
+			auto filename = getArg<String>("string", stack, 1).getValue();
+
+			float tolerance = Animation::defaultTolerance;
+			if (nArgs == 2) {
+				tolerance = static_cast<float>(getNumericArg(stack, 2));
+				scriptExecutionAssert(tolerance >= 0,
+						"Require tolerance of at least 0");
+			}
+
+			scriptExecutionAssert(animation->validate(),
+					"Animation '" + animation->getName() + "' not loaded");
+
+			scriptExecutionAssert(animation->save(filename, tolerance),
+					"Failed to write '" + filename + "'");
 		}
 	};
+
+	/*
+	 * curves baked into uniformly spaced samples, linearly interpolated.
+	 * Per curve arrays are laid out channel by channel so kernels load
+	 * eight channels at a time
+	 */
+	struct BakedCurves {
+		/** samples of all curves, curve after curve */
+		std::vector<float> samples;
+		/** x of first sample */
+		std::vector<float> startX;
+		/** samples per unit x */
+		std::vector<float> scale;
+		/** position of last sample, in samples */
+		std::vector<float> maxU;
+		/** index of last sample that starts a span */
+		std::vector<int32_t> maxI;
+		/** index of first sample in samples */
+		std::vector<int32_t> offset;
+
+		/*
+		 * bake curve, at least two samples so every curve has a span
+		 */
+		void add(const Bezier & curve, unsigned samplesPerFrame) {
+			float start = curve.getStartX();
+			float end = curve.getEndX();
+			auto n = std::max(static_cast<int32_t>(std::ceil(
+					(end - start) * static_cast<float>(samplesPerFrame))) + 1,
+					2);
+
+			startX.emplace_back(start);
+			float span = end - start;
+			scale.emplace_back(span > 0 ? static_cast<float>(n - 1) / span : 0);
+			maxU.emplace_back(static_cast<float>(n - 1));
+			maxI.emplace_back(n - 2);
+			offset.emplace_back(static_cast<int32_t>(samples.size()));
+
+			for (int32_t i = 0; i < n; ++i) {
+				float x = i == n - 1 ?
+						end :
+						start + (end - start) * static_cast<float>(i)
+								/ static_cast<float>(n - 1);
+				samples.emplace_back(curve.getY(x));
+			}
+		}
+	};
+
+	/*
+	 * sample channels first to first + count at frame
+	 */
+	typedef void (*SampleKernel)(const BakedCurves & b, float frame,
+			size_t first, size_t count, float * values);
+
+	/*
+	 * scalar, from channel 'c' onwards
+	 */
+	void sampleScalar(const BakedCurves & b, float frame, size_t c,
+			size_t end, float * values) {
+		for (; c < end; ++c) {
+			float u = (frame - b.startX[c]) * b.scale[c];
+			u = std::min(std::max(u, 0.f), b.maxU[c]);
+			int32_t i = std::min(static_cast<int32_t>(u), b.maxI[c]);
+			float t = u - static_cast<float>(i);
+			const float * s = b.samples.data() + b.offset[c] + i;
+			*values++ = s[0] + t * (s[1] - s[0]);
+		}
+	}
+
+#ifdef SIMD_X86
+	/*
+	 * avx2, eight channels at a time, gathering spans of samples
+	 */
+	SIMD_TARGET_AVX2 void sampleAvx2(const BakedCurves & b, float frame,
+			size_t first, size_t count, float * values) {
+		__m256 f = _mm256_set1_ps(frame);
+		__m256 zero = _mm256_setzero_ps();
+		__m256i one = _mm256_set1_epi32(1);
+		const float * samples = b.samples.data();
+
+		size_t c = first;
+		size_t end = first + count;
+		for (; c + 8 <= end; c += 8, values += 8) {
+			__m256 u = _mm256_mul_ps(_mm256_sub_ps(f,
+					_mm256_loadu_ps(b.startX.data() + c)),
+					_mm256_loadu_ps(b.scale.data() + c));
+			u = _mm256_min_ps(_mm256_max_ps(u, zero),
+					_mm256_loadu_ps(b.maxU.data() + c));
+			__m256i i = _mm256_min_epi32(_mm256_cvttps_epi32(u),
+					_mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+							b.maxI.data() + c)));
+			__m256 t = _mm256_sub_ps(u, _mm256_cvtepi32_ps(i));
+			__m256i idx = _mm256_add_epi32(i,
+					_mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+							b.offset.data() + c)));
+			__m256 s0 = _mm256_i32gather_ps(samples, idx, 4);
+			__m256 s1 = _mm256_i32gather_ps(samples,
+					_mm256_add_epi32(idx, one), 4);
+			_mm256_storeu_ps(values,
+					_mm256_add_ps(s0, _mm256_mul_ps(t, _mm256_sub_ps(s1, s0))));
+		}
+		// clear upper lanes, or sse code after this pays for mixing states
+		_mm256_zeroupper();
+		sampleScalar(b, frame, c, end, values);
+	}
+#endif
+
+	/*
+	 * sample kernel for best instruction set supported, sse2 lacks gathers
+	 * so gains nothing over scalar
+	 */
+	SampleKernel sampleKernel() {
+#ifdef SIMD_X86
+		if (Simd::getLevel() == Simd::Level::AVX2) {
+			return sampleAvx2;
+		}
+#endif
+		return [](const BakedCurves & b, float frame, size_t first,
+				size_t count, float * values) {
+			sampleScalar(b, frame, first, first + count, values);
+		};
+	}
+
+	/** start of compressed animation files, "ANIM" */
+	const uint32_t fileMagic = 0x4d494e41;
+	const uint32_t fileVersion = 2;
+
+	template<typename TYPE>
+	void writeValue(std::vector<char> & bytes, const TYPE & value) {
+		const char * data = reinterpret_cast<const char *>(&value);
+		bytes.insert(bytes.end(), data, data + sizeof(value));
+	}
+
+	void writeString(std::vector<char> & bytes, const std::string & value) {
+		writeValue(bytes, static_cast<uint32_t>(value.size()));
+		bytes.insert(bytes.end(), value.begin(), value.end());
+	}
+
+	template<typename TYPE>
+	bool readValue(const char * & data, const char * end, TYPE & value) {
+		if (static_cast<size_t>(end - data) < sizeof(value)) {
+			return false;
+		}
+		std::memcpy(&value, data, sizeof(value));
+		data += sizeof(value);
+		return true;
+	}
+
+	bool readString(const char * & data, const char * end,
+			std::string & value) {
+		uint32_t size;
+		if (readValue(data, end, size) == false
+				|| static_cast<size_t>(end - data) < size) {
+			return false;
+		}
+		value.assign(data, size);
+		data += size;
+		return true;
+	}
 }
 
 struct Animation::impl {
@@ -104,20 +358,175 @@ struct Animation::impl {
 	float offset;
 	float fps;
 	std::unordered_map<std::string, Bone> bones;
-	bool valid = false;
+	unsigned samplesPerFrame;
+	/** most error of compressed curves, 0 to bake or evaluate curves */
+	float tolerance;
+	/**
+	 * curves of all bones, bone after bone in order of bones. Freed once
+	 * baked or compressed
+	 */
+	std::vector<Bezier> curves;
+	std::unordered_map<std::string, size_t> firstChannels;
+	size_t channelCount;
+	BakedCurves baked;
+	CompressedCurves compressed;
+	bool isCompressed;
+	/** compressed animation file contents, read on validation */
+	std::shared_ptr<Binary> source;
+	/** compressed animation file couldn't be read */
+	bool failed = false;
+	std::atomic<bool> valid;
+	/** held while curves are baked or compressed */
+	std::mutex lock;
 
 	impl(const std::string & name, float sFrame, float eFrame, float offset,
-			float fps, const std::unordered_map<std::string, Bone> & bones) :
+			float fps, const std::unordered_map<std::string, Bone> & bones,
+			unsigned samplesPerFrame, float tolerance) :
 					name(name),
 					sFrame(sFrame),
 					eFrame(eFrame),
 					offset(offset),
 					fps(fps),
 					bones(bones),
+					samplesPerFrame(samplesPerFrame),
+					tolerance(tolerance),
+					isCompressed(tolerance > 0),
+					valid(false) {
+		for (const auto & entry : this->bones) {
+			firstChannels.emplace(entry.first, curves.size());
+			for (size_t i = 0, n = entry.second.size(); i < n; ++i) {
+				curves.emplace_back(entry.second.get(static_cast<int>(i)));
+			}
+		}
+		channelCount = curves.size();
+	}
+
+	impl(const std::string & name, const Binary & source) :
+					name(name),
+					sFrame(0),
+					eFrame(0),
+					offset(0),
+					fps(0),
+					samplesPerFrame(0),
+					tolerance(0),
+					channelCount(0),
+					isCompressed(true),
+					source(std::make_shared<Binary>(source)),
 					valid(false) {
 	}
+
+	/*
+	 * compress curves, rotations of bones compressed whole
+	 */
+	CompressedCurves compress(float tolerance) const {
+		std::vector<std::array<size_t, 4>> rotations;
+		for (const auto & entry : bones) {
+			std::array<size_t, 4> indices;
+			if (entry.second.getRotationCurves(indices)) {
+				size_t first = firstChannels.at(entry.first);
+				for (auto & index : indices) {
+					index += first;
+				}
+				rotations.emplace_back(indices);
+			}
+		}
+		return CompressedCurves::compress(curves, rotations, tolerance);
+	}
+
+	/*
+	 * bytes held by curves
+	 */
+	size_t getCurveByteCount() const {
+		size_t count = 0;
+		for (const auto & curve : curves) {
+			count += curve.getByteCount();
+		}
+		return count;
+	}
+
+	/*
+	 * free curves, no longer sampled once baked or compressed. Bones keep
+	 * names of their curves
+	 */
+	void releaseCurves() {
+		for (auto & entry : bones) {
+			std::vector<std::string> curveNames;
+			for (size_t i = 0, n = entry.second.size(); i < n; ++i) {
+				curveNames.emplace_back(entry.second.getCurveName(i));
+			}
+			entry.second = Bone(entry.first, curveNames);
+		}
+		curves.clear();
+		curves.shrink_to_fit();
+	}
+
+	/*
+	 * read compressed animation file, bones laid out by channels of curves
+	 * in file order, then laid out again in order of bones
+	 */
+	bool read(const char * data, size_t size) {
+		const char * end = data + size;
+		uint32_t magic;
+		uint32_t version;
+		uint32_t nBones;
+		if (readValue(data, end, magic) == false || magic != fileMagic
+				|| readValue(data, end, version) == false
+				|| version != fileVersion
+				|| readValue(data, end, sFrame) == false
+				|| readValue(data, end, eFrame) == false
+				|| readValue(data, end, offset) == false
+				|| readValue(data, end, fps) == false
+				|| readValue(data, end, nBones) == false) {
+			return false;
+		}
+
+		std::vector<std::string> boneNames;
+		for (uint32_t i = 0; i < nBones; ++i) {
+			std::string boneName;
+			uint32_t nCurves;
+			if (readString(data, end, boneName) == false
+					|| readValue(data, end, nCurves) == false) {
+				return false;
+			}
+			std::vector<std::string> curveNames(nCurves);
+			for (auto & curveName : curveNames) {
+				if (readString(data, end, curveName) == false) {
+					return false;
+				}
+			}
+			if (bones.emplace(boneName, Bone(boneName, curveNames)).second
+					== false) {
+				return false;
+			}
+			boneNames.emplace_back(boneName);
+		}
+
+		if (compressed.read(data, static_cast<size_t>(end - data)) == false) {
+			return false;
+		}
+
+		for (const auto & entry : bones) {
+			firstChannels.emplace(entry.first, channelCount);
+			channelCount += entry.second.size();
+		}
+		if (compressed.getChannelCount() != channelCount) {
+			return false;
+		}
+
+		std::vector<size_t> channels;
+		for (const auto & boneName : boneNames) {
+			size_t first = firstChannels.at(boneName);
+			for (size_t i = 0, n = bones.at(boneName).size(); i < n; ++i) {
+				channels.emplace_back(first + i);
+			}
+		}
+		compressed.remapChannels(channels);
+		return true;
+	}
 };
 
+const float Animation::defaultTolerance = 0.0005f;
+
 /**
  * constructor
  *
@@ -127,11 +536,30 @@ struct Animation::impl {
  * @param offset
  * @param fps
  * @param bones
+ * @param samplesPerFrame  samples per frame curves are baked into on
+ *                         validation, freeing the curves. 0 to evaluate
+ *                         curves exactly
+ * @param tolerance        most error of values from compressing curves
+ *                         on validation, 0 not to compress. Kept only
+ *                         if smaller than the curves
  */
 Animation::Animation(const std::string & name, float sFrame, float eFrame,
 		float offset, float fps,
-		const std::unordered_map<std::string, Bone> & bones) :
-		pimpl(new impl(name, sFrame, eFrame, offset, fps, bones)) {
+		const std::unordered_map<std::string, Bone> & bones,
+		unsigned samplesPerFrame, float tolerance) :
+				pimpl(new impl(name, sFrame, eFrame, offset, fps, bones,
+						samplesPerFrame, tolerance)) {
+}
+
+/**
+ * constructor, from compressed animation file written by save. Frames and
+ * bones are known once valid
+ *
+ * @param name        name of animation
+ * @param compressed  contents of compressed animation file
+ */
+Animation::Animation(const std::string & name, const Binary & compressed) :
+		pimpl(new impl(name, compressed)) {
 }
 
 /**
@@ -170,6 +598,40 @@ const std::unordered_map<std::string, Bone> & Animation::getBones() const {
 	return pimpl->bones;
 }
 
+/**
+ * get bytes held to sample animation, of baked or compressed curves or of
+ * curves themselves. Animation must be valid
+ *
+ * @return  bytes held
+ */
+size_t Animation::getByteCount() const {
+	assert(pimpl->valid);
+
+	if (pimpl->isCompressed) {
+		return pimpl->compressed.getByteCount();
+	}
+	if (pimpl->samplesPerFrame == 0) {
+		return pimpl->getCurveByteCount();
+	}
+	const auto & b = pimpl->baked;
+	size_t count = b.samples.size() * sizeof(float);
+	count += b.startX.size() * sizeof(float);
+	count += b.scale.size() * sizeof(float);
+	count += b.maxU.size() * sizeof(float);
+	count += b.maxI.size() * sizeof(int32_t);
+	count += b.offset.size() * sizeof(int32_t);
+	return count;
+}
+
+/**
+ * get number of channels, one per curve of each bone
+ *
+ * @return  number of channels
+ */
+size_t Animation::getChannelCount() const {
+	return pimpl->channelCount;
+}
+
 /**
  * get end frame of animation
  *
@@ -208,6 +670,39 @@ float Animation::getOffset() const {
 	return pimpl->offset;
 }
 
+/**
+ * get channel of first curve of named bone, the bone's other curves
+ * follow it. Bones are laid out in order of getBones
+ *
+ * @param name  name of bone
+ *
+ * @return      index of first channel of bone
+ */
+size_t Animation::getFirstChannel(const std::string & name) const {
+	return pimpl->firstChannels.at(name);
+}
+
+/**
+ * get named script object member
+ *
+ * @param execState  current script execution state
+ * @param name       name of member
+ *
+ * @return           script object represented by name
+ */
+OVERRIDE ScriptObjectPtr Animation::getMember(
+		ScriptExecutionState & execState, const std::string & name) const {
+	static std::unordered_map<std::string, ScriptObjectPtr> members = {
+			{ "getByteCount", std::make_shared<GetByteCount>() },
+			{ "save", std::make_shared<Save>() } };
+
+	auto entry = members.find(name);
+	if (entry != members.end()) {
+		return entry->second;
+	}
+	return ScriptObject::getMember(execState, name);
+}
+
 /**
  * get animation name
  *
@@ -265,20 +760,155 @@ float Animation::nextFrame(float frame, float dt) const {
 	return frame2;
 }
 
+/**
+ * Sample consecutive channels at frame, together rather than curve by
+ * curve. Animation must be valid
+ *
+ * @param frame   frame to sample at
+ * @param first   first channel to sample
+ * @param count   number of channels to sample
+ * @param values  sampled value of each channel, written
+ */
+void Animation::sample(float frame, size_t first, size_t count,
+		float * values) const {
+	assert(pimpl->valid);
+	assert(first + count <= pimpl->channelCount);
+
+	if (pimpl->isCompressed) {
+		pimpl->compressed.sample(frame, first, count, values);
+		return;
+	}
+	if (pimpl->samplesPerFrame == 0) {
+		for (size_t i = 0; i < count; ++i) {
+			values[i] = pimpl->curves[first + i].getY(frame);
+		}
+		return;
+	}
+
+	static auto kernel = sampleKernel();
+	kernel(pimpl->baked, frame, first, count, values);
+}
+
+/**
+ * save animation to compressed animation file, compressing curves within
+ * tolerance unless compressed already. Baked animations hold no curves to
+ * compress. Animation must be valid
+ *
+ * @param filename   name of file to write
+ * @param tolerance  most error of values from compressing curves
+ *
+ * @return           false if file not written
+ */
+bool Animation::save(const std::string & filename, float tolerance) const {
+	assert(pimpl->valid);
+
+	if (pimpl->isCompressed == false && pimpl->samplesPerFrame > 0) {
+		std::cerr << "ERROR: '" << pimpl->name
+				<< "' is baked, curves not held to save" << std::endl;
+		return false;
+	}
+
+	std::vector<char> bytes;
+	writeValue(bytes, fileMagic);
+	writeValue(bytes, fileVersion);
+	writeValue(bytes, pimpl->sFrame);
+	writeValue(bytes, pimpl->eFrame);
+	writeValue(bytes, pimpl->offset);
+	writeValue(bytes, pimpl->fps);
+
+	// bones written in channel order, so curves need no remapping
+	std::vector<std::pair<size_t, std::string>> names;
+	for (const auto & entry : pimpl->firstChannels) {
+		names.emplace_back(entry.second, entry.first);
+	}
+	std::sort(names.begin(), names.end());
+	writeValue(bytes, static_cast<uint32_t>(names.size()));
+	for (const auto & name : names) {
+		const auto & bone = pimpl->bones.at(name.second);
+		writeString(bytes, name.second);
+		writeValue(bytes, static_cast<uint32_t>(bone.size()));
+		for (size_t i = 0, n = bone.size(); i < n; ++i) {
+			writeString(bytes, bone.getCurveName(i));
+		}
+	}
+
+	if (pimpl->isCompressed) {
+		pimpl->compressed.write(bytes);
+	} else {
+		pimpl->compress(tolerance).write(bytes);
+	}
+
+	std::ofstream file(filename, std::ios::binary);
+	file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+	return file.good();
+}
+
 /**
  * Validate elements
  *
  * @return true if all elements valid, false otherwise
  */
 bool Animation::validate() const {
-	if (pimpl->valid == true) {
+	if (pimpl->valid) {
 		return true;
 	}
-	pimpl->valid = true;
+
+	// curves baked or compressed once, maybe from multiple threads
+	std::lock_guard<std::mutex> locker(pimpl->lock);
+
+	if (pimpl->valid) {
+		return true;
+	}
+	if (pimpl->failed) {
+		return false;
+	}
+
+	if (pimpl->source != nullptr) {
+		const auto & source = *pimpl->source;
+		if (source.valid() == false) {
+			return false;
+		}
+		if (pimpl->read(source.getData(),
+				static_cast<size_t>(source.getByteCount())) == false) {
+			std::cerr << "ERROR: '" << source.getName()
+					<< "' is not a compressed animation" << std::endl;
+			// left invalid, bones and curves not usable
+			pimpl->bones.clear();
+			pimpl->firstChannels.clear();
+			pimpl->source.reset();
+			pimpl->failed = true;
+			return false;
+		}
+		pimpl->source.reset();
+		pimpl->valid = true;
+		return true;
+	}
+
 	for (const auto & entry : pimpl->bones) {
-		pimpl->valid = pimpl->valid && entry.second.validate();
+		if (entry.second.validate() == false) {
+			return false;
+		}
 	}
-	return pimpl->valid;
+	if (pimpl->isCompressed) {
+		pimpl->compressed = pimpl->compress(pimpl->tolerance);
+		// kept only if smaller than curves compressed
+		if (pimpl->compressed.getByteCount()
+				>= pimpl->getCurveByteCount()) {
+			pimpl->compressed = CompressedCurves();
+			pimpl->isCompressed = false;
+		}
+	}
+	if (pimpl->isCompressed == false && pimpl->samplesPerFrame > 0) {
+		for (const auto & curve : pimpl->curves) {
+			pimpl->baked.add(curve, pimpl->samplesPerFrame);
+		}
+	}
+	if (pimpl->isCompressed || pimpl->samplesPerFrame > 0) {
+		pimpl->releaseCurves();
+	}
+	// only valid once baked or compressed, as read without lock
+	pimpl->valid = true;
+	return true;
 }
 
 /**
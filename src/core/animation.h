@@ -4,10 +4,13 @@
 
 #include <unordered_map>
 
+class Binary;
 class Bone;
 
 class Animation: public ScriptObject {
 public:
+	/** tolerance of compressed curves when saved without one */
+	static const float defaultTolerance;
 
 	/**
 	 * constructor
@@ -18,10 +21,26 @@ public:
 	 * @param offset
 	 * @param fps
 	 * @param bones
+	 * @param samplesPerFrame  samples per frame curves are baked into on
+	 *                         validation, freeing the curves. 0 to
+	 *                         evaluate curves exactly
+	 * @param tolerance        most error of values from compressing
+	 *                         curves on validation, 0 not to compress.
+	 *                         Kept only if smaller than the curves
 	 */
 	Animation(const std::string & name, float sFrame, float eFrame,
 			float offset, float fps,
-			const std::unordered_map<std::string, Bone> & bones);
+			const std::unordered_map<std::string, Bone> & bones,
+			unsigned samplesPerFrame, float tolerance);
+
+	/**
+	 * constructor, from compressed animation file written by save. Frames
+	 * and bones are known once valid
+	 *
+	 * @param name        name of animation
+	 * @param compressed  contents of compressed animation file
+	 */
+	Animation(const std::string & name, const Binary & compressed);
 
 	/**
 	 * destructor
@@ -51,6 +70,21 @@ public:
 	 */
 	const std::unordered_map<std::string, Bone> & getBones() const;
 
+	/**
+	 * get bytes held to sample animation, of baked or compressed curves or
+	 * of curves themselves. Animation must be valid
+	 *
+	 * @return  bytes held
+	 */
+	size_t getByteCount() const;
+
+	/**
+	 * get number of channels, one per curve of each bone
+	 *
+	 * @return  number of channels
+	 */
+	size_t getChannelCount() const;
+
 	/**
 	 * get end frame of animation
 	 *
@@ -74,6 +108,27 @@ public:
 	 */
 	float getFrameStep(float dt) const;
 
+	/**
+	 * get channel of first curve of named bone, the bone's other curves
+	 * follow it. Bones are laid out in order of getBones
+	 *
+	 * @param name  name of bone
+	 *
+	 * @return      index of first channel of bone
+	 */
+	size_t getFirstChannel(const std::string & name) const;
+
+	/**
+	 * get named script object member
+	 *
+	 * @param execState  current script execution state
+	 * @param name       name of member
+	 *
+	 * @return           script object represented by name
+	 */
+	ScriptObjectPtr getMember(ScriptExecutionState & execState,
+			const std::string & name) const override;
+
 	/**
 	 * get animation name
 	 *
@@ -121,6 +176,30 @@ public:
 	 */
 	float nextFrame(float frame, float dt) const;
 
+	/**
+	 * Sample consecutive channels at frame, together rather than curve by
+	 * curve. Animation must be valid
+	 *
+	 * @param frame   frame to sample at
+	 * @param first   first channel to sample
+	 * @param count   number of channels to sample
+	 * @param values  sampled value of each channel, written
+	 */
+	void sample(float frame, size_t first, size_t count,
+			float * values) const;
+
+	/**
+	 * save animation to compressed animation file, compressing curves
+	 * within tolerance unless compressed already. Baked animations hold no
+	 * curves to compress. Animation must be valid
+	 *
+	 * @param filename   name of file to write
+	 * @param tolerance  most error of values from compressing curves
+	 *
+	 * @return           false if file not written
+	 */
+	bool save(const std::string & filename, float tolerance) const;
+
 	/**
 	 * Validate elements
 	 *
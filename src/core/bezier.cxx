@@ -47,16 +47,19 @@ struct Bezier::impl {
 			double t2 = k0 * std::cos(theta + k1) - k2;
 			double t3 = k0 * std::cos(theta + 2 * k1) - k2;
 
-			if (t1 >= 0 && t1 <= 1) {
-				assert((t2 < 0 || t2 > 1) && (t3 < 0 || t3 > 1));
-				t = t1;
-			} else if (t2 >= 0 && t2 <= 1) {
-				assert(t3 < 0 || t3 > 1);
+			// root within [0, 1], at ends of span rounding can put it
+			// just outside, so take root nearest span
+			auto outside = [](double root) {
+				return std::max(std::max(-root, root - 1), 0.);
+			};
+			t = t1;
+			if (outside(t2) < outside(t)) {
 				t = t2;
-			} else {
-				assert(t3 >= 0 && t3 <= 1);
+			}
+			if (outside(t3) < outside(t)) {
 				t = t3;
 			}
+			t = std::min(std::max(t, 0.), 1.);
 		} else {
 			// using Cardano's method, find one real root
 			double y1 = -q / 2 + std::sqrt(dis);
@@ -83,6 +86,47 @@ Bezier::Bezier(const Binary & binary) :
 		pimpl(new impl(binary)) {
 }
 
+/**
+ * get bytes held by control points, to measure memory
+ *
+ * @return  bytes held
+ */
+size_t Bezier::getByteCount() const {
+	return pimpl->ctrlPoints.capacity() * sizeof(float);
+}
+
+/**
+ * get x of last point, curve must be valid
+ *
+ * @return  x where curve ends
+ */
+float Bezier::getEndX() const {
+	assert(pimpl->valid);
+	return pimpl->ctrlPoints[pimpl->ctrlPoints.size() - 4];
+}
+
+/**
+ * get number of keys, points the curve passes through. Curve must be valid
+ *
+ * @return  number of keys
+ */
+size_t Bezier::getKeyCount() const {
+	assert(pimpl->valid);
+	return pimpl->ctrlPoints.size() / 6;
+}
+
+/**
+ * get x of key, curve must be valid
+ *
+ * @param idx  index of key
+ *
+ * @return     x of key
+ */
+float Bezier::getKeyX(size_t idx) const {
+	assert(pimpl->valid);
+	return pimpl->ctrlPoints[idx * 6 + 2];
+}
+
 /**
  * get name of bezier curve
  *
@@ -92,6 +136,16 @@ const std::string & Bezier::getName() const {
 	return pimpl->name;
 }
 
+/**
+ * get x of first point, curve must be valid
+ *
+ * @return  x where curve starts
+ */
+float Bezier::getStartX() const {
+	assert(pimpl->valid);
+	return pimpl->ctrlPoints[2];
+}
+
 /**
  * get y for given x
  *
@@ -18,6 +18,37 @@ public:
 	 */
 	Bezier(const Binary & binary);
 
+	/**
+	 * get bytes held by control points, to measure memory
+	 *
+	 * @return  bytes held
+	 */
+	size_t getByteCount() const;
+
+	/**
+	 * get x of last point, curve must be valid
+	 *
+	 * @return  x where curve ends
+	 */
+	float getEndX() const;
+
+	/**
+	 * get number of keys, points the curve passes through. Curve must be
+	 * valid
+	 *
+	 * @return  number of keys
+	 */
+	size_t getKeyCount() const;
+
+	/**
+	 * get x of key, curve must be valid
+	 *
+	 * @param idx  index of key
+	 *
+	 * @return     x of key
+	 */
+	float getKeyX(size_t idx) const;
+
 	/**
 	 * get name of bezier curve
 	 *
@@ -25,6 +56,13 @@ public:
 	 */
 	const std::string & getName() const;
 
+	/**
+	 * get x of first point, curve must be valid
+	 *
+	 * @return  x where curve starts
+	 */
+	float getStartX() const;
+
 	/**
 	 * get y for given x
 	 *
@@ -13,6 +13,7 @@
 
 #include <cassert>
 #include <cmath>
+#include <unordered_map>
 
 namespace {
 
@@ -40,15 +41,73 @@ namespace {
 			stack.push(std::make_shared<Bone>(name, beziers));
 		}
 	};
+
+	/*
+	 * what a curve drives, found from its name once rather than each frame
+	 */
+	enum class Channel {
+		LOC_X,
+		LOC_Y,
+		LOC_Z,
+		QUAT_X,
+		QUAT_Y,
+		QUAT_Z,
+		QUAT_W,
+		DLOC_X,
+		DLOC_Y,
+		DLOC_Z,
+		DROT_X,
+		DROT_Y,
+		DROT_Z,
+		OTHER
+	};
+
+	/*
+	 * channel driven by named curve
+	 */
+	Channel toChannel(const std::string & name) {
+		static const std::unordered_map<std::string, Channel> channels = {
+				{ "LocX", Channel::LOC_X },
+				{ "LocY", Channel::LOC_Y },
+				{ "LocZ", Channel::LOC_Z },
+				{ "QuatX", Channel::QUAT_X },
+				{ "QuatY", Channel::QUAT_Y },
+				{ "QuatZ", Channel::QUAT_Z },
+				{ "QuatW", Channel::QUAT_W },
+				{ "dLocX", Channel::DLOC_X },
+				{ "dLocY", Channel::DLOC_Y },
+				{ "dLocZ", Channel::DLOC_Z },
+				{ "dRotX", Channel::DROT_X },
+				{ "dRotY", Channel::DROT_Y },
+				{ "dRotZ", Channel::DROT_Z } };
+		auto it = channels.find(name);
+		return it != channels.end() ? it->second : Channel::OTHER;
+	}
 }
 
 struct Bone::impl {
 	std::string name;
+	/** curves, none if sampled elsewhere */
 	std::vector<Bezier> curves;
+	std::vector<std::string> curveNames;
+	/** channel of each curve */
+	std::vector<Channel> channels;
 	bool valid;
 
 	impl(const std::string & name, const std::vector<Bezier> & curves) :
 			name(name), curves(curves), valid(false) {
+		for (const auto & curve : curves) {
+			curveNames.emplace_back(curve.getName());
+			channels.emplace_back(toChannel(curve.getName()));
+		}
+	}
+
+	impl(const std::string & name,
+			const std::vector<std::string> & curveNames) :
+			name(name), curveNames(curveNames), valid(true) {
+		for (const auto & curveName : curveNames) {
+			channels.emplace_back(toChannel(curveName));
+		}
 	}
 
 };
@@ -63,6 +122,17 @@ Bone::Bone(const std::string & name, const std::vector<Bezier> & curves) :
 		pimpl(new impl(name, curves)) {
 }
 
+/**
+ * constructor, of curves sampled elsewhere, known only by name
+ *
+ * @param name        name of bone
+ * @param curveNames  names of curves of bone
+ */
+Bone::Bone(const std::string & name,
+		const std::vector<std::string> & curveNames) :
+		pimpl(new impl(name, curveNames)) {
+}
+
 /**
  * destructor
  */
@@ -89,24 +159,70 @@ const Bezier & Bone::get(int idx) const {
 	return pimpl->curves.at(idx);
 }
 
+/**
+ * get name of curve at given index
+ *
+ * @param idx  index of curve
+ *
+ * @return     name of curve
+ */
+const std::string & Bone::getCurveName(size_t idx) const {
+	return pimpl->curveNames.at(idx);
+}
+
+/**
+ * get indices of curves of rotation quaternion, x, y, z then w
+ *
+ * @param indices  index of curve of each component, written
+ *
+ * @return         false if bone has no rotation curves
+ */
+bool Bone::getRotationCurves(std::array<size_t, 4> & indices) const {
+	int found = 0;
+	for (size_t i = 0, n = pimpl->channels.size(); i < n; ++i) {
+		switch (pimpl->channels[i]) {
+		case Channel::QUAT_X:
+			indices[0] = i;
+			found |= 0x1;
+			break;
+		case Channel::QUAT_Y:
+			indices[1] = i;
+			found |= 0x2;
+			break;
+		case Channel::QUAT_Z:
+			indices[2] = i;
+			found |= 0x4;
+			break;
+		case Channel::QUAT_W:
+			indices[3] = i;
+			found |= 0x8;
+			break;
+		default:
+			break;
+		}
+	}
+	return found == 0xf;
+}
+
 /**
  * get number of curves
  *
  * @return  number of curves
  */
 size_t Bone::size() const {
-	return pimpl->curves.size();
+	return pimpl->channels.size();
 }
 
 /**
+ * get transform from curve values sampled at current frame
  *
  * @param current  current transform
- * @param frame    current frame
+ * @param values   value of each curve at current frame, in curve order
  * @param d        frame step
  *
  * @return         updated transform
  */
-Transform Bone::getTransform(const Transform & current, float frame,
+Transform Bone::getTransform(const Transform & current, const float * values,
 		float d) const {
 	Vec3 translation = current.getTranslation();
 	Quat rotation = current.getRotation();
@@ -116,90 +232,79 @@ Transform Bone::getTransform(const Transform & current, float frame,
 
 	int flags = 0;
 
-	for (const auto & curve : pimpl->curves) {
-		if (curve.getName() == "LocX") {
+	for (size_t i = 0, n = pimpl->channels.size(); i < n; ++i) {
+		float value = values[i];
+		switch (pimpl->channels[i]) {
+		case Channel::LOC_X:
 			assert((flags & 0x0381) == 0); // 0000 0011 1000 0001
-			tx = curve.getY(frame);
+			tx = value;
 			flags |= 0x0001; // 0000 0000 0000 0001
-			continue;
-		}
-		if (curve.getName() == "LocY") {
+			break;
+		case Channel::LOC_Y:
 			assert((flags & 0x0382) == 0); // 0000 0011 1000 0010
-			ty = curve.getY(frame);
+			ty = value;
 			flags |= 0x0002; // 0000 0000 0000 0010
-			continue;
-		}
-		if (curve.getName() == "LocZ") {
+			break;
+		case Channel::LOC_Z:
 			assert((flags & 0x0384) == 0); // 0000 0011 1000 0100
-			tz = curve.getY(frame);
+			tz = value;
 			flags |= 0x0004; // 0000 0000 0000 0100
-			continue;
-		}
-		if (curve.getName() == "QuatX") {
+			break;
+		case Channel::QUAT_X:
 			assert((flags & 0x1c08) == 0); // 0001 1100 0000 1000
-			rx = curve.getY(frame);
+			rx = value;
 			flags |= 0x0008; // 0000 0000 0000 1000
-			continue;
-		}
-		if (curve.getName() == "QuatY") {
+			break;
+		case Channel::QUAT_Y:
 			assert((flags & 0x1c10) == 0); // 0001 1100 0001 0000
-			ry = curve.getY(frame);
+			ry = value;
 			flags |= 0x0010; // 0000 0000 0001 0000
-			continue;
-		}
-		if (curve.getName() == "QuatZ") {
+			break;
+		case Channel::QUAT_Z:
 			assert((flags & 0x1c20) == 0); // 0001 1100 0010 0000
-			rz = curve.getY(frame);
+			rz = value;
 			flags |= 0x0020; // 0000 0000 0010 0000
-			continue;
-		}
-		if (curve.getName() == "QuatW") {
+			break;
+		case Channel::QUAT_W:
 			assert((flags & 0x1c40) == 0); // 0001 1100 0100 0000
-			rw = curve.getY(frame);
+			rw = value;
 			flags |= 0x0040; // 0000 0000 0100 0000
-			continue;
-		}
-		if (curve.getName() == "dLocX") {
+			break;
+		case Channel::DLOC_X:
 			assert((flags & 0x0087) == 0); // 0000 0000 1000 0111
-			double x = curve.getY(frame) * d;
-			translation += rotation.rotateX(x);
+			translation += rotation.rotateX(value * d);
 			flags |= 0x0080; // 0000 0000 1000 0000
-			continue;
-		}
-		if (curve.getName() == "dLocY") {
+			break;
+		case Channel::DLOC_Y:
 			assert((flags & 0x0107) == 0); // 0000 0001 0000 0111
-			double y = curve.getY(frame) * d;
-			translation += rotation.rotateY(y);
+			translation += rotation.rotateY(value * d);
 			flags |= 0x0100; // 0000 0001 0000 0000
-			continue;
-		}
-		if (curve.getName() == "dLocZ") {
+			break;
+		case Channel::DLOC_Z:
 			assert((flags & 0x0207) == 0); // 0000 0010 0000 0111
-			double z = curve.getY(frame) * d;
-			translation += rotation.rotateZ(z);
+			translation += rotation.rotateZ(value * d);
 			flags |= 0x0200; // 0000 0010 0000 0000
-			continue;
-		}
-		if (curve.getName() == "dRotX") {
+			break;
+		case Channel::DROT_X:
 			assert((flags & 0x0478) == 0); // 0000 0100 0111 1000
-			float angle = static_cast<float>(curve.getY(frame) / 180 * M_PI * d);
-			rotation *= Quat(Normal(1.f, 0.f, 0.f), angle);
+			rotation *= Quat(Normal(1.f, 0.f, 0.f),
+					static_cast<float>(value / 180 * M_PI * d));
 			flags |= 0x0400; // 0000 0100 0000 0000
-			continue;
-		}
-		if (curve.getName() == "dRotY") {
+			break;
+		case Channel::DROT_Y:
 			assert((flags & 0x0878) == 0); // 0000 1000 0111 1000
-			float angle = static_cast<float>(curve.getY(frame) / 180 * M_PI * d);
-			rotation *= Quat(Normal(0.f, 1.f, 0.f), angle);
+			rotation *= Quat(Normal(0.f, 1.f, 0.f),
+					static_cast<float>(value / 180 * M_PI * d));
 			flags |= 0x0800; // 0000 1000 0000 0000
-			continue;
-		}
-		if (curve.getName() == "dRotZ") {
+			break;
+		case Channel::DROT_Z:
 			assert((flags & 0x1078) == 0); // 0001 0000 0111 1000
-			float angle = static_cast<float>(curve.getY(frame) / 180 * M_PI * d);
-			rotation *= Quat(Normal(0.f, 0.f, 1.f), angle);
+			rotation *= Quat(Normal(0.f, 0.f, 1.f),
+					static_cast<float>(value / 180 * M_PI * d));
 			flags |= 0x1000; // 0001 0000 0000 0000
-			continue;
+			break;
+		case Channel::OTHER:
+			break;
 		}
 	}
 
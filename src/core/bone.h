@@ -2,6 +2,7 @@
 
 #include "../scripting/scriptObject.h"
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -19,6 +20,15 @@ public:
 	 */
 	Bone(const std::string & name, const std::vector<Bezier> & curves);
 
+	/**
+	 * constructor, of curves sampled elsewhere, known only by name
+	 *
+	 * @param name        name of bone
+	 * @param curveNames  names of curves of bone
+	 */
+	Bone(const std::string & name,
+			const std::vector<std::string> & curveNames);
+
 	/**
 	 * destructor
 	 */
@@ -33,6 +43,15 @@ public:
 	 */
 	const Bezier & get(int idx) const;
 
+	/**
+	 * get name of curve at given index
+	 *
+	 * @param idx  index of curve
+	 *
+	 * @return     name of curve
+	 */
+	const std::string & getCurveName(size_t idx) const;
+
 	/**
 	 * get bone name
 	 *
@@ -41,14 +60,24 @@ public:
 	const std::string & getName();
 
 	/**
+	 * get indices of curves of rotation quaternion, x, y, z then w
+	 *
+	 * @param indices  index of curve of each component, written
+	 *
+	 * @return         false if bone has no rotation curves
+	 */
+	bool getRotationCurves(std::array<size_t, 4> & indices) const;
+
+	/**
+	 * get transform from curve values sampled at current frame
 	 *
 	 * @param current  current transform
-	 * @param frame    current frame
+	 * @param values   value of each curve at current frame, in curve order
 	 * @param d        frame step
 	 *
 	 * @return         updated transform
 	 */
-	Transform getTransform(const Transform & current, float frame,
+	Transform getTransform(const Transform & current, const float * values,
 			float d) const;
 
 	/**
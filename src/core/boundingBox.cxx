@@ -23,8 +23,8 @@ namespace {
 	/*
 	 *
 	 */
-	std::vector<BaseParameter> params = { Parameter<Real>("min", nullptr),
-			Parameter<Real>("max", nullptr) };
+	std::vector<BaseParameter> params = { Parameter<Vec3>("min", nullptr),
+			Parameter<Vec3>("max", nullptr) };
 
 	/*
 	 *
@@ -40,9 +40,10 @@ namespace {
 				std::stack<std::shared_ptr<ScriptObject> > & stack) const
 						override {
 			auto args = parameters.getArgs(nArgs, stack);
-			auto min = std::static_pointer_cast<Vec3>(args["min"]);
-			auto max = std::static_pointer_cast<Vec3>(args["max"]);
-			stack.emplace(std::make_shared<BoundingBox>(*min, *max));
+			const auto & min = ScriptType<Vec3>::get(args["min"]);
+			const auto & max = ScriptType<Vec3>::get(args["max"]);
+			stack.emplace(
+					std::make_shared<ScriptBoundingBox>(BoundingBox(min, max)));
 		}
 	};
 
@@ -54,11 +55,11 @@ namespace {
 				std::stack<ScriptObjectPtr> & stack) const override {
 			checkNumArgs(nArgs, 1);
 
-			auto box = std::static_pointer_cast<BoundingBox>(self);
+			const auto & box = ScriptType<BoundingBox>::get(self);
 
 			auto point = getArg<Vec3>("Vec3", stack, 1);
 
-			if (box->contains(point)) {
+			if (box.contains(point)) {
 				stack.emplace(Bool::True());
 			} else {
 				stack.emplace(Bool::False());
@@ -74,8 +75,8 @@ namespace {
 				std::stack<ScriptObjectPtr> & stack) const override {
 			checkNumArgs(nArgs, 0);
 
-			auto box = std::static_pointer_cast<BoundingBox>(self);
-			stack.emplace(std::make_shared<Real>(box->getRadius()));
+			const auto & box = ScriptType<BoundingBox>::get(self);
+			stack.emplace(std::make_shared<Real>(box.getRadius()));
 		}
 	};
 
@@ -87,11 +88,11 @@ namespace {
 				std::stack<ScriptObjectPtr> & stack) const override {
 			checkNumArgs(nArgs, 1);
 
-			auto box = std::static_pointer_cast<BoundingBox>(self);
+			const auto & box = ScriptType<BoundingBox>::get(self);
 
 			auto bb = getArg<BoundingBox>("bounding box", stack, 1);
 
-			stack.emplace(std::make_shared<BoundingBox>(*box + bb));
+			stack.emplace(std::make_shared<ScriptBoundingBox>(box + bb));
 		}
 	};
 
@@ -103,9 +104,9 @@ namespace {
 				std::stack<ScriptObjectPtr> & stack) const override {
 			checkNumArgs(nArgs, 0);
 
-			auto box = std::static_pointer_cast<BoundingBox>(self);
+			const auto & box = ScriptType<BoundingBox>::get(self);
 
-			stack.emplace(std::make_shared<Vec3>(box->getMin()));
+			stack.emplace(std::make_shared<ScriptVec3>(box.getMin()));
 		}
 	};
 
@@ -117,9 +118,9 @@ namespace {
 				std::stack<ScriptObjectPtr> & stack) const override {
 			checkNumArgs(nArgs, 0);
 
-			auto box = std::static_pointer_cast<BoundingBox>(self);
+			const auto & box = ScriptType<BoundingBox>::get(self);
 
-			stack.emplace(std::make_shared<Vec3>(box->getMax()));
+			stack.emplace(std::make_shared<ScriptVec3>(box.getMax()));
 		}
 	};
 
@@ -564,8 +565,8 @@ const Vec3 & BoundingBox::getMax() const {
  *
  * @return           script object represented by name
  */
-OVERRIDE ScriptObjectPtr BoundingBox::getMember(ScriptExecutionState & execState,
-		const std::string & name) const {
+OVERRIDE ScriptObjectPtr ScriptBoundingBox::getMember(
+		ScriptExecutionState & execState, const std::string & name) const {
 	static std::unordered_map<std::string, ScriptObjectPtr> members = {
 			{ "__add__", std::make_shared<Add>() },
 			{ "contains", std::make_shared<Contains>() },
@@ -775,7 +776,7 @@ bool BoundingBox::rayIntersection(const Ray & ray, Vec3 & point,
  *
  * @return  bounds as string
  */
-OVERRIDE std::string BoundingBox::toString() const {
+std::string BoundingBox::toString() const {
 	return "BoundigBox(min=" + m_min.toString() + " max=" + m_max.toString()
 			+ ")";
 }
@@ -844,7 +845,7 @@ STATIC const BoundingBox & BoundingBox::empty() {
  *
  * @return  BoundingBox factory
  */
-STATIC const ScriptObjectPtr & BoundingBox::getFactory() {
+STATIC const ScriptObjectPtr & ScriptBoundingBox::getFactory() {
 	static auto factory = std::static_pointer_cast<ScriptObject>(
 			std::make_shared<Factory>());
 	return factory;
@@ -3,6 +3,7 @@
 #include "vec3.h"
 
 #include "../scripting/scriptObject.h"
+#include "../scripting/scriptType.h"
 
 #include <memory>
 
@@ -10,7 +11,10 @@ class Intersection;
 class Ray;
 class Transform;
 
-class BoundingBox final: public ScriptObject {
+/**
+ * plain axis aligned box value, ScriptBoundingBox represents it in scripts
+ */
+class BoundingBox final {
 public:
 	/**
 	 * construct bounding box from single point
@@ -46,7 +50,7 @@ public:
 	/**
 	 * default destructor
 	 */
-	inline virtual ~BoundingBox() = default;
+	inline ~BoundingBox() = default;
 
 	/**
 	 * Collide two boxes
@@ -103,17 +107,6 @@ public:
 	 */
 	const Vec3 & getMax() const;
 
-	/**
-	 * get named script object member
-	 *
-	 * @param execState  current script execution state
-	 * @param name       name of member
-	 *
-	 * @return           script object represented by name
-	 */
-	ScriptObjectPtr getMember(ScriptExecutionState & execState,
-			const std::string & name) const override;
-
 	/**
 	 * get minimum point of bounds
 	 *
@@ -218,7 +211,7 @@ public:
 	 *
 	 * @return  bounds as string
 	 */
-	std::string toString() const override;
+	std::string toString() const;
 
 	/**
 	 * transform bounding box
@@ -236,13 +229,6 @@ public:
 	 */
 	static const BoundingBox & empty();
 
-	/**
-	 * get script object factory for BoundingBox
-	 *
-	 * @return  BoundingBox factory
-	 */
-	static const ScriptObjectPtr & getFactory();
-
 private:
 	/**
 	 * construct empty bounding box
@@ -292,3 +278,51 @@ private:
 	Vec3 m_max;
 };
 
+/**
+ * script object holding BoundingBox
+ */
+class ScriptBoundingBox final: public ScriptObject {
+public:
+
+	inline explicit ScriptBoundingBox(const BoundingBox & value) :
+			m_value(value) {
+	}
+
+	inline const BoundingBox & getValue() const {
+		return m_value;
+	}
+
+	/**
+	 * get named script object member
+	 *
+	 * @param execState  current script execution state
+	 * @param name       name of member
+	 *
+	 * @return           script object represented by name
+	 */
+	ScriptObjectPtr getMember(ScriptExecutionState & execState,
+			const std::string & name) const override;
+
+	inline std::string toString() const override {
+		return m_value.toString();
+	}
+
+	/**
+	 * get script object factory for BoundingBox
+	 *
+	 * @return  BoundingBox factory
+	 */
+	static const ScriptObjectPtr & getFactory();
+
+private:
+	BoundingBox m_value;
+};
+
+template<>
+struct ScriptType<BoundingBox> {
+	typedef ScriptBoundingBox Object;
+
+	static inline const BoundingBox & get(const ScriptObjectPtr & obj) {
+		return std::static_pointer_cast<ScriptBoundingBox>(obj)->getValue();
+	}
+};
@@ -2,6 +2,7 @@
 
 #include "boundingBox.h"
 #include "color.h"
+#include "contactManifold.h"
 #include "convexHull.h"
 #include "debugGeometry.h"
 #include "intersection.h"
@@ -50,8 +51,9 @@ namespace {
 					} else if (typeid(*arg) == typeid(Terrain)) {
 						terrain = std::static_pointer_cast<Terrain>(arg);
 						continue;
-					} else if (typeid(*arg) == typeid(BoundingBox)) {
-						box = std::static_pointer_cast<BoundingBox>(arg);
+					} else if (typeid(*arg) == typeid(ScriptBoundingBox)) {
+						box = std::make_shared<BoundingBox>(
+								ScriptType<BoundingBox>::get(arg));
 						continue;
 					} else if (typeid(*arg) == typeid(Sphere)) {
 						sphere = std::static_pointer_cast<Sphere>(arg);
@@ -568,16 +570,14 @@ CollisionHierarchy::~CollisionHierarchy() {
  *
  * @param that
  * @param toThis
- * @return
+ * @param contacts  contacts to add to
  */
-PRIVATE std::vector<Intersection> CollisionHierarchy::leafCollide(
-		const CollisionHierarchy & that, const Transform & toThis) const {
-	std::vector<Intersection> intersections;
+PRIVATE void CollisionHierarchy::leafCollide(const CollisionHierarchy & that,
+		const Transform & toThis, ContactManifold & contacts) const {
 	Intersection intxn;
 	if (pimpl->collision.collide(that.pimpl->collision, toThis, intxn)) {
-		intersections.emplace_back(intxn);
+		contacts.add(intxn);
 	}
-	return intersections;
 }
 
 /**
@@ -585,59 +585,53 @@ PRIVATE std::vector<Intersection> CollisionHierarchy::leafCollide(
  *
  * @param that
  * @param toThis
- * @return
+ * @param contacts  contacts to add to
  */
-PRIVATE std::vector<Intersection> CollisionHierarchy::rCollide(
-		const CollisionHierarchy & that, const Transform & toThis) const {
+PRIVATE void CollisionHierarchy::rCollide(const CollisionHierarchy & that,
+		const Transform & toThis, ContactManifold & contacts) const {
 	if (that.pimpl->children.size() == 0) {
 		if (pimpl->children.size() == 0) {
-			return leafCollide(that, toThis);
+			leafCollide(that, toThis, contacts);
 		} else {
-			return collide(that, toThis);
+			collide(that, toThis, contacts);
 		}
+		return;
 	}
-	std::vector<Intersection> intersections;
 	if (pimpl->collision.intersection(that.pimpl->collision, toThis) == false) {
-		return intersections;
+		return;
 	}
 
 	for (const auto & child : that.pimpl->children) {
-		auto childIntersections = collide(child, toThis);
-		intersections.insert(intersections.end(), childIntersections.begin(),
-				childIntersections.end());
+		collide(child, toThis, contacts);
 	}
-	return intersections;
 }
 
 /**
- * Collide two hierarchies, traversing 'this' children
+ * Collide two hierarchies, traversing 'this' children, adding contacts
+ * in 'this' space
  *
  * @param that
  * @param toThis
- * @return
+ * @param contacts  contacts to add to
  */
-std::vector<Intersection> CollisionHierarchy::collide(
-		const CollisionHierarchy & that, const Transform & toThis) const {
+void CollisionHierarchy::collide(const CollisionHierarchy & that,
+		const Transform & toThis, ContactManifold & contacts) const {
 	if (pimpl->children.size() == 0) {
 		if (that.pimpl->children.size() == 0) {
-			return leafCollide(that, toThis);
+			leafCollide(that, toThis, contacts);
 		} else {
-			return rCollide(that, toThis);
+			rCollide(that, toThis, contacts);
 		}
+		return;
 	}
 
-	std::vector<Intersection> intersections;
-
 	if (pimpl->collision.intersection(that.pimpl->collision, toThis) == false) {
-		return intersections;
+		return;
 	}
 
 	for (const auto & child : pimpl->children) {
-		auto childIntersection = child.rCollide(that, toThis);
-		intersections.insert(intersections.end(), childIntersection.begin(),
-				childIntersection.end());
+		child.rCollide(that, toThis, contacts);
 	}
-	return intersections;
 }
 
 /**
@@ -3,9 +3,9 @@
 #include "../scripting/scriptObject.h"
 
 class BoundingBox;
+class ContactManifold;
 class ConvexHull;
 class DebugGeometry;
-class Intersection;
 class ParallelPlanes;
 class Ray;
 class Sphere;
@@ -69,14 +69,15 @@ public:
 	~CollisionHierarchy();
 
 	/**
-	 * Collide two hierarchies, traversing 'this' children
+	 * Collide two hierarchies, traversing 'this' children, adding contacts
+	 * in 'this' space
 	 *
 	 * @param that
 	 * @param toThis
-	 * @return
+	 * @param contacts  contacts to add to
 	 */
-	std::vector<Intersection> collide(const CollisionHierarchy & that,
-			const Transform & toThis) const;
+	void collide(const CollisionHierarchy & that, const Transform & toThis,
+			ContactManifold & contacts) const;
 
 	/**
 	 * Draw debug geometry to list
@@ -125,20 +126,20 @@ private:
 	 *
 	 * @param that
 	 * @param toThis
-	 * @return
+	 * @param contacts  contacts to add to
 	 */
-	std::vector<Intersection> leafCollide(const CollisionHierarchy & that,
-			const Transform & toThis) const;
+	void leafCollide(const CollisionHierarchy & that, const Transform & toThis,
+			ContactManifold & contacts) const;
 
 	/**
 	 * Collide two hierarchies, traversing 'that' children
 	 *
 	 * @param that
 	 * @param toThis
-	 * @return
+	 * @param contacts  contacts to add to
 	 */
-	std::vector<Intersection> rCollide(const CollisionHierarchy & that,
-			const Transform & toThis) const;
+	void rCollide(const CollisionHierarchy & that, const Transform & toThis,
+			ContactManifold & contacts) const;
 
 	struct impl;
 	std::shared_ptr<impl> pimpl;
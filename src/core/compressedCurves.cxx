@@ -0,0 +1,824 @@
+#include "compressedCurves.h"
+
+#include "bezier.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+namespace {
+	/** range of any but largest component of unit quaternion, 1 / sqrt(2) */
+	const float rotationRange = 0.707106781f;
+	/** times keys can be at over x range of track, as times are 16 bit */
+	const uint32_t timeCount = 65536;
+	/** x either side of key slopes are measured over */
+	const float slopeDelta = 1.f / 64;
+	/** checks per frame of error of interpolated keys */
+	const float checksPerFrame = 4;
+
+	/*
+	 * one track being compressed
+	 */
+	struct Track {
+		std::vector<uint32_t> channels;
+		float startX;
+		float scale;
+		float maxU;
+		float minimum;
+		float step;
+		float slopeMinimum;
+		float slopeStep;
+		std::vector<uint16_t> times;
+		std::vector<uint16_t> keys;
+	};
+
+	/*
+	 * key fitted to curves at time of track, values and slopes either
+	 * side of it, of every channel of track
+	 */
+	struct Fit {
+		uint16_t time;
+		float value[4];
+		float in[4];
+		float out[4];
+	};
+
+	/*
+	 * x of time of track
+	 */
+	float toX(const Track & track, float time) {
+		return track.scale > 0 ? track.startX + time / track.scale :
+				track.startX;
+	}
+
+	/*
+	 * values of curves of channels of track at x, rotations normalized
+	 */
+	void evaluate(const std::vector<Bezier> & curves, const Track & track,
+			float x, float * values) {
+		size_t width = track.channels.size();
+		float sum = 0;
+		for (size_t c = 0; c < width; ++c) {
+			values[c] = curves[track.channels[c]].getY(x);
+			sum += values[c] * values[c];
+		}
+		if (width == 4) {
+			if (sum > 0) {
+				float scale = 1 / std::sqrt(sum);
+				for (size_t c = 0; c < 4; ++c) {
+					values[c] *= scale;
+				}
+			} else {
+				values[0] = values[1] = values[2] = 0;
+				values[3] = 1;
+			}
+		}
+	}
+
+	/*
+	 * fit key to curves at time, slopes measured just before and after
+	 */
+	Fit fitKey(const std::vector<Bezier> & curves, const Track & track,
+			uint16_t time) {
+		Fit fit;
+		fit.time = time;
+		float x = toX(track, time);
+		float before[4];
+		float after[4];
+		evaluate(curves, track, x, fit.value);
+		evaluate(curves, track, x - slopeDelta, before);
+		evaluate(curves, track, x + slopeDelta, after);
+		for (size_t c = 0, n = track.channels.size(); c < n; ++c) {
+			fit.in[c] = (fit.value[c] - before[c]) / slopeDelta;
+			fit.out[c] = (after[c] - fit.value[c]) / slopeDelta;
+		}
+		return fit;
+	}
+
+	/*
+	 * quantize component of rotation other than largest to 15 bits
+	 */
+	uint16_t quantize(float c) {
+		float u = (c / rotationRange * 0.5f + 0.5f) * 32767.f;
+		return static_cast<uint16_t>(std::min(std::max(u + 0.5f, 0.f),
+				32767.f));
+	}
+
+	float dequantize(uint16_t q) {
+		return (static_cast<float>(q & 0x7fff) / 32767.f * 2 - 1)
+				* rotationRange;
+	}
+
+	/*
+	 * quantize value to 16 bits, over range from minimum in steps
+	 */
+	uint16_t quantize(float v, float minimum, float step) {
+		return static_cast<uint16_t>(step > 0 ?
+				std::min(std::max((v - minimum) / step + 0.5f, 0.f),
+						65535.f) : 0);
+	}
+
+	float dequantize(uint16_t q, float minimum, float step) {
+		return minimum + static_cast<float>(q) * step;
+	}
+
+	/*
+	 * index of largest component of rotation encoded to key
+	 */
+	int largestOf(const uint16_t * key) {
+		return key[0] >> 15 | (key[1] >> 15) << 1;
+	}
+
+	/*
+	 * encode unit quaternion x, y, z, w by smallest three components, index
+	 * of largest in top bits of first two. Gives sign q was made positive
+	 * by
+	 */
+	float encodeRotation(const float * q, uint16_t * key) {
+		int largest = 0;
+		for (int i = 1; i < 4; ++i) {
+			if (std::abs(q[i]) > std::abs(q[largest])) {
+				largest = i;
+			}
+		}
+		// largest made positive, q and -q being the same rotation
+		float sign = q[largest] < 0 ? -1.f : 1.f;
+		for (int i = 0, j = 0; i < 4; ++i) {
+			if (i != largest) {
+				key[j++] = quantize(sign * q[i]);
+			}
+		}
+		key[0] = static_cast<uint16_t>(key[0] | (largest & 1) << 15);
+		key[1] = static_cast<uint16_t>(key[1] | (largest >> 1) << 15);
+		return sign;
+	}
+
+	void decodeRotation(const uint16_t * key, float * q) {
+		int largest = largestOf(key);
+		float sum = 0;
+		for (int i = 0, j = 0; i < 4; ++i) {
+			if (i != largest) {
+				q[i] = dequantize(key[j++]);
+				sum += q[i] * q[i];
+			}
+		}
+		q[largest] = std::sqrt(std::max(1 - sum, 0.f));
+	}
+
+	/*
+	 * decode slopes of rotation q, decoded from key. Slope of largest
+	 * component follows from q staying unit, q . slopes = 0
+	 */
+	void decodeRotationSlopes(const float * q, const uint16_t * key,
+			const uint16_t * encoded, float minimum, float step,
+			float * slopes) {
+		int largest = largestOf(key);
+		float dot = 0;
+		for (int i = 0, j = 0; i < 4; ++i) {
+			if (i != largest) {
+				slopes[i] = dequantize(encoded[j++], minimum, step);
+				dot += q[i] * slopes[i];
+			}
+		}
+		slopes[largest] = q[largest] > 0 ? -dot / q[largest] : 0;
+	}
+
+	/*
+	 * cubic hermite interpolation of values a and b, dx apart, leaving a
+	 * and entering b at slopes, to r. Rotations interpolated along
+	 * shortest path and normalized
+	 */
+	void interpolate(const float * a, const float * aOut, const float * b,
+			const float * bIn, size_t width, float t, float dx, float * r) {
+		float t2 = t * t;
+		float t3 = t2 * t;
+		float h00 = 2 * t3 - 3 * t2 + 1;
+		float h10 = (t3 - 2 * t2 + t) * dx;
+		float h01 = 3 * t2 - 2 * t3;
+		float h11 = (t3 - t2) * dx;
+		float sign = 1;
+		if (width == 4
+				&& a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] < 0) {
+			sign = -1;
+		}
+		float sum = 0;
+		for (size_t i = 0; i < width; ++i) {
+			r[i] = h00 * a[i] + h10 * aOut[i]
+					+ sign * (h01 * b[i] + h11 * bIn[i]);
+			sum += r[i] * r[i];
+		}
+		if (width == 4) {
+			float scale = sum > 0 ? 1 / std::sqrt(sum) : 0;
+			for (size_t i = 0; i < 4; ++i) {
+				r[i] *= scale;
+			}
+		}
+	}
+
+	/*
+	 * set ranges of track keys are quantized over, values of scalar tracks
+	 * and slopes of all. Slopes of rotations take the sign their key is
+	 * made positive by
+	 */
+	void setRanges(const std::vector<Fit> & fits, Track & track) {
+		bool rotation = track.channels.size() == 4;
+		std::vector<float> slopes;
+		for (const auto & fit : fits) {
+			if (rotation) {
+				uint16_t key[3];
+				float sign = encodeRotation(fit.value, key);
+				int largest = largestOf(key);
+				for (int i = 0; i < 4; ++i) {
+					if (i != largest) {
+						slopes.emplace_back(sign * fit.in[i]);
+						slopes.emplace_back(sign * fit.out[i]);
+					}
+				}
+			} else {
+				slopes.emplace_back(fit.in[0]);
+				slopes.emplace_back(fit.out[0]);
+			}
+		}
+		const auto & slopeRange = std::minmax_element(slopes.begin(),
+				slopes.end());
+		track.slopeMinimum = *slopeRange.first;
+		track.slopeStep = (*slopeRange.second - *slopeRange.first) / 65535.f;
+
+		if (rotation == false) {
+			auto range = std::minmax_element(fits.begin(), fits.end(),
+					[](const Fit & a, const Fit & b) {
+						return a.value[0] < b.value[0];
+					});
+			track.minimum = range.first->value[0];
+			track.step = (range.second->value[0] - range.first->value[0])
+					/ 65535.f;
+		}
+	}
+
+	/*
+	 * quantize fitted key to key, value then slopes in then slopes out,
+	 * over ranges of track. Gives key decoded
+	 */
+	Fit encodeKey(const Fit & fit, const Track & track, uint16_t * key) {
+		Fit decoded;
+		decoded.time = fit.time;
+		if (track.channels.size() == 4) {
+			float sign = encodeRotation(fit.value, key);
+			int largest = largestOf(key);
+			for (int i = 0, j = 0; i < 4; ++i) {
+				if (i != largest) {
+					key[3 + j] = quantize(sign * fit.in[i],
+							track.slopeMinimum, track.slopeStep);
+					key[6 + j++] = quantize(sign * fit.out[i],
+							track.slopeMinimum, track.slopeStep);
+				}
+			}
+			decodeRotation(key, decoded.value);
+			decodeRotationSlopes(decoded.value, key, key + 3,
+					track.slopeMinimum, track.slopeStep, decoded.in);
+			decodeRotationSlopes(decoded.value, key, key + 6,
+					track.slopeMinimum, track.slopeStep, decoded.out);
+		} else {
+			key[0] = quantize(fit.value[0], track.minimum, track.step);
+			key[1] = quantize(fit.in[0], track.slopeMinimum,
+					track.slopeStep);
+			key[2] = quantize(fit.out[0], track.slopeMinimum,
+					track.slopeStep);
+			decoded.value[0] = dequantize(key[0], track.minimum, track.step);
+			decoded.in[0] = dequantize(key[1], track.slopeMinimum,
+					track.slopeStep);
+			decoded.out[0] = dequantize(key[2], track.slopeMinimum,
+					track.slopeStep);
+		}
+		return decoded;
+	}
+
+	/*
+	 * number of checks a span of dx is divided into
+	 */
+	int checkCount(float dx) {
+		return std::max(static_cast<int>(std::ceil(dx * checksPerFrame)), 4);
+	}
+
+	/*
+	 * fit slopes leaving key a and entering key b, least squares from
+	 * curves at checks between them. Slopes of keys measure curves only
+	 * either side of them, the best fit of a span differing where curves
+	 * aren't cubic in x
+	 */
+	void fitSpan(const std::vector<Bezier> & curves, const Track & track,
+			Fit & a, Fit & b) {
+		size_t width = track.channels.size();
+		float x0 = toX(track, a.time);
+		float dx = toX(track, b.time) - x0;
+		int m = checkCount(dx);
+
+		// normal equations of slopes, per channel
+		float pp = 0;
+		float pr = 0;
+		float rr = 0;
+		float pe[4] = { 0, 0, 0, 0 };
+		float re[4] = { 0, 0, 0, 0 };
+		for (int j = 1; j < m; ++j) {
+			float t = static_cast<float>(j) / static_cast<float>(m);
+			float t2 = t * t;
+			float t3 = t2 * t;
+			float h00 = 2 * t3 - 3 * t2 + 1;
+			float h01 = 3 * t2 - 2 * t3;
+			float p = (t3 - 2 * t2 + t) * dx;
+			float r = (t3 - t2) * dx;
+			float s[4];
+			evaluate(curves, track, x0 + dx * t, s);
+			pp += p * p;
+			pr += p * r;
+			rr += r * r;
+			for (size_t c = 0; c < width; ++c) {
+				float e = s[c] - h00 * a.value[c] - h01 * b.value[c];
+				pe[c] += p * e;
+				re[c] += r * e;
+			}
+		}
+		float det = pp * rr - pr * pr;
+		if (det <= 0) {
+			return;
+		}
+		for (size_t c = 0; c < width; ++c) {
+			a.out[c] = (rr * pe[c] - pr * re[c]) / det;
+			b.in[c] = (pp * re[c] - pr * pe[c]) / det;
+		}
+	}
+
+	/*
+	 * greatest error, from curves, of interpolating decoded keys a and b
+	 * at checks between them. Rotations compared by the nearer of q and -q
+	 */
+	float spanError(const std::vector<Bezier> & curves, const Track & track,
+			const Fit & a, const Fit & b) {
+		size_t width = track.channels.size();
+		float x0 = toX(track, a.time);
+		float dx = toX(track, b.time) - x0;
+		int m = checkCount(dx);
+
+		float error = 0;
+		for (int j = 1; j < m; ++j) {
+			float t = static_cast<float>(j) / static_cast<float>(m);
+			float r[4];
+			float s[4];
+			interpolate(a.value, a.out, b.value, b.in, width, t, dx, r);
+			evaluate(curves, track, x0 + dx * t, s);
+			float sign = 1;
+			if (width == 4 && r[0] * s[0] + r[1] * s[1] + r[2] * s[2]
+					+ r[3] * s[3] < 0) {
+				sign = -1;
+			}
+			for (size_t i = 0; i < width; ++i) {
+				error = std::max(error, std::abs(sign * r[i] - s[i]));
+			}
+		}
+		return error;
+	}
+
+	/*
+	 * compress curves of channels of track. Keys start at keys of curves,
+	 * spans further than tolerance from curves are split, then keys
+	 * interpolation of their neighbours recovers are dropped. Error of
+	 * quantizing key values is allowed above tolerance
+	 */
+	void compressTrack(const std::vector<Bezier> & curves, float tolerance,
+			Track & track) {
+		float start = curves[track.channels[0]].getStartX();
+		float end = curves[track.channels[0]].getEndX();
+		for (auto channel : track.channels) {
+			start = std::min(start, curves[channel].getStartX());
+			end = std::max(end, curves[channel].getEndX());
+		}
+		float span = end - start;
+		track.startX = start;
+		track.scale = span > 0 ? static_cast<float>(timeCount - 1) / span : 0;
+		track.maxU = span > 0 ? static_cast<float>(timeCount - 1) : 1;
+
+		std::vector<uint16_t> times = { 0, static_cast<uint16_t>(track.maxU) };
+		for (auto channel : track.channels) {
+			const auto & curve = curves[channel];
+			for (size_t i = 0, n = curve.getKeyCount(); i < n; ++i) {
+				float u = (curve.getKeyX(i) - start) * track.scale + 0.5f;
+				times.emplace_back(static_cast<uint16_t>(
+						std::min(std::max(u, 0.f), track.maxU)));
+			}
+		}
+		std::sort(times.begin(), times.end());
+		times.erase(std::unique(times.begin(), times.end()), times.end());
+
+		std::vector<Fit> fits;
+		for (auto time : times) {
+			fits.emplace_back(fitKey(curves, track, time));
+		}
+		for (size_t k = 0; k + 1 < fits.size(); ++k) {
+			fitSpan(curves, track, fits[k], fits[k + 1]);
+		}
+
+		size_t keyWidth = track.channels.size() == 4 ? 9 : 3;
+		uint16_t key[9];
+		float allowed;
+		while (true) {
+			setRanges(fits, track);
+			allowed = tolerance + (track.channels.size() == 4 ?
+					rotationRange / 32767.f : track.step / 2);
+
+			std::vector<Fit> split = { fits[0] };
+			for (size_t k = 0; k + 1 < fits.size(); ++k) {
+				uint16_t t0 = fits[k].time;
+				uint16_t t1 = fits[k + 1].time;
+				if (t1 - t0 > 1 && spanError(curves, track,
+						encodeKey(fits[k], track, key),
+						encodeKey(fits[k + 1], track, key)) > allowed) {
+					split.emplace_back(fitKey(curves, track,
+							static_cast<uint16_t>((t0 + t1) / 2)));
+					fitSpan(curves, track, split[split.size() - 2],
+							split.back());
+					split.emplace_back(fits[k + 1]);
+					fitSpan(curves, track, split[split.size() - 2],
+							split.back());
+				} else {
+					split.emplace_back(fits[k + 1]);
+				}
+			}
+			if (split.size() == fits.size()) {
+				break;
+			}
+			fits.swap(split);
+		}
+
+		// spans merged while a refit of them stays within tolerance, over
+		// ranges already set
+		std::vector<Fit> kept = { fits[0] };
+		Fit last = fits[1];
+		for (size_t b = 2; b < fits.size(); ++b) {
+			Fit a = kept.back();
+			Fit next = fits[b];
+			fitSpan(curves, track, a, next);
+			if (spanError(curves, track, encodeKey(a, track, key),
+					encodeKey(next, track, key)) > allowed) {
+				kept.emplace_back(last);
+				last = fits[b];
+			} else {
+				kept.back() = a;
+				last = next;
+			}
+		}
+		kept.emplace_back(last);
+
+		track.times.clear();
+		track.keys.clear();
+		for (const auto & fit : kept) {
+			encodeKey(fit, track, key);
+			track.times.emplace_back(fit.time);
+			track.keys.insert(track.keys.end(), key, key + keyWidth);
+		}
+	}
+
+	/*
+	 * find span of keys first to last containing time u, giving index of
+	 * first key of span and weight of second
+	 */
+	uint32_t findSpan(const uint16_t * times, uint32_t first, uint32_t last,
+			float u, float & t) {
+		// last key ends the final span, so isn't searched
+		auto end = std::upper_bound(times + first + 1, times + last - 1, u);
+		auto k = static_cast<uint32_t>(end - times) - 1;
+		float t0 = times[k];
+		float t1 = times[k + 1];
+		t = std::min(std::max((u - t0) / (t1 - t0), 0.f), 1.f);
+		return k;
+	}
+
+	/*
+	 * x between key k and the next
+	 */
+	float spanX(const uint16_t * times, uint32_t k, float scale) {
+		return scale > 0 ?
+				static_cast<float>(times[k + 1] - times[k]) / scale : 0;
+	}
+
+	/*
+	 * time of frame in track
+	 */
+	float toTime(float frame, float startX, float scale, float maxU) {
+		return std::min(std::max((frame - startX) * scale, 0.f), maxU);
+	}
+
+	template<typename TYPE>
+	void writeVector(std::vector<char> & bytes, const std::vector<TYPE> & v) {
+		auto count = static_cast<uint32_t>(v.size());
+		const char * data = reinterpret_cast<const char *>(&count);
+		bytes.insert(bytes.end(), data, data + sizeof(count));
+		data = reinterpret_cast<const char *>(v.data());
+		bytes.insert(bytes.end(), data, data + v.size() * sizeof(TYPE));
+	}
+
+	template<typename TYPE>
+	bool readVector(const char * & data, const char * end,
+			std::vector<TYPE> & v) {
+		uint32_t count;
+		if (static_cast<size_t>(end - data) < sizeof(count)) {
+			return false;
+		}
+		std::memcpy(&count, data, sizeof(count));
+		data += sizeof(count);
+		if (static_cast<size_t>(end - data) / sizeof(TYPE) < count) {
+			return false;
+		}
+		v.resize(count);
+		std::memcpy(v.data(), data, count * sizeof(TYPE));
+		data += count * sizeof(TYPE);
+		return true;
+	}
+}
+
+/**
+ * constructor, no curves
+ */
+CompressedCurves::CompressedCurves() :
+		channelCount(0) {
+}
+
+/**
+ * Compress curves. Keys start at keys of curves, with their values and
+ * slopes, and are added where hermite interpolation strays further than
+ * tolerance from the curves, then dropped where it doesn't
+ *
+ * @param curves     curves, one per channel
+ * @param rotations  channels of x, y, z and w of each rotation quaternion,
+ *                   compressed together
+ * @param tolerance  most error of values from fitting keys, above that of
+ *                   quantizing them
+ *
+ * @return           compressed curves
+ */
+STATIC CompressedCurves CompressedCurves::compress(
+		const std::vector<Bezier> & curves,
+		const std::vector<std::array<size_t, 4>> & rotations,
+		float tolerance) {
+	auto add = [](Tracks & tracks, const Track & track) {
+		tracks.channels.insert(tracks.channels.end(), track.channels.begin(),
+				track.channels.end());
+		tracks.startX.emplace_back(track.startX);
+		tracks.scale.emplace_back(track.scale);
+		tracks.maxU.emplace_back(track.maxU);
+		if (track.channels.size() == 1) {
+			tracks.minimum.emplace_back(track.minimum);
+			tracks.step.emplace_back(track.step);
+		}
+		tracks.slopeMinimum.emplace_back(track.slopeMinimum);
+		tracks.slopeStep.emplace_back(track.slopeStep);
+		if (tracks.firstKey.empty()) {
+			tracks.firstKey.emplace_back(0);
+		}
+		tracks.times.insert(tracks.times.end(), track.times.begin(),
+				track.times.end());
+		tracks.keys.insert(tracks.keys.end(), track.keys.begin(),
+				track.keys.end());
+		tracks.firstKey.emplace_back(
+				static_cast<uint32_t>(tracks.times.size()));
+	};
+
+	CompressedCurves compressed;
+	compressed.channelCount = curves.size();
+
+	std::vector<bool> inRotation(curves.size(), false);
+	for (const auto & rotation : rotations) {
+		Track track;
+		for (auto channel : rotation) {
+			track.channels.emplace_back(static_cast<uint32_t>(channel));
+			inRotation[channel] = true;
+		}
+		track.minimum = 0;
+		track.step = 0;
+		compressTrack(curves, tolerance, track);
+		add(compressed.rotations, track);
+	}
+	for (size_t i = 0, n = curves.size(); i < n; ++i) {
+		if (inRotation[i] == false) {
+			Track track;
+			track.channels.emplace_back(static_cast<uint32_t>(i));
+			compressTrack(curves, tolerance, track);
+			add(compressed.scalars, track);
+		}
+	}
+	return compressed;
+}
+
+/**
+ * get bytes held by curves, to measure compression
+ *
+ * @return  bytes held
+ */
+size_t CompressedCurves::getByteCount() const {
+	size_t count = sizeof(*this);
+	for (const auto * tracks : { &rotations, &scalars }) {
+		count += tracks->channels.size() * sizeof(uint32_t);
+		count += tracks->startX.size() * sizeof(float);
+		count += tracks->scale.size() * sizeof(float);
+		count += tracks->maxU.size() * sizeof(float);
+		count += tracks->minimum.size() * sizeof(float);
+		count += tracks->step.size() * sizeof(float);
+		count += tracks->slopeMinimum.size() * sizeof(float);
+		count += tracks->slopeStep.size() * sizeof(float);
+		count += tracks->firstKey.size() * sizeof(uint32_t);
+		count += tracks->times.size() * sizeof(uint16_t);
+		count += tracks->keys.size() * sizeof(uint16_t);
+	}
+	return count;
+}
+
+/**
+ * get number of keys kept, a rotation key holding four channels
+ *
+ * @return  number of keys
+ */
+size_t CompressedCurves::getKeyCount() const {
+	return rotations.times.size() + scalars.times.size();
+}
+
+/**
+ * read curves written by write
+ *
+ * @param data  bytes to read from
+ * @param size  number of bytes
+ *
+ * @return      false if bytes aren't compressed curves
+ */
+bool CompressedCurves::read(const char * data, size_t size) {
+	const char * end = data + size;
+	uint32_t count;
+	if (size < sizeof(count)) {
+		return false;
+	}
+	std::memcpy(&count, data, sizeof(count));
+	data += sizeof(count);
+	channelCount = count;
+
+	for (auto * tracks : { &rotations, &scalars }) {
+		bool rotation = tracks == &rotations;
+		if (readVector(data, end, tracks->channels) == false
+				|| readVector(data, end, tracks->startX) == false
+				|| readVector(data, end, tracks->scale) == false
+				|| readVector(data, end, tracks->maxU) == false
+				|| readVector(data, end, tracks->minimum) == false
+				|| readVector(data, end, tracks->step) == false
+				|| readVector(data, end, tracks->slopeMinimum) == false
+				|| readVector(data, end, tracks->slopeStep) == false
+				|| readVector(data, end, tracks->firstKey) == false
+				|| readVector(data, end, tracks->times) == false
+				|| readVector(data, end, tracks->keys) == false) {
+			return false;
+		}
+
+		size_t n = tracks->startX.size();
+		size_t width = rotation ? 4 : 1;
+		size_t keyWidth = rotation ? 9 : 3;
+		if (tracks->channels.size() != n * width
+				|| tracks->scale.size() != n || tracks->maxU.size() != n
+				|| tracks->minimum.size() != (rotation ? 0 : n)
+				|| tracks->step.size() != (rotation ? 0 : n)
+				|| tracks->slopeMinimum.size() != n
+				|| tracks->slopeStep.size() != n
+				|| tracks->firstKey.size() != (n > 0 ? n + 1 : 0)
+				|| tracks->keys.size() != tracks->times.size() * keyWidth) {
+			return false;
+		}
+		for (auto channel : tracks->channels) {
+			if (channel >= channelCount) {
+				return false;
+			}
+		}
+		for (size_t i = 0; i < n; ++i) {
+			uint32_t first = tracks->firstKey[i];
+			uint32_t last = tracks->firstKey[i + 1];
+			// every track spans from first time to last in order
+			if (last < first + 2 || last > tracks->times.size()
+					|| tracks->times[first] != 0
+					|| tracks->times[last - 1] != tracks->maxU[i]
+					|| std::is_sorted(tracks->times.begin() + first,
+							tracks->times.begin() + last,
+							std::less_equal<uint16_t>()) == false) {
+				return false;
+			}
+		}
+	}
+	return data == end;
+}
+
+/**
+ * move curves to other channels
+ *
+ * @param channels  new channel of each channel
+ */
+void CompressedCurves::remapChannels(const std::vector<size_t> & channels) {
+	assert(channels.size() == channelCount);
+	for (auto * tracks : { &rotations, &scalars }) {
+		for (auto & channel : tracks->channels) {
+			channel = static_cast<uint32_t>(channels[channel]);
+		}
+	}
+}
+
+/**
+ * Sample consecutive channels at frame
+ *
+ * @param frame   frame to sample at
+ * @param first   first channel to sample
+ * @param count   number of channels to sample
+ * @param values  sampled value of each channel, written
+ */
+void CompressedCurves::sample(float frame, size_t first, size_t count,
+		float * values) const {
+	// channels wrap below first, so one comparison checks both ends
+	auto inRange = [first, count](uint32_t channel) {
+		return channel - first < count;
+	};
+
+	const auto & r = rotations;
+	for (size_t i = 0, n = r.startX.size(); i < n; ++i) {
+		const uint32_t * channels = r.channels.data() + i * 4;
+		if (inRange(channels[0]) == false && inRange(channels[1]) == false
+				&& inRange(channels[2]) == false
+				&& inRange(channels[3]) == false) {
+			continue;
+		}
+		float u = toTime(frame, r.startX[i], r.scale[i], r.maxU[i]);
+		float t;
+		uint32_t k = findSpan(r.times.data(), r.firstKey[i],
+				r.firstKey[i + 1], u, t);
+
+		// keys of value, slopes in then slopes out
+		const uint16_t * ka = r.keys.data() + k * 9;
+		const uint16_t * kb = ka + 9;
+		float a[4];
+		float aOut[4];
+		float b[4];
+		float bIn[4];
+		float q[4];
+		decodeRotation(ka, a);
+		decodeRotationSlopes(a, ka, ka + 6, r.slopeMinimum[i],
+				r.slopeStep[i], aOut);
+		decodeRotation(kb, b);
+		decodeRotationSlopes(b, kb, kb + 3, r.slopeMinimum[i],
+				r.slopeStep[i], bIn);
+		interpolate(a, aOut, b, bIn, 4, t,
+				spanX(r.times.data(), k, r.scale[i]), q);
+		for (int c = 0; c < 4; ++c) {
+			if (inRange(channels[c])) {
+				values[channels[c] - first] = q[c];
+			}
+		}
+	}
+
+	const auto & s = scalars;
+	for (size_t i = 0, n = s.startX.size(); i < n; ++i) {
+		uint32_t channel = s.channels[i];
+		if (inRange(channel) == false) {
+			continue;
+		}
+		float u = toTime(frame, s.startX[i], s.scale[i], s.maxU[i]);
+		float t;
+		uint32_t k = findSpan(s.times.data(), s.firstKey[i],
+				s.firstKey[i + 1], u, t);
+
+		const uint16_t * ka = s.keys.data() + k * 3;
+		const uint16_t * kb = ka + 3;
+		float a = dequantize(ka[0], s.minimum[i], s.step[i]);
+		float aOut = dequantize(ka[2], s.slopeMinimum[i], s.slopeStep[i]);
+		float b = dequantize(kb[0], s.minimum[i], s.step[i]);
+		float bIn = dequantize(kb[1], s.slopeMinimum[i], s.slopeStep[i]);
+		interpolate(&a, &aOut, &b, &bIn, 1, t,
+				spanX(s.times.data(), k, s.scale[i]), values + channel - first);
+	}
+}
+
+/**
+ * write curves, to be read back by read
+ *
+ * @param bytes  bytes to append to
+ */
+void CompressedCurves::write(std::vector<char> & bytes) const {
+	auto count = static_cast<uint32_t>(channelCount);
+	const char * data = reinterpret_cast<const char *>(&count);
+	bytes.insert(bytes.end(), data, data + sizeof(count));
+
+	for (const auto * tracks : { &rotations, &scalars }) {
+		writeVector(bytes, tracks->channels);
+		writeVector(bytes, tracks->startX);
+		writeVector(bytes, tracks->scale);
+		writeVector(bytes, tracks->maxU);
+		writeVector(bytes, tracks->minimum);
+		writeVector(bytes, tracks->step);
+		writeVector(bytes, tracks->slopeMinimum);
+		writeVector(bytes, tracks->slopeStep);
+		writeVector(bytes, tracks->firstKey);
+		writeVector(bytes, tracks->times);
+		writeVector(bytes, tracks->keys);
+	}
+}
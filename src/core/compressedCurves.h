@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Bezier;
+
+/*
+ * Animation curves fitted by hermite keys, values and slopes either side,
+ * starting at keys of the curves and kept to those needed to stay within a
+ * tolerance of the curves. Quantized to 16 bits, rotation quaternions whole
+ * by their smallest three components, other values and slopes over their
+ * range. Sampled straight from the keys, so clips are never decompressed as
+ * a whole
+ */
+class CompressedCurves final {
+public:
+
+	/**
+	 * constructor, no curves
+	 */
+	CompressedCurves();
+
+	/**
+	 * Compress curves. Keys start at keys of curves, with their values and
+	 * slopes, and are added where hermite interpolation strays further
+	 * than tolerance from the curves, then dropped where it doesn't
+	 *
+	 * @param curves     curves, one per channel
+	 * @param rotations  channels of x, y, z and w of each rotation
+	 *                   quaternion, compressed together
+	 * @param tolerance  most error of values from fitting keys, above that
+	 *                   of quantizing them
+	 *
+	 * @return           compressed curves
+	 */
+	static CompressedCurves compress(const std::vector<Bezier> & curves,
+			const std::vector<std::array<size_t, 4>> & rotations,
+			float tolerance);
+
+	/**
+	 * get bytes held by curves, to measure compression
+	 *
+	 * @return  bytes held
+	 */
+	size_t getByteCount() const;
+
+	/**
+	 * get number of channels
+	 *
+	 * @return  number of channels
+	 */
+	inline size_t getChannelCount() const {
+		return channelCount;
+	}
+
+	/**
+	 * get number of keys kept, a rotation key holding four channels
+	 *
+	 * @return  number of keys
+	 */
+	size_t getKeyCount() const;
+
+	/**
+	 * read curves written by write
+	 *
+	 * @param data  bytes to read from
+	 * @param size  number of bytes
+	 *
+	 * @return      false if bytes aren't compressed curves
+	 */
+	bool read(const char * data, size_t size);
+
+	/**
+	 * move curves to other channels
+	 *
+	 * @param channels  new channel of each channel
+	 */
+	void remapChannels(const std::vector<size_t> & channels);
+
+	/**
+	 * Sample consecutive channels at frame
+	 *
+	 * @param frame   frame to sample at
+	 * @param first   first channel to sample
+	 * @param count   number of channels to sample
+	 * @param values  sampled value of each channel, written
+	 */
+	void sample(float frame, size_t first, size_t count,
+			float * values) const;
+
+	/**
+	 * write curves, to be read back by read
+	 *
+	 * @param bytes  bytes to append to
+	 */
+	void write(std::vector<char> & bytes) const;
+
+private:
+
+	/*
+	 * curves of one kind, channels and ranges per track, keys of all
+	 * tracks one track after another
+	 */
+	struct Tracks {
+		/** channels of each track, 4 for rotations, 1 otherwise */
+		std::vector<uint32_t> channels;
+		/** x of first time */
+		std::vector<float> startX;
+		/** times per unit x */
+		std::vector<float> scale;
+		/** last time */
+		std::vector<float> maxU;
+		/** least value of scalar tracks */
+		std::vector<float> minimum;
+		/** value per quantization step of scalar tracks */
+		std::vector<float> step;
+		/** least slope */
+		std::vector<float> slopeMinimum;
+		/** slope per quantization step */
+		std::vector<float> slopeStep;
+		/** index of first key of each track, and total */
+		std::vector<uint32_t> firstKey;
+		/** time of each key */
+		std::vector<uint16_t> times;
+		/**
+		 * quantized keys, values then slopes into and out of key. 3 values
+		 * per rotation, 1 otherwise
+		 */
+		std::vector<uint16_t> keys;
+	};
+
+	size_t channelCount;
+	Tracks rotations;
+	Tracks scalars;
+};
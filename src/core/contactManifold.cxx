@@ -0,0 +1,121 @@
+#include "contactManifold.h"
+
+#include "transform.h"
+#include "vec3.h"
+
+#include <algorithm>
+
+namespace {
+	/** contacts closer than this are at the same point, squared */
+	const double mergeDistanceSquared = 1e-8;
+
+	/*
+	 * twice area of quadrilateral, squared, taking whichever pairing of
+	 * points makes the diagonals
+	 */
+	double quadArea(const Vec3 * p) {
+		auto a = (p[0] - p[1]).cross(p[2] - p[3]);
+		auto b = (p[0] - p[2]).cross(p[1] - p[3]);
+		auto c = (p[0] - p[3]).cross(p[1] - p[2]);
+		return std::max(a.dot(a), std::max(b.dot(b), c.dot(c)));
+	}
+}
+
+/**
+ * constructor, no contacts
+ */
+ContactManifold::ContactManifold() :
+		m_size(0) {
+}
+
+/**
+ * add contact, reducing contacts if full
+ *
+ * @param contact  contact to add
+ */
+void ContactManifold::add(const Intersection & contact) {
+	for (size_t i = 0; i < m_size; ++i) {
+		auto d = m_contacts[i].getPoint() - contact.getPoint();
+		if (d.dot(d) < mergeDistanceSquared) {
+			if (contact.getDepth() > m_contacts[i].getDepth()) {
+				m_contacts[i] = contact;
+			}
+			return;
+		}
+	}
+	if (m_size < capacity) {
+		m_contacts[m_size++] = contact;
+		return;
+	}
+
+	// candidates, new contact last
+	const Intersection * candidates[capacity + 1];
+	size_t deepest = 0;
+	for (size_t i = 0; i <= capacity; ++i) {
+		candidates[i] = i < capacity ? &m_contacts[i] : &contact;
+		if (candidates[i]->getDepth() > candidates[deepest]->getDepth()) {
+			deepest = i;
+		}
+	}
+
+	// drop whichever leaves largest area, new contact first on ties
+	size_t drop = capacity;
+	double bestArea = -1;
+	for (size_t k = capacity + 1; k-- > 0;) {
+		if (k == deepest) {
+			continue;
+		}
+		Vec3 p[capacity];
+		for (size_t i = 0, n = 0; i <= capacity; ++i) {
+			if (i != k) {
+				p[n++] = candidates[i]->getPoint();
+			}
+		}
+		double area = quadArea(p);
+		if (area > bestArea) {
+			bestArea = area;
+			drop = k;
+		}
+	}
+	if (drop != capacity) {
+		m_contacts[drop] = contact;
+	}
+}
+
+/**
+ * add contacts of other manifold
+ *
+ * @param other  manifold to add contacts of
+ */
+void ContactManifold::add(const ContactManifold & other) {
+	for (const auto & contact : other) {
+		add(contact);
+	}
+}
+
+/**
+ * get deepest contact, manifold must not be empty
+ *
+ * @return  deepest contact
+ */
+const Intersection & ContactManifold::getDeepest() const {
+	assert(m_size != 0);
+	size_t deepest = 0;
+	for (size_t i = 1; i < m_size; ++i) {
+		if (m_contacts[i].getDepth() > m_contacts[deepest].getDepth()) {
+			deepest = i;
+		}
+	}
+	return m_contacts[deepest];
+}
+
+/**
+ * transform all contacts
+ *
+ * @param rotTrans  transform to apply
+ */
+void ContactManifold::transform(const Transform & rotTrans) {
+	for (size_t i = 0; i < m_size; ++i) {
+		m_contacts[i].transform(rotTrans);
+	}
+}
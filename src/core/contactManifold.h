@@ -0,0 +1,100 @@
+#pragma once
+
+#include "intersection.h"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+class Transform;
+
+/*
+ * Contacts between a pair of shapes, held in place without allocating. At
+ * most four are kept, adding another keeps the deepest contact and the others
+ * spanning the largest area, so the pair stays supported. Contacts at the
+ * same point are merged, keeping the deeper
+ */
+class ContactManifold final {
+public:
+	static const size_t capacity = 4;
+
+	/**
+	 * constructor, no contacts
+	 */
+	ContactManifold();
+
+	/**
+	 * add contact, reducing contacts if full
+	 *
+	 * @param contact  contact to add
+	 */
+	void add(const Intersection & contact);
+
+	/**
+	 * add contacts of other manifold
+	 *
+	 * @param other  manifold to add contacts of
+	 */
+	void add(const ContactManifold & other);
+
+	inline Intersection * begin() {
+		return m_contacts.data();
+	}
+
+	inline const Intersection * begin() const {
+		return m_contacts.data();
+	}
+
+	/**
+	 * remove all contacts
+	 */
+	inline void clear() {
+		m_size = 0;
+	}
+
+	inline bool empty() const {
+		return m_size == 0;
+	}
+
+	inline Intersection * end() {
+		return m_contacts.data() + m_size;
+	}
+
+	inline const Intersection * end() const {
+		return m_contacts.data() + m_size;
+	}
+
+	/**
+	 * get contact
+	 *
+	 * @param index  index of contact
+	 *
+	 * @return       contact
+	 */
+	inline const Intersection & get(size_t index) const {
+		assert(index < m_size);
+		return m_contacts[index];
+	}
+
+	/**
+	 * get deepest contact, manifold must not be empty
+	 *
+	 * @return  deepest contact
+	 */
+	const Intersection & getDeepest() const;
+
+	inline size_t size() const {
+		return m_size;
+	}
+
+	/**
+	 * transform all contacts
+	 *
+	 * @param rotTrans  transform to apply
+	 */
+	void transform(const Transform & rotTrans);
+
+private:
+	std::array<Intersection, capacity> m_contacts;
+	size_t m_size;
+};
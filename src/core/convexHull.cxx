@@ -1,10 +1,12 @@
 #include "convexHull.h"
 
 #include "boundingBox.h"
+#include "gjk.h"
 #include "indexArray.h"
 #include "intersection.h"
 #include "mat4.h"
 #include "normalArray.h"
+#include "quickhull.h"
 #include "ray.h"
 #include "sphere.h"
 #include "transform.h"
@@ -44,7 +46,7 @@ namespace {
 				std::stack<std::shared_ptr<ScriptObject> > & stack) const
 						override {
 			auto args = parameters.getArgs(nArgs, stack);
-			auto bounds = std::static_pointer_cast<BoundingBox>(args["bounds"]);
+			const auto & bounds = ScriptType<BoundingBox>::get(args["bounds"]);
 			auto vertices = std::static_pointer_cast<Vec3Array>(
 					args["vertices"]);
 			auto indices = std::static_pointer_cast<IndexArray>(
@@ -58,7 +60,7 @@ namespace {
 			auto edgeDirections = std::static_pointer_cast<IndexArray>(
 					args["edgeDirections"]);
 			stack.emplace(
-					std::make_shared<ConvexHull>(*bounds, *vertices, *indices,
+					std::make_shared<ConvexHull>(bounds, *vertices, *indices,
 							*faceNormals, *planes, *edges, *faceDirections,
 							*edgeDirections));
 		}
@@ -153,6 +155,10 @@ struct ConvexHull::impl {
 	std::unique_ptr<TriangleList> triangleList;
 	std::unique_ptr<Sphere> sphere;
 
+	/** points hull is to be built from, null once built */
+	std::unique_ptr<Vec3Array> points;
+	size_t maxVertices;
+
 	impl(const BoundingBox & box) :
 					bounds(box),
 					vertices(box::corners(box)),
@@ -161,7 +167,8 @@ struct ConvexHull::impl {
 					planeIndices(box::planeIndices),
 					edgeIndices(box::edgeIndices),
 					faceDirectionIndices(box::faceDirectionsIndices),
-					edgeDirectionIndices(box::edgeDirectionsIndices) {
+					edgeDirectionIndices(box::edgeDirectionsIndices),
+					maxVertices(0) {
 	}
 
 	impl(const BoundingBox & bounds, const Vec3Array & vertices,
@@ -176,7 +183,21 @@ struct ConvexHull::impl {
 					planeIndices(planeIndices),
 					edgeIndices(edgeIndices),
 					faceDirectionIndices(faceDirectionsIndices),
-					edgeDirectionIndices(edgeDirectionsIndices) {
+					edgeDirectionIndices(edgeDirectionsIndices),
+					maxVertices(0) {
+	}
+
+	impl(const Vec3Array & points, size_t maxVertices) :
+					bounds(BoundingBox::empty()),
+					vertices(std::vector<Vec3>()),
+					indices(std::vector<int16_t>()),
+					faceNormals(std::vector<Normal>()),
+					planeIndices(std::vector<int16_t>()),
+					edgeIndices(std::vector<int16_t>()),
+					faceDirectionIndices(std::vector<int16_t>()),
+					edgeDirectionIndices(std::vector<int16_t>()),
+					points(new Vec3Array(points)),
+					maxVertices(maxVertices) {
 	}
 
 	impl(const impl & other) :
@@ -187,7 +208,31 @@ struct ConvexHull::impl {
 					planeIndices(other.planeIndices),
 					edgeIndices(other.edgeIndices),
 					faceDirectionIndices(other.faceDirectionIndices),
-					edgeDirectionIndices(other.edgeDirectionIndices) {
+					edgeDirectionIndices(other.edgeDirectionIndices),
+					points(other.points == nullptr ?
+							nullptr : new Vec3Array(*other.points)),
+					maxVertices(other.maxVertices) {
+	}
+
+	/*
+	 * build hull from points, once loaded
+	 */
+	bool build() {
+		if (points->validate() == false) {
+			return false;
+		}
+		auto hull = Quickhull::build(*points, maxVertices);
+		const auto & built = *hull.pimpl;
+		bounds = built.bounds;
+		vertices = built.vertices;
+		indices = built.indices;
+		faceNormals = built.faceNormals;
+		planeIndices = built.planeIndices;
+		edgeIndices = built.edgeIndices;
+		faceDirectionIndices = built.faceDirectionIndices;
+		edgeDirectionIndices = built.edgeDirectionIndices;
+		points = nullptr;
+		return true;
 	}
 };
 
@@ -211,6 +256,16 @@ ConvexHull::ConvexHull(const BoundingBox & bounds, const Vec3Array & vertices,
 						edgeDirectionsIndices)) {
 }
 
+/**
+ * Construct from points, hull is built by quickhull once points load
+ *
+ * @param points       points to build hull of
+ * @param maxVertices  most vertices of hull
+ */
+ConvexHull::ConvexHull(const Vec3Array & points, size_t maxVertices) :
+		pimpl(new impl(points, maxVertices)) {
+}
+
 /**
  * copy constructor
  *
@@ -379,7 +434,7 @@ bool ConvexHull::collide(const BoundingBox & box, const Transform & boxToThis,
 }
 
 /**
- * Collide two hulls
+ * Collide two hulls, GJK and EPA with separating axis test as fallback
  *
  * @param other         hull to collide against
  * @param otherToThis   from other hull space to this hull space
@@ -395,6 +450,30 @@ bool ConvexHull::collide(const ConvexHull & other,
 		return false;
 	}
 
+	switch (Gjk::collide(pimpl->vertices, other.pimpl->vertices, otherToThis,
+			intersection)) {
+	case Gjk::Result::SEPARATED:
+		return false;
+	case Gjk::Result::INTERSECTING:
+		return true;
+	case Gjk::Result::UNKNOWN:
+		break;
+	}
+	return satCollide(other, otherToThis, intersection);
+}
+
+/**
+ * Collide two hulls using separating axis test, testing face normals of
+ * both hulls and cross products of edge directions
+ *
+ * @param other         hull to collide against
+ * @param otherToThis   from other hull space to this hull space
+ * @param intersection  intersection, written only if collision
+ *
+ * @return              true if collision, false otherwise
+ */
+PRIVATE bool ConvexHull::satCollide(const ConvexHull & other,
+		const Transform & otherToThis, Intersection & intersection) const {
 	auto thatVerticesInThisSpace = other.pimpl->vertices.transformed(
 			otherToThis);
 
@@ -865,6 +944,9 @@ ConvexHull ConvexHull::transformed(const Transform & transform) const {
 bool ConvexHull::validate() const {
 	std::lock_guard<std::mutex> locker(pimpl->m_validateLock);
 
+	if (pimpl->points != nullptr && pimpl->build() == false) {
+		return false;
+	}
 	if (pimpl->vertices.validate() == false) {
 		return false;
 	}
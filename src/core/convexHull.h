@@ -75,6 +75,14 @@ public:
 			const IndexArray & faceDirectionsIndices,
 			const IndexArray & edgeDirectionsIndices);
 
+	/**
+	 * Construct from points, hull is built by quickhull once points load
+	 *
+	 * @param points       points to build hull of
+	 * @param maxVertices  most vertices of hull
+	 */
+	ConvexHull(const Vec3Array & points, size_t maxVertices);
+
 	/**
 	 * copy constructor
 	 *
@@ -100,7 +108,7 @@ public:
 			Intersection & intersection) const;
 
 	/**
-	 * Collide two hulls
+	 * Collide two hulls, GJK and EPA with separating axis test as fallback
 	 *
 	 * @param other         hull to collide against
 	 * @param otherToThis   from other hull space to this hull space
@@ -216,6 +224,19 @@ public:
 	static const ScriptObjectPtr & getFactory();
 
 private:
+	/**
+	 * Collide two hulls using separating axis test, testing face normals of
+	 * both hulls and cross products of edge directions
+	 *
+	 * @param other         hull to collide against
+	 * @param otherToThis   from other hull space to this hull space
+	 * @param intersection  intersection, written only if collision
+	 *
+	 * @return              true if collision, false otherwise
+	 */
+	bool satCollide(const ConvexHull & other, const Transform & otherToThis,
+			Intersection & intersection) const;
+
 	struct impl;
 	std::shared_ptr<impl> pimpl;
 };
@@ -13,6 +13,7 @@
 #include "normal.h"
 #include "normalArray.h"
 #include "quat.h"
+#include "quickhull.h"
 #include "ray.h"
 #include "rect.h"
 #include "skinningMatrix.h"
@@ -36,24 +37,25 @@ struct CoreModule::impl {
 		members.emplace("Animation", Animation::getFactory());
 		members.emplace("Bone", Bone::getFactory());
 		members.emplace("Bezier",  Binary::getFactory(currentDir));
-		members.emplace("BoundingBox", BoundingBox::getFactory());
+		members.emplace("BoundingBox", ScriptBoundingBox::getFactory());
 		members.emplace("Collision", CollisionHierarchy::getFactory());
 		members.emplace("Color", Color::getFactory());
 		members.emplace("ConvexHull", ConvexHull::getFactory());
 		members.emplace("IndexArray", IndexArray::getFactory(currentDir));
 //		members.emplace("Mat3", Mat3::getFactory());
-		members.emplace("Mat4", Mat4::getFactory());
-		members.emplace("Normal", Normal::getFactory());
+		members.emplace("Mat4", ScriptMat4::getFactory());
+		members.emplace("Normal", ScriptNormal::getFactory());
 		members.emplace("NormalArray",  NormalArray::getFactory(currentDir));
-		members.emplace("Quat", Quat::getFactory());
+		members.emplace("Quat", ScriptQuat::getFactory());
+		members.emplace("Quickhull", Quickhull::getFactory());
 		members.emplace("Ray", Ray::getFactory());
 		members.emplace("Rect", Rect::getFactory());
 		members.emplace("SkinningMatrix", SkinningMatrix::getFactory());
 		members.emplace("Sphere", Sphere::getFactory());
 		members.emplace("Terrain", Terrain::getFactory());
-		members.emplace("Transform", Transform::getFactory());
+		members.emplace("Transform", ScriptTransform::getFactory());
 		members.emplace("Vec2", Vec2::getFactory());
-		members.emplace("Vec3", Vec3::getFactory());
+		members.emplace("Vec3", ScriptVec3::getFactory());
 		members.emplace("Vec3Array",  Vec3Array::getFactory(currentDir));
 	}
 };
@@ -0,0 +1,209 @@
+#include "flatRTree.h"
+
+#include "simd.h"
+
+namespace {
+	/*
+	 * scalar overlap of query with children from 'i' onwards
+	 */
+	unsigned overlapScalar(const float * bounds, unsigned width,
+			const float * query, unsigned i) {
+		unsigned mask = 0;
+		for (; i < width; ++i) {
+			if (bounds[i] <= query[3] && bounds[width + i] <= query[4]
+					&& bounds[2 * width + i] <= query[5]
+					&& bounds[3 * width + i] >= query[0]
+					&& bounds[4 * width + i] >= query[1]
+					&& bounds[5 * width + i] >= query[2]) {
+				mask |= 1u << i;
+			}
+		}
+		return mask;
+	}
+
+	unsigned overlapScalar(const float * bounds, unsigned width,
+			const float * query) {
+		return overlapScalar(bounds, width, query, 0);
+	}
+
+	/*
+	 * scalar ray slab test with children from 'i' onwards
+	 */
+	unsigned rayScalar(const float * bounds, unsigned width,
+			const float * ray, unsigned i) {
+		unsigned mask = 0;
+		for (; i < width; ++i) {
+			float tmin = ray[6];
+			float tmax = ray[7];
+			bool hit = true;
+			for (unsigned k = 0; k < 3 && hit; ++k) {
+				float lo = bounds[k * width + i];
+				float hi = bounds[(k + 3) * width + i];
+				if (ray[3 + k] == 0) {
+					hit = ray[k] >= lo && ray[k] <= hi;
+					continue;
+				}
+				float t0 = (lo - ray[k]) * ray[3 + k];
+				float t1 = (hi - ray[k]) * ray[3 + k];
+				tmin = std::max(tmin, std::min(t0, t1));
+				tmax = std::min(tmax, std::max(t0, t1));
+				hit = tmin <= tmax;
+			}
+			if (hit) {
+				mask |= 1u << i;
+			}
+		}
+		return mask;
+	}
+
+	unsigned rayScalar(const float * bounds, unsigned width,
+			const float * ray) {
+		return rayScalar(bounds, width, ray, 0);
+	}
+
+	const FlatRTreeKernels scalarKernels = { overlapScalar, rayScalar };
+
+#ifdef SIMD_X86
+	/*
+	 * sse2 overlap, four children at a time
+	 */
+	SIMD_TARGET_SSE2 unsigned overlapSse2(const float * bounds,
+			unsigned width, const float * query) {
+		__m128 qlx = _mm_set1_ps(query[0]);
+		__m128 qly = _mm_set1_ps(query[1]);
+		__m128 qlz = _mm_set1_ps(query[2]);
+		__m128 qhx = _mm_set1_ps(query[3]);
+		__m128 qhy = _mm_set1_ps(query[4]);
+		__m128 qhz = _mm_set1_ps(query[5]);
+
+		unsigned mask = 0;
+		unsigned i = 0;
+		for (; i + 4 <= width; i += 4) {
+			__m128 m = _mm_cmple_ps(_mm_loadu_ps(bounds + i), qhx);
+			m = _mm_and_ps(m,
+					_mm_cmple_ps(_mm_loadu_ps(bounds + width + i), qhy));
+			m = _mm_and_ps(m,
+					_mm_cmple_ps(_mm_loadu_ps(bounds + 2 * width + i), qhz));
+			m = _mm_and_ps(m,
+					_mm_cmpge_ps(_mm_loadu_ps(bounds + 3 * width + i), qlx));
+			m = _mm_and_ps(m,
+					_mm_cmpge_ps(_mm_loadu_ps(bounds + 4 * width + i), qly));
+			m = _mm_and_ps(m,
+					_mm_cmpge_ps(_mm_loadu_ps(bounds + 5 * width + i), qlz));
+			mask |= static_cast<unsigned>(_mm_movemask_ps(m)) << i;
+		}
+		return mask | overlapScalar(bounds, width, query, i);
+	}
+
+	/*
+	 * sse2 ray slab test, four children at a time
+	 */
+	SIMD_TARGET_SSE2 unsigned raySse2(const float * bounds, unsigned width,
+			const float * ray) {
+		unsigned mask = 0;
+		unsigned i = 0;
+		for (; i + 4 <= width; i += 4) {
+			__m128 tmin = _mm_set1_ps(ray[6]);
+			__m128 tmax = _mm_set1_ps(ray[7]);
+			__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (unsigned k = 0; k < 3; ++k) {
+				__m128 lo = _mm_loadu_ps(bounds + k * width + i);
+				__m128 hi = _mm_loadu_ps(bounds + (k + 3) * width + i);
+				__m128 o = _mm_set1_ps(ray[k]);
+				if (ray[3 + k] == 0) {
+					inside = _mm_and_ps(inside, _mm_and_ps(_mm_cmpge_ps(o, lo),
+							_mm_cmple_ps(o, hi)));
+					continue;
+				}
+				__m128 inv = _mm_set1_ps(ray[3 + k]);
+				__m128 t0 = _mm_mul_ps(_mm_sub_ps(lo, o), inv);
+				__m128 t1 = _mm_mul_ps(_mm_sub_ps(hi, o), inv);
+				tmin = _mm_max_ps(tmin, _mm_min_ps(t0, t1));
+				tmax = _mm_min_ps(tmax, _mm_max_ps(t0, t1));
+			}
+			__m128 m = _mm_and_ps(inside, _mm_cmple_ps(tmin, tmax));
+			mask |= static_cast<unsigned>(_mm_movemask_ps(m)) << i;
+		}
+		return mask | rayScalar(bounds, width, ray, i);
+	}
+
+	/*
+	 * avx2 overlap, eight children at a time
+	 */
+	SIMD_TARGET_AVX2 unsigned overlapAvx2(const float * bounds,
+			unsigned width, const float * query) {
+		if (width != 8) {
+			return overlapSse2(bounds, width, query);
+		}
+		__m256 m = _mm256_cmp_ps(_mm256_loadu_ps(bounds),
+				_mm256_set1_ps(query[3]), _CMP_LE_OQ);
+		m = _mm256_and_ps(m, _mm256_cmp_ps(_mm256_loadu_ps(bounds + 8),
+				_mm256_set1_ps(query[4]), _CMP_LE_OQ));
+		m = _mm256_and_ps(m, _mm256_cmp_ps(_mm256_loadu_ps(bounds + 16),
+				_mm256_set1_ps(query[5]), _CMP_LE_OQ));
+		m = _mm256_and_ps(m, _mm256_cmp_ps(_mm256_loadu_ps(bounds + 24),
+				_mm256_set1_ps(query[0]), _CMP_GE_OQ));
+		m = _mm256_and_ps(m, _mm256_cmp_ps(_mm256_loadu_ps(bounds + 32),
+				_mm256_set1_ps(query[1]), _CMP_GE_OQ));
+		m = _mm256_and_ps(m, _mm256_cmp_ps(_mm256_loadu_ps(bounds + 40),
+				_mm256_set1_ps(query[2]), _CMP_GE_OQ));
+		return static_cast<unsigned>(_mm256_movemask_ps(m));
+	}
+
+	/*
+	 * avx2 ray slab test, eight children at a time
+	 */
+	SIMD_TARGET_AVX2 unsigned rayAvx2(const float * bounds, unsigned width,
+			const float * ray) {
+		if (width != 8) {
+			return raySse2(bounds, width, ray);
+		}
+		__m256 tmin = _mm256_set1_ps(ray[6]);
+		__m256 tmax = _mm256_set1_ps(ray[7]);
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (unsigned k = 0; k < 3; ++k) {
+			__m256 lo = _mm256_loadu_ps(bounds + k * 8);
+			__m256 hi = _mm256_loadu_ps(bounds + (k + 3) * 8);
+			__m256 o = _mm256_set1_ps(ray[k]);
+			if (ray[3 + k] == 0) {
+				inside = _mm256_and_ps(inside,
+						_mm256_and_ps(_mm256_cmp_ps(o, lo, _CMP_GE_OQ),
+								_mm256_cmp_ps(o, hi, _CMP_LE_OQ)));
+				continue;
+			}
+			__m256 inv = _mm256_set1_ps(ray[3 + k]);
+			__m256 t0 = _mm256_mul_ps(_mm256_sub_ps(lo, o), inv);
+			__m256 t1 = _mm256_mul_ps(_mm256_sub_ps(hi, o), inv);
+			tmin = _mm256_max_ps(tmin, _mm256_min_ps(t0, t1));
+			tmax = _mm256_min_ps(tmax, _mm256_max_ps(t0, t1));
+		}
+		__m256 m = _mm256_and_ps(inside,
+				_mm256_cmp_ps(tmin, tmax, _CMP_LE_OQ));
+		return static_cast<unsigned>(_mm256_movemask_ps(m));
+	}
+
+	const FlatRTreeKernels sse2Kernels = { overlapSse2, raySse2 };
+
+	const FlatRTreeKernels avx2Kernels = { overlapAvx2, rayAvx2 };
+#endif
+}
+
+/**
+ * get kernels for best instruction set supported by processor
+ *
+ * @return  kernels
+ */
+STATIC const FlatRTreeKernels & FlatRTreeKernels::get() {
+#ifdef SIMD_X86
+	switch (Simd::getLevel()) {
+	case Simd::Level::AVX2:
+		return avx2Kernels;
+	case Simd::Level::SSE2:
+		return sse2Kernels;
+	case Simd::Level::SCALAR:
+		break;
+	}
+#endif
+	return scalarKernels;
+}
+
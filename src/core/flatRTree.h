@@ -0,0 +1,312 @@
+#pragma once
+
+#include "boundingBox.h"
+#include "normal.h"
+#include "ray.h"
+#include "vec3.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+/*
+ * Tests of a query against structure of arrays child bounds, as laid out in
+ * FlatRTree nodes, returning mask of children hit. Selected at runtime for
+ * best instruction set
+ */
+struct FlatRTreeKernels {
+	/**
+	 * bounds   minX, minY, minZ, maxX, maxY, maxZ each 'width' floats
+	 * query    minX, minY, minZ, maxX, maxY, maxZ
+	 */
+	unsigned (*overlap)(const float * bounds, unsigned width,
+			const float * query);
+
+	/**
+	 * bounds   as for overlap
+	 * ray      start x, y, z, inverse direction x, y, z, tmin, tmax. Zero
+	 *          inverse direction marks axis ray is parallel with
+	 */
+	unsigned (*ray)(const float * bounds, unsigned width, const float * ray);
+
+	/**
+	 * get kernels for best instruction set supported by processor
+	 *
+	 * @return  kernels
+	 */
+	static const FlatRTreeKernels & get();
+};
+
+/*
+ * R-tree bulk loaded with sort tile recursive packing. Nodes are stored
+ * contiguously, each holding its children's bounds as structure of arrays
+ * floats so all children are tested at once. Bounds are relative to centre
+ * of tree and rounded outward, so float tests never miss
+ */
+template<unsigned SIZE, typename TYPE>
+class FlatRTree {
+	static_assert(SIZE == 4 || SIZE == 8, "FlatRTree SIZE must be 4 or 8");
+
+private:
+	struct Node {
+		/** minX, minY, minZ, maxX, maxY, maxZ for each child */
+		float bounds[6 * SIZE];
+		/** index of child node, or leaf */
+		uint32_t child[SIZE];
+		uint32_t count;
+		bool leaf;
+
+		Node() :
+				count(0), leaf(false) {
+			// unused children never hit by overlap, or ray tests with finite
+			// range
+			std::fill(bounds, bounds + 6 * SIZE,
+					std::numeric_limits<float>::infinity());
+		}
+	};
+
+	/*
+	 * item being packed into nodes
+	 */
+	struct Item {
+		BoundingBox bounds;
+		Vec3 centre;
+		uint32_t index;
+
+		Item(const BoundingBox & bounds, uint32_t index) :
+				bounds(bounds), centre(bounds.getCentre()), index(index) {
+		}
+	};
+
+	std::vector<Node> m_nodes;
+	std::vector<TYPE> m_leaves;
+	BoundingBox m_bounds;
+	Vec3 m_centre;
+	uint32_t m_root;
+
+	static float roundDown(double v) {
+		float f = static_cast<float>(v);
+		if (f > v) {
+			f = std::nextafter(f, -std::numeric_limits<float>::max());
+		}
+		return f;
+	}
+
+	static float roundUp(double v) {
+		float f = static_cast<float>(v);
+		if (f < v) {
+			f = std::nextafter(f, std::numeric_limits<float>::max());
+		}
+		return f;
+	}
+
+	/*
+	 * order items so runs of SIZE are spatially coherent, sorting on x into
+	 * slabs, each slab on y into slices, and each slice on z
+	 */
+	static void sortTileRecursive(std::vector<Item> & items) {
+		size_t n = items.size();
+		size_t nNodes = (n + SIZE - 1) / SIZE;
+		auto s = static_cast<size_t>(
+				std::ceil(std::cbrt(static_cast<double>(nNodes))));
+		size_t sliceSize = s * SIZE;
+		size_t slabSize = s * sliceSize;
+
+		std::sort(items.begin(), items.end(),
+				[](const Item & a, const Item & b) {
+					return a.centre.getX() < b.centre.getX();
+				});
+		for (size_t i = 0; i < n; i += slabSize) {
+			size_t slabEnd = std::min(n, i + slabSize);
+			std::sort(items.begin() + i, items.begin() + slabEnd,
+					[](const Item & a, const Item & b) {
+						return a.centre.getY() < b.centre.getY();
+					});
+			for (size_t j = i; j < slabEnd; j += sliceSize) {
+				size_t sliceEnd = std::min(slabEnd, j + sliceSize);
+				std::sort(items.begin() + j, items.begin() + sliceEnd,
+						[](const Item & a, const Item & b) {
+							return a.centre.getZ() < b.centre.getZ();
+						});
+			}
+		}
+	}
+
+	/*
+	 * pack items into nodes, SIZE at a time, returning parent items
+	 */
+	std::vector<Item> pack(const std::vector<Item> & items, bool leaf,
+			double padding) {
+		std::vector<Item> parents;
+		for (size_t i = 0, n = items.size(); i < n; i += SIZE) {
+			auto nodeIndex = static_cast<uint32_t>(m_nodes.size());
+			m_nodes.emplace_back();
+			auto & node = m_nodes.back();
+			node.leaf = leaf;
+			BoundingBox bounds = BoundingBox::empty();
+			for (size_t j = i; j < std::min(n, i + SIZE); ++j) {
+				const auto & item = items[j];
+				auto lo = item.bounds.getMin() - m_centre;
+				auto hi = item.bounds.getMax() - m_centre;
+				auto c = node.count++;
+				node.bounds[c] = roundDown(lo.getX() - padding);
+				node.bounds[SIZE + c] = roundDown(lo.getY() - padding);
+				node.bounds[2 * SIZE + c] = roundDown(lo.getZ() - padding);
+				node.bounds[3 * SIZE + c] = roundUp(hi.getX() + padding);
+				node.bounds[4 * SIZE + c] = roundUp(hi.getY() + padding);
+				node.bounds[5 * SIZE + c] = roundUp(hi.getZ() + padding);
+				node.child[c] = item.index;
+				bounds += item.bounds;
+			}
+			parents.emplace_back(bounds, nodeIndex);
+		}
+		return parents;
+	}
+
+	/*
+	 * call function for every hit child of node
+	 */
+	template<typename FUNC>
+	void visit(const Node & node, unsigned mask, uint32_t * stack,
+			size_t & top, FUNC & fn) const {
+		for (unsigned c = 0; mask != 0; ++c, mask >>= 1) {
+			if ((mask & 1) == 0) {
+				continue;
+			}
+			if (node.leaf) {
+				fn(m_leaves[node.child[c]]);
+			} else {
+				stack[top++] = node.child[c];
+			}
+		}
+	}
+
+	/** tree depth is logarithmic in SIZE, bounded well within stack */
+	static const size_t stackSize = 64 * SIZE;
+
+public:
+	FlatRTree() :
+			m_bounds(BoundingBox::empty()), m_root(0) {
+	}
+
+	/**
+	 * bulk load tree
+	 *
+	 * @param bounds  bounds of each leaf
+	 * @param leaves  leaves, same length as bounds
+	 */
+	FlatRTree(const std::vector<BoundingBox> & bounds,
+			const std::vector<TYPE> & leaves) :
+			m_bounds(BoundingBox::empty()), m_root(0) {
+		size_t n = std::min(bounds.size(), leaves.size());
+		if (n == 0) {
+			return;
+		}
+
+		std::vector<Item> items;
+		items.reserve(n);
+		for (size_t i = 0; i < n; ++i) {
+			items.emplace_back(bounds[i], static_cast<uint32_t>(i));
+			m_bounds += bounds[i];
+		}
+		m_centre = m_bounds.getCentre();
+
+		// cover float error in ray tests, relative to size of tree
+		auto extents = m_bounds.getExtents();
+		double padding = 1e-5 * std::max(1e-3, std::max(extents.getX(),
+				std::max(extents.getY(), extents.getZ())));
+
+		sortTileRecursive(items);
+
+		// leaves in packed order
+		m_leaves.reserve(n);
+		for (auto & item : items) {
+			m_leaves.emplace_back(leaves[item.index]);
+			item.index = static_cast<uint32_t>(m_leaves.size() - 1);
+		}
+
+		items = pack(items, true, padding);
+		while (items.size() > 1) {
+			sortTileRecursive(items);
+			items = pack(items, false, padding);
+		}
+		m_root = items[0].index;
+	}
+
+	~FlatRTree() {
+	}
+
+	bool empty() const {
+		return m_nodes.empty();
+	}
+
+	// call function 'fn' passing parameter of type TYPE if it was inserted
+	// with bounds intersecting 'bounds' for all those that do
+	template<typename FUNC>
+	void intersect(const BoundingBox & bounds, FUNC & fn) const {
+		if (empty()) {
+			return;
+		}
+		if (!bounds.intersects(m_bounds)) {
+			return;
+		}
+
+		auto lo = bounds.getMin() - m_centre;
+		auto hi = bounds.getMax() - m_centre;
+		float query[6] = { roundDown(lo.getX()), roundDown(lo.getY()),
+				roundDown(lo.getZ()), roundUp(hi.getX()), roundUp(hi.getY()),
+				roundUp(hi.getZ()) };
+
+		const auto & kernels = FlatRTreeKernels::get();
+		std::array<uint32_t, stackSize> stack;
+		size_t top = 0;
+		stack[top++] = m_root;
+		while (top != 0) {
+			const auto & node = m_nodes[stack[--top]];
+			visit(node, kernels.overlap(node.bounds, SIZE, query),
+					stack.data(), top, fn);
+		}
+	}
+
+	// call function 'fn' passing parameter of type TYPE if it was inserted
+	// with bounds intersected by ray between t0 and t1
+	template<typename FUNC>
+	void rayIntersect(const Ray & ray, double t0, double t1, FUNC & fn) const {
+		if (empty()) {
+			return;
+		}
+		if (!m_bounds.rayIntersect(ray, t0, t1)) {
+			return;
+		}
+
+		// parallel axes as for BoundingBox::rayIntersect
+		const float epsilon = .00001f;
+		const auto & d = ray.getDirection();
+		auto o = ray.getStart() - m_centre;
+		float query[8] = { static_cast<float>(o.getX()),
+				static_cast<float>(o.getY()), static_cast<float>(o.getZ()),
+				std::abs(d.getX()) > epsilon ?
+						static_cast<float>(1 / d.getX()) : 0,
+				std::abs(d.getY()) > epsilon ?
+						static_cast<float>(1 / d.getY()) : 0,
+				std::abs(d.getZ()) > epsilon ?
+						static_cast<float>(1 / d.getZ()) : 0,
+				std::max(roundDown(t0), -std::numeric_limits<float>::max()),
+				std::min(roundUp(t1), std::numeric_limits<float>::max()) };
+
+		const auto & kernels = FlatRTreeKernels::get();
+		std::array<uint32_t, stackSize> stack;
+		size_t top = 0;
+		stack[top++] = m_root;
+		while (top != 0) {
+			const auto & node = m_nodes[stack[--top]];
+			visit(node, kernels.ray(node.bounds, SIZE, query), stack.data(),
+					top, fn);
+		}
+	}
+};
+
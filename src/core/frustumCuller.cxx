@@ -0,0 +1,368 @@
+#include "frustumCuller.h"
+#include "simd.h"
+
+#include "boundingBox.h"
+#include "mat3.h"
+#include "transform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+	/** boxes tested per kernel call */
+	const size_t nLanes = 8;
+
+	/*
+	 * batch of boxes gathered component by component, as centres and half
+	 * extents. Unused lanes hold zeros
+	 */
+	struct Lanes {
+		float cx[nLanes];
+		float cy[nLanes];
+		float cz[nLanes];
+		float ex[nLanes];
+		float ey[nLanes];
+		float ez[nLanes];
+	};
+
+	/*
+	 * plane in space of boxes, distance of point from plane being
+	 * nx * x + ny * y + nz * z + d
+	 */
+	struct PlaneTerms {
+		float nx;
+		float ny;
+		float nz;
+		float d;
+	};
+
+	/*
+	 * test first n lanes against each plane, writing masks of lanes wholly
+	 * outside, straddling and with centres outside each plane, and for each
+	 * lane most distance outside a plane and least distance inside planes it
+	 * lies wholly inside of. Planes after all lanes are outside one may be
+	 * left untested
+	 */
+	typedef void (*CullKernel)(const Lanes & l, size_t n,
+			const PlaneTerms * planes, size_t nPlanes, unsigned * outside,
+			unsigned * straddle, unsigned * centre, float * outMargins,
+			float * inMargins);
+
+	/*
+	 * scalar, one box at a time
+	 */
+	void cullScalar(const Lanes & l, size_t n, const PlaneTerms * planes,
+			size_t nPlanes, unsigned * outside, unsigned * straddle,
+			unsigned * centre, float * outMargins, float * inMargins) {
+		std::fill(outMargins, outMargins + n,
+				-std::numeric_limits<float>::infinity());
+		std::fill(inMargins, inMargins + n,
+				std::numeric_limits<float>::infinity());
+		unsigned all = (1u << n) - 1;
+		unsigned out = 0;
+		for (size_t k = 0; k < nPlanes; ++k) {
+			outside[k] = 0;
+			straddle[k] = 0;
+			centre[k] = 0;
+			if (out == all) {
+				continue;
+			}
+			const auto & p = planes[k];
+			for (size_t i = 0; i < n; ++i) {
+				float d = p.nx * l.cx[i] + p.ny * l.cy[i] + p.nz * l.cz[i]
+						+ p.d;
+				float r = std::abs(p.nx) * l.ex[i] + std::abs(p.ny) * l.ey[i]
+						+ std::abs(p.nz) * l.ez[i];
+				outside[k] |= (d > r ? 1u : 0u) << i;
+				straddle[k] |= (d > -r ? 1u : 0u) << i;
+				centre[k] |= (d > 0 ? 1u : 0u) << i;
+				outMargins[i] = std::max(outMargins[i], d - r);
+				if (-r - d >= 0) {
+					inMargins[i] = std::min(inMargins[i], -r - d);
+				}
+			}
+			out |= outside[k];
+		}
+	}
+
+#ifdef SIMD_X86
+	/*
+	 * sse2, four boxes at a time
+	 */
+	SIMD_TARGET_SSE2 void cullSse2(const Lanes & l, size_t n,
+			const PlaneTerms * planes, size_t nPlanes, unsigned * outside,
+			unsigned * straddle, unsigned * centre, float * outMargins,
+			float * inMargins) {
+		__m128 sign = _mm_set1_ps(-0.0f);
+		__m128 zero = _mm_setzero_ps();
+		__m128 inf = _mm_set1_ps(std::numeric_limits<float>::infinity());
+		std::fill(outside, outside + nPlanes, 0);
+		std::fill(straddle, straddle + nPlanes, 0);
+		std::fill(centre, centre + nPlanes, 0);
+		for (size_t i = 0; i < n; i += 4) {
+			__m128 cx = _mm_loadu_ps(l.cx + i);
+			__m128 cy = _mm_loadu_ps(l.cy + i);
+			__m128 cz = _mm_loadu_ps(l.cz + i);
+			__m128 ex = _mm_loadu_ps(l.ex + i);
+			__m128 ey = _mm_loadu_ps(l.ey + i);
+			__m128 ez = _mm_loadu_ps(l.ez + i);
+			__m128 outMargin = _mm_set1_ps(
+					-std::numeric_limits<float>::infinity());
+			__m128 inMargin = inf;
+			unsigned all = ((1u << std::min<size_t>(n - i, 4)) - 1) << i;
+			unsigned out = 0;
+			for (size_t k = 0; k < nPlanes && out != all; ++k) {
+				__m128 nx = _mm_set1_ps(planes[k].nx);
+				__m128 ny = _mm_set1_ps(planes[k].ny);
+				__m128 nz = _mm_set1_ps(planes[k].nz);
+				__m128 d = _mm_add_ps(_mm_set1_ps(planes[k].d),
+						_mm_mul_ps(nx, cx));
+				d = _mm_add_ps(d, _mm_mul_ps(ny, cy));
+				d = _mm_add_ps(d, _mm_mul_ps(nz, cz));
+				__m128 r = _mm_mul_ps(_mm_andnot_ps(sign, nx), ex);
+				r = _mm_add_ps(r, _mm_mul_ps(_mm_andnot_ps(sign, ny), ey));
+				r = _mm_add_ps(r, _mm_mul_ps(_mm_andnot_ps(sign, nz), ez));
+				__m128 nr = _mm_xor_ps(r, sign);
+				outside[k] |= all & (static_cast<unsigned>(
+						_mm_movemask_ps(_mm_cmpgt_ps(d, r))) << i);
+				straddle[k] |= all & (static_cast<unsigned>(
+						_mm_movemask_ps(_mm_cmpgt_ps(d, nr))) << i);
+				centre[k] |= all & (static_cast<unsigned>(
+						_mm_movemask_ps(_mm_cmpgt_ps(d, zero))) << i);
+				outMargin = _mm_max_ps(outMargin, _mm_sub_ps(d, r));
+				__m128 in = _mm_sub_ps(nr, d);
+				__m128 inside = _mm_cmpge_ps(in, zero);
+				in = _mm_or_ps(_mm_and_ps(inside, in),
+						_mm_andnot_ps(inside, inf));
+				inMargin = _mm_min_ps(inMargin, in);
+				out |= outside[k] & all;
+			}
+			float outs[4];
+			float ins[4];
+			_mm_storeu_ps(outs, outMargin);
+			_mm_storeu_ps(ins, inMargin);
+			for (size_t j = i, m = std::min<size_t>(n, i + 4); j < m; ++j) {
+				outMargins[j] = outs[j - i];
+				inMargins[j] = ins[j - i];
+			}
+		}
+	}
+
+	/*
+	 * avx2, eight boxes at a time
+	 */
+	SIMD_TARGET_AVX2 void cullAvx2(const Lanes & l, size_t n,
+			const PlaneTerms * planes, size_t nPlanes, unsigned * outside,
+			unsigned * straddle, unsigned * centre, float * outMargins,
+			float * inMargins) {
+		__m256 sign = _mm256_set1_ps(-0.0f);
+		__m256 zero = _mm256_setzero_ps();
+		__m256 inf = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+		__m256 cx = _mm256_loadu_ps(l.cx);
+		__m256 cy = _mm256_loadu_ps(l.cy);
+		__m256 cz = _mm256_loadu_ps(l.cz);
+		__m256 ex = _mm256_loadu_ps(l.ex);
+		__m256 ey = _mm256_loadu_ps(l.ey);
+		__m256 ez = _mm256_loadu_ps(l.ez);
+		__m256 outMargin = _mm256_set1_ps(
+				-std::numeric_limits<float>::infinity());
+		__m256 inMargin = inf;
+		unsigned all = (1u << n) - 1;
+		unsigned out = 0;
+		for (size_t k = 0; k < nPlanes; ++k) {
+			outside[k] = 0;
+			straddle[k] = 0;
+			centre[k] = 0;
+			if (out == all) {
+				continue;
+			}
+			__m256 nx = _mm256_set1_ps(planes[k].nx);
+			__m256 ny = _mm256_set1_ps(planes[k].ny);
+			__m256 nz = _mm256_set1_ps(planes[k].nz);
+			__m256 d = _mm256_add_ps(_mm256_set1_ps(planes[k].d),
+					_mm256_mul_ps(nx, cx));
+			d = _mm256_add_ps(d, _mm256_mul_ps(ny, cy));
+			d = _mm256_add_ps(d, _mm256_mul_ps(nz, cz));
+			__m256 r = _mm256_mul_ps(_mm256_andnot_ps(sign, nx), ex);
+			r = _mm256_add_ps(r,
+					_mm256_mul_ps(_mm256_andnot_ps(sign, ny), ey));
+			r = _mm256_add_ps(r,
+					_mm256_mul_ps(_mm256_andnot_ps(sign, nz), ez));
+			__m256 nr = _mm256_xor_ps(r, sign);
+			outside[k] = all & static_cast<unsigned>(_mm256_movemask_ps(
+					_mm256_cmp_ps(d, r, _CMP_GT_OQ)));
+			straddle[k] = all & static_cast<unsigned>(_mm256_movemask_ps(
+					_mm256_cmp_ps(d, nr, _CMP_GT_OQ)));
+			centre[k] = all & static_cast<unsigned>(_mm256_movemask_ps(
+					_mm256_cmp_ps(d, zero, _CMP_GT_OQ)));
+			outMargin = _mm256_max_ps(outMargin, _mm256_sub_ps(d, r));
+			__m256 in = _mm256_sub_ps(nr, d);
+			inMargin = _mm256_min_ps(inMargin, _mm256_blendv_ps(inf, in,
+					_mm256_cmp_ps(in, zero, _CMP_GE_OQ)));
+			out |= outside[k];
+		}
+		float outs[nLanes];
+		float ins[nLanes];
+		_mm256_storeu_ps(outs, outMargin);
+		_mm256_storeu_ps(ins, inMargin);
+		std::copy(outs, outs + n, outMargins);
+		std::copy(ins, ins + n, inMargins);
+	}
+#endif
+
+	/*
+	 * cull kernel for best instruction set supported
+	 */
+	CullKernel cullKernel() {
+#ifdef SIMD_X86
+		switch (Simd::getLevel()) {
+		case Simd::Level::AVX2:
+			return cullAvx2;
+		case Simd::Level::SSE2:
+			return cullSse2;
+		case Simd::Level::SCALAR:
+			break;
+		}
+#endif
+		return cullScalar;
+	}
+}
+
+const size_t FrustumCuller::maxPlanes;
+const uint32_t FrustumCuller::outside;
+const uint32_t FrustumCuller::centreOutside;
+
+/**
+ * constructor
+ *
+ * @param hull  planes of convex hull, normals facing out
+ * @param clip  clip planes, normals facing side kept
+ */
+FrustumCuller::FrustumCuller(const std::vector<Plane> & hull,
+		const std::vector<Plane> & clip) :
+		hullMask(0), mask(0) {
+	// leaving planes out only culls less
+	for (const auto & plane : hull) {
+		if (planes.size() < maxPlanes) {
+			hullMask |= 1u << planes.size();
+			planes.emplace_back(plane);
+		}
+	}
+	for (const auto & plane : clip) {
+		if (planes.size() < maxPlanes) {
+			planes.emplace_back(plane);
+			planes.back().flipNormal();
+		}
+	}
+	mask = planes.empty() ? 0 : ~0u >> (32 - planes.size());
+}
+
+/**
+ * Test batch of boxes sharing transform against planes
+ *
+ * @param boxes      boxes to test
+ * @param n          number of boxes
+ * @param toPlanes   transform taking boxes into space of planes
+ * @param enclosing  result of box enclosing boxes, planes boxes straddle
+ *                   being among those it straddles
+ * @param results    result of each box, written
+ */
+void FrustumCuller::cull(const BoundingBox * const * boxes, size_t n,
+		const Transform & toPlanes, const Result & enclosing,
+		Result * results) const {
+	static auto kernel = cullKernel();
+
+	// planes into space of boxes, once for whole batch. Distance of box
+	// point x is n . (R x + t - p), so normal is inverse of R applied to n
+	auto rotation = toPlanes.getInverseRotationMatrix();
+	auto translation = toPlanes.getTranslation();
+	PlaneTerms terms[maxPlanes];
+	uint32_t bits[maxPlanes];
+	size_t nPlanes = 0;
+	for (size_t k = 0, m = planes.size(); k < m; ++k) {
+		if ((enclosing.planes & (1u << k)) == 0) {
+			continue;
+		}
+		const auto & normal = planes[k].getNormal();
+		float x = normal.getX();
+		float y = normal.getY();
+		float z = normal.getZ();
+		auto & t = terms[nPlanes];
+		t.nx = rotation.get(0, 0) * x + rotation.get(0, 1) * y
+				+ rotation.get(0, 2) * z;
+		t.ny = rotation.get(1, 0) * x + rotation.get(1, 1) * y
+				+ rotation.get(1, 2) * z;
+		t.nz = rotation.get(2, 0) * x + rotation.get(2, 1) * y
+				+ rotation.get(2, 2) * z;
+		t.d = static_cast<float>(
+				(translation - planes[k].getPoint()).dot(normal));
+		bits[nPlanes] = 1u << k;
+		++nPlanes;
+	}
+
+	Lanes l;
+	unsigned outsideMasks[maxPlanes];
+	unsigned straddleMasks[maxPlanes];
+	unsigned centreMasks[maxPlanes];
+	float outMargins[nLanes];
+	float inMargins[nLanes];
+	for (size_t i = 0; i < n; i += nLanes) {
+		size_t count = std::min(n - i, nLanes);
+		for (size_t j = 0; j < nLanes; ++j) {
+			bool used = j < count;
+			const auto & min = boxes[used ? i + j : i]->getMin();
+			const auto & max = boxes[used ? i + j : i]->getMax();
+			l.cx[j] = used ? static_cast<float>(
+					(min.getX() + max.getX()) / 2) : 0;
+			l.cy[j] = used ? static_cast<float>(
+					(min.getY() + max.getY()) / 2) : 0;
+			l.cz[j] = used ? static_cast<float>(
+					(min.getZ() + max.getZ()) / 2) : 0;
+			l.ex[j] = used ? static_cast<float>(
+					(max.getX() - min.getX()) / 2) : 0;
+			l.ey[j] = used ? static_cast<float>(
+					(max.getY() - min.getY()) / 2) : 0;
+			l.ez[j] = used ? static_cast<float>(
+					(max.getZ() - min.getZ()) / 2) : 0;
+		}
+
+		kernel(l, count, terms, nPlanes, outsideMasks, straddleMasks,
+				centreMasks, outMargins, inMargins);
+
+		for (size_t j = 0; j < count; ++j) {
+			uint32_t planes = 0;
+			for (size_t k = 0; k < nPlanes; ++k) {
+				if ((outsideMasks[k] & (1u << j)) != 0) {
+					planes |= outside;
+				}
+				if ((straddleMasks[k] & (1u << j)) != 0) {
+					planes |= bits[k];
+				}
+				if ((centreMasks[k] & (1u << j)) != 0
+						&& (bits[k] & hullMask) != 0) {
+					planes |= centreOutside;
+				}
+			}
+			auto & result = results[i + j];
+			result.planes = planes;
+			// planes not tested are those enclosing box lies wholly inside
+			// of, as box does, by no less
+			result.margin = (planes & outside) != 0 ? outMargins[j]
+					: std::min(inMargins[j], enclosing.margin);
+		}
+	}
+}
+
+/**
+ * get result for box enclosing everything, so boxes within are tested
+ * against all planes
+ *
+ * @return  result enclosing everything
+ */
+FrustumCuller::Result FrustumCuller::getRoot() const {
+	Result root;
+	root.planes = mask;
+	root.margin = std::numeric_limits<float>::infinity();
+	return root;
+}
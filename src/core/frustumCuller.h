@@ -0,0 +1,86 @@
+#pragma once
+
+#include "plane.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class BoundingBox;
+class Transform;
+
+/*
+ * Boxes tested against planes of view frustum in batches, gathered component
+ * by component so kernels test eight boxes against a plane at a time. Each
+ * box gives the planes it straddles, so boxes within it needn't be tested
+ * against planes it lies wholly inside of
+ */
+class FrustumCuller final {
+public:
+
+	/*
+	 * result of test of box
+	 */
+	struct Result {
+		/** planes box straddles, with outside or centreOutside set */
+		uint32_t planes;
+		/**
+		 * distance box lies outside a plane if outside, otherwise least
+		 * distance box lies inside of planes it lies wholly inside of
+		 */
+		float margin;
+	};
+
+	/** most planes culled against, planes past it are left out */
+	static const size_t maxPlanes = 30;
+	/** set in result of box wholly outside a plane */
+	static const uint32_t outside = 1u << 31;
+	/** set in result of box with centre outside a plane of hull */
+	static const uint32_t centreOutside = 1u << 30;
+
+	/**
+	 * constructor
+	 *
+	 * @param hull  planes of convex hull, normals facing out
+	 * @param clip  clip planes, normals facing side kept
+	 */
+	FrustumCuller(const std::vector<Plane> & hull,
+			const std::vector<Plane> & clip);
+
+	/**
+	 * Test batch of boxes sharing transform against planes
+	 *
+	 * @param boxes      boxes to test
+	 * @param n          number of boxes
+	 * @param toPlanes   transform taking boxes into space of planes
+	 * @param enclosing  result of box enclosing boxes, planes boxes straddle
+	 *                   being among those it straddles
+	 * @param results    result of each box, written
+	 */
+	void cull(const BoundingBox * const * boxes, size_t n,
+			const Transform & toPlanes, const Result & enclosing,
+			Result * results) const;
+
+	/**
+	 * get mask of all planes
+	 *
+	 * @return  mask of planes
+	 */
+	inline uint32_t getMask() const {
+		return mask;
+	}
+
+	/**
+	 * get result for box enclosing everything, so boxes within are tested
+	 * against all planes
+	 *
+	 * @return  result enclosing everything
+	 */
+	Result getRoot() const;
+
+private:
+	/** planes, normals facing out */
+	std::vector<Plane> planes;
+	uint32_t hullMask;
+	uint32_t mask;
+};
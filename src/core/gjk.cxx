@@ -0,0 +1,377 @@
+#include "gjk.h"
+
+#include "intersection.h"
+#include "mat3.h"
+#include "normal.h"
+#include "transform.h"
+#include "vec3.h"
+#include "vec3Array.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace {
+	const int maxGjkIterations = 64;
+	const int maxEpaIterations = 64;
+	/** epa convergence, relative to penetration depth */
+	const double epaTolerance = 1e-6;
+	/** squared length below which vectors are degenerate */
+	const double epsilon = 1e-20;
+
+	/*
+	 * point on Minkowski difference a - b, and point on b used for contact
+	 */
+	struct SupportPoint {
+		Vec3 w;
+		Vec3 b;
+
+		SupportPoint() = default;
+
+		SupportPoint(const Vec3 & w, const Vec3 & b) :
+				w(w), b(b) {
+		}
+	};
+
+	/*
+	 * support mapping of a - b, with b transformed into a space
+	 */
+	struct MinkowskiDifference {
+		const Vec3Array & a;
+		const Vec3Array & b;
+		Mat3 rotation;
+		Mat3 inverseRotation;
+		Vec3 translation;
+
+		MinkowskiDifference(const Vec3Array & a, const Vec3Array & b,
+				const Transform & bToA) :
+						a(a),
+						b(b),
+						rotation(bToA.getRotationMatrix()),
+						inverseRotation(bToA.getInverseRotationMatrix()),
+						translation(bToA.getTranslation()) {
+		}
+
+		SupportPoint support(const Vec3 & direction) const {
+			Vec3 pb = rotation * b.getSupport(inverseRotation * -direction)
+					+ translation;
+			return SupportPoint(a.getSupport(direction) - pb, pb);
+		}
+	};
+
+	/*
+	 * triangle case, 'a' newest point, reduce simplex and update search
+	 * direction
+	 */
+	void updateSimplex3(SupportPoint & a, SupportPoint & b, SupportPoint & c,
+			SupportPoint & d, int & dim, Vec3 & direction) {
+		Vec3 ab = b.w - a.w;
+		Vec3 ac = c.w - a.w;
+		Vec3 ao = -a.w;
+		Vec3 n = ab.cross(ac);
+
+		dim = 2;
+		// closest to edge ab
+		if (ab.cross(n).dot(ao) > 0) {
+			c = a;
+			direction = ab.cross(ao).cross(ab);
+			return;
+		}
+		// closest to edge ac
+		if (n.cross(ac).dot(ao) > 0) {
+			b = a;
+			direction = ac.cross(ao).cross(ac);
+			return;
+		}
+
+		dim = 3;
+		// above triangle
+		if (n.dot(ao) > 0) {
+			d = c;
+			c = b;
+			b = a;
+			direction = n;
+			return;
+		}
+		// below triangle
+		d = b;
+		b = a;
+		direction = -n;
+	}
+
+	/*
+	 * tetrahedron case, 'a' newest point and bcd base, reduce simplex and
+	 * update search direction
+	 *
+	 * return true if origin enclosed
+	 */
+	bool updateSimplex4(SupportPoint & a, SupportPoint & b, SupportPoint & c,
+			SupportPoint & d, int & dim, Vec3 & direction) {
+		Vec3 ab = b.w - a.w;
+		Vec3 ac = c.w - a.w;
+		Vec3 ad = d.w - a.w;
+		Vec3 ao = -a.w;
+		Vec3 abc = ab.cross(ac);
+		Vec3 acd = ac.cross(ad);
+		Vec3 adb = ad.cross(ab);
+
+		dim = 3;
+		// in front of abc
+		if (abc.dot(ao) > 0) {
+			d = c;
+			c = b;
+			b = a;
+			direction = abc;
+			return false;
+		}
+		// in front of acd
+		if (acd.dot(ao) > 0) {
+			b = a;
+			direction = acd;
+			return false;
+		}
+		// in front of adb
+		if (adb.dot(ao) > 0) {
+			c = d;
+			d = b;
+			b = a;
+			direction = adb;
+			return false;
+		}
+		return true;
+	}
+
+	/*
+	 * polytope face, vertex indices and outward unit normal
+	 */
+	struct Face {
+		size_t v[3];
+		Vec3 normal;
+		double distance;
+	};
+
+	/*
+	 * create face wound i0, i1, i2 counter clockwise, false if degenerate
+	 */
+	bool makeFace(const std::vector<SupportPoint> & points, size_t i0,
+			size_t i1, size_t i2, Face & face) {
+		Vec3 n = (points[i1].w - points[i0].w).cross(
+				points[i2].w - points[i0].w);
+		double l2 = n.dot(n);
+		if (l2 < epsilon) {
+			return false;
+		}
+		n /= std::sqrt(l2);
+		face.v[0] = i0;
+		face.v[1] = i1;
+		face.v[2] = i2;
+		face.normal = n;
+		face.distance = n.dot(points[i0].w);
+		return true;
+	}
+
+	/*
+	 * add edge to horizon, or remove it if already present reversed
+	 */
+	void addEdge(std::vector<std::pair<size_t, size_t>> & edges, size_t a,
+			size_t b) {
+		for (auto it = edges.begin(); it != edges.end(); ++it) {
+			if (it->first == b && it->second == a) {
+				*it = edges.back();
+				edges.pop_back();
+				return;
+			}
+		}
+		edges.emplace_back(a, b);
+	}
+
+	/*
+	 * expanding polytope algorithm, starting from tetrahedron enclosing
+	 * origin
+	 *
+	 * return true if converged, writing intersection
+	 */
+	bool epa(const MinkowskiDifference & md, const SupportPoint & a,
+			const SupportPoint & b, const SupportPoint & c,
+			const SupportPoint & d, Intersection & intersection) {
+		std::vector<SupportPoint> points = { a, b, c, d };
+		std::vector<Face> faces;
+		faces.reserve(64);
+
+		Vec3 centre = (a.w + b.w + c.w + d.w) * .25;
+
+		Face face;
+		const size_t tetrahedron[4][3] = {
+				{ 0, 1, 2 }, { 0, 2, 3 }, { 0, 3, 1 }, { 1, 3, 2 } };
+		for (const auto & f : tetrahedron) {
+			if (makeFace(points, f[0], f[1], f[2], face) == false) {
+				return false;
+			}
+			// wind so normal points out of tetrahedron
+			if (face.normal.dot(centre - points[f[0]].w) > 0) {
+				makeFace(points, f[0], f[2], f[1], face);
+			}
+			faces.emplace_back(face);
+		}
+
+		std::vector<std::pair<size_t, size_t>> edges;
+
+		for (int iter = 0; iter < maxEpaIterations; ++iter) {
+			// face closest to origin
+			size_t closest = 0;
+			for (size_t i = 1, n = faces.size(); i < n; ++i) {
+				if (faces[i].distance < faces[closest].distance) {
+					closest = i;
+				}
+			}
+			const auto normal = faces[closest].normal;
+			const auto distance = faces[closest].distance;
+
+			auto p = md.support(normal);
+			double pd = p.w.dot(normal);
+
+			// converged, no significant expansion
+			if (pd - distance < epaTolerance * std::max(1.0, distance)) {
+				const auto & f = faces[closest];
+				const auto & w0 = points[f.v[0]];
+				const auto & w1 = points[f.v[1]];
+				const auto & w2 = points[f.v[2]];
+
+				// barycentric coordinates of origin projected onto face
+				Vec3 p0 = w1.w - w0.w;
+				Vec3 p1 = w2.w - w0.w;
+				Vec3 p2 = normal * distance - w0.w;
+				double d00 = p0.dot(p0);
+				double d01 = p0.dot(p1);
+				double d11 = p1.dot(p1);
+				double d20 = p2.dot(p0);
+				double d21 = p2.dot(p1);
+				double denom = d00 * d11 - d01 * d01;
+				if (std::abs(denom) < epsilon) {
+					return false;
+				}
+				double v = (d11 * d20 - d01 * d21) / denom;
+				double w = (d00 * d21 - d01 * d20) / denom;
+				double u = 1 - v - w;
+
+				Vec3 point = w0.b * u + w1.b * v + w2.b * w;
+
+				// push 'a' out along negative normal of a - b
+				intersection.set(point, -normal.normalized(), distance);
+				return true;
+			}
+
+			// remove faces visible from new point, keeping horizon
+			size_t pi = points.size();
+			points.emplace_back(p);
+			edges.clear();
+			for (size_t i = 0; i < faces.size();) {
+				const auto & f = faces[i];
+				if (f.normal.dot(p.w - points[f.v[0]].w) > 0) {
+					addEdge(edges, f.v[0], f.v[1]);
+					addEdge(edges, f.v[1], f.v[2]);
+					addEdge(edges, f.v[2], f.v[0]);
+					faces[i] = faces.back();
+					faces.pop_back();
+				} else {
+					++i;
+				}
+			}
+
+			// numerical trouble, new point sees no faces
+			if (edges.empty()) {
+				return false;
+			}
+
+			// fill horizon with faces to new point
+			for (const auto & edge : edges) {
+				if (makeFace(points, edge.first, edge.second, pi, face)
+						== false) {
+					return false;
+				}
+				faces.emplace_back(face);
+			}
+		}
+		return false;
+	}
+}
+
+/**
+ * Collide convex hulls of two vertex sets, GJK to find overlap, then EPA
+ * to find penetration depth and normal. UNKNOWN is returned for
+ * degenerate cases, touching hulls or failure to converge, for which the
+ * caller should fall back on another test
+ *
+ * @param a             vertices of first hull
+ * @param b             vertices of second hull
+ * @param bToA          from second hull space to first hull space
+ * @param intersection  intersection in first hull space, normal pushing
+ *                      first hull out of second, point on second hull,
+ *                      written only if intersecting
+ *
+ * @return              result of collision
+ */
+STATIC Gjk::Result Gjk::collide(const Vec3Array & a, const Vec3Array & b,
+		const Transform & bToA, Intersection & intersection) {
+	if (a.size() == 0 || b.size() == 0) {
+		return Result::UNKNOWN;
+	}
+
+	MinkowskiDifference md(a, b, bToA);
+
+	// initial search from centre of 'a' toward centre of 'b'
+	Vec3 direction = bToA.getTranslation();
+	if (direction.dot(direction) < epsilon) {
+		direction.set(1, 0, 0);
+	}
+
+	SupportPoint sa, sb, sc, sd;
+
+	sc = md.support(direction);
+	direction = -sc.w;
+	if (direction.dot(direction) < epsilon) {
+		// touching
+		return Result::UNKNOWN;
+	}
+
+	sb = md.support(direction);
+	if (sb.w.dot(direction) < 0) {
+		return Result::SEPARATED;
+	}
+
+	// perpendicular to line toward origin
+	Vec3 cb = sc.w - sb.w;
+	direction = cb.cross(-sb.w).cross(cb);
+	if (direction.dot(direction) < epsilon) {
+		// origin on line, any perpendicular will do
+		direction = cb.cross(Vec3(1, 0, 0));
+		if (direction.dot(direction) < epsilon) {
+			direction = cb.cross(Vec3(0, 0, -1));
+		}
+	}
+
+	int dim = 2;
+	for (int iter = 0; iter < maxGjkIterations; ++iter) {
+		if (direction.dot(direction) < epsilon) {
+			// origin on simplex
+			return Result::UNKNOWN;
+		}
+
+		sa = md.support(direction);
+		if (sa.w.dot(direction) < 0) {
+			return Result::SEPARATED;
+		}
+
+		++dim;
+		if (dim == 3) {
+			updateSimplex3(sa, sb, sc, sd, dim, direction);
+		} else if (updateSimplex4(sa, sb, sc, sd, dim, direction)) {
+			if (epa(md, sa, sb, sc, sd, intersection)) {
+				return Result::INTERSECTING;
+			}
+			return Result::UNKNOWN;
+		}
+	}
+	return Result::UNKNOWN;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+class Intersection;
+class Transform;
+class Vec3Array;
+
+class Gjk {
+public:
+
+	enum class Result {
+		SEPARATED, INTERSECTING, UNKNOWN
+	};
+
+	/**
+	 * Collide convex hulls of two vertex sets, GJK to find overlap, then EPA
+	 * to find penetration depth and normal. UNKNOWN is returned for
+	 * degenerate cases, touching hulls or failure to converge, for which the
+	 * caller should fall back on another test
+	 *
+	 * @param a             vertices of first hull
+	 * @param b             vertices of second hull
+	 * @param bToA          from second hull space to first hull space
+	 * @param intersection  intersection in first hull space, normal pushing
+	 *                      first hull out of second, point on second hull,
+	 *                      written only if intersecting
+	 *
+	 * @return              result of collision
+	 */
+	static Result collide(const Vec3Array & a, const Vec3Array & b,
+			const Transform & bToA, Intersection & intersection);
+};
+
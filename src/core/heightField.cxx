@@ -0,0 +1,71 @@
+#include "heightField.h"
+
+#include "triangle.h"
+
+const double HeightField::padding = 1e-6;
+
+/**
+ * empty height field, queries report nothing
+ */
+HeightField::HeightField() :
+		m_bounds(BoundingBox::empty()), m_gridSize(1) {
+}
+
+/**
+ * constructor, triangles 2i and 2i + 1 are cell i, cells are in rows of
+ * increasing y, columns of increasing x
+ *
+ * @param bounds     bounds of triangles
+ * @param gridSize   size of cell in x and y
+ * @param triangles  triangles, two per cell
+ */
+HeightField::HeightField(const BoundingBox & bounds, double gridSize,
+		const std::vector<Triangle> & triangles) :
+		m_bounds(bounds), m_gridSize(gridSize) {
+	if (gridSize <= 0 || triangles.empty()) {
+		return;
+	}
+	const auto & bmin = bounds.getMin();
+	const auto & bmax = bounds.getMax();
+	int nCols = static_cast<int>((bmax.getX() - bmin.getX()) / gridSize + .5);
+	int nRows = static_cast<int>((bmax.getY() - bmin.getY()) / gridSize + .5);
+	if (nCols <= 0 || nRows <= 0) {
+		return;
+	}
+
+	// cells, missing triangles leave empty bounds never visited
+	Level cells;
+	cells.nCols = nCols;
+	cells.nRows = nRows;
+	size_t nCells = static_cast<size_t>(nCols) * static_cast<size_t>(nRows);
+	cells.bounds.assign(nCells, BoundingBox::empty());
+	for (size_t i = 0, n = std::min(nCells, triangles.size() / 2); i < n;
+			++i) {
+		cells.bounds[i] += triangles[2 * i].getBounds();
+		cells.bounds[i] += triangles[2 * i + 1].getBounds();
+	}
+	m_levels.emplace_back(std::move(cells));
+
+	// merge 2x2 tiles until single tile
+	while (m_levels.back().nCols > 1 || m_levels.back().nRows > 1) {
+		const auto & below = m_levels.back();
+		Level level;
+		level.nCols = (below.nCols + 1) / 2;
+		level.nRows = (below.nRows + 1) / 2;
+		level.bounds.assign(static_cast<size_t>(level.nCols)
+				* static_cast<size_t>(level.nRows), BoundingBox::empty());
+		for (int r = 0; r < below.nRows; ++r) {
+			for (int c = 0; c < below.nCols; ++c) {
+				level.bounds[(r / 2) * level.nCols + c / 2] +=
+						below.bounds[r * below.nCols + c];
+			}
+		}
+		m_levels.emplace_back(std::move(level));
+	}
+}
+
+/**
+ * destructor
+ */
+HeightField::~HeightField() {
+}
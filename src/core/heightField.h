@@ -0,0 +1,204 @@
+#pragma once
+
+#include "boundingBox.h"
+#include "mat3.h"
+#include "transform.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+class Triangle;
+
+/*
+ * Regular grid of cells over x and y, each cell holding two triangles, with
+ * bounds of cells, and so their min and max heights, merged 2x2 into
+ * successively coarser tiles. Queries descend from the coarsest tile,
+ * rejecting tiles that miss the query, and report cells without allocating
+ */
+class HeightField {
+public:
+
+	/**
+	 * empty height field, queries report nothing
+	 */
+	HeightField();
+
+	/**
+	 * constructor, triangles 2i and 2i + 1 are cell i, cells are in rows of
+	 * increasing y, columns of increasing x
+	 *
+	 * @param bounds     bounds of triangles
+	 * @param gridSize   size of cell in x and y
+	 * @param triangles  triangles, two per cell
+	 */
+	HeightField(const BoundingBox & bounds, double gridSize,
+			const std::vector<Triangle> & triangles);
+
+	/**
+	 * destructor
+	 */
+	~HeightField();
+
+	/**
+	 * call function with index of each cell overlapping box in x and y, and
+	 * whose heights overlap box in z
+	 *
+	 * @param box  box in field space
+	 * @param fn   function taking cell index
+	 */
+	template<typename FUNC>
+	void intersect(const BoundingBox & box, FUNC & fn) const {
+		double zmin = box.getMin().getZ();
+		double zmax = box.getMax().getZ();
+		auto test = [&](const BoundingBox & bounds) {
+			return bounds.getMin().getZ() <= zmax
+					&& bounds.getMax().getZ() >= zmin;
+		};
+		descend(box, test, fn);
+	}
+
+	/**
+	 * call function with index of each cell overlapping box in x and y of
+	 * field space, and whose bounds, when moved to box space, overlap box
+	 *
+	 * @param box         box in its own space
+	 * @param boxToField  from box space to field space
+	 * @param fn          function taking cell index
+	 */
+	template<typename FUNC>
+	void intersect(const BoundingBox & box, const Transform & boxToField,
+			FUNC & fn) const {
+		auto fieldToBox = boxToField.inverse();
+		auto r = fieldToBox.getRotationMatrix();
+		const auto & t = fieldToBox.getTranslation();
+		double m[3][3];
+		for (unsigned i = 0; i < 3; ++i) {
+			for (unsigned j = 0; j < 3; ++j) {
+				m[i][j] = r.get(i, j);
+			}
+		}
+		double translation[3] = { t.getX(), t.getY(), t.getZ() };
+		const auto & boxMin = box.getMin();
+		const auto & boxMax = box.getMax();
+		double lo[3] = { boxMin.getX(), boxMin.getY(), boxMin.getZ() };
+		double hi[3] = { boxMax.getX(), boxMax.getY(), boxMax.getZ() };
+
+		// centre and extent of tile in box space
+		auto test = [&](const BoundingBox & bounds) {
+			const auto & bmin = bounds.getMin();
+			const auto & bmax = bounds.getMax();
+			double c[3] = { .5 * (bmin.getX() + bmax.getX()),
+					.5 * (bmin.getY() + bmax.getY()),
+					.5 * (bmin.getZ() + bmax.getZ()) };
+			double e[3] = { .5 * (bmax.getX() - bmin.getX()),
+					.5 * (bmax.getY() - bmin.getY()),
+					.5 * (bmax.getZ() - bmin.getZ()) };
+			for (unsigned i = 0; i < 3; ++i) {
+				double centre = translation[i];
+				double extent = padding;
+				for (unsigned j = 0; j < 3; ++j) {
+					centre += m[i][j] * c[j];
+					extent += std::abs(m[i][j]) * e[j];
+				}
+				if (centre - extent > hi[i] || centre + extent < lo[i]) {
+					return false;
+				}
+			}
+			return true;
+		};
+		descend(box.transformed(boxToField), test, fn);
+	}
+
+private:
+	/** 2x2 tiles per level, so levels never exceed bits of int */
+	static const size_t maxLevels = 32;
+	/** each level pops one tile and pushes at most four */
+	static const size_t stackSize = 3 * maxLevels + 1;
+	/** tile bounds padding, so touching cells aren't lost to rounding */
+	static const double padding;
+
+	/*
+	 * bounds of tiles, cells at level zero
+	 */
+	struct Level {
+		int nCols;
+		int nRows;
+		std::vector<BoundingBox> bounds;
+	};
+
+	struct Tile {
+		int level;
+		int col;
+		int row;
+	};
+
+	BoundingBox m_bounds;
+	double m_gridSize;
+	std::vector<Level> m_levels;
+
+	/*
+	 * descend from coarsest tile, through tiles in window of cells under
+	 * box in x and y passing test, to cells
+	 */
+	template<typename TEST, typename FUNC>
+	void descend(const BoundingBox & box, TEST & test, FUNC & fn) const {
+		if (m_levels.empty()) {
+			return;
+		}
+		const auto & bmin = m_bounds.getMin();
+		const auto & bmax = m_bounds.getMax();
+		const auto & boxMin = box.getMin();
+		const auto & boxMax = box.getMax();
+		if (bmin.getX() > boxMax.getX() || boxMin.getX() > bmax.getX()
+				|| bmin.getY() > boxMax.getY() || boxMin.getY() > bmax.getY()) {
+			return;
+		}
+
+		// window of cells
+		const auto & cells = m_levels.front();
+		int sCol = std::max(static_cast<int>(
+				(boxMin.getX() - bmin.getX()) / m_gridSize), 0);
+		int sRow = std::max(static_cast<int>(
+				(boxMin.getY() - bmin.getY()) / m_gridSize), 0);
+		int eCol = std::min(static_cast<int>(
+				(boxMax.getX() - bmin.getX()) / m_gridSize), cells.nCols - 1);
+		int eRow = std::min(static_cast<int>(
+				(boxMax.getY() - bmin.getY()) / m_gridSize), cells.nRows - 1);
+
+		std::array<Tile, stackSize> stack;
+		size_t top = 0;
+		stack[top++] = { static_cast<int>(m_levels.size() - 1), 0, 0 };
+		while (top != 0) {
+			auto tile = stack[--top];
+			const auto & level = m_levels[tile.level];
+			int index = tile.row * level.nCols + tile.col;
+			const auto & bounds = level.bounds[index];
+			if (bounds.isEmpty() || test(bounds) == false) {
+				continue;
+			}
+			if (tile.level == 0) {
+				fn(static_cast<size_t>(index));
+				continue;
+			}
+
+			// children overlapping window
+			const auto & below = m_levels[tile.level - 1];
+			int shift = tile.level - 1;
+			for (int r = 2 * tile.row, er = std::min(r + 2, below.nRows);
+					r < er; ++r) {
+				if (((r + 1) << shift) <= sRow || (r << shift) > eRow) {
+					continue;
+				}
+				for (int c = 2 * tile.col, ec = std::min(c + 2, below.nCols);
+						c < ec; ++c) {
+					if (((c + 1) << shift) <= sCol || (c << shift) > eCol) {
+						continue;
+					}
+					stack[top++] = { tile.level - 1, c, r };
+				}
+			}
+		}
+	}
+};
@@ -36,21 +36,6 @@ Mat3::Mat3(const Vec3 & c0, const Vec3 & c1, const Vec3 & c2) :
 				r2c2(static_cast<float>(c2.getZ())) {
 }
 
-/*
- *
- */
-Mat3::Mat3(const Mat3 & m) :
-				r0c0(m.r0c0),
-				r0c1(m.r0c1),
-				r0c2(m.r0c2),
-				r1c0(m.r1c0),
-				r1c1(m.r1c1),
-				r1c2(m.r1c2),
-				r2c0(m.r2c0),
-				r2c1(m.r2c1),
-				r2c2(m.r2c2) {
-}
-
 /*
  *
  */
@@ -71,12 +56,6 @@ Mat3::Mat3(const Quat & rotation) {
 	r2c2 = 1.f - 2.f * x * x - 2.f * y * y;
 }
 
-/**
- * destructor
- */
-Mat3::~Mat3() {
-}
-
 /**
  * get quaternion representation of matrix
  *
@@ -107,19 +86,6 @@ Quat Mat3::asQuat() const {
 			(r1c0 - r0c1) / (4.f * z));
 }
 
-/**
- * get element at given row and column
- *
- * @param row  row number
- * @param col  column number
- *
- * @return     element at row, column
- */
-float Mat3::get(unsigned row, unsigned col) const {
-	assert(row < 3 && col < 3);
-	return m_array[row * 3 + col];
-}
-
 /**
  * calculate inverse of matrix
  *
@@ -3,13 +3,15 @@
 #include "normal.h"
 #include "vec3.h"
 
-#include "../scripting/scriptObject.h"
-
-#include <memory>
+#include <cassert>
+#include <string>
 
 class Quat;
 
-class Mat3: public ScriptObject {
+/**
+ * plain 3x3 matrix value
+ */
+class Mat3 {
 public:
 
 	Mat3(float r0c0, float r0c1, float r0c2, float r1c0, float r1c1, float r1c2,
@@ -17,14 +19,16 @@ public:
 
 	Mat3(const Vec3 & c0, const Vec3 & c1, const Vec3 & c2);
 
-	Mat3(const Mat3 & m);
+	Mat3(const Mat3 &) = default;
 
 	Mat3(const Quat & rotation);
 
 	/**
 	 * destructor
 	 */
-	~Mat3();
+	~Mat3() = default;
+
+	Mat3 & operator=(const Mat3 &) = default;
 
 	/**
 	 * get quaternion representation of matrix
@@ -41,7 +45,10 @@ public:
 	 *
 	 * @return     element at row, column
 	 */
-	float get(unsigned row, unsigned col) const;
+	inline float get(unsigned row, unsigned col) const {
+		assert(row < 3 && col < 3);
+		return m_array[row * 3 + col];
+	}
 
 	/**
 	 * calculate inverse of matrix
@@ -1,15 +1,56 @@
 #include "mat4.h"
 #include "quat.h"
+#include "simd.h"
 
 #include "../scripting/executable.h"
 #include "../scripting/parameters.h"
 #include "../scripting/real.h"
 #include "../scripting/scriptExecutionException.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace {
 
+	/*
+	 * row major product r = m * n, r may be m or n
+	 */
+	void mulScalar(const float * m, const float * n, float * r) {
+		float p[16];
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				p[row * 4 + col] = m[row * 4] * n[col]
+						+ m[row * 4 + 1] * n[4 + col]
+						+ m[row * 4 + 2] * n[8 + col]
+						+ m[row * 4 + 3] * n[12 + col];
+			}
+		}
+		std::copy(p, p + 16, r);
+	}
+
+#ifdef SIMD_X86
+	/*
+	 * sse2, each row of product is row of m weighting rows of n. Rows of n
+	 * are loaded first and each row of m is read before its row of r is
+	 * written, so r may be m or n
+	 */
+	SIMD_TARGET_SSE2 void mulSse2(const float * m, const float * n,
+			float * r) {
+		__m128 n0 = _mm_loadu_ps(n);
+		__m128 n1 = _mm_loadu_ps(n + 4);
+		__m128 n2 = _mm_loadu_ps(n + 8);
+		__m128 n3 = _mm_loadu_ps(n + 12);
+		for (int i = 0; i < 16; i += 4) {
+			__m128 p = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[i]), n0),
+							_mm_mul_ps(_mm_set1_ps(m[i + 1]), n1)),
+					_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[i + 2]), n2),
+							_mm_mul_ps(_mm_set1_ps(m[i + 3]), n3)));
+			_mm_storeu_ps(r + i, p);
+		}
+	}
+#endif
+
 	/*
 	 *
 	 */
@@ -28,10 +69,11 @@ namespace {
 				}
 			}
 			stack.emplace(
-					std::make_shared<Mat4>(m[0][0], m[0][1], m[0][2], m[0][3],
-							m[1][0], m[1][1], m[1][2], m[1][3],
-							m[2][0], m[2][1], m[2][2], m[2][3],
-							m[3][0], m[3][1], m[3][2], m[3][3]));
+					std::make_shared<ScriptMat4>(
+							Mat4(m[0][0], m[0][1], m[0][2], m[0][3], m[1][0],
+									m[1][1], m[1][2], m[1][3], m[2][0],
+									m[2][1], m[2][2], m[2][3], m[3][0],
+									m[3][1], m[3][2], m[3][3])));
 		}
 	};
 }
@@ -226,61 +268,13 @@ Mat4 Mat4::inverse() const {
  * @param n right matrix
  */
 void Mat4::mul(const Mat4 & m, const Mat4 & n) {
-	float r0c0 = m.m_r0c0 * n.m_r0c0 + m.m_r0c1 * n.m_r1c0 + m.m_r0c2 * n.m_r2c0
-			+ m.m_r0c3 * n.m_r3c0;
-	float r0c1 = m.m_r0c0 * n.m_r0c1 + m.m_r0c1 * n.m_r1c1 + m.m_r0c2 * n.m_r2c1
-			+ m.m_r0c3 * n.m_r3c1;
-	float r0c2 = m.m_r0c0 * n.m_r0c2 + m.m_r0c1 * n.m_r1c2 + m.m_r0c2 * n.m_r2c2
-			+ m.m_r0c3 * n.m_r3c2;
-	float r0c3 = m.m_r0c0 * n.m_r0c3 + m.m_r0c1 * n.m_r1c3 + m.m_r0c2 * n.m_r2c3
-			+ m.m_r0c3 * n.m_r3c3;
-
-	float r1c0 = m.m_r1c0 * n.m_r0c0 + m.m_r1c1 * n.m_r1c0 + m.m_r1c2 * n.m_r2c0
-			+ m.m_r1c3 * n.m_r3c0;
-	float r1c1 = m.m_r1c0 * n.m_r0c1 + m.m_r1c1 * n.m_r1c1 + m.m_r1c2 * n.m_r2c1
-			+ m.m_r1c3 * n.m_r3c1;
-	float r1c2 = m.m_r1c0 * n.m_r0c2 + m.m_r1c1 * n.m_r1c2 + m.m_r1c2 * n.m_r2c2
-			+ m.m_r1c3 * n.m_r3c2;
-	float r1c3 = m.m_r1c0 * n.m_r0c3 + m.m_r1c1 * n.m_r1c3 + m.m_r1c2 * n.m_r2c3
-			+ m.m_r1c3 * n.m_r3c3;
-
-	float r2c0 = m.m_r2c0 * n.m_r0c0 + m.m_r2c1 * n.m_r1c0 + m.m_r2c2 * n.m_r2c0
-			+ m.m_r2c3 * n.m_r3c0;
-	float r2c1 = m.m_r2c0 * n.m_r0c1 + m.m_r2c1 * n.m_r1c1 + m.m_r2c2 * n.m_r2c1
-			+ m.m_r2c3 * n.m_r3c1;
-	float r2c2 = m.m_r2c0 * n.m_r0c2 + m.m_r2c1 * n.m_r1c2 + m.m_r2c2 * n.m_r2c2
-			+ m.m_r2c3 * n.m_r3c2;
-	float r2c3 = m.m_r2c0 * n.m_r0c3 + m.m_r2c1 * n.m_r1c3 + m.m_r2c2 * n.m_r2c3
-			+ m.m_r2c3 * n.m_r3c3;
-
-	float r3c0 = m.m_r3c0 * n.m_r0c0 + m.m_r3c1 * n.m_r1c0 + m.m_r3c2 * n.m_r2c0
-			+ m.m_r3c3 * n.m_r3c0;
-	float r3c1 = m.m_r3c0 * n.m_r0c1 + m.m_r3c1 * n.m_r1c1 + m.m_r3c2 * n.m_r2c1
-			+ m.m_r3c3 * n.m_r3c1;
-	float r3c2 = m.m_r3c0 * n.m_r0c2 + m.m_r3c1 * n.m_r1c2 + m.m_r3c2 * n.m_r2c2
-			+ m.m_r3c3 * n.m_r3c2;
-	float r3c3 = m.m_r3c0 * n.m_r0c3 + m.m_r3c1 * n.m_r1c3 + m.m_r3c2 * n.m_r2c3
-			+ m.m_r3c3 * n.m_r3c3;
-
-	m_r0c0 = r0c0;
-	m_r0c1 = r0c1;
-	m_r0c2 = r0c2;
-	m_r0c3 = r0c3;
-
-	m_r1c0 = r1c0;
-	m_r1c1 = r1c1;
-	m_r1c2 = r1c2;
-	m_r1c3 = r1c3;
-
-	m_r2c0 = r2c0;
-	m_r2c1 = r2c1;
-	m_r2c2 = r2c2;
-	m_r2c3 = r2c3;
-
-	m_r3c0 = r3c0;
-	m_r3c1 = r3c1;
-	m_r3c2 = r3c2;
-	m_r3c3 = r3c3;
+#ifdef SIMD_X86
+	if (Simd::getLevel() != Simd::Level::SCALAR) {
+		mulSse2(m.m_array, n.m_array, m_array);
+		return;
+	}
+#endif
+	mulScalar(m.m_array, n.m_array, m_array);
 }
 
 /**
@@ -299,7 +293,7 @@ void Mat4::mul(const Mat4 & m) {
  *
  * @return string version of matrix
  */
-OVERRIDE std::string Mat4::toString() const {
+std::string Mat4::toString() const {
 	return "Mat4([" + std::to_string(m_r0c0) + ", "
 			+ std::to_string(m_r0c1) + ", "
 			+ std::to_string(m_r0c2) + ", "
@@ -344,7 +338,7 @@ void Mat4::transform(Vec3 & v) const {
  *
  * @return  Mat4 factory
  */
-STATIC const ScriptObjectPtr & Mat4::getFactory() {
+STATIC const ScriptObjectPtr & ScriptMat4::getFactory() {
 	static auto factory = std::static_pointer_cast<ScriptObject>(
 			std::make_shared<Factory>());
 	return factory;
@@ -4,10 +4,14 @@
 #include "vec3.h"
 
 #include "../scripting/scriptObject.h"
+#include "../scripting/scriptType.h"
 
 #include <cassert>
 
-class Mat4 final: public ScriptObject {
+/**
+ * plain 4x4 matrix value, ScriptMat4 represents it in scripts
+ */
+class alignas(16) Mat4 final {
 public:
 	/**
 	 * constructor, fill all elements with zero
@@ -54,7 +58,7 @@ public:
 	/**
 	 * default destructor
 	 */
-	inline virtual ~Mat4() = default;
+	inline ~Mat4() = default;
 
 	/**
 	 * calculate determinant
@@ -121,7 +125,7 @@ public:
 	 *
 	 * @return string version of matrix
 	 */
-	std::string toString() const override;
+	std::string toString() const;
 
 	/**
 	 * transform vector by this matrix
@@ -132,13 +136,6 @@ public:
 	 */
 	void transform(Vec3 & v) const;
 
-	/**
-	 * get script object factory for Mat4
-	 *
-	 * @return  Mat4 factory
-	 */
-	static const ScriptObjectPtr & getFactory();
-
 	/**
 	 * get identity matrix
 	 *
@@ -156,3 +153,41 @@ private:
 		float m_array[16];
 	};
 };
+
+/**
+ * script object holding Mat4
+ */
+class ScriptMat4 final: public ScriptObject {
+public:
+
+	inline explicit ScriptMat4(const Mat4 & value) :
+			m_value(value) {
+	}
+
+	inline const Mat4 & getValue() const {
+		return m_value;
+	}
+
+	inline std::string toString() const override {
+		return m_value.toString();
+	}
+
+	/**
+	 * get script object factory for Mat4
+	 *
+	 * @return  Mat4 factory
+	 */
+	static const ScriptObjectPtr & getFactory();
+
+private:
+	Mat4 m_value;
+};
+
+template<>
+struct ScriptType<Mat4> {
+	typedef ScriptMat4 Object;
+
+	static inline const Mat4 & get(const ScriptObjectPtr & obj) {
+		return std::static_pointer_cast<ScriptMat4>(obj)->getValue();
+	}
+};
@@ -26,7 +26,7 @@ namespace {
 			auto y = static_cast<float>(getNumericArg(stack, 2));
 			auto z = static_cast<float>(getNumericArg(stack, 3));
 
-			stack.emplace(std::make_shared<Normal>(x, y, z));
+			stack.emplace(std::make_shared<ScriptNormal>(Normal(x, y, z)));
 		}
 	};
 
@@ -38,8 +38,8 @@ namespace {
 				std::stack<ScriptObjectPtr> & stack) const override {
 			checkNumArgs(nArgs, 0);
 
-			const auto & normal = std::static_pointer_cast<Normal>(self);
-			auto result = std::make_shared<Normal>(-(*normal));
+			const auto & normal = ScriptType<Normal>::get(self);
+			auto result = std::make_shared<ScriptNormal>(-normal);
 			stack.emplace(result);
 		}
 	};
@@ -52,16 +52,16 @@ namespace {
 				std::stack<ScriptObjectPtr> & stack) const override {
 			checkNumArgs(nArgs, 1);
 
-			const auto & normal = *std::static_pointer_cast<Normal>(self);
+			const auto & normal = ScriptType<Normal>::get(self);
 
 			auto e = stack.top();
 			stack.pop();
-			if (typeid(*e) == typeid(Vec3)) {
-				auto v = std::static_pointer_cast<Vec3>(e);
-				stack.emplace(std::make_shared<Real>(v->dot(normal)));
-			} else if (typeid(*e) == typeid(Normal)) {
-				auto n = std::static_pointer_cast<Normal>(e);
-				stack.emplace(std::make_shared<Real>(n->dot(normal)));
+			if (typeid(*e) == typeid(ScriptVec3)) {
+				const auto & v = ScriptType<Vec3>::get(e);
+				stack.emplace(std::make_shared<Real>(v.dot(normal)));
+			} else if (typeid(*e) == typeid(ScriptNormal)) {
+				const auto & n = ScriptType<Normal>::get(e);
+				stack.emplace(std::make_shared<Real>(n.dot(normal)));
 			} else {
 				scriptExecutionAssert(false,
 						"Require Vec3 or Normal for dot product");
@@ -106,18 +106,18 @@ Normal::Normal(float x, float y, float z) {
  *
  * @return           script object represented by name
  */
-OVERRIDE ScriptObjectPtr Normal::getMember(ScriptExecutionState & execState,
-		const std::string & name) const {
+OVERRIDE ScriptObjectPtr ScriptNormal::getMember(
+		ScriptExecutionState & execState, const std::string & name) const {
 	static std::unordered_map<std::string, ScriptObjectPtr> members = {
 			{ "__neg__", std::make_shared<Neg>() },
 			{ "dot", std::make_shared<Dot>() } };
 
 	if (name == "x") {
-		return std::make_shared<Real>(m_x);
+		return std::make_shared<Real>(m_value.getX());
 	} else if (name == "y") {
-		return std::make_shared<Real>(m_y);
+		return std::make_shared<Real>(m_value.getY());
 	} else if (name == "z") {
-		return std::make_shared<Real>(m_z);
+		return std::make_shared<Real>(m_value.getZ());
 	}
 	auto entry = members.find(name);
 	if (entry != members.end()) {
@@ -148,7 +148,7 @@ void Normal::set(float x, float y, float z) {
  *
  * @return  Normal factory
  */
-STATIC const ScriptObjectPtr & Normal::getFactory() {
+STATIC const ScriptObjectPtr & ScriptNormal::getFactory() {
 	static auto factory = std::static_pointer_cast<ScriptObject>(
 			std::make_shared<Factory>());
 	return factory;
@@ -1,11 +1,19 @@
 #pragma once
 
 #include "../scripting/scriptObject.h"
+#include "../scripting/scriptType.h"
 
-class Normal final: public ScriptObject {
+#include <string>
+
+/**
+ * plain unit vector value, ScriptNormal represents it in scripts
+ */
+class Normal final {
 public:
 	inline Normal(const Normal &) = default;
 
+	Normal & operator=(const Normal &) = default;
+
 	Normal(double x, double y, double z);
 
 	Normal(float x, float y, float z);
@@ -13,7 +21,7 @@ public:
 	/**
 	 * default destructor
 	 */
-	inline virtual ~Normal() = default;
+	inline ~Normal() = default;
 
 	inline Normal cross(const Normal & other) const {
 		float x = m_y * other.m_z - m_z * other.m_y;
@@ -26,17 +34,6 @@ public:
 		return m_x * other.m_x + m_y * other.m_y + m_z * other.m_z;
 	}
 
-	/**
-	 * get named script object member
-	 *
-	 * @param execState  current script execution state
-	 * @param name       name of member
-	 *
-	 * @return           script object represented by name
-	 */
-	ScriptObjectPtr getMember(ScriptExecutionState & execState,
-			const std::string & name) const override;
-
 	inline float getX() const {
 		return m_x;
 	}
@@ -63,11 +60,46 @@ public:
 
 	void set(float x, float y, float z);
 
-	inline std::string toString() const override {
+	inline std::string toString() const {
 		return "Normal(" + std::to_string(m_x) + ", " + std::to_string(m_y)
 				+ ", " + std::to_string(m_z) + ")";
 	}
 
+private:
+	float m_x;
+	float m_y;
+	float m_z;
+};
+
+/**
+ * script object holding Normal
+ */
+class ScriptNormal final: public ScriptObject {
+public:
+
+	inline explicit ScriptNormal(const Normal & value) :
+			m_value(value) {
+	}
+
+	inline const Normal & getValue() const {
+		return m_value;
+	}
+
+	/**
+	 * get named script object member
+	 *
+	 * @param execState  current script execution state
+	 * @param name       name of member
+	 *
+	 * @return           script object represented by name
+	 */
+	ScriptObjectPtr getMember(ScriptExecutionState & execState,
+			const std::string & name) const override;
+
+	inline std::string toString() const override {
+		return m_value.toString();
+	}
+
 	/**
 	 * get script object factory for Normal
 	 *
@@ -76,8 +108,15 @@ public:
 	static const ScriptObjectPtr & getFactory();
 
 private:
-	float m_x;
-	float m_y;
-	float m_z;
+	Normal m_value;
+};
+
+template<>
+struct ScriptType<Normal> {
+	typedef ScriptNormal Object;
+
+	static inline const Normal & get(const ScriptObjectPtr & obj) {
+		return std::static_pointer_cast<ScriptNormal>(obj)->getValue();
+	}
 };
 
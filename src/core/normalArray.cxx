@@ -48,7 +48,7 @@ namespace {
 					scriptExecutionAssertType<Normal>(e,
 							"Require list of normals");
 
-					normals.emplace_back(*std::static_pointer_cast<Normal>(e));
+					normals.emplace_back(ScriptType<Normal>::get(e));
 				}
 
 				stack.emplace(std::make_shared<NormalArray>(normals));
@@ -1,86 +1,211 @@
 #include "occlusionMap.h"
+#include "simd.h"
 
 #include "aspect.h"
+#include "boundingBox.h"
 #include "convexHull.h"
 #include "intersection.h"
-#include "normalArray.h"
 #include "transform.h"
+#include "triangleList.h"
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
+#include <vector>
 
 namespace {
-	struct MinMax {
-		std::vector<int> min;
-		std::vector<int> max;
-		int width;
-		int height;
-		int miny;
-		int maxy;
-
-		/**
-		 * Constructor
-		 *
-		 * @param height
-		 */
-		MinMax(int width, int height) :
-						width(width),
-						height(height),
-						miny(std::numeric_limits<int>::max()),
-						maxy(std::numeric_limits<int>::lowest()) {
-			min.reserve(height);
-			max.reserve(height);
-			for (int i = 0; i < height; ++i) {
-				min.emplace_back(std::numeric_limits<int>::max());
-				max.emplace_back(std::numeric_limits<int>::lowest());
-			}
-		}
+	/** pixels along each side of tile */
+	const int tileSize = 8;
+	/** pixels of tile */
+	const int tilePixels = tileSize * tileSize;
+	/** most edges a triangle is rasterized against, its own and outline */
+	const size_t maxEdges = 12;
+
+	/*
+	 * line in screen space, a * x + b * y + c being distance in pixels inside
+	 * of it
+	 */
+	struct Line {
+		double a;
+		double b;
+		double c;
+	};
 
-		/**
-		 * Write line to min max
-		 *
-		 * @param x0
-		 * @param y0
-		 * @param x1
-		 * @param y1
-		 */
-		void write(int x0, int y0, int x1, int y1) {
-			// clip against map edges
-			if ((x0 < 0 && x1 < 0) || (y0 < 0 && y1 < 0)
-					|| (x0 >= width && x1 >= width)
-					|| (y0 >= height && y1 >= height)) {
-				return;
-			}
+	/*
+	 * triangle in screen space, x, y and depth of each vertex, and for each
+	 * edge from a vertex to next, true if on outline of occluder
+	 */
+	struct ScreenTriangle {
+		float v[3][3];
+		bool outline[3];
+	};
 
-			miny = std::min(std::min(miny, y0), y1);
-			maxy = std::max(std::max(maxy, y0), y1);
+	/*
+	 * triangle relative to a tile, each edge distance and depth of pixel i, j
+	 * of tile being a * i + b * j + c. Edge distances are of centre of pixel
+	 * for edges of triangle, and of whole pixel for edges of outline, and
+	 * depth is farthest over pixel
+	 */
+	struct TileSetup {
+		size_t n;
+		float ea[maxEdges];
+		float eb[maxEdges];
+		float ec[maxEdges];
+		float za;
+		float zb;
+		float zc;
+	};
 
-			int dx = std::abs(x1 - x0);
-			int dy = std::abs(y1 - y0);
-			int sx = x0 < x1 ? 1 : -1;
-			int sy = y0 < y1 ? 1 : -1;
-			int err = dx - dy;
+	/*
+	 * write depth of pixels of tile inside all edges, where nearer, giving
+	 * nearest and farthest depth of tile after
+	 */
+	typedef void (*TileKernel)(const TileSetup & s, float * tile,
+			float & nearest, float & farthest);
 
-			while (true) {
-				if (y0 >= 0 && y0 < height) {
-					min[y0] = std::min(min[y0], x0);
-					max[y0] = std::max(max[y0], x0);
-				}
-				if (x0 == x1 && y0 == y1) {
-					break;
+	/*
+	 * scalar, one pixel at a time
+	 */
+	void rasterizeScalar(const TileSetup & s, float * tile, float & nearest,
+			float & farthest) {
+		nearest = std::numeric_limits<float>::infinity();
+		farthest = -std::numeric_limits<float>::infinity();
+		for (int j = 0; j < tileSize; ++j) {
+			float y = static_cast<float>(j);
+			for (int i = 0; i < tileSize; ++i) {
+				float x = static_cast<float>(i);
+				float & depth = tile[j * tileSize + i];
+				bool inside = true;
+				for (size_t k = 0; k < s.n; ++k) {
+					inside = inside && s.ea[k] * x + s.eb[k] * y + s.ec[k] >= 0;
 				}
-				int e2 = 2 * err;
-				if (e2 > -dy) {
-					err = err - dy;
-					x0 = x0 + sx;
+				if (inside) {
+					depth = std::min(depth, s.za * x + s.zb * y + s.zc);
 				}
-				if (e2 < dx) {
-					err = err + dx;
-					y0 = y0 + sy;
+				nearest = std::min(nearest, depth);
+				farthest = std::max(farthest, depth);
+			}
+		}
+	}
+
+#ifdef SIMD_X86
+	/*
+	 * sse2, four pixels of a row at a time
+	 */
+	SIMD_TARGET_SSE2 void rasterizeSse2(const TileSetup & s, float * tile,
+			float & nearest, float & farthest) {
+		__m128 zero = _mm_setzero_ps();
+		__m128 near = _mm_set1_ps(std::numeric_limits<float>::infinity());
+		__m128 far = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+		for (int half = 0; half < tileSize; half += 4) {
+			float h = static_cast<float>(half);
+			__m128 x = _mm_set_ps(h + 3, h + 2, h + 1, h);
+			__m128 ex[maxEdges];
+			for (size_t k = 0; k < s.n; ++k) {
+				ex[k] = _mm_mul_ps(_mm_set1_ps(s.ea[k]), x);
+			}
+			__m128 zx = _mm_mul_ps(_mm_set1_ps(s.za), x);
+			for (int j = 0; j < tileSize; ++j) {
+				float y = static_cast<float>(j);
+				float * row = tile + j * tileSize + half;
+				__m128 inside = _mm_cmpeq_ps(zero, zero);
+				for (size_t k = 0; k < s.n; ++k) {
+					__m128 e = _mm_add_ps(ex[k],
+							_mm_set1_ps(s.eb[k] * y + s.ec[k]));
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(e, zero));
 				}
+				__m128 z = _mm_add_ps(zx, _mm_set1_ps(s.zb * y + s.zc));
+				__m128 depth = _mm_loadu_ps(row);
+				depth = _mm_or_ps(_mm_and_ps(inside, _mm_min_ps(depth, z)),
+						_mm_andnot_ps(inside, depth));
+				_mm_storeu_ps(row, depth);
+				near = _mm_min_ps(near, depth);
+				far = _mm_max_ps(far, depth);
 			}
 		}
-	};
+		float nears[4];
+		float fars[4];
+		_mm_storeu_ps(nears, near);
+		_mm_storeu_ps(fars, far);
+		nearest = std::min(std::min(nears[0], nears[1]),
+				std::min(nears[2], nears[3]));
+		farthest = std::max(std::max(fars[0], fars[1]),
+				std::max(fars[2], fars[3]));
+	}
+
+	/*
+	 * avx2, a row of pixels at a time
+	 */
+	SIMD_TARGET_AVX2 void rasterizeAvx2(const TileSetup & s, float * tile,
+			float & nearest, float & farthest) {
+		__m256 zero = _mm256_setzero_ps();
+		__m256 near = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+		__m256 far = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+		__m256 x = _mm256_set_ps(7, 6, 5, 4, 3, 2, 1, 0);
+		__m256 ex[maxEdges];
+		for (size_t k = 0; k < s.n; ++k) {
+			ex[k] = _mm256_mul_ps(_mm256_set1_ps(s.ea[k]), x);
+		}
+		__m256 zx = _mm256_mul_ps(_mm256_set1_ps(s.za), x);
+		for (int j = 0; j < tileSize; ++j) {
+			float y = static_cast<float>(j);
+			float * row = tile + j * tileSize;
+			__m256 inside = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+			for (size_t k = 0; k < s.n; ++k) {
+				__m256 e = _mm256_add_ps(ex[k],
+						_mm256_set1_ps(s.eb[k] * y + s.ec[k]));
+				inside = _mm256_and_ps(inside,
+						_mm256_cmp_ps(e, zero, _CMP_GE_OQ));
+			}
+			__m256 z = _mm256_add_ps(zx, _mm256_set1_ps(s.zb * y + s.zc));
+			__m256 depth = _mm256_loadu_ps(row);
+			depth = _mm256_blendv_ps(depth, _mm256_min_ps(depth, z), inside);
+			_mm256_storeu_ps(row, depth);
+			near = _mm256_min_ps(near, depth);
+			far = _mm256_max_ps(far, depth);
+		}
+		float nears[tileSize];
+		float fars[tileSize];
+		_mm256_storeu_ps(nears, near);
+		_mm256_storeu_ps(fars, far);
+		nearest = *std::min_element(nears, nears + tileSize);
+		farthest = *std::max_element(fars, fars + tileSize);
+	}
+#endif
+
+	/*
+	 * tile kernel for best instruction set supported
+	 */
+	TileKernel tileKernel() {
+#ifdef SIMD_X86
+		switch (Simd::getLevel()) {
+		case Simd::Level::AVX2:
+			return rasterizeAvx2;
+		case Simd::Level::SSE2:
+			return rasterizeSse2;
+		case Simd::Level::SCALAR:
+			break;
+		}
+#endif
+		return rasterizeScalar;
+	}
+
+	/*
+	 * line through screen points p and q, inside to left of p to q if sign
+	 * is positive, right if negative
+	 */
+	Line lineThrough(const float * p, const float * q, double sign) {
+		Line line;
+		line.a = sign * (double(p[1]) - q[1]);
+		line.b = sign * (double(q[0]) - p[0]);
+		double length = std::sqrt(line.a * line.a + line.b * line.b);
+		if (length > 0) {
+			line.a /= length;
+			line.b /= length;
+		}
+		line.c = -line.a * p[0] - line.b * p[1];
+		return line;
+	}
 
 	Mat4 calcProjectionMatrix(const Aspect & aspect, float width,
 			float height) {
@@ -92,219 +217,262 @@ namespace {
 }
 
 struct OcclusionMap::impl {
-	std::vector<float> map;
+	Aspect aspect;
 	int width;
 	int height;
-	double minz;
-	Aspect aspect;
+	int tilesX;
+	int tilesY;
+	/** camera space to pixels, depth 0 at near plane and 1 at far */
 	Mat4 cameraToScreen;
+	/** w of perspective projection is distance, of orthographic constant */
+	bool perspective;
 	Plane nearPlane;
+	/** depth of pixels, tile after tile, empty until occluder written */
+	std::vector<float> depths;
+	std::vector<float> tileNearest;
+	std::vector<float> tileFarthest;
+	/** nearest depth written */
+	float nearest;
+	/** triangles and outline of occluder being written */
+	std::vector<ScreenTriangle> triangles;
+	std::vector<Line> outlines;
 
 	impl(const Aspect & aspect, int width, int height) :
-					map(width * height, 1),
+					aspect(aspect),
 					width(width),
 					height(height),
-					minz(1),
-					aspect(aspect),
+					tilesX((width + tileSize - 1) / tileSize),
+					tilesY((height + tileSize - 1) / tileSize),
 					cameraToScreen(
 							calcProjectionMatrix(aspect,
 									static_cast<float>(width),
 									static_cast<float>(height))),
-					nearPlane(aspect.getConvexHull().getPlanes()[0]) {
+					perspective(cameraToScreen.get(3, 3) == 0),
+					nearPlane(aspect.getConvexHull().getPlanes()[0]),
+					nearest(std::numeric_limits<float>::infinity()) {
 	}
 
 	/**
-	 * Clip edges to plane
+	 * Check edge of triangle facing camera lies on outline of occluder, all
+	 * of occluder being on the same side of it seen from camera
+	 *
+	 * @param a         start of edge in camera space
+	 * @param b         end of edge in camera space
+	 * @param inside    third vertex of triangle
+	 * @param vertices  vertices of occluder in camera space
 	 *
-	 * @param edges
-	 * @param vertices
-	 * @param faces
-	 * @param plane
+	 * @return          true if edge is on outline
 	 */
-	void clipEdges(std::vector<ConvexHull::Edge> & edges, Vec3Array & vertices,
-			NormalArray & faces, const Plane & plane) {
-		auto vsize = vertices.size();
-
-		size_t index = 0;
-		while (index < edges.size()) {
-			auto & edge = edges[index];
-
-			const auto & a = vertices.get(edge.getVertexIndex0());
-			const auto & b = vertices.get(edge.getVertexIndex1());
-
-			double da = plane.distanceTo(a);
-			double db = plane.distanceTo(b);
-
-			if (da <= 0) {
-				if (db > 0) {
-					// a inside, b outside
-					Vec3 c;
-					c.interpolate(a, b, da / (da - db));
-					edge.setVertexIndex1(vertices.size());
-					vertices.add(c);
-				}
-			} else if (db <= 0) {
-				// b inside, a outside
-				Vec3 c;
-				c.interpolate(b, a, db / (db - da));
-				edge.setVertexIndex0(vertices.size());
-				vertices.add(c);
-			} else {
-				// a outside, b outside
-				edges.erase(edges.begin() + index);
-				continue;
-			}
-			index += 1;
-		}
-
-		// test empty
-		if (edges.size() == 0) {
-			return;
-		}
-
-		// test unchanged
-		if (vsize == vertices.size()) {
-			return;
-		}
-
-		//
-		// build edges from clip points
-		//
-
-		// 2 new vertices, must have clipped a plane
-		if (vertices.size() - vsize == 2) {
-			edges.emplace_back(vsize, vsize + 1, edges[0].getFaceNormalIndex0(),
-					edges[0].getFaceNormalIndex1());
-			return;
+	bool isOutline(const Vec3 & a, const Vec3 & b, const Vec3 & inside,
+			const Vec3Array & vertices) const {
+		// plane holding edge and line of sight
+		Vec3 normal = perspective ? a.cross(b)
+				: (b - a).cross(Vec3(0., 0., 1.));
+		double length = normal.length();
+		if (length == 0) {
+			return true;
 		}
-
-		// add new face
-		auto newFaceIdx = faces.size();
-		faces.add(plane.getNormal());
-
-		for (size_t i = vsize; i < vertices.size() - 1; ++i) {
-			for (size_t j = i + 1; j < vertices.size(); ++j) {
-				auto f = getFaceIndex(i, j, edges);
-				if (f != std::numeric_limits<size_t>::max()) {
-					edges.emplace_back(i, j, f, newFaceIdx);
-				}
+		normal /= length;
+		double side = normal.dot(inside - a) < 0 ? -1 : 1;
+		for (const auto & v : vertices) {
+			if (side * normal.dot(v - a) < -1e-6) {
+				return false;
 			}
 		}
+		return true;
 	}
 
 	/**
-	 * Get element
+	 * Project point in camera space to pixels and depth
 	 *
-	 * @param x
-	 * @param y
-	 * @return
+	 * @param v  point in camera space
+	 * @param p  x, y and depth, written
 	 */
-	float get(int x, int y) {
-		return map[y * width + x];
+	void project(const Vec3 & v, float * p) const {
+		const auto & m = cameraToScreen;
+		double r[4];
+		for (unsigned i = 0; i < 4; ++i) {
+			r[i] = m.get(i, 0) * v.getX() + m.get(i, 1) * v.getY()
+					+ m.get(i, 2) * v.getZ() + m.get(i, 3);
+		}
+		p[0] = static_cast<float>(r[0] / r[3]);
+		p[1] = static_cast<float>(r[1] / r[3]);
+		p[2] = static_cast<float>(r[2] / r[3]);
 	}
 
 	/**
-	 * Given 2 vertex indices on open edge find the common face
+	 * Clip triangle facing camera to near plane, keeping what is left as
+	 * triangles in screen space, and edges on outline of occluder as lines
 	 *
-	 * @param   v0
-	 * @param   v1
-	 * @param   edges
-	 *
-	 * @return  common face index, or max size_t if no common face
+	 * @param v        vertices in camera space
+	 * @param outline  for each edge from a vertex to next, true if on outline
+	 *                 of occluder
 	 */
-	size_t getFaceIndex(size_t v0, size_t v1,
-			const std::vector<ConvexHull::Edge> & edges) {
-		size_t a0 = 0;
-		size_t a1 = 0;
-		size_t b0 = 0;
-		size_t b1 = 0;
-		bool foundFirst = false;
-		bool foundSecond = false;
-		for (const auto & edge : edges) {
-			if (edge.getVertexIndex0() == v0 || edge.getVertexIndex1() == v0) {
-				a0 = edge.getFaceNormalIndex0();
-				a1 = edge.getFaceNormalIndex1();
-				foundFirst = true;
+	void clip(const Vec3 * v, const bool * outline) {
+		// edges cut along near plane are on outline of what is left
+		float p[4][3];
+		bool edgeOutline[4];
+		size_t n = 0;
+		for (size_t k = 0; k < 3; ++k) {
+			const auto & a = v[k];
+			const auto & b = v[(k + 1) % 3];
+			double da = nearPlane.distanceTo(a);
+			double db = nearPlane.distanceTo(b);
+			if (da <= 0) {
+				project(a, p[n]);
+				edgeOutline[n++] = outline[k];
 			}
-			if (edge.getVertexIndex0() == v1 || edge.getVertexIndex1() == v1) {
-				b0 = edge.getFaceNormalIndex0();
-				b1 = edge.getFaceNormalIndex1();
-				foundSecond = true;
+			if ((da <= 0) != (db <= 0)) {
+				Vec3 c;
+				c.interpolate(a, b, da / (da - db));
+				project(c, p[n]);
+				edgeOutline[n++] = da <= 0 ? true : outline[k];
 			}
 		}
-		if (foundFirst == false || foundSecond == false) {
-			return std::numeric_limits<size_t>::max();
+		if (n < 3) {
+			return;
 		}
-		if (a0 == b0 || a0 == b1) {
-			if (a1 == b0 || a1 == b1) {
-				return std::numeric_limits<size_t>::max();
+
+		double area = 0;
+		for (size_t k = 0; k < n; ++k) {
+			const float * a = p[k];
+			const float * b = p[(k + 1) % n];
+			area += double(a[0]) * b[1] - double(b[0]) * a[1];
+		}
+		if (std::abs(area) < 1e-6) {
+			return;
+		}
+		for (size_t k = 0; k < n; ++k) {
+			if (edgeOutline[k]) {
+				outlines.push_back(lineThrough(p[k], p[(k + 1) % n],
+						area > 0 ? 1 : -1));
 			}
-			return a0;
 		}
-		if (a1 == b0 || a1 == b1) {
-			return a1;
+		for (size_t k = 1; k + 1 < n; ++k) {
+			ScreenTriangle triangle;
+			std::copy(p[0], p[0] + 3, triangle.v[0]);
+			std::copy(p[k], p[k] + 3, triangle.v[1]);
+			std::copy(p[k + 1], p[k + 1] + 3, triangle.v[2]);
+			triangle.outline[0] = k == 1 && edgeOutline[0];
+			triangle.outline[1] = edgeOutline[k];
+			triangle.outline[2] = k + 2 == n && edgeOutline[n - 1];
+			triangles.push_back(triangle);
 		}
-		return std::numeric_limits<size_t>::max();
 	}
 
 	/**
-	 * Test min max against occlusion map
+	 * Rasterize triangle tile by tile, skipping tiles it misses or lies
+	 * behind all of. Pixels are covered by their centre inside triangle,
+	 * and wholly inside outline of occluder, so triangles of occluder meet
+	 * without gaps while none of it spills out of the outline
 	 *
-	 * @param minMax
-	 * @param z
-	 * @return
+	 * @param triangle  triangle in screen space
 	 */
-	bool isOccluded(const MinMax & minMax, float z) {
-		int miny = std::max(0, minMax.miny);
-		int maxy = std::min(height, minMax.maxy + 1);
-		for (int y = miny; y < maxy; ++y) {
-			int minx = std::max(0, minMax.min[y]);
-			int maxx = std::min(width, minMax.max[y] + 1);
-			for (int x = minx; x < maxx; ++x) {
-				if (z < get(x, y)) {
-					return false;
+	void rasterize(const ScreenTriangle & triangle) {
+		const auto & v = triangle.v;
+		double area = (double(v[1][0]) - v[0][0]) * (double(v[2][1]) - v[0][1])
+				- (double(v[2][0]) - v[0][0]) * (double(v[1][1]) - v[0][1]);
+		if (std::abs(area) < 1e-6) {
+			return;
+		}
+		float minX = std::max(0.f, std::min(std::min(v[0][0], v[1][0]),
+				v[2][0]));
+		float maxX = std::min(static_cast<float>(width),
+				std::max(std::max(v[0][0], v[1][0]), v[2][0]));
+		float minY = std::max(0.f, std::min(std::min(v[0][1], v[1][1]),
+				v[2][1]));
+		float maxY = std::min(static_cast<float>(height),
+				std::max(std::max(v[0][1], v[1][1]), v[2][1]));
+		if (minX >= maxX || minY >= maxY) {
+			return;
+		}
+		int x0 = static_cast<int>(minX);
+		int x1 = static_cast<int>(std::ceil(maxX));
+		int y0 = static_cast<int>(minY);
+		int y1 = static_cast<int>(std::ceil(maxY));
+		float nearestZ = std::min(std::min(v[0][2], v[1][2]), v[2][2]);
+
+		// edges of triangle across occluder at pixel centres, and of outline
+		// near triangle, its own among them, at pixel corner farthest outside
+		Line edges[maxEdges];
+		size_t n = 0;
+		for (size_t k = 0; k < 3; ++k) {
+			if (!triangle.outline[k]) {
+				edges[n] = lineThrough(v[k], v[(k + 1) % 3],
+						area > 0 ? 1 : -1);
+				edges[n].c += (edges[n].a + edges[n].b) / 2;
+				++n;
+			}
+		}
+		for (const auto & line : outlines) {
+			double d = std::numeric_limits<double>::infinity();
+			for (const auto & p : v) {
+				d = std::min(d, line.a * p[0] + line.b * p[1] + line.c);
+			}
+			if (d < 1) {
+				if (n == maxEdges) {
+					// too many edges to test, leave it out
+					return;
 				}
+				edges[n] = line;
+				edges[n].c += (line.a + line.b) / 2
+						- (std::abs(line.a) + std::abs(line.b)) / 2;
+				++n;
 			}
 		}
-		return true;
-	}
-
-	/**
-	 * Write element
-	 *
-	 * @param x
-	 * @param y
-	 * @param z
-	 */
-	void put(int x, int y, float z) {
-		map[y * width + x] = std::min(map[y * width + x], z);
-	}
-
-	/**
-	 * Write min max to occlusion map
-	 *
-	 * @param minMax
-	 * @param z
-	 */
-	void write(const MinMax & minMax, float z) {
-		int miny = std::max(0, minMax.miny + 1);
-		int maxy = std::min(height, minMax.maxy);
-		for (int y = miny; y < maxy; ++y) {
-			int minx = std::max(0, minMax.min[y] + 1);
-			int maxx = std::min(width, minMax.max[y]);
-			for (int x = minx; x < maxx; ++x) {
-				put(x, y, z);
+		// depth as za * x + zb * y + zc, farthest over pixel
+		double dx1 = double(v[1][0]) - v[0][0];
+		double dy1 = double(v[1][1]) - v[0][1];
+		double dz1 = double(v[1][2]) - v[0][2];
+		double dx2 = double(v[2][0]) - v[0][0];
+		double dy2 = double(v[2][1]) - v[0][1];
+		double dz2 = double(v[2][2]) - v[0][2];
+		double za = (dz1 * dy2 - dz2 * dy1) / area;
+		double zb = (dx1 * dz2 - dx2 * dz1) / area;
+		double zc = v[0][2] - za * v[0][0] - zb * v[0][1] + (za + zb) / 2
+				+ (std::abs(za) + std::abs(zb)) / 2;
+
+		static auto kernel = tileKernel();
+		TileSetup s;
+		s.n = n;
+		for (int ty = y0 / tileSize; ty <= (y1 - 1) / tileSize; ++ty) {
+			for (int tx = x0 / tileSize; tx <= (x1 - 1) / tileSize; ++tx) {
+				size_t t = static_cast<size_t>(ty * tilesX + tx);
+				if (nearestZ >= tileFarthest[t]) {
+					continue;
+				}
+				double ox = tx * tileSize;
+				double oy = ty * tileSize;
+				bool missed = false;
+				for (size_t k = 0; k < n; ++k) {
+					const auto & edge = edges[k];
+					double e = edge.a * ox + edge.b * oy + edge.c;
+					missed = missed || e + (tileSize - 1) * (std::max(edge.a,
+							0.0) + std::max(edge.b, 0.0)) < 0;
+					s.ea[k] = static_cast<float>(edge.a);
+					s.eb[k] = static_cast<float>(edge.b);
+					s.ec[k] = static_cast<float>(e);
+				}
+				if (missed) {
+					continue;
+				}
+				s.za = static_cast<float>(za);
+				s.zb = static_cast<float>(zb);
+				s.zc = static_cast<float>(za * ox + zb * oy + zc);
+				kernel(s, &depths[t * tilePixels], tileNearest[t],
+						tileFarthest[t]);
 			}
 		}
+		nearest = std::min(nearest, nearestZ);
 	}
 };
 
 /**
  * Create new occlusion map
  *
- * @param aspect
- * @param width
- * @param height
+ * @param aspect  aspect of camera
+ * @param width   width in pixels
+ * @param height  height in pixels
  */
 OcclusionMap::OcclusionMap(const Aspect & aspect, int width, int height) :
 		pimpl(new impl(aspect, width, height)) {
@@ -317,99 +485,186 @@ OcclusionMap::~OcclusionMap() {
 }
 
 /**
- * Write occluder to occlusion map
+ * get depth of pixel, 0 at near and 1 at far plane of camera, infinite where
+ * no occluder is
  *
- * @param aspect
- * @param occluder
- * @param debugGeometry
+ * @param x  column of pixel, from left
+ * @param y  row of pixel, from bottom
+ *
+ * @return   depth of pixel
  */
-void OcclusionMap::write(const ConvexHull & occluder) {
-	// compare occluder to camera frustum
-	Intersection intxn;
-	if (occluder.collide(pimpl->aspect.getConvexHull(),
-			pimpl->aspect.getRotTrans(), intxn) == false) {
-		return;
+float OcclusionMap::getDepth(int x, int y) const {
+	if (pimpl->depths.empty()) {
+		return std::numeric_limits<float>::infinity();
 	}
+	int tile = (y / tileSize) * pimpl->tilesX + x / tileSize;
+	return pimpl->depths[static_cast<size_t>(tile * tilePixels
+			+ (y % tileSize) * tileSize + x % tileSize)];
+}
 
-	// vertices in camera space
-	auto worldToCamera = pimpl->aspect.getRotTrans().inverse();
-	auto vertices = occluder.getVertices().transformed(worldToCamera);
+/**
+ * get height
+ *
+ * @return  height in pixels
+ */
+int OcclusionMap::getHeight() const {
+	return pimpl->height;
+}
 
-	// face normals in camera space
-	auto w2cRotation = worldToCamera.getRotationMatrix();
-	NormalArray normals = occluder.getFaceNormals().transformed(w2cRotation);
-
-	// clip to near plane
-	std::vector<ConvexHull::Edge> clippedEdges = occluder.getEdges();
-	pimpl->clipEdges(clippedEdges, vertices, normals, pimpl->nearPlane);
-
-	// silhouette edges
-	double z = 0;
-	std::vector<ConvexHull::Edge> prunedEdges;
-	for (const auto & edge : clippedEdges) {
-		const auto & v = vertices.get(edge.getVertexIndex0());
-		double d0 = v.dot(normals.get(edge.getFaceNormalIndex0()));
-		double d1 = v.dot(normals.get(edge.getFaceNormalIndex1()));
-		if ((d0 < 0 && d1 > 0) || (d0 > 0 && d1 < 0)) {
-			// farthest z
-			z = std::max(z, -v.getZ());
-			z = std::max(z, -vertices.get(edge.getVertexIndex1()).getZ());
-			prunedEdges.emplace_back(edge);
-		}
-	}
-	z /= pimpl->aspect.getCamera()->getFar();
-	// keep track of minimum z
-	pimpl->minz = std::min(pimpl->minz, z);
-	// vertices to screen space
-	vertices.transformed(pimpl->cameraToScreen);
-	// screen space edges
-	MinMax minMax(pimpl->width, pimpl->height);
-	for (const auto & edge : prunedEdges) {
-		const auto & v0 = vertices.get(edge.getVertexIndex0());
-		const auto & v1 = vertices.get(edge.getVertexIndex1());
-		minMax.write(static_cast<int>(v0.getX()), static_cast<int>(v0.getY()),
-				static_cast<int>(v1.getX()), static_cast<int>(v1.getY()));
-	}
-	pimpl->write(minMax, static_cast<float>(z));
+/**
+ * get width
+ *
+ * @return  width in pixels
+ */
+int OcclusionMap::getWidth() const {
+	return pimpl->width;
 }
 
 /**
- * Test occluder against occlusion map
+ * Test box against occlusion map, by its screen space bounds and nearest
+ * depth, so allocates nothing
+ *
+ * @param toWorld  transform to take box from local to world space
+ * @param box      box to test
  *
- * @param aspect
- * @param toWorld
- * @param occluder
- * @return
+ * @return         true if box is hidden behind occluders
  */
 bool OcclusionMap::isOccluded(const Transform & toWorld,
-		const ConvexHull & occluder) const {
-	// vertices in camera space
+		const BoundingBox & box) const {
+	if (pimpl->depths.empty()) {
+		return false;
+	}
+
+	// corners in camera space, then screen space
 	auto toCamera = toWorld.to(pimpl->aspect.getRotTrans());
-	auto vertices = occluder.getVertices().transformed(toCamera);
-	// compare occluder to near clip plane
-	if (pimpl->nearPlane.isAbove(vertices) == false) {
+	const auto & min = box.getMin();
+	const auto & max = box.getMax();
+	float minX = std::numeric_limits<float>::infinity();
+	float maxX = -std::numeric_limits<float>::infinity();
+	float minY = std::numeric_limits<float>::infinity();
+	float maxY = -std::numeric_limits<float>::infinity();
+	float z = std::numeric_limits<float>::infinity();
+	for (int i = 0; i < 8; ++i) {
+		Vec3 corner((i & 1) != 0 ? max.getX() : min.getX(),
+				(i & 2) != 0 ? max.getY() : min.getY(),
+				(i & 4) != 0 ? max.getZ() : min.getZ());
+		toCamera.transformPoint(corner);
+		// compare box to near clip plane
+		if (pimpl->nearPlane.distanceTo(corner) > 0) {
+			return false;
+		}
+		float p[3];
+		pimpl->project(corner, p);
+		minX = std::min(minX, p[0]);
+		maxX = std::max(maxX, p[0]);
+		minY = std::min(minY, p[1]);
+		maxY = std::max(maxY, p[1]);
+		z = std::min(z, p[2]);
+	}
+	// check against nearest depth
+	if (z <= pimpl->nearest) {
+		return false;
+	}
+
+	// pixels box touches on screen, any off it being out of view
+	minX = std::max(0.f, minX);
+	maxX = std::min(static_cast<float>(pimpl->width), maxX);
+	minY = std::max(0.f, minY);
+	maxY = std::min(static_cast<float>(pimpl->height), maxY);
+	if (minX > maxX || minY > maxY) {
 		return false;
 	}
-	// nearest z
-	float far = pimpl->aspect.getCamera()->getFar();
-	double z = far;
+	int x0 = std::min(static_cast<int>(minX), pimpl->width - 1);
+	int x1 = std::max(x0 + 1, static_cast<int>(std::ceil(maxX)));
+	int y0 = std::min(static_cast<int>(minY), pimpl->height - 1);
+	int y1 = std::max(y0 + 1, static_cast<int>(std::ceil(maxY)));
+
+	for (int ty = y0 / tileSize; ty <= (y1 - 1) / tileSize; ++ty) {
+		for (int tx = x0 / tileSize; tx <= (x1 - 1) / tileSize; ++tx) {
+			size_t t = static_cast<size_t>(ty * pimpl->tilesX + tx);
+			if (z > pimpl->tileFarthest[t]) {
+				// tile wholly nearer than box
+				continue;
+			}
+			if (z <= pimpl->tileNearest[t]) {
+				return false;
+			}
+			const float * tile = &pimpl->depths[t * tilePixels];
+			int ox = tx * tileSize;
+			int oy = ty * tileSize;
+			for (int y = std::max(y0, oy), ye = std::min(y1, oy + tileSize);
+					y < ye; ++y) {
+				for (int x = std::max(x0, ox), xe = std::min(x1,
+						ox + tileSize); x < xe; ++x) {
+					if (tile[(y - oy) * tileSize + x - ox] >= z) {
+						return false;
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * Write occluder to occlusion map, as triangles of its faces facing camera
+ *
+ * @param occluder  occluder in world space
+ */
+void OcclusionMap::write(const ConvexHull & occluder) {
+	// compare occluder to camera frustum
+	Intersection intxn;
+	if (occluder.collide(pimpl->aspect.getConvexHull(),
+			pimpl->aspect.getRotTrans(), intxn) == false) {
+		return;
+	}
+
+	if (pimpl->depths.empty()) {
+		size_t tiles = static_cast<size_t>(pimpl->tilesX * pimpl->tilesY);
+		pimpl->depths.assign(tiles * tilePixels,
+				std::numeric_limits<float>::infinity());
+		pimpl->tileNearest.assign(tiles,
+				std::numeric_limits<float>::infinity());
+		pimpl->tileFarthest.assign(tiles,
+				std::numeric_limits<float>::infinity());
+	}
+
+	// vertices in camera space
+	auto worldToCamera = pimpl->aspect.getRotTrans().inverse();
+	auto vertices = occluder.getVertices().transformed(worldToCamera);
+	Vec3 centre;
 	for (const auto & v : vertices) {
-		z = std::min(-v.getZ(), z);
+		centre += v;
 	}
-	z /= far;
-	// check against minimum z
-	if (z < pimpl->minz) {
-		return false;
+	centre /= static_cast<double>(vertices.size());
+
+	pimpl->triangles.clear();
+	pimpl->outlines.clear();
+	for (const auto & triangle : occluder.getTriangleList()) {
+		Vec3 v[] = { triangle.getVertex0(), triangle.getVertex1(),
+				triangle.getVertex2() };
+		for (auto & p : v) {
+			worldToCamera.transformPoint(p);
+		}
+		// wind anticlockwise seen from outside, and skip faces facing away
+		auto normal = (v[1] - v[0]).cross(v[2] - v[0]);
+		if (normal.dot(v[0] - centre) < 0) {
+			std::swap(v[1], v[2]);
+			normal = -normal;
+		}
+		if ((pimpl->perspective ? normal.dot(v[0]) : -normal.getZ()) >= 0) {
+			continue;
+		}
+		bool outline[3];
+		for (size_t k = 0; k < 3; ++k) {
+			outline[k] = pimpl->isOutline(v[k], v[(k + 1) % 3],
+					v[(k + 2) % 3], vertices);
+		}
+		pimpl->clip(v, outline);
 	}
-	// vertices to screen space
-	vertices = vertices.transformed(pimpl->cameraToScreen);
-	MinMax minMax(pimpl->width, pimpl->height);
-	// screen space edges
-	for (const auto & edge : occluder.getEdges()) {
-		const auto & v0 = vertices.get(edge.getVertexIndex0());
-		const auto & v1 = vertices.get(edge.getVertexIndex1());
-		minMax.write(static_cast<int>(v0.getX()), static_cast<int>(v0.getY()),
-				static_cast<int>(v1.getX()), static_cast<int>(v1.getY()));
+
+	// all outline known before any pixel is written
+	for (const auto & triangle : pimpl->triangles) {
+		pimpl->rasterize(triangle);
 	}
-	return pimpl->isOccluded(minMax, static_cast<float>(z));
 }
@@ -3,18 +3,26 @@
 #include <memory>
 
 class Aspect;
+class BoundingBox;
 class ConvexHull;
 class Transform;
 
+/*
+ * Depth of occluders seen from a camera, rasterized in software in tiles of
+ * 8x8 pixels, with nearest and farthest depth of each tile so most of a query
+ * is answered tile by tile. Only pixels wholly inside occluders are written,
+ * so boxes are never found occluded by the edges of occluders. Needs no
+ * renderer, so can be run headless
+ */
 class OcclusionMap {
 public:
 
 	/**
 	 * Create new occlusion map
 	 *
-	 * @param aspect
-	 * @param width
-	 * @param height
+	 * @param aspect  aspect of camera
+	 * @param width   width in pixels
+	 * @param height  height in pixels
 	 */
 	OcclusionMap(const Aspect & aspect, int width, int height);
 
@@ -24,22 +32,46 @@ public:
 	~OcclusionMap();
 
 	/**
-	 * Test occluder against occlusion map
+	 * get depth of pixel, 0 at near and 1 at far plane of camera, infinite
+	 * where no occluder is
 	 *
-	 * @param aspect
-	 * @param toWorld
-	 * @param occluder
-	 * @return
+	 * @param x  column of pixel, from left
+	 * @param y  row of pixel, from bottom
+	 *
+	 * @return   depth of pixel
+	 */
+	float getDepth(int x, int y) const;
+
+	/**
+	 * get height
+	 *
+	 * @return  height in pixels
 	 */
-	bool isOccluded(const Transform & toWorld,
-			const ConvexHull & occluder) const;
+	int getHeight() const;
 
 	/**
-	 * Write occluder to occlusion map
+	 * get width
 	 *
-	 * @param aspect
-	 * @param occluder
-	 * @param debugGeometry
+	 * @return  width in pixels
+	 */
+	int getWidth() const;
+
+	/**
+	 * Test box against occlusion map, by its screen space bounds and nearest
+	 * depth, so allocates nothing
+	 *
+	 * @param toWorld  transform to take box from local to world space
+	 * @param box      box to test
+	 *
+	 * @return         true if box is hidden behind occluders
+	 */
+	bool isOccluded(const Transform & toWorld, const BoundingBox & box) const;
+
+	/**
+	 * Write occluder to occlusion map, as triangles of its faces facing
+	 * camera
+	 *
+	 * @param occluder  occluder in world space
 	 */
 	void write(const ConvexHull & occluder);
 
@@ -47,4 +79,3 @@ private:
 	struct impl;
 	std::unique_ptr<impl> pimpl;
 };
-
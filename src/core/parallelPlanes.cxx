@@ -2,11 +2,11 @@
 
 #include "boundingBox.h"
 #include "convexHull.h"
+#include "flatRTree.h"
 #include "indexArray.h"
 #include "intersection.h"
 #include "plane.h"
 #include "ray.h"
-#include "rtree.h"
 #include "transform.h"
 #include "triangle.h"
 #include "triangleList.h"
@@ -68,7 +68,7 @@ struct ParallelPlanes::impl {
 	IndexArray indices;
 	TriangleList triangles;
 	BoundingBox bounds;
-	RTree<4, Triangle> rtree;
+	FlatRTree<8, Triangle> rtree;
 	bool valid;
 
 	impl(const Vec3Array & vertices, const IndexArray & indices) :
@@ -204,9 +204,12 @@ bool ParallelPlanes::validate() {
 
 		triangles.emplace_back(a, b, c);
 	}
+	std::vector<BoundingBox> bounds;
+	bounds.reserve(triangles.size());
 	for (const auto & triangle : triangles) {
-		pimpl->rtree.insert(triangle.getBounds(), triangle);
+		bounds.emplace_back(triangle.getBounds());
 	}
+	pimpl->rtree = FlatRTree<8, Triangle>(bounds, triangles);
 	pimpl->triangles = TriangleList(triangles);
 
 	pimpl->bounds = pimpl->vertices.getBounds();
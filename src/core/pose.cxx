@@ -0,0 +1,497 @@
+#include "pose.h"
+
+#include "quat.h"
+#include "simd.h"
+#include "skeleton.h"
+#include "transform.h"
+#include "vec3.h"
+
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+	/*
+	 * rotations of bones, component by component
+	 */
+	struct Rotations {
+		float * x;
+		float * y;
+		float * z;
+		float * w;
+	};
+
+	struct ConstRotations {
+		const float * x;
+		const float * y;
+		const float * z;
+		const float * w;
+	};
+
+	/*
+	 * combine rotations r into q by weights t, for bones 'i' to n. Weights
+	 * are t[i * tStride], so a stride of 0 weights every bone alike
+	 */
+	typedef void (*RotationKernel)(const Rotations & q,
+			const ConstRotations & r, const float * t, size_t tStride,
+			size_t i, size_t n);
+
+	/*
+	 * scalar nlerp of q towards r, along shortest path
+	 */
+	void blendScalar(const Rotations & q, const ConstRotations & r,
+			const float * t, size_t tStride, size_t i, size_t n) {
+		for (; i < n; ++i) {
+			float b = t[i * tStride];
+			float a = 1 - b;
+			float dot = q.x[i] * r.x[i] + q.y[i] * r.y[i] + q.z[i] * r.z[i]
+					+ q.w[i] * r.w[i];
+			if (dot < 0) {
+				b = -b;
+			}
+			float x = a * q.x[i] + b * r.x[i];
+			float y = a * q.y[i] + b * r.y[i];
+			float z = a * q.z[i] + b * r.z[i];
+			float w = a * q.w[i] + b * r.w[i];
+			// length at least sqrt(a * a + b * b), as dot made positive
+			float s = 1 / std::sqrt(x * x + y * y + z * z + w * w);
+			q.x[i] = x * s;
+			q.y[i] = y * s;
+			q.z[i] = z * s;
+			q.w[i] = w * s;
+		}
+	}
+
+	/*
+	 * scalar, q rotated by r scaled by weight, r nlerped from identity
+	 */
+	void addScalar(const Rotations & q, const ConstRotations & r,
+			const float * t, size_t tStride, size_t i, size_t n) {
+		for (; i < n; ++i) {
+			float b = t[i * tStride];
+			float a = 1 - b;
+			if (r.w[i] < 0) {
+				b = -b;
+			}
+			float x = b * r.x[i];
+			float y = b * r.y[i];
+			float z = b * r.z[i];
+			float w = a + b * r.w[i];
+			float s = 1 / std::sqrt(x * x + y * y + z * z + w * w);
+			x *= s;
+			y *= s;
+			z *= s;
+			w *= s;
+
+			float qx = q.x[i];
+			float qy = q.y[i];
+			float qz = q.z[i];
+			float qw = q.w[i];
+			q.x[i] = qx * w + qy * z - qz * y + qw * x;
+			q.y[i] = -qx * z + qy * w + qz * x + qw * y;
+			q.z[i] = qx * y - qy * x + qz * w + qw * z;
+			q.w[i] = -qx * x - qy * y - qz * z + qw * w;
+		}
+	}
+
+#ifdef SIMD_X86
+	/*
+	 * sse2, four bones at a time
+	 */
+	SIMD_TARGET_SSE2 void blendSse2(const Rotations & q,
+			const ConstRotations & r, const float * t, size_t tStride,
+			size_t i, size_t n) {
+		__m128 one = _mm_set1_ps(1);
+		__m128 sign = _mm_set1_ps(-0.f);
+		for (; i + 4 <= n; i += 4) {
+			__m128 b = tStride != 0 ? _mm_loadu_ps(t + i) : _mm_set1_ps(*t);
+			__m128 a = _mm_sub_ps(one, b);
+			__m128 qx = _mm_loadu_ps(q.x + i);
+			__m128 qy = _mm_loadu_ps(q.y + i);
+			__m128 qz = _mm_loadu_ps(q.z + i);
+			__m128 qw = _mm_loadu_ps(q.w + i);
+			__m128 rx = _mm_loadu_ps(r.x + i);
+			__m128 ry = _mm_loadu_ps(r.y + i);
+			__m128 rz = _mm_loadu_ps(r.z + i);
+			__m128 rw = _mm_loadu_ps(r.w + i);
+			__m128 dot = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(qx, rx), _mm_mul_ps(qy, ry)),
+					_mm_add_ps(_mm_mul_ps(qz, rz), _mm_mul_ps(qw, rw)));
+			b = _mm_xor_ps(b, _mm_and_ps(dot, sign));
+			__m128 x = _mm_add_ps(_mm_mul_ps(a, qx), _mm_mul_ps(b, rx));
+			__m128 y = _mm_add_ps(_mm_mul_ps(a, qy), _mm_mul_ps(b, ry));
+			__m128 z = _mm_add_ps(_mm_mul_ps(a, qz), _mm_mul_ps(b, rz));
+			__m128 w = _mm_add_ps(_mm_mul_ps(a, qw), _mm_mul_ps(b, rw));
+			__m128 s = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+					_mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)))));
+			_mm_storeu_ps(q.x + i, _mm_mul_ps(x, s));
+			_mm_storeu_ps(q.y + i, _mm_mul_ps(y, s));
+			_mm_storeu_ps(q.z + i, _mm_mul_ps(z, s));
+			_mm_storeu_ps(q.w + i, _mm_mul_ps(w, s));
+		}
+		blendScalar(q, r, t, tStride, i, n);
+	}
+
+	/*
+	 * sse2, four bones at a time
+	 */
+	SIMD_TARGET_SSE2 void addSse2(const Rotations & q,
+			const ConstRotations & r, const float * t, size_t tStride,
+			size_t i, size_t n) {
+		__m128 one = _mm_set1_ps(1);
+		__m128 sign = _mm_set1_ps(-0.f);
+		for (; i + 4 <= n; i += 4) {
+			__m128 b = tStride != 0 ? _mm_loadu_ps(t + i) : _mm_set1_ps(*t);
+			__m128 a = _mm_sub_ps(one, b);
+			__m128 rw = _mm_loadu_ps(r.w + i);
+			b = _mm_xor_ps(b, _mm_and_ps(rw, sign));
+			__m128 x = _mm_mul_ps(b, _mm_loadu_ps(r.x + i));
+			__m128 y = _mm_mul_ps(b, _mm_loadu_ps(r.y + i));
+			__m128 z = _mm_mul_ps(b, _mm_loadu_ps(r.z + i));
+			__m128 w = _mm_add_ps(a, _mm_mul_ps(b, rw));
+			__m128 s = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+					_mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)))));
+			x = _mm_mul_ps(x, s);
+			y = _mm_mul_ps(y, s);
+			z = _mm_mul_ps(z, s);
+			w = _mm_mul_ps(w, s);
+
+			__m128 qx = _mm_loadu_ps(q.x + i);
+			__m128 qy = _mm_loadu_ps(q.y + i);
+			__m128 qz = _mm_loadu_ps(q.z + i);
+			__m128 qw = _mm_loadu_ps(q.w + i);
+			_mm_storeu_ps(q.x + i, _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(qx, w), _mm_mul_ps(qy, z)),
+					_mm_sub_ps(_mm_mul_ps(qw, x), _mm_mul_ps(qz, y))));
+			_mm_storeu_ps(q.y + i, _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(qy, w), _mm_mul_ps(qz, x)),
+					_mm_sub_ps(_mm_mul_ps(qw, y), _mm_mul_ps(qx, z))));
+			_mm_storeu_ps(q.z + i, _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(qx, y), _mm_mul_ps(qz, w)),
+					_mm_sub_ps(_mm_mul_ps(qw, z), _mm_mul_ps(qy, x))));
+			_mm_storeu_ps(q.w + i, _mm_sub_ps(_mm_mul_ps(qw, w),
+					_mm_add_ps(_mm_add_ps(_mm_mul_ps(qx, x),
+							_mm_mul_ps(qy, y)), _mm_mul_ps(qz, z))));
+		}
+		addScalar(q, r, t, tStride, i, n);
+	}
+
+	/*
+	 * avx2, eight bones at a time
+	 */
+	SIMD_TARGET_AVX2 void blendAvx2(const Rotations & q,
+			const ConstRotations & r, const float * t, size_t tStride,
+			size_t i, size_t n) {
+		__m256 one = _mm256_set1_ps(1);
+		__m256 sign = _mm256_set1_ps(-0.f);
+		for (; i + 8 <= n; i += 8) {
+			__m256 b = tStride != 0 ?
+					_mm256_loadu_ps(t + i) : _mm256_set1_ps(*t);
+			__m256 a = _mm256_sub_ps(one, b);
+			__m256 qx = _mm256_loadu_ps(q.x + i);
+			__m256 qy = _mm256_loadu_ps(q.y + i);
+			__m256 qz = _mm256_loadu_ps(q.z + i);
+			__m256 qw = _mm256_loadu_ps(q.w + i);
+			__m256 rx = _mm256_loadu_ps(r.x + i);
+			__m256 ry = _mm256_loadu_ps(r.y + i);
+			__m256 rz = _mm256_loadu_ps(r.z + i);
+			__m256 rw = _mm256_loadu_ps(r.w + i);
+			__m256 dot = _mm256_add_ps(
+					_mm256_add_ps(_mm256_mul_ps(qx, rx), _mm256_mul_ps(qy, ry)),
+					_mm256_add_ps(_mm256_mul_ps(qz, rz),
+							_mm256_mul_ps(qw, rw)));
+			b = _mm256_xor_ps(b, _mm256_and_ps(dot, sign));
+			__m256 x = _mm256_add_ps(_mm256_mul_ps(a, qx),
+					_mm256_mul_ps(b, rx));
+			__m256 y = _mm256_add_ps(_mm256_mul_ps(a, qy),
+					_mm256_mul_ps(b, ry));
+			__m256 z = _mm256_add_ps(_mm256_mul_ps(a, qz),
+					_mm256_mul_ps(b, rz));
+			__m256 w = _mm256_add_ps(_mm256_mul_ps(a, qw),
+					_mm256_mul_ps(b, rw));
+			__m256 s = _mm256_div_ps(one, _mm256_sqrt_ps(_mm256_add_ps(
+					_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)),
+					_mm256_add_ps(_mm256_mul_ps(z, z), _mm256_mul_ps(w, w)))));
+			_mm256_storeu_ps(q.x + i, _mm256_mul_ps(x, s));
+			_mm256_storeu_ps(q.y + i, _mm256_mul_ps(y, s));
+			_mm256_storeu_ps(q.z + i, _mm256_mul_ps(z, s));
+			_mm256_storeu_ps(q.w + i, _mm256_mul_ps(w, s));
+		}
+		// clear upper lanes, or sse code after this pays for mixing states
+		_mm256_zeroupper();
+		blendScalar(q, r, t, tStride, i, n);
+	}
+
+	/*
+	 * avx2, eight bones at a time
+	 */
+	SIMD_TARGET_AVX2 void addAvx2(const Rotations & q,
+			const ConstRotations & r, const float * t, size_t tStride,
+			size_t i, size_t n) {
+		__m256 one = _mm256_set1_ps(1);
+		__m256 sign = _mm256_set1_ps(-0.f);
+		for (; i + 8 <= n; i += 8) {
+			__m256 b = tStride != 0 ?
+					_mm256_loadu_ps(t + i) : _mm256_set1_ps(*t);
+			__m256 a = _mm256_sub_ps(one, b);
+			__m256 rw = _mm256_loadu_ps(r.w + i);
+			b = _mm256_xor_ps(b, _mm256_and_ps(rw, sign));
+			__m256 x = _mm256_mul_ps(b, _mm256_loadu_ps(r.x + i));
+			__m256 y = _mm256_mul_ps(b, _mm256_loadu_ps(r.y + i));
+			__m256 z = _mm256_mul_ps(b, _mm256_loadu_ps(r.z + i));
+			__m256 w = _mm256_add_ps(a, _mm256_mul_ps(b, rw));
+			__m256 s = _mm256_div_ps(one, _mm256_sqrt_ps(_mm256_add_ps(
+					_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)),
+					_mm256_add_ps(_mm256_mul_ps(z, z), _mm256_mul_ps(w, w)))));
+			x = _mm256_mul_ps(x, s);
+			y = _mm256_mul_ps(y, s);
+			z = _mm256_mul_ps(z, s);
+			w = _mm256_mul_ps(w, s);
+
+			__m256 qx = _mm256_loadu_ps(q.x + i);
+			__m256 qy = _mm256_loadu_ps(q.y + i);
+			__m256 qz = _mm256_loadu_ps(q.z + i);
+			__m256 qw = _mm256_loadu_ps(q.w + i);
+			_mm256_storeu_ps(q.x + i, _mm256_add_ps(
+					_mm256_add_ps(_mm256_mul_ps(qx, w), _mm256_mul_ps(qy, z)),
+					_mm256_sub_ps(_mm256_mul_ps(qw, x), _mm256_mul_ps(qz, y))));
+			_mm256_storeu_ps(q.y + i, _mm256_add_ps(
+					_mm256_add_ps(_mm256_mul_ps(qy, w), _mm256_mul_ps(qz, x)),
+					_mm256_sub_ps(_mm256_mul_ps(qw, y), _mm256_mul_ps(qx, z))));
+			_mm256_storeu_ps(q.z + i, _mm256_add_ps(
+					_mm256_add_ps(_mm256_mul_ps(qx, y), _mm256_mul_ps(qz, w)),
+					_mm256_sub_ps(_mm256_mul_ps(qw, z), _mm256_mul_ps(qy, x))));
+			_mm256_storeu_ps(q.w + i, _mm256_sub_ps(_mm256_mul_ps(qw, w),
+					_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(qx, x),
+							_mm256_mul_ps(qy, y)), _mm256_mul_ps(qz, z))));
+		}
+		// clear upper lanes, or sse code after this pays for mixing states
+		_mm256_zeroupper();
+		addScalar(q, r, t, tStride, i, n);
+	}
+#endif
+
+	/*
+	 * blend kernel for best instruction set supported
+	 */
+	RotationKernel blendKernel() {
+#ifdef SIMD_X86
+		switch (Simd::getLevel()) {
+		case Simd::Level::AVX2:
+			return blendAvx2;
+		case Simd::Level::SSE2:
+			return blendSse2;
+		case Simd::Level::SCALAR:
+			break;
+		}
+#endif
+		return blendScalar;
+	}
+
+	/*
+	 * additive kernel for best instruction set supported
+	 */
+	RotationKernel addKernel() {
+#ifdef SIMD_X86
+		switch (Simd::getLevel()) {
+		case Simd::Level::AVX2:
+			return addAvx2;
+		case Simd::Level::SSE2:
+			return addSse2;
+		case Simd::Level::SCALAR:
+			break;
+		}
+#endif
+		return addScalar;
+	}
+}
+
+/**
+ * constructor, every bone untransformed
+ *
+ * @param skeleton  skeleton posed
+ */
+Pose::Pose(const std::shared_ptr<const Skeleton> & skeleton) :
+				skeleton(skeleton),
+				rx(skeleton->size(), 0),
+				ry(skeleton->size(), 0),
+				rz(skeleton->size(), 0),
+				rw(skeleton->size(), 1),
+				tx(skeleton->size(), 0),
+				ty(skeleton->size(), 0),
+				tz(skeleton->size(), 0) {
+}
+
+/**
+ * constructor, bones carried over from other pose by name, others
+ * untransformed
+ *
+ * @param skeleton  skeleton posed
+ * @param other     pose to carry bones over from
+ */
+Pose::Pose(const std::shared_ptr<const Skeleton> & skeleton,
+		const Pose & other) :
+				Pose(skeleton) {
+	for (size_t i = 0, n = size(); i < n; ++i) {
+		size_t j = other.skeleton->getIndex(skeleton->getName(i));
+		if (j != Skeleton::npos) {
+			rx[i] = other.rx[j];
+			ry[i] = other.ry[j];
+			rz[i] = other.rz[j];
+			rw[i] = other.rw[j];
+			tx[i] = other.tx[j];
+			ty[i] = other.ty[j];
+			tz[i] = other.tz[j];
+		}
+	}
+}
+
+/**
+ * get transform of bone
+ *
+ * @param bone  index of bone
+ *
+ * @return      transform of bone
+ */
+Transform Pose::get(size_t bone) const {
+	assert(bone < size());
+	return Transform(Vec3(tx[bone], ty[bone], tz[bone]),
+			Quat(rx[bone], ry[bone], rz[bone], rw[bone]));
+}
+
+/**
+ * add additive pose of same skeleton to every bone, rotations of additive
+ * pose applied after own, translations summed
+ *
+ * @param additive  pose to add
+ * @param t         weight of additive pose
+ */
+void Pose::add(const Pose & additive, float t) {
+	add(additive, &t, 0);
+}
+
+/**
+ * add additive pose of same skeleton bone by bone, rotations of additive
+ * pose applied after own, translations summed
+ *
+ * @param additive  pose to add
+ * @param weights   weight of additive pose for each bone
+ */
+void Pose::add(const Pose & additive, const float * weights) {
+	add(additive, weights, 1);
+}
+
+/**
+ * interpolate every bone towards other pose of same skeleton, rotations
+ * by nlerp along shortest path
+ *
+ * t = 0, 'this' unchanged
+ * t = 1, 'this' = other
+ *
+ * @param other  pose to interpolate towards
+ * @param t      interpolation factor
+ */
+void Pose::interpolate(const Pose & other, float t) {
+	interpolate(other, &t, 0);
+}
+
+/**
+ * interpolate towards other pose of same skeleton bone by bone, rotations
+ * by nlerp along shortest path
+ *
+ * @param other    pose to interpolate towards
+ * @param weights  interpolation factor for each bone
+ */
+void Pose::interpolate(const Pose & other, const float * weights) {
+	interpolate(other, weights, 1);
+}
+
+/**
+ * set transform of bone
+ *
+ * @param bone       index of bone
+ * @param transform  transform of bone
+ */
+void Pose::set(size_t bone, const Transform & transform) {
+	setRotation(bone, transform.getRotation());
+	setTranslation(bone, transform.getTranslation());
+}
+
+/**
+ * set rotation of bone
+ *
+ * @param bone      index of bone
+ * @param rotation  rotation of bone
+ */
+void Pose::setRotation(size_t bone, const Quat & rotation) {
+	assert(bone < size());
+	rx[bone] = rotation.getX();
+	ry[bone] = rotation.getY();
+	rz[bone] = rotation.getZ();
+	rw[bone] = rotation.getW();
+}
+
+/**
+ * set translation of bone
+ *
+ * @param bone         index of bone
+ * @param translation  translation of bone
+ */
+void Pose::setTranslation(size_t bone, const Vec3 & translation) {
+	assert(bone < size());
+	tx[bone] = translation.getX();
+	ty[bone] = translation.getY();
+	tz[bone] = translation.getZ();
+}
+
+/**
+ * add additive pose by weights t[i * tStride] for bone i
+ *
+ * @param additive  pose to add
+ * @param t         weights
+ * @param tStride   stride of weights, 0 to weight every bone alike
+ */
+PRIVATE void Pose::add(const Pose & additive, const float * t,
+		size_t tStride) {
+	assert(additive.skeleton == skeleton);
+
+	static auto kernel = addKernel();
+	kernel(Rotations { rx.data(), ry.data(), rz.data(), rw.data() },
+			ConstRotations { additive.rx.data(), additive.ry.data(),
+					additive.rz.data(), additive.rw.data() }, t, tStride, 0,
+			size());
+
+	for (size_t i = 0, n = size(); i < n; ++i) {
+		double w = t[i * tStride];
+		tx[i] += w * additive.tx[i];
+		ty[i] += w * additive.ty[i];
+		tz[i] += w * additive.tz[i];
+	}
+}
+
+/**
+ * interpolate towards other pose by factors t[i * tStride] for bone i
+ *
+ * @param other    pose to interpolate towards
+ * @param t        interpolation factors
+ * @param tStride  stride of factors, 0 to interpolate every bone alike
+ */
+PRIVATE void Pose::interpolate(const Pose & other, const float * t,
+		size_t tStride) {
+	assert(other.skeleton == skeleton);
+
+	static auto kernel = blendKernel();
+	kernel(Rotations { rx.data(), ry.data(), rz.data(), rw.data() },
+			ConstRotations { other.rx.data(), other.ry.data(),
+					other.rz.data(), other.rw.data() }, t, tStride, 0, size());
+
+	for (size_t i = 0, n = size(); i < n; ++i) {
+		double b = t[i * tStride];
+		double a = 1 - b;
+		tx[i] = a * tx[i] + b * other.tx[i];
+		ty[i] = a * ty[i] + b * other.ty[i];
+		tz[i] = a * tz[i] + b * other.tz[i];
+	}
+}
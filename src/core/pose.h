@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class Quat;
+class Skeleton;
+class Transform;
+class Vec3;
+
+/*
+ * Transform of each bone of a skeleton, held component by component in
+ * arrays indexed by bone, so whole poses are copied and blended in passes
+ * over contiguous memory
+ */
+class Pose final {
+public:
+	/**
+	 * constructor, every bone untransformed
+	 *
+	 * @param skeleton  skeleton posed
+	 */
+	explicit Pose(const std::shared_ptr<const Skeleton> & skeleton);
+
+	/**
+	 * constructor, bones carried over from other pose by name, others
+	 * untransformed
+	 *
+	 * @param skeleton  skeleton posed
+	 * @param other     pose to carry bones over from
+	 */
+	Pose(const std::shared_ptr<const Skeleton> & skeleton, const Pose & other);
+
+	/**
+	 * add additive pose of same skeleton to every bone, rotations of additive
+	 * pose applied after own, translations summed
+	 *
+	 * @param additive  pose to add
+	 * @param t         weight of additive pose
+	 */
+	void add(const Pose & additive, float t);
+
+	/**
+	 * add additive pose of same skeleton bone by bone, rotations of additive
+	 * pose applied after own, translations summed
+	 *
+	 * @param additive  pose to add
+	 * @param weights   weight of additive pose for each bone
+	 */
+	void add(const Pose & additive, const float * weights);
+
+	/**
+	 * get transform of bone
+	 *
+	 * @param bone  index of bone
+	 *
+	 * @return      transform of bone
+	 */
+	Transform get(size_t bone) const;
+
+	/**
+	 * get skeleton posed
+	 *
+	 * @return  skeleton
+	 */
+	inline const std::shared_ptr<const Skeleton> & getSkeleton() const {
+		return skeleton;
+	}
+
+	/**
+	 * interpolate every bone towards other pose of same skeleton, rotations
+	 * by nlerp along shortest path
+	 *
+	 * t = 0, 'this' unchanged
+	 * t = 1, 'this' = other
+	 *
+	 * @param other  pose to interpolate towards
+	 * @param t      interpolation factor
+	 */
+	void interpolate(const Pose & other, float t);
+
+	/**
+	 * interpolate towards other pose of same skeleton bone by bone, rotations
+	 * by nlerp along shortest path
+	 *
+	 * @param other    pose to interpolate towards
+	 * @param weights  interpolation factor for each bone
+	 */
+	void interpolate(const Pose & other, const float * weights);
+
+	/**
+	 * set transform of bone
+	 *
+	 * @param bone       index of bone
+	 * @param transform  transform of bone
+	 */
+	void set(size_t bone, const Transform & transform);
+
+	/**
+	 * set rotation of bone
+	 *
+	 * @param bone      index of bone
+	 * @param rotation  rotation of bone
+	 */
+	void setRotation(size_t bone, const Quat & rotation);
+
+	/**
+	 * set translation of bone
+	 *
+	 * @param bone         index of bone
+	 * @param translation  translation of bone
+	 */
+	void setTranslation(size_t bone, const Vec3 & translation);
+
+	/**
+	 * get number of bones
+	 *
+	 * @return  number of bones
+	 */
+	inline size_t size() const {
+		return rx.size();
+	}
+
+private:
+	std::shared_ptr<const Skeleton> skeleton;
+	/** rotations held in float, so kernels take as many bones as fit */
+	std::vector<float> rx;
+	std::vector<float> ry;
+	std::vector<float> rz;
+	std::vector<float> rw;
+	std::vector<double> tx;
+	std::vector<double> ty;
+	std::vector<double> tz;
+
+	/**
+	 * add additive pose by weights t[i * tStride] for bone i
+	 *
+	 * @param additive  pose to add
+	 * @param t         weights
+	 * @param tStride   stride of weights, 0 to weight every bone alike
+	 */
+	void add(const Pose & additive, const float * t, size_t tStride);
+
+	/**
+	 * interpolate towards other pose by factors t[i * tStride] for bone i
+	 *
+	 * @param other    pose to interpolate towards
+	 * @param t        interpolation factors
+	 * @param tStride  stride of factors, 0 to interpolate every bone alike
+	 */
+	void interpolate(const Pose & other, const float * t, size_t tStride);
+};
@@ -26,7 +26,7 @@ namespace {
 			auto y = getFloatArg(stack, 3);
 			auto z = getFloatArg(stack, 4);
 
-			stack.emplace(std::make_shared<Quat>(w, x, y, z));
+			stack.emplace(std::make_shared<ScriptQuat>(Quat(w, x, y, z)));
 		}
 	};
 
@@ -38,9 +38,9 @@ namespace {
 				std::stack<ScriptObjectPtr> & stack) const override {
 			checkNumArgs(nArgs, 0);
 
-			auto quat = std::static_pointer_cast<Quat>(self);
+			const auto & quat = ScriptType<Quat>::get(self);
 
-			stack.emplace(std::make_shared<Quat>(quat->conjugate()));
+			stack.emplace(std::make_shared<ScriptQuat>(quat.conjugate()));
 		}
 	};
 
@@ -52,21 +52,21 @@ namespace {
 				std::stack<ScriptObjectPtr> & stack) const override {
 			checkNumArgs(nArgs, 1);
 
-			auto quatPtr = std::static_pointer_cast<Quat>(self);
+			const auto & quat = ScriptType<Quat>::get(self);
 
 			auto arg = stack.top();
 			stack.pop();
 
-			if (typeid(*arg) == typeid(Quat)) {
-				auto other = *std::static_pointer_cast<Quat>(arg);
-				stack.emplace(std::make_shared<Quat>(*quatPtr * other));
+			if (typeid(*arg) == typeid(ScriptQuat)) {
+				const auto & other = ScriptType<Quat>::get(arg);
+				stack.emplace(std::make_shared<ScriptQuat>(quat * other));
 				return;
-			} else if (typeid(*arg) == typeid(Vec3)) {
-				auto v = quatPtr->rotate(*std::static_pointer_cast<Vec3>(arg));
-				stack.emplace(std::make_shared<Vec3>(v));
-			} else if (typeid(*arg) == typeid(Normal)) {
-				Normal n = quatPtr->rotate(*std::static_pointer_cast<Normal>(arg));
-				stack.emplace(std::make_shared<Normal>(n));
+			} else if (typeid(*arg) == typeid(ScriptVec3)) {
+				auto v = quat.rotate(ScriptType<Vec3>::get(arg));
+				stack.emplace(std::make_shared<ScriptVec3>(v));
+			} else if (typeid(*arg) == typeid(ScriptNormal)) {
+				Normal n = quat.rotate(ScriptType<Normal>::get(arg));
+				stack.emplace(std::make_shared<ScriptNormal>(n));
 			} else {
 				scriptExecutionAssert(false,
 						"Require quat, vec3 or normal argument");
@@ -113,7 +113,7 @@ Quat::Quat(const Normal & axis, float angle) {
  *
  * @return           script object represented by name
  */
-OVERRIDE ScriptObjectPtr Quat::getMember(ScriptExecutionState & execState,
+OVERRIDE ScriptObjectPtr ScriptQuat::getMember(ScriptExecutionState & execState,
 		const std::string & name) const {
 	static std::unordered_map<std::string, ScriptObjectPtr> members = {
 			{"getConjugate", std::make_shared<GetConjugate>() },
@@ -338,7 +338,7 @@ void Quat::set(float x, float y, float z, float w) {
  *
  * @return  Quat factory
  */
-STATIC const ScriptObjectPtr & Quat::getFactory() {
+STATIC const ScriptObjectPtr & ScriptQuat::getFactory() {
 	static auto factory = std::static_pointer_cast<ScriptObject>(
 			std::make_shared<Factory>());
 	return factory;
@@ -4,8 +4,12 @@
 #include "vec3.h"
 
 #include "../scripting/scriptObject.h"
+#include "../scripting/scriptType.h"
 
-class Quat final: public ScriptObject {
+/**
+ * plain quaternion value, ScriptQuat represents it in scripts
+ */
+class Quat final {
 public:
 
 	/**
@@ -27,7 +31,7 @@ public:
 	/**
 	 * default destructor
 	 */
-	inline virtual ~Quat() = default;
+	inline ~Quat() = default;
 
 	inline Quat() :
 			m_x(0), m_y(0), m_z(0), m_w(0) {
@@ -41,17 +45,6 @@ public:
 		return Quat(-m_x, -m_y, -m_z, m_w);
 	}
 
-	/**
-	 * get named script object member
-	 *
-	 * @param execState  current script execution state
-	 * @param name       name of member
-	 *
-	 * @return           script object represented by name
-	 */
-	ScriptObjectPtr getMember(ScriptExecutionState & execState,
-			const std::string & name) const override;
-
 	inline float getW() const {
 		return m_w;
 	}
@@ -142,11 +135,47 @@ public:
 	 */
 	void set(float x, float y, float z, float w);
 
-	inline std::string toString() const override {
+	inline std::string toString() const {
 		return "Quat( " + std::to_string(m_x) + ", " + std::to_string(m_y)
 				+ ", " + std::to_string(m_z) + ", " + std::to_string(m_w) + " )";
 	}
 
+private:
+	float m_x;
+	float m_y;
+	float m_z;
+	float m_w;
+};
+
+/**
+ * script object holding Quat
+ */
+class ScriptQuat final: public ScriptObject {
+public:
+
+	inline explicit ScriptQuat(const Quat & value) :
+			m_value(value) {
+	}
+
+	inline const Quat & getValue() const {
+		return m_value;
+	}
+
+	/**
+	 * get named script object member
+	 *
+	 * @param execState  current script execution state
+	 * @param name       name of member
+	 *
+	 * @return           script object represented by name
+	 */
+	ScriptObjectPtr getMember(ScriptExecutionState & execState,
+			const std::string & name) const override;
+
+	inline std::string toString() const override {
+		return m_value.toString();
+	}
+
 	/**
 	 * get script object factory for Quat
 	 *
@@ -155,8 +184,14 @@ public:
 	static const ScriptObjectPtr & getFactory();
 
 private:
-	float m_x;
-	float m_y;
-	float m_z;
-	float m_w;
+	Quat m_value;
+};
+
+template<>
+struct ScriptType<Quat> {
+	typedef ScriptQuat Object;
+
+	static inline const Quat & get(const ScriptObjectPtr & obj) {
+		return std::static_pointer_cast<ScriptQuat>(obj)->getValue();
+	}
 };
@@ -0,0 +1,631 @@
+#include "quickhull.h"
+
+#include "boundingBox.h"
+#include "convexHull.h"
+#include "indexArray.h"
+#include "normal.h"
+#include "normalArray.h"
+#include "vec3.h"
+#include "vec3Array.h"
+
+#include "../scripting/executable.h"
+#include "../scripting/parameters.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+	/** no face or vertex */
+	const size_t none = std::numeric_limits<size_t>::max();
+	/** normals closer than this, as one less cosine, are the same direction */
+	const double directionTolerance = 1e-6;
+
+	/*
+	 * triangle of hull being built, anticlockwise seen from outside.
+	 * Neighbour i shares edge from vertex i to vertex i + 1
+	 */
+	struct Face {
+		size_t vertex[3];
+		size_t neighbour[3];
+		/** unit normal, zero if triangle has no area */
+		Vec3 normal;
+		double offset;
+		/** points above face, not yet in hull */
+		std::vector<size_t> outside;
+		bool alive;
+	};
+
+	/*
+	 * edge of horizon, from visible face to face not visible
+	 */
+	struct HorizonEdge {
+		size_t start;
+		size_t end;
+		size_t face;
+	};
+
+	/*
+	 * coordinate of vector along axis
+	 */
+	double coordinate(const Vec3 & v, int axis) {
+		return axis == 0 ? v.getX() : (axis == 1 ? v.getY() : v.getZ());
+	}
+
+	/*
+	 * has face no area, so no normal
+	 */
+	bool sliver(const Face & face) {
+		return face.normal.dot(face.normal) == 0;
+	}
+
+	/*
+	 * are directions parallel, or opposed
+	 */
+	bool sameDirection(const Vec3 & a, const Vec3 & b) {
+		return std::abs(a.dot(b)) > 1 - directionTolerance;
+	}
+
+	/*
+	 * quickhull over triangles, coplanar triangles merged when hull is made
+	 */
+	class Builder {
+	public:
+		explicit Builder(const Vec3Array & array) :
+						points(array.size() == 0 ? nullptr : &*array.begin()),
+						nPoints(array.size()),
+						epsilon(0),
+						stamp(0) {
+		}
+
+		/*
+		 * build hull, false if points span no volume
+		 */
+		bool build(size_t maxVertices) {
+			size_t simplex[4];
+			if (buildSimplex(simplex) == false) {
+				return false;
+			}
+
+			// every other point to face it is farthest above
+			std::vector<size_t> all = { 0, 1, 2, 3 };
+			for (size_t i = 0, n = nPoints; i < n; ++i) {
+				if (i != simplex[0] && i != simplex[1] && i != simplex[2]
+						&& i != simplex[3]) {
+					assign(i, all);
+				}
+			}
+			for (auto f : all) {
+				if (faces[f].outside.empty() == false) {
+					pending.emplace_back(f);
+				}
+			}
+
+			size_t nVertices = 4;
+			while (pending.empty() == false && nVertices < maxVertices) {
+				auto f = pending.back();
+				pending.pop_back();
+				if (faces[f].alive == false || faces[f].outside.empty()) {
+					continue;
+				}
+
+				// farthest outside point
+				auto & outside = faces[f].outside;
+				size_t farthest = 0;
+				double farthestDistance = -1;
+				for (size_t i = 0, n = outside.size(); i < n; ++i) {
+					double d = distance(faces[f], outside[i]);
+					if (d > farthestDistance) {
+						farthestDistance = d;
+						farthest = i;
+					}
+				}
+				auto eye = outside[farthest];
+
+				if (addPoint(f, eye)) {
+					++nVertices;
+				} else {
+					// horizon not a loop, within tolerance of hull
+					outside[farthest] = outside.back();
+					outside.pop_back();
+					if (outside.empty() == false) {
+						pending.emplace_back(f);
+					}
+				}
+			}
+			return true;
+		}
+
+		/*
+		 * convex hull of faces built
+		 */
+		ConvexHull makeHull() const {
+			// vertices used by faces, triangles
+			std::unordered_map<size_t, size_t> remap;
+			std::vector<Vec3> vertices;
+			std::vector<int16_t> indices;
+			BoundingBox bounds = BoundingBox::empty();
+			for (const auto & face : faces) {
+				if (face.alive == false) {
+					continue;
+				}
+				for (auto v : face.vertex) {
+					auto entry = remap.emplace(v, vertices.size());
+					if (entry.second) {
+						vertices.emplace_back(points[v]);
+						bounds += points[v];
+					}
+					indices.emplace_back(
+							static_cast<int16_t>(entry.first->second));
+				}
+			}
+
+			// coplanar triangles are one face, filled from any triangle,
+			// slivers join any neighbouring face
+			std::vector<size_t> group(faces.size(), none);
+			std::vector<Vec3> faceNormals;
+			std::vector<size_t> stack;
+			for (size_t f = 0, n = faces.size(); f < n; ++f) {
+				if (faces[f].alive == false || group[f] != none
+						|| sliver(faces[f])) {
+					continue;
+				}
+				const auto & seed = faces[f].normal;
+				Vec3 sum;
+				group[f] = faceNormals.size();
+				stack.assign(1, f);
+				while (stack.empty() == false) {
+					auto t = stack.back();
+					stack.pop_back();
+					sum = sum + faces[t].normal;
+					for (auto nb : faces[t].neighbour) {
+						if (group[nb] == none && (sliver(faces[nb])
+								|| faces[nb].normal.dot(seed)
+										> 1 - directionTolerance)) {
+							group[nb] = faceNormals.size();
+							stack.emplace_back(nb);
+						}
+					}
+				}
+				faceNormals.emplace_back(sum / sum.length());
+			}
+			for (bool changed = true; changed;) {
+				changed = false;
+				for (size_t f = 0, n = faces.size(); f < n; ++f) {
+					if (faces[f].alive == false || group[f] != none) {
+						continue;
+					}
+					for (auto nb : faces[f].neighbour) {
+						if (group[nb] != none) {
+							group[f] = group[nb];
+							changed = true;
+							break;
+						}
+					}
+				}
+			}
+
+			// plane of each face through outermost vertex
+			auto nFaces = faceNormals.size();
+			std::vector<int16_t> planeIndices(nFaces);
+			std::vector<double> planeOffsets(nFaces,
+					-std::numeric_limits<double>::infinity());
+			for (size_t f = 0, n = faces.size(); f < n; ++f) {
+				if (faces[f].alive == false) {
+					continue;
+				}
+				auto g = group[f];
+				for (auto v : faces[f].vertex) {
+					double d = faceNormals[g].dot(points[v]);
+					if (d > planeOffsets[g]) {
+						planeOffsets[g] = d;
+						planeIndices[g] = static_cast<int16_t>(remap[v]);
+					}
+				}
+			}
+
+			// edges between faces, each once
+			std::vector<int16_t> edgeIndices;
+			std::vector<Vec3> edgeDirections;
+			std::vector<int16_t> edgeDirectionIndices;
+			for (size_t f = 0, n = faces.size(); f < n; ++f) {
+				if (faces[f].alive == false) {
+					continue;
+				}
+				for (int i = 0; i < 3; ++i) {
+					auto nb = faces[f].neighbour[i];
+					if (nb < f || group[nb] == group[f]) {
+						continue;
+					}
+					auto v0 = faces[f].vertex[i];
+					auto v1 = faces[f].vertex[(i + 1) % 3];
+					auto direction = points[v1] - points[v0];
+					direction = direction / direction.length();
+					bool unique = true;
+					for (const auto & other : edgeDirections) {
+						if (sameDirection(direction, other)) {
+							unique = false;
+							break;
+						}
+					}
+					if (unique) {
+						edgeDirections.emplace_back(direction);
+						edgeDirectionIndices.emplace_back(
+								static_cast<int16_t>(edgeIndices.size() / 4));
+					}
+					size_t edge[4] = { remap.at(v0), remap.at(v1), group[f],
+							group[nb] };
+					for (auto index : edge) {
+						edgeIndices.emplace_back(static_cast<int16_t>(index));
+					}
+				}
+			}
+
+			// face directions, opposed faces share direction
+			std::vector<int16_t> faceDirectionIndices;
+			for (size_t g = 0; g < nFaces; ++g) {
+				bool unique = true;
+				for (auto other : faceDirectionIndices) {
+					if (sameDirection(faceNormals[g], faceNormals[other])) {
+						unique = false;
+						break;
+					}
+				}
+				if (unique) {
+					faceDirectionIndices.emplace_back(static_cast<int16_t>(g));
+				}
+			}
+
+			std::vector<Normal> normals;
+			normals.reserve(nFaces);
+			for (const auto & n : faceNormals) {
+				normals.emplace_back(n.getX(), n.getY(), n.getZ());
+			}
+
+			return ConvexHull(bounds, Vec3Array(vertices), IndexArray(indices),
+					NormalArray(normals), IndexArray(planeIndices),
+					IndexArray(edgeIndices), IndexArray(faceDirectionIndices),
+					IndexArray(edgeDirectionIndices));
+		}
+
+	private:
+		/** points, contiguous for speed */
+		const Vec3 * points;
+		size_t nPoints;
+		/** points closer to face than this are on it */
+		double epsilon;
+		std::vector<Face> faces;
+		/** faces that may have outside points */
+		std::vector<size_t> pending;
+		/** faces marked visible from current point */
+		std::vector<unsigned> visited;
+		unsigned stamp;
+
+		/*
+		 * add face, normal from winding, neighbours unset
+		 */
+		size_t addFace(size_t a, size_t b, size_t c) {
+			const auto & pa = points[a];
+			auto normal = (points[b] - pa).cross(points[c] - pa);
+			double length = normal.length();
+			if (length > 0) {
+				normal = normal / length;
+			}
+
+			Face face;
+			face.vertex[0] = a;
+			face.vertex[1] = b;
+			face.vertex[2] = c;
+			face.neighbour[0] = face.neighbour[1] = face.neighbour[2] = none;
+			face.normal = normal;
+			face.offset = normal.dot(pa);
+			face.alive = true;
+			faces.emplace_back(std::move(face));
+			return faces.size() - 1;
+		}
+
+		/*
+		 * add point, replacing faces it can see with faces fanning from it
+		 * to horizon. False if horizon isn't a single loop, hull unchanged
+		 */
+		bool addPoint(size_t f, size_t eye) {
+			// faces visible from point, connected to face
+			++stamp;
+			visited.resize(faces.size(), 0);
+			std::vector<size_t> visible(1, f);
+			visited[f] = stamp;
+			for (size_t k = 0; k < visible.size(); ++k) {
+				for (auto nb : faces[visible[k]].neighbour) {
+					if (visited[nb] != stamp
+							&& distance(faces[nb], eye) > epsilon) {
+						visited[nb] = stamp;
+						visible.emplace_back(nb);
+					}
+				}
+			}
+
+			// horizon edges, keyed by start
+			std::vector<HorizonEdge> edges;
+			std::unordered_map<size_t, size_t> starts;
+			for (auto v : visible) {
+				const auto & face = faces[v];
+				for (int i = 0; i < 3; ++i) {
+					if (visited[face.neighbour[i]] == stamp) {
+						continue;
+					}
+					HorizonEdge edge = { face.vertex[i],
+							face.vertex[(i + 1) % 3], face.neighbour[i] };
+					if (starts.emplace(edge.start, edges.size()).second
+							== false) {
+						return false;
+					}
+					edges.emplace_back(edge);
+				}
+			}
+
+			// order edges around loop
+			std::vector<size_t> loop;
+			loop.reserve(edges.size());
+			size_t e = 0;
+			do {
+				loop.emplace_back(e);
+				auto it = starts.find(edges[e].end);
+				if (it == starts.end()) {
+					return false;
+				}
+				e = it->second;
+			} while (e != 0 && loop.size() <= edges.size());
+			if (loop.size() != edges.size()) {
+				return false;
+			}
+
+			// fan of faces from point to horizon
+			auto m = loop.size();
+			std::vector<size_t> fan(m);
+			for (size_t k = 0; k < m; ++k) {
+				const auto & edge = edges[loop[k]];
+				fan[k] = addFace(edge.start, edge.end, eye);
+				faces[fan[k]].neighbour[0] = edge.face;
+				auto & other = faces[edge.face];
+				for (int i = 0; i < 3; ++i) {
+					if (other.vertex[i] == edge.end
+							&& other.vertex[(i + 1) % 3] == edge.start) {
+						other.neighbour[i] = fan[k];
+					}
+				}
+			}
+			for (size_t k = 0; k < m; ++k) {
+				faces[fan[k]].neighbour[1] = fan[(k + 1) % m];
+				faces[fan[k]].neighbour[2] = fan[(k + m - 1) % m];
+			}
+
+			// outside points of visible faces to new faces
+			for (auto v : visible) {
+				auto & face = faces[v];
+				face.alive = false;
+				for (auto p : face.outside) {
+					if (p != eye) {
+						assign(p, fan);
+					}
+				}
+				std::vector<size_t>().swap(face.outside);
+			}
+			for (auto nf : fan) {
+				if (faces[nf].outside.empty() == false) {
+					pending.emplace_back(nf);
+				}
+			}
+			return true;
+		}
+
+		/*
+		 * give point to face it is farthest above, if any
+		 */
+		void assign(size_t p, const std::vector<size_t> & candidates) {
+			size_t best = none;
+			double bestDistance = epsilon;
+			for (auto f : candidates) {
+				double d = distance(faces[f], p);
+				if (d > bestDistance) {
+					bestDistance = d;
+					best = f;
+				}
+			}
+			if (best != none) {
+				faces[best].outside.emplace_back(p);
+			}
+		}
+
+		/*
+		 * tetrahedron of extreme points, false if points span no volume
+		 */
+		bool buildSimplex(size_t simplex[4]) {
+			auto n = nPoints;
+			if (n < 4) {
+				return false;
+			}
+
+			// extremes along axes, and tolerance from their magnitude
+			size_t minIndex[3] = { 0, 0, 0 };
+			size_t maxIndex[3] = { 0, 0, 0 };
+			for (size_t i = 1; i < n; ++i) {
+				const auto & p = points[i];
+				for (int axis = 0; axis < 3; ++axis) {
+					double c = coordinate(p, axis);
+					if (c < coordinate(points[minIndex[axis]], axis)) {
+						minIndex[axis] = i;
+					}
+					if (c > coordinate(points[maxIndex[axis]], axis)) {
+						maxIndex[axis] = i;
+					}
+				}
+			}
+			double magnitude = 0;
+			for (int axis = 0; axis < 3; ++axis) {
+				magnitude += std::max(
+						std::abs(coordinate(points[minIndex[axis]], axis)),
+						std::abs(coordinate(points[maxIndex[axis]], axis)));
+			}
+			epsilon = 3 * std::numeric_limits<double>::epsilon() * magnitude;
+
+			// widest pair of extremes
+			double widest = 0;
+			for (int axis = 0; axis < 3; ++axis) {
+				auto d = points[maxIndex[axis]] - points[minIndex[axis]];
+				if (d.dot(d) > widest) {
+					widest = d.dot(d);
+					simplex[0] = minIndex[axis];
+					simplex[1] = maxIndex[axis];
+				}
+			}
+			if (std::sqrt(widest) <= epsilon) {
+				return false;
+			}
+
+			// farthest from line
+			const auto & a = points[simplex[0]];
+			auto ab = points[simplex[1]] - a;
+			double farthest = 0;
+			for (size_t i = 0; i < n; ++i) {
+				auto c = ab.cross(points[i] - a);
+				if (c.dot(c) > farthest) {
+					farthest = c.dot(c);
+					simplex[2] = i;
+				}
+			}
+			if (std::sqrt(farthest) / ab.length() <= epsilon) {
+				return false;
+			}
+
+			// farthest from plane
+			auto normal = ab.cross(points[simplex[2]] - a);
+			normal = normal / normal.length();
+			farthest = 0;
+			for (size_t i = 0; i < n; ++i) {
+				double d = std::abs(normal.dot(points[i] - a));
+				if (d > farthest) {
+					farthest = d;
+					simplex[3] = i;
+				}
+			}
+			if (farthest <= epsilon) {
+				return false;
+			}
+
+			// faces wound outward, away from remaining vertex
+			static const int corners[4][4] = {
+					{ 0, 1, 2, 3 },
+					{ 0, 3, 1, 2 },
+					{ 1, 3, 2, 0 },
+					{ 2, 3, 0, 1 } };
+			for (const auto & c : corners) {
+				auto f = addFace(simplex[c[0]], simplex[c[1]], simplex[c[2]]);
+				if (distance(faces[f], simplex[c[3]]) > 0) {
+					std::swap(faces[f].vertex[1], faces[f].vertex[2]);
+					faces[f].normal = -faces[f].normal;
+					faces[f].offset = -faces[f].offset;
+				}
+			}
+
+			// neighbours share edge wound the other way
+			for (size_t f = 0; f < 4; ++f) {
+				for (int i = 0; i < 3; ++i) {
+					auto v0 = faces[f].vertex[i];
+					auto v1 = faces[f].vertex[(i + 1) % 3];
+					for (size_t g = 0; g < 4; ++g) {
+						for (int j = 0; j < 3; ++j) {
+							if (faces[g].vertex[j] == v1
+									&& faces[g].vertex[(j + 1) % 3] == v0) {
+								faces[f].neighbour[i] = g;
+							}
+						}
+					}
+				}
+			}
+			return true;
+		}
+
+		/*
+		 * signed distance of point above face
+		 */
+		double distance(const Face & face, size_t p) const {
+			return face.normal.dot(points[p]) - face.offset;
+		}
+	};
+
+	/*
+	 * points and optional most vertices of hull
+	 */
+	struct Factory: public Executable {
+
+		void execute(const ScriptObjectPtr &, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			if (nArgs != 2) {
+				checkNumArgs(nArgs, 1);
+			}
+
+			auto points = getArg<Vec3Array>("Vec3Array", stack, 1);
+			auto maxVertices = Quickhull::defaultMaxVertices;
+			if (nArgs == 2) {
+				auto n = getInt32Arg(stack, 2);
+				auto limit = Quickhull::maxVertexLimit;
+				scriptExecutionAssert(
+						n >= 4 && static_cast<size_t>(n) <= limit,
+						"Require 4 to " + std::to_string(limit) + " vertices");
+				maxVertices = static_cast<size_t>(n);
+			}
+
+			stack.push(std::make_shared<ConvexHull>(points, maxVertices));
+		}
+	};
+}
+
+const size_t Quickhull::defaultMaxVertices = 64;
+const size_t Quickhull::maxVertexLimit = 4096;
+
+/**
+ * Build convex hull of points by quickhull. The hull grows by the
+ * farthest outlying point each iteration, so a hull stopped at
+ * maxVertices lies within the full hull and keeps its most outlying
+ * points. Coplanar triangles are merged into faces. Points spanning no
+ * volume give the hull of their bounding box
+ *
+ * @param points       points to build hull of
+ * @param maxVertices  most vertices of hull, at least 4
+ *
+ * @return             convex hull
+ */
+STATIC ConvexHull Quickhull::build(const Vec3Array & points,
+		size_t maxVertices) {
+	assert(maxVertices >= 4 && maxVertices <= maxVertexLimit);
+
+	Builder builder(points);
+	if (builder.build(maxVertices)) {
+		return builder.makeHull();
+	}
+
+	if (points.size() == 0) {
+		return ConvexHull(BoundingBox(Vec3()));
+	}
+	BoundingBox bounds = BoundingBox::empty();
+	for (const auto & point : points) {
+		bounds += point;
+	}
+	return ConvexHull(bounds);
+}
+
+/**
+ * get script object factory for hull of points
+ *
+ * @return  Quickhull factory
+ */
+STATIC const ScriptObjectPtr & Quickhull::getFactory() {
+	static auto factory = std::static_pointer_cast<ScriptObject>(
+			std::make_shared<Factory>());
+	return factory;
+}
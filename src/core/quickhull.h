@@ -0,0 +1,41 @@
+#pragma once
+
+#include "../scripting/scriptObject.h"
+
+#include <cstddef>
+
+class ConvexHull;
+class Vec3Array;
+
+/*
+ * Convex hulls built from arbitrary points, so collisions needn't be authored
+ * face by face
+ */
+class Quickhull {
+public:
+	/** vertices of hull when not given, plenty for collision */
+	static const size_t defaultMaxVertices;
+	/** most vertices of any hull, as hull indices are 16 bit */
+	static const size_t maxVertexLimit;
+
+	/**
+	 * Build convex hull of points by quickhull. The hull grows by the
+	 * farthest outlying point each iteration, so a hull stopped at
+	 * maxVertices lies within the full hull and keeps its most outlying
+	 * points. Coplanar triangles are merged into faces. Points spanning no
+	 * volume give the hull of their bounding box
+	 *
+	 * @param points       points to build hull of
+	 * @param maxVertices  most vertices of hull, at least 4
+	 *
+	 * @return             convex hull
+	 */
+	static ConvexHull build(const Vec3Array & points, size_t maxVertices);
+
+	/**
+	 * get script object factory for hull of points
+	 *
+	 * @return  Quickhull factory
+	 */
+	static const ScriptObjectPtr & getFactory();
+};
@@ -3,6 +3,7 @@
 #include "boundingBox.h"
 #include "collisionHierarchy.h"
 #include "constraint.h"
+#include "contactManifold.h"
 #include "intersection.h"
 #include "mat3.h"
 #include "ray.h"
@@ -27,8 +28,11 @@ struct RigidBody::impl {
 	double radius;
 
 	std::unordered_set<std::string> nocollide;
+	uint32_t collisionGroup;
+	uint32_t collisionMask;
 
 	bool doFriction;
+	bool continuous;
 	Vec3 lastPosition;
 
 	bool valid;
@@ -37,7 +41,8 @@ struct RigidBody::impl {
 			const Transform & rotTrans, const Vec3 & velocity,
 			const Vec3 & angularVelocity, const CollisionHierarchy & collision,
 			const Vec3 & gravity, double sgp,
-			const std::unordered_set<std::string> & nocollide, bool doFriction) :
+			const std::unordered_set<std::string> & nocollide,
+			uint32_t collisionGroup, uint32_t collisionMask, bool doFriction) :
 					name(name),
 					inverseMass(inverseMass),
 					inverseInertialTensor(0, 0, 0, 0, 0, 0, 0, 0, 0), // temporary
@@ -49,13 +54,17 @@ struct RigidBody::impl {
 					collision(collision),
 					radius(-1),
 					nocollide(nocollide),
+					collisionGroup(collisionGroup),
+					collisionMask(collisionMask),
 					doFriction(doFriction),
+					continuous(false),
 					lastPosition(rotTrans.getTranslation()),
 					valid(false) {
 	}
 
 	/**
-	 * apply friction
+	 * apply friction, static bodies are left untouched so they can be shared
+	 * between concurrently resolved pairs
 	 */
 	void applyFriction(impl & that, const Normal & normal) {
 		Vec3 currentPosition = rotTrans.getTranslation();
@@ -70,7 +79,7 @@ struct RigidBody::impl {
 
 		double e = 100000;
 
-		if (d < e) {
+		if (d < e && inverseMass > 0) {
 			tmp.scaleAdd(l, normal, lastPosition);
 			rotTrans.setTranslation(tmp);
 			lastPosition = tmp;
@@ -86,7 +95,7 @@ struct RigidBody::impl {
 		tmp.scaleAdd(-l, normal, currentPosition - that.lastPosition);
 		d = tmp.length();
 
-		if (d < e) {
+		if (d < e && that.inverseMass > 0) {
 			tmp.scaleAdd(l, normal, that.lastPosition);
 			that.rotTrans.setTranslation(tmp);
 			that.lastPosition = tmp;
@@ -217,17 +226,21 @@ struct RigidBody::impl {
  * @param gravity          body gravity
  * @param sgp              standard gravitational parameter
  * @param nocollide        list of names of objects to not collide with
+ * @param collisionGroup   bitmask of layers body is in
+ * @param collisionMask    bitmask of layers body collides with
  * @param doFriction       friction flag
  */
 RigidBody::RigidBody(const std::string & name, float inverseMass,
 		const Transform & rotTrans, const Vec3 & velocity,
 		const Vec3 & angularVelocity, const CollisionHierarchy & collision,
 		const Vec3 & gravity, double sgp,
-		const std::unordered_set<std::string> & nocollide, bool doFriction) :
+		const std::unordered_set<std::string> & nocollide,
+		uint32_t collisionGroup, uint32_t collisionMask, bool doFriction) :
 				pimpl(
 						new impl(name, inverseMass, rotTrans, velocity,
 								angularVelocity, collision, gravity, sgp,
-								nocollide, doFriction)) {
+								nocollide, collisionGroup, collisionMask,
+								doFriction)) {
 }
 
 /**
@@ -452,6 +465,33 @@ const CollisionHierarchy & RigidBody::getCollision() const {
 	return pimpl->collision;
 }
 
+/**
+ * get layers body is in
+ *
+ * @return  bitmask of layers
+ */
+uint32_t RigidBody::getCollisionGroup() const {
+	return pimpl->collisionGroup;
+}
+
+/**
+ * get layers body collides with
+ *
+ * @return  bitmask of layers
+ */
+uint32_t RigidBody::getCollisionMask() const {
+	return pimpl->collisionMask;
+}
+
+/**
+ * get bodies gravity
+ *
+ * @return  gravity of body
+ */
+const Vec3 & RigidBody::getGravity() const {
+	return pimpl->gravity;
+}
+
 /**
  * get bodies inverse mass
  *
@@ -461,6 +501,15 @@ float RigidBody::getInverseMass() const {
 	return pimpl->inverseMass;
 }
 
+/**
+ * get bodies position at start of last step
+ *
+ * @return  position at start of last step
+ */
+const Vec3 & RigidBody::getLastPosition() const {
+	return pimpl->lastPosition;
+}
+
 /**
  * get bodies linear velocity
  *
@@ -524,6 +573,15 @@ Vec3 RigidBody::getTranslation() const {
 	return pimpl->rotTrans.getTranslation();
 }
 
+/**
+ * is body swept along its steps, so it can't pass through thin bodies
+ *
+ * @return  true if swept, false otherwise
+ */
+bool RigidBody::isContinuous() const {
+	return pimpl->continuous;
+}
+
 /**
  * is name in list of bodies not to collide with
  *
@@ -538,6 +596,15 @@ bool RigidBody::noCollide(const std::string & name) const {
 	return pimpl->nocollide.find(name) != pimpl->nocollide.end();
 }
 
+/**
+ * get names of bodies not to collide with
+ *
+ * @return  set of names
+ */
+const std::unordered_set<std::string> & RigidBody::getNoCollide() const {
+	return pimpl->nocollide;
+}
+
 /**
  * Intersection against ray, writes point and distance and returns true if
  * intersection, otherwise returns false leaving point and distance
@@ -567,22 +634,23 @@ bool RigidBody::rayIntersection(const Ray & ray, Vec3 & point,
 /**
  * Resolve collision, if any
  *
- * @param that  other rigid body
- *
- * @return      list of intersections
+ * @param that      other rigid body
+ * @param contacts  cleared, then written with world space contacts
  */
-std::vector<Intersection> RigidBody::resolveCollision(RigidBody & that) {
+void RigidBody::resolveCollision(RigidBody & that,
+		ContactManifold & contacts) {
+	contacts.clear();
 	auto dp = pimpl->rotTrans.getTranslation() -
 			that.pimpl->rotTrans.getTranslation();
 	auto r = pimpl->radius + that.pimpl->radius;
 	if (dp.dot(dp) > r * r) {
-		return std::vector<Intersection>();
+		return;
 	}
 
-	auto intersections = pimpl->collision.collide(that.pimpl->collision,
-			that.pimpl->rotTrans.to(pimpl->rotTrans));
+	pimpl->collision.collide(that.pimpl->collision,
+			that.pimpl->rotTrans.to(pimpl->rotTrans), contacts);
 
-	for (auto & i : intersections) {
+	for (auto & i : contacts) {
 		// intersection into world space
 		i.transform(pimpl->rotTrans);
 
@@ -591,13 +659,18 @@ std::vector<Intersection> RigidBody::resolveCollision(RigidBody & that) {
 		v.scale(i.getDepth() / (pimpl->inverseMass + that.pimpl->inverseMass),
 				i.getNormal());
 
-		auto tmp = pimpl->rotTrans.getTranslation();
-		tmp.scaleAdd(pimpl->inverseMass, v, tmp);
-		pimpl->rotTrans.setTranslation(tmp);
+		// static bodies are only read
+		if (pimpl->inverseMass > 0) {
+			auto tmp = pimpl->rotTrans.getTranslation();
+			tmp.scaleAdd(pimpl->inverseMass, v, tmp);
+			pimpl->rotTrans.setTranslation(tmp);
+		}
 
-		tmp = that.pimpl->rotTrans.getTranslation();
-		tmp.scaleAdd(-that.pimpl->inverseMass, v, tmp);
-		that.pimpl->rotTrans.setTranslation(tmp);
+		if (that.pimpl->inverseMass > 0) {
+			auto tmp = that.pimpl->rotTrans.getTranslation();
+			tmp.scaleAdd(-that.pimpl->inverseMass, v, tmp);
+			that.pimpl->rotTrans.setTranslation(tmp);
+		}
 
 		// calculate impulse in world
 		Vec3 impulse;
@@ -605,16 +678,18 @@ std::vector<Intersection> RigidBody::resolveCollision(RigidBody & that) {
 			continue;
 		}
 
-		applyImpulse(i.getPoint(), impulse);
-		that.applyImpulse(i.getPoint(), -impulse);
+		if (pimpl->inverseMass > 0) {
+			applyImpulse(i.getPoint(), impulse);
+		}
+		if (that.pimpl->inverseMass > 0) {
+			that.applyImpulse(i.getPoint(), -impulse);
+		}
 
 		// friction
 		if (pimpl->doFriction && that.pimpl->doFriction) {
 			pimpl->applyFriction(*that.pimpl, i.getNormal());
 		}
 	}
-
-	return intersections;
 }
 
 /**
@@ -637,6 +712,15 @@ void RigidBody::setAngularVelocity(double x, double y, double z) {
 	pimpl->angularVelocity.set(x, y, z);
 }
 
+/**
+ * set whether body is swept along its steps
+ *
+ * @param continuous  true to sweep body, false otherwise
+ */
+void RigidBody::setContinuous(bool continuous) {
+	pimpl->continuous = continuous;
+}
+
 /**
  * set bodies linear velocity
  *
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_set>
@@ -7,7 +8,7 @@
 
 class CollisionHierarchy;
 class Constraint;
-class Intersection;
+class ContactManifold;
 class Quat;
 class Ray;
 class Transform;
@@ -28,13 +29,16 @@ public:
 	 * @param gravity          body gravity
 	 * @param sgp              standard gravitational parameter
 	 * @param nocollide        list of names of objects to not collide with
+	 * @param collisionGroup   bitmask of layers body is in
+	 * @param collisionMask    bitmask of layers body collides with
 	 * @param doFriction       friction flag
 	 */
 	RigidBody(const std::string & name, float inverseMass,
 			const Transform & rotTrans, const Vec3 & velocity,
 			const Vec3 & angularVelocity, const CollisionHierarchy & collision,
 			const Vec3 & gravity, double sgp,
-			const std::unordered_set<std::string> & nocollide, bool doFriction);
+			const std::unordered_set<std::string> & nocollide,
+			uint32_t collisionGroup, uint32_t collisionMask, bool doFriction);
 
 	/**
 	 * Apply impulse to body
@@ -83,6 +87,27 @@ public:
 	 */
 	const CollisionHierarchy & getCollision() const;
 
+	/**
+	 * get layers body is in
+	 *
+	 * @return  bitmask of layers
+	 */
+	uint32_t getCollisionGroup() const;
+
+	/**
+	 * get layers body collides with
+	 *
+	 * @return  bitmask of layers
+	 */
+	uint32_t getCollisionMask() const;
+
+	/**
+	 * get bodies gravity
+	 *
+	 * @return  gravity of body
+	 */
+	const Vec3 & getGravity() const;
+
 	/**
 	 * get bodies inverse mass
 	 *
@@ -90,6 +115,13 @@ public:
 	 */
 	float getInverseMass() const;
 
+	/**
+	 * get bodies position at start of last step
+	 *
+	 * @return  position at start of last step
+	 */
+	const Vec3 & getLastPosition() const;
+
 	/**
 	 * get bodies linear velocity
 	 *
@@ -139,6 +171,13 @@ public:
 	 */
 	Vec3 getTranslation() const;
 
+	/**
+	 * is body swept along its steps, so it can't pass through thin bodies
+	 *
+	 * @return  true if swept, false otherwise
+	 */
+	bool isContinuous() const;
+
 	/**
 	 * is name in list of bodies not to collide with
 	 *
@@ -148,6 +187,13 @@ public:
 	 */
 	bool noCollide(const std::string & name) const;
 
+	/**
+	 * get names of bodies not to collide with
+	 *
+	 * @return  set of names
+	 */
+	const std::unordered_set<std::string> & getNoCollide() const;
+
 	/**
 	 * is this body equal to other
 	 *
@@ -188,11 +234,10 @@ public:
 	/**
 	 * Resolve collision, if any
 	 *
-	 * @param that  other rigid body
-	 *
-	 * @return      list of intersections
+	 * @param that      other rigid body
+	 * @param contacts  cleared, then written with world space contacts
 	 */
-	std::vector<Intersection> resolveCollision(RigidBody & that);
+	void resolveCollision(RigidBody & that, ContactManifold & contacts);
 
 	/**
 	 * set bodies angular velocity
@@ -210,6 +255,13 @@ public:
 	 */
 	void setAngularVelocity(double x, double y, double z);
 
+	/**
+	 * set whether body is swept along its steps
+	 *
+	 * @param continuous  true to sweep body, false otherwise
+	 */
+	void setContinuous(bool continuous);
+
 	/**
 	 * set bodies linear velocity
 	 *
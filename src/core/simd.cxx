@@ -0,0 +1,55 @@
+#include "simd.h"
+
+#if defined(SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+	/*
+	 * query processor for supported instruction sets
+	 */
+	Simd::Level detect() {
+#if defined(SIMD_X86) && defined(__GNUC__)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2")) {
+			return Simd::Level::AVX2;
+		}
+		if (__builtin_cpu_supports("sse2")) {
+			return Simd::Level::SSE2;
+		}
+#elif defined(SIMD_X86) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		bool sse2 = (info[3] & (1 << 26)) != 0;
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+
+		if (maxLeaf >= 7 && osxsave && avx) {
+			// operating system saves ymm registers
+			if ((_xgetbv(0) & 6) == 6) {
+				__cpuidex(info, 7, 0);
+				if ((info[1] & (1 << 5)) != 0) {
+					return Simd::Level::AVX2;
+				}
+			}
+		}
+		if (sse2) {
+			return Simd::Level::SSE2;
+		}
+#endif
+		return Simd::Level::SCALAR;
+	}
+}
+
+/**
+ * get best instruction set supported by processor, detected once
+ *
+ * @return  instruction set level
+ */
+STATIC Simd::Level Simd::getLevel() {
+	static Level level = detect();
+	return level;
+}
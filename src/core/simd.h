@@ -0,0 +1,36 @@
+#pragma once
+
+/*
+ * SIMD_X86 is defined when x86 intrinsics are available. Kernels for a
+ * particular instruction set are marked with SIMD_TARGET_SSE2 or
+ * SIMD_TARGET_AVX2 so they can be compiled regardless of the build's
+ * target architecture, and selected at runtime using Simd::getLevel()
+ */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) \
+		|| defined(_M_IX86)
+#define SIMD_X86 1
+#include <immintrin.h>
+#if defined(__GNUC__)
+#define SIMD_TARGET_SSE2 __attribute__((target("sse2")))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SIMD_TARGET_SSE2
+#define SIMD_TARGET_AVX2
+#endif
+#endif
+
+class Simd {
+public:
+
+	enum class Level {
+		SCALAR, SSE2, AVX2
+	};
+
+	/**
+	 * get best instruction set supported by processor, detected once
+	 *
+	 * @return  instruction set level
+	 */
+	static Level getLevel();
+};
+
@@ -0,0 +1,30 @@
+#include "skeleton.h"
+
+#include <cassert>
+
+const size_t Skeleton::npos = static_cast<size_t>(-1);
+
+/**
+ * constructor
+ *
+ * @param names  names of bones, in index order, without duplicates
+ */
+Skeleton::Skeleton(const std::vector<std::string> & names) :
+		names(names) {
+	for (size_t i = 0, n = names.size(); i < n; ++i) {
+		assert(indices.count(names[i]) == 0);
+		indices.emplace(names[i], i);
+	}
+}
+
+/**
+ * get index of named bone
+ *
+ * @param name  name of bone
+ *
+ * @return      index of bone, npos if not in skeleton
+ */
+size_t Skeleton::getIndex(const std::string & name) const {
+	auto it = indices.find(name);
+	return it != indices.end() ? it->second : npos;
+}
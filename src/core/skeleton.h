@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Names of bones of a skeleton, each given an index once so poses can hold
+ * bones in arrays rather than maps keyed by name
+ */
+class Skeleton final {
+public:
+	/** index of bones not in skeleton */
+	static const size_t npos;
+
+	/**
+	 * constructor
+	 *
+	 * @param names  names of bones, in index order, without duplicates
+	 */
+	explicit Skeleton(const std::vector<std::string> & names);
+
+	/**
+	 * get index of named bone
+	 *
+	 * @param name  name of bone
+	 *
+	 * @return      index of bone, npos if not in skeleton
+	 */
+	size_t getIndex(const std::string & name) const;
+
+	/**
+	 * get name of bone
+	 *
+	 * @param index  index of bone
+	 *
+	 * @return       name of bone
+	 */
+	inline const std::string & getName(size_t index) const {
+		return names[index];
+	}
+
+	/**
+	 * get names of bones, in index order
+	 *
+	 * @return  names of bones
+	 */
+	inline const std::vector<std::string> & getNames() const {
+		return names;
+	}
+
+	/**
+	 * get number of bones
+	 *
+	 * @return  number of bones
+	 */
+	inline size_t size() const {
+		return names.size();
+	}
+
+private:
+	std::vector<std::string> names;
+	std::unordered_map<std::string, size_t> indices;
+};
@@ -36,17 +36,17 @@ namespace {
 			auto bone = std::static_pointer_cast<String>(args["bone"]);
 			auto index = std::static_pointer_cast<Real>(args["index"]);
 			auto parent = std::static_pointer_cast<Real>(args["parent"]);
-			auto fromParent = std::static_pointer_cast<Transform>(
+			const auto & fromParent = ScriptType<Transform>::get(
 					args["fromParent"]);
-			auto toRestPose = std::static_pointer_cast<Transform>(
+			const auto & toRestPose = ScriptType<Transform>::get(
 					args["toRestPose"]);
 
 			assert(index->getInt32() > parent->getInt32());
 
 			stack.push(
 					std::make_shared<SkinningMatrix>(bone->getValue(),
-							index->getInt32(), parent->getInt32(), *fromParent,
-							*toRestPose));
+							index->getInt32(), parent->getInt32(), fromParent,
+							toRestPose));
 		}
 	};
 }
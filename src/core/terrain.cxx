@@ -2,8 +2,10 @@
 
 #include "boundingBox.h"
 #include "convexHull.h"
+#include "heightField.h"
 #include "indexArray.h"
 #include "intersection.h"
+#include "plane.h"
 #include "ray.h"
 #include "sphere.h"
 #include "transform.h"
@@ -17,8 +19,80 @@
 #include "../scripting/string.h"
 
 #include <algorithm>
+#include <array>
+#include <limits>
 
 namespace {
+	/** clipping tolerance, as for TriangleList */
+	const double e = 0.001;
+
+	/** hulls with more planes take the general path, through TriangleList */
+	const size_t maxClipPlanes = 29;
+
+	/** triangles under shape remembered between passes */
+	const size_t maxCandidates = 256;
+
+	/*
+	 * convex polygon in fixed storage, a triangle clipped by n planes has at
+	 * most 3 + n vertices. Clipping alternates between two buffers
+	 */
+	struct Polygon {
+		std::array<Vec3, 3 + maxClipPlanes> buffers[2];
+		size_t size;
+		int current;
+
+		void reset(const Triangle & triangle) {
+			size = 3;
+			current = 0;
+			buffers[0][0] = triangle.getVertex0();
+			buffers[0][1] = triangle.getVertex1();
+			buffers[0][2] = triangle.getVertex2();
+		}
+
+		const Vec3 & get(size_t index) const {
+			return buffers[current][index];
+		}
+	};
+
+	/*
+	 * clip polygon keeping part below plane, 'distance' giving signed
+	 * distance above plane. Polygon within tolerance of one side is kept or
+	 * dropped whole, as for TriangleList
+	 */
+	template<typename DISTANCE>
+	void clip(Polygon & polygon, const DISTANCE & distance) {
+		std::array<double, 3 + maxClipPlanes> d;
+		bool above = true;
+		bool below = true;
+		for (size_t i = 0; i < polygon.size; ++i) {
+			d[i] = distance(polygon.get(i));
+			above = above && d[i] > -e;
+			below = below && d[i] < e;
+		}
+		if (below) {
+			return;
+		}
+		if (above) {
+			polygon.size = 0;
+			return;
+		}
+
+		const auto & from = polygon.buffers[polygon.current];
+		auto & to = polygon.buffers[1 - polygon.current];
+		size_t size = 0;
+		for (size_t i = 0, n = polygon.size; i < n; ++i) {
+			size_t j = (i + 1) % n;
+			if (d[i] <= 0) {
+				to[size++] = from[i];
+			}
+			if ((d[i] < 0 && d[j] > 0) || (d[i] > 0 && d[j] < 0)) {
+				to[size++].interpolate(from[i], from[j], d[i] / (d[i] - d[j]));
+			}
+		}
+		polygon.current = 1 - polygon.current;
+		polygon.size = size;
+	}
+
 	/*
 	 *
 	 */
@@ -60,6 +134,7 @@ struct Terrain::impl {
 	Vec3Array vertices;
 	IndexArray indices;
 	TriangleList triangles;
+	HeightField heightField;
 	BoundingBox bounds;
 	std::vector<Ray> edges;
 	bool valid;
@@ -72,6 +147,51 @@ struct Terrain::impl {
 					valid(false) {
 	}
 
+	/**
+	 * call function with each terrain triangle whose bounds intersect box
+	 *
+	 * @param box  box in terrain space
+	 * @param fn   function taking triangle
+	 */
+	template<typename FUNC>
+	void forEachTriangle(const BoundingBox & box, FUNC & fn) const {
+		auto cell = [&](size_t index) {
+			for (size_t i = 2 * index; i < 2 * index + 2; ++i) {
+				const auto & t = triangles.get(i);
+				if (box.intersects(t.getBounds())) {
+					fn(t);
+				}
+			}
+		};
+		heightField.intersect(box, cell);
+	}
+
+	/**
+	 * call function with each terrain triangle, transformed to box space,
+	 * whose bounds intersect box
+	 *
+	 * @param box           box in its own space
+	 * @param boxToTerrain  from box space to terrain space
+	 * @param fn            function taking index of triangle and transformed
+	 *                      triangle
+	 */
+	template<typename FUNC>
+	void forEachTransformed(const BoundingBox & box,
+			const Transform & boxToTerrain, FUNC & fn) const {
+		auto terrainToBox = boxToTerrain.inverse();
+		auto r = terrainToBox.getRotationMatrix();
+		auto t = terrainToBox.getTranslation();
+		auto cell = [&](size_t index) {
+			for (size_t i = 2 * index; i < 2 * index + 2; ++i) {
+				auto transformed = triangles.get(i).rotatedTranslated(r, t);
+				if (box.intersects(transformed.getBounds())) {
+					fn(i, transformed);
+				}
+			}
+		};
+		heightField.intersect(box, boxToTerrain, cell);
+	}
+
 	/**
 	 * Clip terrain mesh against bounding box, triangles remain uncut
 	 *
@@ -80,57 +200,97 @@ struct Terrain::impl {
 	 * @return     terrain clipped against box
 	 */
 	TriangleList clippedAndTransformed(const BoundingBox & box,
-			const Transform & boxToTerrain) {
-
-		auto boxBoundsInTerrainSpace = box.transformed(boxToTerrain);
-
-		const auto & bmin = bounds.getMin();
-		const auto & bmax = bounds.getMax();
-		const auto & boxMin = boxBoundsInTerrainSpace.getMin();
-		const auto & boxMax = boxBoundsInTerrainSpace.getMax();
+			const Transform & boxToTerrain) const {
+		TriangleList clipped;
+		auto add = [&](size_t, const Triangle & t) {
+			clipped.add(t);
+		};
+		forEachTransformed(box, boxToTerrain, add);
+		return clipped;
+	}
 
-		if (bmin.getX() > boxMax.getX() || boxMin.getX() > bmax.getX()
-				|| bmin.getY() > boxMax.getY() || boxMin.getY() > bmax.getY()
-				|| boxMin.getZ() > bmax.getZ()) {
-			return std::vector<Triangle>();
+	/**
+	 * Intersect terrain with convex shape without building intermediate
+	 * triangle lists, matching TriangleList::intersection to within
+	 * clipping tolerance
+	 *
+	 * @param bounds        bounds of shape
+	 * @param toTerrain     from shape space to terrain space
+	 * @param clipper       clips polygon to inside of shape
+	 * @param vertices      vertices of shape
+	 * @param intersection  intersection, written only if collision
+	 *
+	 * @return              true if collision, false otherwise
+	 */
+	template<typename CLIPPER, typename VERTICES>
+	bool intersect(const BoundingBox & bounds, const Transform & toTerrain,
+			CLIPPER & clipper, const VERTICES & vertices,
+			Intersection & intersection) const {
+
+		// candidates kept for depth pass, found again only if too many
+		std::array<size_t, maxCandidates> candidates;
+		size_t nCandidates = 0;
+
+		// area weighted centre and normal of terrain inside shape
+		double area = 0;
+		Vec3 p, tmp;
+		Polygon polygon;
+		auto accumulate = [&](size_t index, const Triangle & t) {
+			if (nCandidates < maxCandidates) {
+				candidates[nCandidates] = index;
+			}
+			++nCandidates;
+			polygon.reset(t);
+			clipper(polygon);
+			if (polygon.size == 0) {
+				return;
+			}
+			const auto & a = polygon.get(0);
+			for (size_t i = 2; i < polygon.size; ++i) {
+				const auto & b = polygon.get(i - 1);
+				const auto & c = polygon.get(i);
+				double ta = .5 * (b - a).cross(c - b).length();
+				area += ta;
+				p.scaleAdd(ta, (a + b + c) / 3, p);
+				tmp.scaleAdd(ta, t.getNormal(), tmp);
+			}
+		};
+		forEachTransformed(bounds, toTerrain, accumulate);
+		if (area == 0) {
+			return false;
 		}
-
-		int nCols = static_cast<int>((bmax.getX() - bmin.getX()) / gridSize
-				+ .5f);
-		int nRows = static_cast<int>((bmax.getY() - bmin.getY()) / gridSize
-				+ .5f);
-
-		int sCol = std::max(
-				static_cast<int>((boxMin.getX() - bmin.getX()) / gridSize), 0);
-		int sRow = std::max(
-				static_cast<int>((boxMin.getY() - bmin.getY()) / gridSize), 0);
-
-		int eCol = std::min(
-				static_cast<int>((boxMax.getX() - bmin.getX()) / gridSize),
-				nCols - 1);
-		int eRow = std::min(
-				static_cast<int>((boxMax.getY() - bmin.getY()) / gridSize),
-				nRows - 1);
-
-		// clipped & transformed
-		auto terrainToHull = boxToTerrain.inverse();
-		auto r = terrainToHull.getRotationMatrix();
-		auto t = terrainToHull.getTranslation();
-		TriangleList clippedAndTransformed;
-		for (int i = sCol; i <= eCol; ++i) {
-			for (int j = sRow; j <= eRow; ++j) {
-				int idx = 2 * (j * nCols + i);
-				auto ta = triangles.get(idx).rotatedTranslated(r, t);
-				auto tb = triangles.get(idx + 1).rotatedTranslated(r, t);
-				if (box.intersects(ta.getBounds())) {
-					clippedAndTransformed.add(ta);
-				}
-				if (box.intersects(tb.getBounds())) {
-					clippedAndTransformed.add(tb);
+		p = p / area;
+		auto n = tmp.normalized();
+
+		// furthest terrain along normal from shape vertices
+		double maxDist = -std::numeric_limits<double>::max();
+		auto depth = [&](size_t, const Triangle & t) {
+			Vec3 q;
+			double d = 0;
+			for (const auto & v : vertices) {
+				if (t.intersectRay(v, n, q, d) && d > maxDist) {
+					maxDist = d;
 				}
 			}
+		};
+		if (nCandidates <= maxCandidates) {
+			auto terrainToShape = toTerrain.inverse();
+			auto r = terrainToShape.getRotationMatrix();
+			auto t = terrainToShape.getTranslation();
+			for (size_t i = 0; i < nCandidates; ++i) {
+				depth(candidates[i],
+						triangles.get(candidates[i]).rotatedTranslated(r, t));
+			}
+		} else {
+			forEachTransformed(bounds, toTerrain, depth);
 		}
-		return clippedAndTransformed;
+		if (maxDist == -std::numeric_limits<double>::max()) {
+			return false;
+		}
+
+		intersection.set(p, -n, maxDist);
+		intersection.transform(toTerrain);
+		return true;
 	}
 };
 
@@ -163,22 +323,43 @@ Terrain::~Terrain() {
  */
 bool Terrain::collide(const BoundingBox & box, const Transform & boxToTerrain,
 		Intersection & intersection) {
+	const auto & min = box.getMin();
+	const auto & max = box.getMax();
+
+	// clip to each face of box
+	auto clipper = [&](Polygon & polygon) {
+		clip(polygon, [&](const Vec3 & v) {
+			return v.getX() - max.getX();
+		});
+		clip(polygon, [&](const Vec3 & v) {
+			return min.getX() - v.getX();
+		});
+		clip(polygon, [&](const Vec3 & v) {
+			return v.getY() - max.getY();
+		});
+		clip(polygon, [&](const Vec3 & v) {
+			return min.getY() - v.getY();
+		});
+		clip(polygon, [&](const Vec3 & v) {
+			return v.getZ() - max.getZ();
+		});
+		clip(polygon, [&](const Vec3 & v) {
+			return min.getZ() - v.getZ();
+		});
+	};
 
-	// clip terrain by hull and transform to hull space
-	auto clippedTerrain = pimpl->clippedAndTransformed(box, boxToTerrain);
-	if (clippedTerrain.size() == 0) {
-		return false;
-	}
-
-	// test intersection
-	if (clippedTerrain.intersection(box, intersection) == false) {
-		return false;
-	}
-
-	// transform intersection from hull to terrain space
-	intersection.transform(boxToTerrain);
-
-	return true;
+	Vec3 boxVertices[] = {
+			Vec3(min.getX(), min.getY(), min.getZ()),
+			Vec3(min.getX(), min.getY(), max.getZ()),
+			Vec3(min.getX(), max.getY(), min.getZ()),
+			Vec3(min.getX(), max.getY(), max.getZ()),
+			Vec3(max.getX(), min.getY(), min.getZ()),
+			Vec3(max.getX(), min.getY(), max.getZ()),
+			Vec3(max.getX(), max.getY(), min.getZ()),
+			Vec3(max.getX(), max.getY(), max.getZ()) };
+
+	return pimpl->intersect(box, boxToTerrain, clipper, boxVertices,
+			intersection);
 }
 
 /**
@@ -192,23 +373,41 @@ bool Terrain::collide(const BoundingBox & box, const Transform & boxToTerrain,
  */
 bool Terrain::collide(const ConvexHull & hull, const Transform & hullToTerrain,
 		Intersection & intersection) {
+	const auto & planes = hull.getPlanes();
+
+	if (planes.size() > maxClipPlanes) {
+		// clip terrain by hull and transform to hull space
+		auto clippedTerrain = pimpl->clippedAndTransformed(hull.getBounds(),
+				hullToTerrain);
+		if (clippedTerrain.size() == 0) {
+			return false;
+		}
 
-	// clip terrain by hull and transform to hull space
-	auto clippedTerrain = pimpl->clippedAndTransformed(hull.getBounds(),
-			hullToTerrain);
-	if (clippedTerrain.size() == 0) {
-		return false;
-	}
+		// test intersection
+		if (clippedTerrain.intersection(hull, intersection) == false) {
+			return false;
+		}
 
-	// test intersection
-	if (clippedTerrain.intersection(hull, intersection) == false) {
-		return false;
+		// transform intersection from hull to terrain space
+		intersection.transform(hullToTerrain);
+
+		return true;
 	}
 
-	// transform intersection from hull to terrain space
-	intersection.transform(hullToTerrain);
+	// clip to each plane of hull
+	auto clipper = [&](Polygon & polygon) {
+		for (const auto & plane : planes) {
+			if (polygon.size == 0) {
+				return;
+			}
+			clip(polygon, [&](const Vec3 & v) {
+				return plane.distanceTo(v);
+			});
+		}
+	};
 
-	return true;
+	return pimpl->intersect(hull.getBounds(), hullToTerrain, clipper,
+			hull.getVertices(), intersection);
 }
 
 /**
@@ -233,20 +432,14 @@ bool Terrain::collide(const Sphere & sphere, const Transform & sphereToThis,
 			Vec3(point.getX() + radius, point.getY() + radius,
 					point.getZ() + radius));
 
-	// clip terrain by sphere
-	auto clippedTerrain = pimpl->clippedAndTransformed(bb, Transform());
-	if (clippedTerrain.size() == 0) {
-		return false;
-	}
-
 	Vec3 intxnPoint;
 	Normal intxnNormal(1.f, 0.f, 0.f); // initial value unimportant
 	double intxnDepth = 0;
 
-	// check planes
-	Vec3 op;
-	double dist;
-	for (const auto & t : clippedTerrain) {
+	// check planes of terrain under sphere
+	auto test = [&](const Triangle & t) {
+		Vec3 op;
+		double dist;
 		auto dir = -t.getNormal();
 
 		if (t.intersectRayExtended(point, dir, op, dist)) {
@@ -257,7 +450,8 @@ bool Terrain::collide(const Sphere & sphere, const Transform & sphereToThis,
 				intxnDepth = dist;
 			}
 		}
-	}
+	};
+	pimpl->forEachTriangle(bb, test);
 
 	if (false) {
 		static Normal up(0.f, 0.f, 1.f);
@@ -359,6 +553,8 @@ bool Terrain::validate() {
 	}
 
 	pimpl->bounds = pimpl->vertices.getBounds();
+	pimpl->heightField = HeightField(pimpl->bounds, pimpl->gridSize,
+			triangles);
 	return true;
 }
 
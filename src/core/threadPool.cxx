@@ -0,0 +1,169 @@
+#include "threadPool.h"
+
+#include "config.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+	/** set on threads doing pool work, nested calls run serially */
+	thread_local bool inPool = false;
+}
+
+struct ThreadPool::impl {
+	std::mutex m_jobLock;
+	std::mutex m_lock;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	std::vector<std::thread> m_workers;
+	bool m_stop;
+
+	// current job
+	const std::function<void(size_t)> * m_fn;
+	size_t m_count;
+	std::atomic<size_t> m_next;
+	unsigned m_generation;
+	unsigned m_busy;
+
+	impl() :
+			m_stop(false),
+			m_fn(nullptr),
+			m_count(0),
+			m_next(0),
+			m_generation(0),
+			m_busy(0) {
+	}
+
+	/*
+	 * take indices until none left
+	 */
+	void work() {
+		for (size_t i = m_next++; i < m_count; i = m_next++) {
+			(*m_fn)(i);
+		}
+	}
+
+	/*
+	 * worker loop
+	 */
+	void run() {
+		inPool = true;
+
+		unsigned seen = 0;
+
+		std::unique_lock<std::mutex> locker(m_lock);
+		for (;;) {
+			while (m_stop == false && m_generation == seen) {
+				m_wake.wait(locker);
+			}
+			if (m_stop) {
+				return;
+			}
+			seen = m_generation;
+			locker.unlock();
+
+			work();
+
+			locker.lock();
+			if (--m_busy == 0) {
+				m_done.notify_all();
+			}
+		}
+	}
+};
+
+/**
+ * constructor
+ *
+ * @param nThreads  number of threads including caller, 0 for one per
+ *                  hardware thread
+ */
+EXPLICIT ThreadPool::ThreadPool(unsigned nThreads) :
+		pimpl(new impl()) {
+	if (nThreads == 0) {
+		nThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	for (unsigned i = 1; i < nThreads; ++i) {
+		pimpl->m_workers.emplace_back(&impl::run, pimpl.get());
+	}
+}
+
+/**
+ * destructor, waits for workers to finish
+ */
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> locker(pimpl->m_lock);
+		pimpl->m_stop = true;
+		pimpl->m_wake.notify_all();
+	}
+	for (auto & worker : pimpl->m_workers) {
+		worker.join();
+	}
+}
+
+/**
+ * get number of threads including caller
+ *
+ * @return  number of threads
+ */
+unsigned ThreadPool::getThreadCount() const {
+	return static_cast<unsigned>(pimpl->m_workers.size() + 1);
+}
+
+/**
+ * call function for every index in range [0, count), splitting indices
+ * across workers, returns once all calls have completed. Caller thread
+ * also does work. Nested calls run serially.
+ *
+ * @param count  number of indices
+ * @param fn     function to call with each index
+ */
+void ThreadPool::parallelFor(size_t count,
+		const std::function<void(size_t)> & fn) {
+	if (pimpl->m_workers.empty() || count < 2 || inPool) {
+		for (size_t i = 0; i < count; ++i) {
+			fn(i);
+		}
+		return;
+	}
+
+	// one job at a time
+	std::lock_guard<std::mutex> jobLocker(pimpl->m_jobLock);
+
+	{
+		std::lock_guard<std::mutex> locker(pimpl->m_lock);
+		pimpl->m_fn = &fn;
+		pimpl->m_count = count;
+		pimpl->m_next = 0;
+		pimpl->m_busy = static_cast<unsigned>(pimpl->m_workers.size());
+		++pimpl->m_generation;
+		pimpl->m_wake.notify_all();
+	}
+
+	inPool = true;
+	pimpl->work();
+	inPool = false;
+
+	std::unique_lock<std::mutex> locker(pimpl->m_lock);
+	while (pimpl->m_busy != 0) {
+		pimpl->m_done.wait(locker);
+	}
+	pimpl->m_fn = nullptr;
+}
+
+/**
+ * get shared pool, sized by 'workerThreads' config
+ *
+ * @return  shared pool
+ */
+STATIC ThreadPool & ThreadPool::getInstance() {
+	static ThreadPool instance(
+			static_cast<unsigned>(std::max(0,
+					Config::getInstance().getInteger("workerThreads"))));
+	return instance;
+}
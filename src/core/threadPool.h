@@ -0,0 +1,50 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+class ThreadPool {
+public:
+
+	/**
+	 * constructor
+	 *
+	 * @param nThreads  number of threads including caller, 0 for one per
+	 *                  hardware thread
+	 */
+	explicit ThreadPool(unsigned nThreads);
+
+	/**
+	 * destructor, waits for workers to finish
+	 */
+	~ThreadPool();
+
+	/**
+	 * get number of threads including caller
+	 *
+	 * @return  number of threads
+	 */
+	unsigned getThreadCount() const;
+
+	/**
+	 * call function for every index in range [0, count), splitting indices
+	 * across workers, returns once all calls have completed. Caller thread
+	 * also does work. Nested calls run serially.
+	 *
+	 * @param count  number of indices
+	 * @param fn     function to call with each index
+	 */
+	void parallelFor(size_t count, const std::function<void(size_t)> & fn);
+
+	/**
+	 * get shared pool, sized by 'workerThreads' config
+	 *
+	 * @return  shared pool
+	 */
+	static ThreadPool & getInstance();
+
+private:
+	struct impl;
+	std::unique_ptr<impl> pimpl;
+};
+
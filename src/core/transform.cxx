@@ -1,4 +1,5 @@
 #include "transform.h"
+#include "simd.h"
 
 #include "../scripting/bool.h"
 #include "../scripting/executable.h"
@@ -6,6 +7,7 @@
 #include "../scripting/real.h"
 #include "../scripting/scriptExecutionException.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <unordered_map>
@@ -26,7 +28,7 @@ namespace {
 			auto t = getArg<Vec3>("Vec3", stack, 1);
 			auto r = getArg<Quat>("Quat", stack, 2);
 
-			stack.emplace(std::make_shared<Transform>(t, r));
+			stack.emplace(std::make_shared<ScriptTransform>(Transform(t, r)));
 		}
 	};
 
@@ -41,20 +43,310 @@ namespace {
 			auto e = stack.top();
 			stack.pop();
 
-			if (typeid(*e) == typeid(Transform)) {
-				Transform result(*std::static_pointer_cast<Transform>(self));
-				result.transform(*std::static_pointer_cast<Transform>(e));
-				stack.emplace(std::make_shared<Transform>(result));
-			} else if (typeid(*e) == typeid(Vec3)) {
-				Vec3 point(*std::static_pointer_cast<Vec3>(e));
-				std::static_pointer_cast<Transform>(self)->transformPoint(
-						point);
-				stack.emplace(std::make_shared<Vec3>(point));
+			if (typeid(*e) == typeid(ScriptTransform)) {
+				Transform result(ScriptType<Transform>::get(self));
+				result.transform(ScriptType<Transform>::get(e));
+				stack.emplace(std::make_shared<ScriptTransform>(result));
+			} else if (typeid(*e) == typeid(ScriptVec3)) {
+				Vec3 point(ScriptType<Vec3>::get(e));
+				ScriptType<Transform>::get(self).transformPoint(point);
+				stack.emplace(std::make_shared<ScriptVec3>(point));
 			} else {
 				scriptExecutionAssert(false, "Require Transform or Vec3 ");
 			}
 		}
 	};
+
+	/** instances composed per kernel call */
+	const size_t nLanes = 8;
+
+	/*
+	 * batch of transforms gathered component by component, so kernels load
+	 * lanes directly. Unused lanes hold zeros
+	 */
+	struct Lanes {
+		float x[nLanes];
+		float y[nLanes];
+		float z[nLanes];
+		float w[nLanes];
+		double tx[nLanes];
+		double ty[nLanes];
+		double tz[nLanes];
+	};
+
+	/*
+	 * view rotation as quaternion, and as row major matrix in double
+	 * precision for rotating translations, and view translation
+	 */
+	struct ViewTerms {
+		float x;
+		float y;
+		float z;
+		float w;
+		double m[9];
+		double t[3];
+	};
+
+	/*
+	 * compose view with first n lanes, writing column major model view
+	 * matrices and, if normal isn't null, rotation matrices
+	 */
+	typedef void (*ToViewKernel)(const ViewTerms & v, const Lanes & l,
+			size_t n, float * modelView, float * normal);
+
+	/*
+	 * scalar, one instance at a time
+	 */
+	void toViewScalar(const ViewTerms & v, const Lanes & l, size_t n,
+			float * modelView, float * normal) {
+		for (size_t i = 0; i < n; ++i) {
+			float a = v.w * l.x[i] + v.x * l.w[i] + v.y * l.z[i]
+					- v.z * l.y[i];
+			float b = v.w * l.y[i] - v.x * l.z[i] + v.y * l.w[i]
+					+ v.z * l.x[i];
+			float c = v.w * l.z[i] + v.x * l.y[i] - v.y * l.x[i]
+					+ v.z * l.w[i];
+			float d = v.w * l.w[i] - v.x * l.x[i] - v.y * l.y[i]
+					- v.z * l.z[i];
+
+			float * mv = modelView + i * 16;
+			mv[0] = 1 - 2 * (b * b + c * c);
+			mv[1] = 2 * (a * b + c * d);
+			mv[2] = 2 * (a * c - b * d);
+			mv[3] = 0;
+			mv[4] = 2 * (a * b - c * d);
+			mv[5] = 1 - 2 * (a * a + c * c);
+			mv[6] = 2 * (b * c + a * d);
+			mv[7] = 0;
+			mv[8] = 2 * (a * c + b * d);
+			mv[9] = 2 * (b * c - a * d);
+			mv[10] = 1 - 2 * (a * a + b * b);
+			mv[11] = 0;
+			for (int r = 0; r < 3; ++r) {
+				mv[12 + r] = static_cast<float>(v.t[r]
+						+ v.m[r * 3] * l.tx[i] + v.m[r * 3 + 1] * l.ty[i]
+						+ v.m[r * 3 + 2] * l.tz[i]);
+			}
+			mv[15] = 1;
+
+			if (normal != nullptr) {
+				float * nm = normal + i * 9;
+				std::copy(mv, mv + 3, nm);
+				std::copy(mv + 4, mv + 7, nm + 3);
+				std::copy(mv + 8, mv + 11, nm + 6);
+			}
+		}
+	}
+
+#ifdef SIMD_X86
+	/*
+	 * transpose elements of column major matrices, each holding four lanes,
+	 * into matrices of first n lanes
+	 */
+	SIMD_TARGET_SSE2 void storeLanes(const __m128 * e, size_t n,
+			float * modelView, float * normal) {
+		for (int c = 0; c < 4; ++c) {
+			__m128 r0 = e[c * 4];
+			__m128 r1 = e[c * 4 + 1];
+			__m128 r2 = e[c * 4 + 2];
+			__m128 r3 = e[c * 4 + 3];
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			__m128 cols[] = { r0, r1, r2, r3 };
+
+			for (size_t i = 0; i < n; ++i) {
+				_mm_storeu_ps(modelView + i * 16 + c * 4, cols[i]);
+				if (normal != nullptr && c < 3) {
+					float col[4];
+					_mm_storeu_ps(col, cols[i]);
+					std::copy(col, col + 3, normal + i * 9 + c * 3);
+				}
+			}
+		}
+	}
+
+	/*
+	 * sse2, four instances at a time
+	 */
+	SIMD_TARGET_SSE2 void toViewSse2(const ViewTerms & v, const Lanes & l,
+			size_t n, float * modelView, float * normal) {
+		__m128 vx = _mm_set1_ps(v.x);
+		__m128 vy = _mm_set1_ps(v.y);
+		__m128 vz = _mm_set1_ps(v.z);
+		__m128 vw = _mm_set1_ps(v.w);
+		__m128 one = _mm_set1_ps(1);
+		__m128 two = _mm_set1_ps(2);
+
+		for (size_t i = 0; i < n; i += 4) {
+			__m128 x = _mm_loadu_ps(l.x + i);
+			__m128 y = _mm_loadu_ps(l.y + i);
+			__m128 z = _mm_loadu_ps(l.z + i);
+			__m128 w = _mm_loadu_ps(l.w + i);
+
+			__m128 a = _mm_add_ps(_mm_mul_ps(vw, x), _mm_mul_ps(vx, w));
+			a = _mm_add_ps(a, _mm_mul_ps(vy, z));
+			a = _mm_sub_ps(a, _mm_mul_ps(vz, y));
+			__m128 b = _mm_add_ps(_mm_mul_ps(vw, y), _mm_mul_ps(vy, w));
+			b = _mm_sub_ps(b, _mm_mul_ps(vx, z));
+			b = _mm_add_ps(b, _mm_mul_ps(vz, x));
+			__m128 c = _mm_add_ps(_mm_mul_ps(vw, z), _mm_mul_ps(vz, w));
+			c = _mm_add_ps(c, _mm_mul_ps(vx, y));
+			c = _mm_sub_ps(c, _mm_mul_ps(vy, x));
+			__m128 d = _mm_sub_ps(_mm_mul_ps(vw, w), _mm_mul_ps(vx, x));
+			d = _mm_sub_ps(d, _mm_mul_ps(vy, y));
+			d = _mm_sub_ps(d, _mm_mul_ps(vz, z));
+
+			__m128 aa = _mm_mul_ps(a, a);
+			__m128 bb = _mm_mul_ps(b, b);
+			__m128 cc = _mm_mul_ps(c, c);
+			__m128 ab = _mm_mul_ps(a, b);
+			__m128 ac = _mm_mul_ps(a, c);
+			__m128 ad = _mm_mul_ps(a, d);
+			__m128 bc = _mm_mul_ps(b, c);
+			__m128 bd = _mm_mul_ps(b, d);
+			__m128 cd = _mm_mul_ps(c, d);
+
+			__m128 e[16];
+			e[0] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(bb, cc)));
+			e[1] = _mm_mul_ps(two, _mm_add_ps(ab, cd));
+			e[2] = _mm_mul_ps(two, _mm_sub_ps(ac, bd));
+			e[3] = _mm_setzero_ps();
+			e[4] = _mm_mul_ps(two, _mm_sub_ps(ab, cd));
+			e[5] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(aa, cc)));
+			e[6] = _mm_mul_ps(two, _mm_add_ps(bc, ad));
+			e[7] = _mm_setzero_ps();
+			e[8] = _mm_mul_ps(two, _mm_add_ps(ac, bd));
+			e[9] = _mm_mul_ps(two, _mm_sub_ps(bc, ad));
+			e[10] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(aa, bb)));
+			e[11] = _mm_setzero_ps();
+			for (int r = 0; r < 3; ++r) {
+				__m128d m0 = _mm_set1_pd(v.m[r * 3]);
+				__m128d m1 = _mm_set1_pd(v.m[r * 3 + 1]);
+				__m128d m2 = _mm_set1_pd(v.m[r * 3 + 2]);
+				__m128d t = _mm_set1_pd(v.t[r]);
+				__m128 halves[2];
+				for (int h = 0; h < 2; ++h) {
+					size_t j = i + h * 2;
+					__m128d p = _mm_add_pd(t,
+							_mm_mul_pd(m0, _mm_loadu_pd(l.tx + j)));
+					p = _mm_add_pd(p, _mm_mul_pd(m1, _mm_loadu_pd(l.ty + j)));
+					p = _mm_add_pd(p, _mm_mul_pd(m2, _mm_loadu_pd(l.tz + j)));
+					halves[h] = _mm_cvtpd_ps(p);
+				}
+				e[12 + r] = _mm_movelh_ps(halves[0], halves[1]);
+			}
+			e[15] = one;
+
+			storeLanes(e, std::min<size_t>(n - i, 4), modelView + i * 16,
+					normal == nullptr ? nullptr : normal + i * 9);
+		}
+	}
+
+	/*
+	 * avx2, eight instances at a time
+	 */
+	SIMD_TARGET_AVX2 void toViewAvx2(const ViewTerms & v, const Lanes & l,
+			size_t n, float * modelView, float * normal) {
+		__m256 vx = _mm256_set1_ps(v.x);
+		__m256 vy = _mm256_set1_ps(v.y);
+		__m256 vz = _mm256_set1_ps(v.z);
+		__m256 vw = _mm256_set1_ps(v.w);
+		__m256 one = _mm256_set1_ps(1);
+		__m256 two = _mm256_set1_ps(2);
+
+		__m256 x = _mm256_loadu_ps(l.x);
+		__m256 y = _mm256_loadu_ps(l.y);
+		__m256 z = _mm256_loadu_ps(l.z);
+		__m256 w = _mm256_loadu_ps(l.w);
+
+		__m256 a = _mm256_add_ps(_mm256_mul_ps(vw, x), _mm256_mul_ps(vx, w));
+		a = _mm256_add_ps(a, _mm256_mul_ps(vy, z));
+		a = _mm256_sub_ps(a, _mm256_mul_ps(vz, y));
+		__m256 b = _mm256_add_ps(_mm256_mul_ps(vw, y), _mm256_mul_ps(vy, w));
+		b = _mm256_sub_ps(b, _mm256_mul_ps(vx, z));
+		b = _mm256_add_ps(b, _mm256_mul_ps(vz, x));
+		__m256 c = _mm256_add_ps(_mm256_mul_ps(vw, z), _mm256_mul_ps(vz, w));
+		c = _mm256_add_ps(c, _mm256_mul_ps(vx, y));
+		c = _mm256_sub_ps(c, _mm256_mul_ps(vy, x));
+		__m256 d = _mm256_sub_ps(_mm256_mul_ps(vw, w), _mm256_mul_ps(vx, x));
+		d = _mm256_sub_ps(d, _mm256_mul_ps(vy, y));
+		d = _mm256_sub_ps(d, _mm256_mul_ps(vz, z));
+
+		__m256 aa = _mm256_mul_ps(a, a);
+		__m256 bb = _mm256_mul_ps(b, b);
+		__m256 cc = _mm256_mul_ps(c, c);
+		__m256 ab = _mm256_mul_ps(a, b);
+		__m256 ac = _mm256_mul_ps(a, c);
+		__m256 ad = _mm256_mul_ps(a, d);
+		__m256 bc = _mm256_mul_ps(b, c);
+		__m256 bd = _mm256_mul_ps(b, d);
+		__m256 cd = _mm256_mul_ps(c, d);
+
+		__m256 e[16];
+		e[0] = _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(bb, cc)));
+		e[1] = _mm256_mul_ps(two, _mm256_add_ps(ab, cd));
+		e[2] = _mm256_mul_ps(two, _mm256_sub_ps(ac, bd));
+		e[3] = _mm256_setzero_ps();
+		e[4] = _mm256_mul_ps(two, _mm256_sub_ps(ab, cd));
+		e[5] = _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(aa, cc)));
+		e[6] = _mm256_mul_ps(two, _mm256_add_ps(bc, ad));
+		e[7] = _mm256_setzero_ps();
+		e[8] = _mm256_mul_ps(two, _mm256_add_ps(ac, bd));
+		e[9] = _mm256_mul_ps(two, _mm256_sub_ps(bc, ad));
+		e[10] = _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(aa, bb)));
+		e[11] = _mm256_setzero_ps();
+		for (int r = 0; r < 3; ++r) {
+			__m256d m0 = _mm256_set1_pd(v.m[r * 3]);
+			__m256d m1 = _mm256_set1_pd(v.m[r * 3 + 1]);
+			__m256d m2 = _mm256_set1_pd(v.m[r * 3 + 2]);
+			__m256d t = _mm256_set1_pd(v.t[r]);
+			__m128 halves[2];
+			for (int h = 0; h < 2; ++h) {
+				size_t j = h * 4;
+				__m256d p = _mm256_add_pd(t,
+						_mm256_mul_pd(m0, _mm256_loadu_pd(l.tx + j)));
+				p = _mm256_add_pd(p,
+						_mm256_mul_pd(m1, _mm256_loadu_pd(l.ty + j)));
+				p = _mm256_add_pd(p,
+						_mm256_mul_pd(m2, _mm256_loadu_pd(l.tz + j)));
+				halves[h] = _mm256_cvtpd_ps(p);
+			}
+			e[12 + r] = _mm256_insertf128_ps(
+					_mm256_castps128_ps256(halves[0]), halves[1], 1);
+		}
+		e[15] = one;
+
+		__m128 lo[16];
+		__m128 hi[16];
+		for (int k = 0; k < 16; ++k) {
+			lo[k] = _mm256_castps256_ps128(e[k]);
+			hi[k] = _mm256_extractf128_ps(e[k], 1);
+		}
+		// storeLanes is sse2, avoid penalty of mixing it with avx state
+		_mm256_zeroupper();
+		storeLanes(lo, std::min<size_t>(n, 4), modelView, normal);
+		if (n > 4) {
+			storeLanes(hi, n - 4, modelView + 4 * 16,
+					normal == nullptr ? nullptr : normal + 4 * 9);
+		}
+	}
+#endif
+
+	/*
+	 * view kernel for best instruction set supported
+	 */
+	ToViewKernel toViewKernel() {
+#ifdef SIMD_X86
+		switch (Simd::getLevel()) {
+		case Simd::Level::AVX2:
+			return toViewAvx2;
+		case Simd::Level::SSE2:
+			return toViewSse2;
+		case Simd::Level::SCALAR:
+			break;
+		}
+#endif
+		return toViewScalar;
+	}
 }
 
 /**
@@ -120,7 +412,7 @@ Mat3 Transform::getInverseRotationMatrix() const {
  *
  * @return           script object represented by name
  */
-std::shared_ptr<ScriptObject> Transform::getMember(
+OVERRIDE std::shared_ptr<ScriptObject> ScriptTransform::getMember(
 		ScriptExecutionState & execState, const std::string & name) const {
 	static std::unordered_map<std::string, ScriptObjectPtr> members = {
 			{ "__mul__", std::make_shared<Mul>() } };
@@ -454,12 +746,72 @@ void Transform::translate(const Vec3 & t) {
 	assert(std::isfinite(tz));
 }
 
+/**
+ * Compose view with each of batch of transforms, writing model view
+ * matrices packed column major as OpenGL expects. Translations are
+ * composed in double precision before narrowing to float
+ *
+ * @param view        world to view transform
+ * @param transforms  model to world transforms
+ * @param n           number of transforms
+ * @param modelView   16 floats per transform, model view matrices
+ * @param normal      9 floats per transform, rotation of each model view
+ *                    matrix, or nullptr if not required
+ */
+STATIC void Transform::toViewMatrices(const Transform & view,
+		const Transform * transforms, size_t n, float * modelView,
+		float * normal) {
+	ViewTerms v;
+	v.x = view.rx;
+	v.y = view.ry;
+	v.z = view.rz;
+	v.w = view.rw;
+
+	double x = view.rx;
+	double y = view.ry;
+	double z = view.rz;
+	double w = view.rw;
+	v.m[0] = 1 - 2 * (y * y + z * z);
+	v.m[1] = 2 * (x * y - z * w);
+	v.m[2] = 2 * (x * z + y * w);
+	v.m[3] = 2 * (x * y + z * w);
+	v.m[4] = 1 - 2 * (x * x + z * z);
+	v.m[5] = 2 * (y * z - x * w);
+	v.m[6] = 2 * (x * z - y * w);
+	v.m[7] = 2 * (y * z + x * w);
+	v.m[8] = 1 - 2 * (x * x + y * y);
+	v.t[0] = view.tx;
+	v.t[1] = view.ty;
+	v.t[2] = view.tz;
+
+	static auto kernel = toViewKernel();
+
+	Lanes l;
+	for (size_t i = 0; i < n; i += nLanes) {
+		size_t count = std::min(n - i, nLanes);
+		for (size_t j = 0; j < nLanes; ++j) {
+			bool used = j < count;
+			const Transform & t = transforms[used ? i + j : i];
+			l.x[j] = used ? t.rx : 0;
+			l.y[j] = used ? t.ry : 0;
+			l.z[j] = used ? t.rz : 0;
+			l.w[j] = used ? t.rw : 0;
+			l.tx[j] = used ? t.tx : 0;
+			l.ty[j] = used ? t.ty : 0;
+			l.tz[j] = used ? t.tz : 0;
+		}
+
+		kernel(v, l, count, modelView + i * 16,
+				normal == nullptr ? nullptr : normal + i * 9);
+	}
+}
+
 /**
  * get script object factory for Transform
  *
  * @return  Transform factory
  */
-STATIC ScriptObjectPtr Transform::getFactory() {
+STATIC ScriptObjectPtr ScriptTransform::getFactory() {
 	static auto factory = std::static_pointer_cast<ScriptObject>(
 			std::make_shared<Factory>());
 	return factory;
@@ -6,12 +6,19 @@
 #include "vec3.h"
 
 #include "../scripting/scriptObject.h"
+#include "../scripting/scriptType.h"
 
-class Transform final: public ScriptObject {
+/**
+ * plain rotation and translation, ScriptTransform represents it in
+ * scripts
+ */
+class Transform final {
 public:
 
 	Transform(const Transform &) = default;
 
+	Transform & operator=(const Transform &) = default;
+
 	/**
 	 * construct, no rotation, no translation
 	 */
@@ -38,7 +45,7 @@ public:
 	/**
 	 * default destructor
 	 */
-	inline virtual ~Transform() = default;
+	inline ~Transform() = default;
 
 	/**
 	 * transform as mat4
@@ -63,17 +70,6 @@ public:
 	 */
 	Mat3 getInverseRotationMatrix() const;
 
-	/**
-	 * get named script object member
-	 *
-	 * @param execState  current script execution state
-	 * @param name       name of member
-	 *
-	 * @return           script object represented by name
-	 */
-	std::shared_ptr<ScriptObject> getMember(ScriptExecutionState & execState,
-			const std::string & name) const;
-
 	/**
 	 * get transform rotation
 	 *
@@ -269,11 +265,20 @@ public:
 	void translate(const Vec3 & t);
 
 	/**
-	 * get script object factory for Transform
-	 *
-	 * @return  Transform factory
+	 * Compose view with each of batch of transforms, writing model view
+	 * matrices packed column major as OpenGL expects. Translations are
+	 * composed in double precision before narrowing to float
+	 *
+	 * @param view        world to view transform
+	 * @param transforms  model to world transforms
+	 * @param n           number of transforms
+	 * @param modelView   16 floats per transform, model view matrices
+	 * @param normal      9 floats per transform, rotation of each model view
+	 *                    matrix, or nullptr if not required
 	 */
-	static ScriptObjectPtr getFactory();
+	static void toViewMatrices(const Transform & view,
+			const Transform * transforms, size_t n, float * modelView,
+			float * normal);
 
 private:
 	float rx;
@@ -285,3 +290,51 @@ private:
 	double tz;
 };
 
+/**
+ * script object holding Transform
+ */
+class ScriptTransform final: public ScriptObject {
+public:
+
+	inline explicit ScriptTransform(const Transform & value) :
+			m_value(value) {
+	}
+
+	inline const Transform & getValue() const {
+		return m_value;
+	}
+
+	/**
+	 * get named script object member
+	 *
+	 * @param execState  current script execution state
+	 * @param name       name of member
+	 *
+	 * @return           script object represented by name
+	 */
+	std::shared_ptr<ScriptObject> getMember(ScriptExecutionState & execState,
+			const std::string & name) const override;
+
+	inline std::string toString() const override {
+		return m_value.toString();
+	}
+
+	/**
+	 * get script object factory for Transform
+	 *
+	 * @return  Transform factory
+	 */
+	static ScriptObjectPtr getFactory();
+
+private:
+	Transform m_value;
+};
+
+template<>
+struct ScriptType<Transform> {
+	typedef ScriptTransform Object;
+
+	static inline const Transform & get(const ScriptObjectPtr & obj) {
+		return std::static_pointer_cast<ScriptTransform>(obj)->getValue();
+	}
+};
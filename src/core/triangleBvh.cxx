@@ -0,0 +1,229 @@
+#include "triangleBvh.h"
+
+#include "triangle.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+	/** triangles per leaf below which splitting is not considered */
+	const uint32_t minSplitSize = 2;
+	/** leaves larger than this are split even if not worthwhile */
+	const uint32_t maxLeafSize = 16;
+	const int nBins = 12;
+	/** triangle bounds padding, so hits on edges aren't lost to rounding */
+	const double padding = 1e-6;
+
+	/*
+	 * bounds as arrays, for axis indexing
+	 */
+	struct Bounds {
+		double min[3];
+		double max[3];
+
+		Bounds() {
+			for (int k = 0; k < 3; ++k) {
+				min[k] = std::numeric_limits<double>::max();
+				max[k] = -std::numeric_limits<double>::max();
+			}
+		}
+
+		void grow(const Bounds & other) {
+			for (int k = 0; k < 3; ++k) {
+				min[k] = std::min(min[k], other.min[k]);
+				max[k] = std::max(max[k], other.max[k]);
+			}
+		}
+
+		void grow(const double * point) {
+			for (int k = 0; k < 3; ++k) {
+				min[k] = std::min(min[k], point[k]);
+				max[k] = std::max(max[k], point[k]);
+			}
+		}
+
+		double area() const {
+			double dx = max[0] - min[0];
+			double dy = max[1] - min[1];
+			double dz = max[2] - min[2];
+			if (dx < 0 || dy < 0 || dz < 0) {
+				return 0;
+			}
+			return 2 * (dx * dy + dy * dz + dz * dx);
+		}
+	};
+
+	/*
+	 * triangle bounds and centre
+	 */
+	struct Primitive {
+		Bounds bounds;
+		double centre[3];
+	};
+
+	/*
+	 * node waiting to be split
+	 */
+	struct Task {
+		uint32_t node;
+		uint32_t first;
+		uint32_t count;
+		size_t depth;
+	};
+}
+
+/**
+ * build hierarchy over triangles
+ *
+ * @param triangles  triangles, indices of which are reported by queries
+ */
+EXPLICIT TriangleBvh::TriangleBvh(const std::vector<Triangle> & triangles) {
+	auto n = static_cast<uint32_t>(triangles.size());
+	if (n == 0) {
+		return;
+	}
+
+	std::vector<Primitive> primitives(n);
+	m_indices.resize(n);
+	for (uint32_t i = 0; i < n; ++i) {
+		const auto bounds = triangles[i].getBounds();
+		auto & primitive = primitives[i];
+		double lo[3] = { bounds.getMin().getX() - padding,
+				bounds.getMin().getY() - padding,
+				bounds.getMin().getZ() - padding };
+		double hi[3] = { bounds.getMax().getX() + padding,
+				bounds.getMax().getY() + padding,
+				bounds.getMax().getZ() + padding };
+		primitive.bounds.grow(lo);
+		primitive.bounds.grow(hi);
+		for (int k = 0; k < 3; ++k) {
+			primitive.centre[k] = (lo[k] + hi[k]) * .5;
+		}
+		m_indices[i] = i;
+	}
+
+	m_nodes.reserve(2 * n);
+	m_nodes.emplace_back();
+
+	std::vector<Task> tasks;
+	tasks.push_back({ 0, 0, n, 1 });
+	while (tasks.empty() == false) {
+		auto task = tasks.back();
+		tasks.pop_back();
+
+		auto begin = m_indices.begin() + task.first;
+		auto end = begin + task.count;
+
+		Bounds bounds;
+		Bounds centres;
+		for (auto it = begin; it != end; ++it) {
+			bounds.grow(primitives[*it].bounds);
+			centres.grow(primitives[*it].centre);
+		}
+		auto & node = m_nodes[task.node];
+		for (int k = 0; k < 3; ++k) {
+			node.min[k] = bounds.min[k];
+			node.max[k] = bounds.max[k];
+		}
+		node.first = task.first;
+		node.count = task.count;
+
+		// stack depth in queries grows with tree depth
+		if (task.count < minSplitSize || task.depth + 2 >= maxDepth) {
+			continue;
+		}
+
+		// best binned split over all axes
+		int bestAxis = -1;
+		int bestBin = 0;
+		double bestCost = std::numeric_limits<double>::max();
+		for (int axis = 0; axis < 3; ++axis) {
+			double lo = centres.min[axis];
+			double extent = centres.max[axis] - lo;
+			if (extent <= 0) {
+				continue;
+			}
+			double scale = nBins / extent;
+
+			Bounds binBounds[nBins];
+			uint32_t binCounts[nBins] = { 0 };
+			for (auto it = begin; it != end; ++it) {
+				const auto & primitive = primitives[*it];
+				int bin = std::min(nBins - 1, static_cast<int>(
+						(primitive.centre[axis] - lo) * scale));
+				binBounds[bin].grow(primitive.bounds);
+				++binCounts[bin];
+			}
+
+			// sweep from right, then from left evaluating each plane
+			double rightArea[nBins];
+			uint32_t rightCount[nBins];
+			Bounds right;
+			uint32_t count = 0;
+			for (int b = nBins - 1; b > 0; --b) {
+				right.grow(binBounds[b]);
+				count += binCounts[b];
+				rightArea[b] = right.area();
+				rightCount[b] = count;
+			}
+			Bounds left;
+			count = 0;
+			for (int b = 0; b < nBins - 1; ++b) {
+				left.grow(binBounds[b]);
+				count += binCounts[b];
+				if (count == 0 || rightCount[b + 1] == 0) {
+					continue;
+				}
+				double cost = left.area() * count
+						+ rightArea[b + 1] * rightCount[b + 1];
+				if (cost < bestCost) {
+					bestCost = cost;
+					bestAxis = axis;
+					bestBin = b;
+				}
+			}
+		}
+
+		// split only if cheaper than testing every triangle in leaf, one
+		// unit of traversal cost relative to triangle test
+		double area = bounds.area();
+		double leafCost = task.count;
+		double splitCost = area > 0 ?
+				1 + bestCost / area : std::numeric_limits<double>::max();
+		if (splitCost >= leafCost && task.count <= maxLeafSize) {
+			continue;
+		}
+
+		decltype(begin) middle;
+		if (bestAxis >= 0) {
+			double lo = centres.min[bestAxis];
+			double scale = nBins / (centres.max[bestAxis] - lo);
+			middle = std::partition(begin, end, [&](uint32_t i) {
+				return std::min(nBins - 1, static_cast<int>(
+						(primitives[i].centre[bestAxis] - lo) * scale))
+						<= bestBin;
+			});
+		} else {
+			// coincident centres, split in half
+			middle = begin + task.count / 2;
+		}
+
+		auto leftCount = static_cast<uint32_t>(middle - begin);
+		auto child = static_cast<uint32_t>(m_nodes.size());
+		m_nodes[task.node].first = child;
+		m_nodes[task.node].count = 0;
+		m_nodes.emplace_back();
+		m_nodes.emplace_back();
+
+		tasks.push_back({ child + 1, task.first + leftCount,
+				task.count - leftCount, task.depth + 1 });
+		tasks.push_back({ child, task.first, leftCount, task.depth + 1 });
+	}
+	m_nodes.shrink_to_fit();
+}
+
+/**
+ * destructor
+ */
+TriangleBvh::~TriangleBvh() {
+}
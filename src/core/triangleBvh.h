@@ -0,0 +1,160 @@
+#pragma once
+
+#include "boundingBox.h"
+#include "vec3.h"
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class Triangle;
+
+/*
+ * Static bounding volume hierarchy over triangles, built once with binned
+ * surface area heuristic splits and stored as a flat node array. Queries
+ * report indices of triangles whose bounds are hit, leaving exact tests to
+ * the caller
+ */
+class TriangleBvh {
+public:
+
+	/**
+	 * build hierarchy over triangles
+	 *
+	 * @param triangles  triangles, indices of which are reported by queries
+	 */
+	explicit TriangleBvh(const std::vector<Triangle> & triangles);
+
+	/**
+	 * destructor
+	 */
+	~TriangleBvh();
+
+	/**
+	 * call function with index of each triangle whose bounds intersect box,
+	 * touching counts as intersecting
+	 *
+	 * @param box  box to test
+	 * @param fn   function taking triangle index
+	 */
+	template<typename FUNC>
+	void intersect(const BoundingBox & box, FUNC & fn) const {
+		if (m_nodes.empty()) {
+			return;
+		}
+		const auto & bmin = box.getMin();
+		const auto & bmax = box.getMax();
+		double lo[3] = { bmin.getX(), bmin.getY(), bmin.getZ() };
+		double hi[3] = { bmax.getX(), bmax.getY(), bmax.getZ() };
+
+		std::array<uint32_t, maxDepth> stack;
+		size_t top = 0;
+		stack[top++] = 0;
+		while (top != 0) {
+			const auto & node = m_nodes[stack[--top]];
+			if (node.min[0] > hi[0] || lo[0] > node.max[0]
+					|| node.min[1] > hi[1] || lo[1] > node.max[1]
+					|| node.min[2] > hi[2] || lo[2] > node.max[2]) {
+				continue;
+			}
+			if (node.count != 0) {
+				for (uint32_t i = 0; i < node.count; ++i) {
+					fn(static_cast<size_t>(m_indices[node.first + i]));
+				}
+			} else {
+				stack[top++] = node.first + 1;
+				stack[top++] = node.first;
+			}
+		}
+	}
+
+	/**
+	 * call function with index of each triangle whose bounds intersect
+	 * line p + t·d for t in range [tmin, tmax], infinite range allowed
+	 *
+	 * @param p     point on line
+	 * @param d     direction of line, need not be unit length
+	 * @param tmin  start of range
+	 * @param tmax  end of range
+	 * @param fn    function taking triangle index
+	 */
+	template<typename FUNC>
+	void intersectLine(const Vec3 & p, const Vec3 & d, double tmin,
+			double tmax, FUNC & fn) const {
+		if (m_nodes.empty()) {
+			return;
+		}
+		double o[3] = { p.getX(), p.getY(), p.getZ() };
+		double dir[3] = { d.getX(), d.getY(), d.getZ() };
+		double inv[3];
+		for (int k = 0; k < 3; ++k) {
+			inv[k] = dir[k] == 0 ? 0 : 1 / dir[k];
+		}
+
+		std::array<uint32_t, maxDepth> stack;
+		size_t top = 0;
+		stack[top++] = 0;
+		while (top != 0) {
+			const auto & node = m_nodes[stack[--top]];
+			if (slabs(node, o, dir, inv, tmin, tmax) == false) {
+				continue;
+			}
+			if (node.count != 0) {
+				for (uint32_t i = 0; i < node.count; ++i) {
+					fn(static_cast<size_t>(m_indices[node.first + i]));
+				}
+			} else {
+				stack[top++] = node.first + 1;
+				stack[top++] = node.first;
+			}
+		}
+	}
+
+private:
+	/** split depth is limited in build, so stack never overflows */
+	static const size_t maxDepth = 64;
+
+	/*
+	 * internal node when count is zero with children at first and first + 1,
+	 * otherwise leaf of count triangle indices starting at first
+	 */
+	struct Node {
+		double min[3];
+		double max[3];
+		uint32_t first;
+		uint32_t count;
+	};
+
+	std::vector<Node> m_nodes;
+	std::vector<uint32_t> m_indices;
+
+	/*
+	 * clip line range against node bounds, axes line is parallel to are
+	 * tested for containment
+	 */
+	static inline bool slabs(const Node & node, const double * o,
+			const double * dir, const double * inv, double tmin,
+			double tmax) {
+		for (int k = 0; k < 3; ++k) {
+			if (dir[k] == 0) {
+				if (o[k] < node.min[k] || o[k] > node.max[k]) {
+					return false;
+				}
+				continue;
+			}
+			double t0 = (node.min[k] - o[k]) * inv[k];
+			double t1 = (node.max[k] - o[k]) * inv[k];
+			if (t0 > t1) {
+				std::swap(t0, t1);
+			}
+			tmin = t0 > tmin ? t0 : tmin;
+			tmax = t1 < tmax ? t1 : tmax;
+			if (tmin > tmax) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
@@ -5,6 +5,7 @@
 #include "intersection.h"
 #include "plane.h"
 #include "ray.h"
+#include "triangleBvh.h"
 #include "vec3Array.h"
 
 #include <limits>
@@ -253,6 +254,9 @@ TriangleList::TriangleList() {
  */
 TriangleList::TriangleList(const std::vector<Triangle> & triangles) :
 		triangles(triangles) {
+	if (triangles.empty() == false) {
+		bvh = std::make_shared<TriangleBvh>(triangles);
+	}
 }
 
 /**
@@ -271,6 +275,9 @@ TriangleList::TriangleList(const IndexArray & indices,
 				vertices.get(indices.get(i + 1)),
 				vertices.get(indices.get(i + 2)));
 	}
+	if (triangles.empty() == false) {
+		bvh = std::make_shared<TriangleBvh>(triangles);
+	}
 }
 
 /**
@@ -283,7 +290,7 @@ TriangleList::TriangleList(const IndexArray & indices,
 */
 bool TriangleList::intersection(const BoundingBox & box,
 		Intersection & intersection) const {
-	auto tris = intersectionTriangles(triangles, box);
+	auto tris = intersectionTriangles(candidates(box), box);
 	if (tris.size() == 0) {
 		return false;
 	}
@@ -312,15 +319,8 @@ bool TriangleList::intersection(const BoundingBox & box,
 			Vec3(max.getX(), max.getY(), min.getZ()),
 			Vec3(max.getX(), max.getY(), max.getZ()) };
 
-	for (const auto & t : triangles) {
-		for (const auto & v : boxVertices) {
-			Vec3 q;
-			double d = 0;
-
-			if (t.intersectRay(v, n, q, d) && d > maxDist) {
-				maxDist = d;
-			}
-		}
+	for (const auto & v : boxVertices) {
+		depthAlongRay(v, n, maxDist);
 	}
 
 	if (maxDist == -std::numeric_limits<double>::max()) {
@@ -341,7 +341,7 @@ bool TriangleList::intersection(const BoundingBox & box,
 */
 bool TriangleList::intersection(const ConvexHull & hull,
 		Intersection & intersection) const {
-	auto tris = intersectionTriangles(triangles, hull);
+	auto tris = intersectionTriangles(candidates(hull.getBounds()), hull);
 	if (tris.size() == 0) {
 		return false;
 	}
@@ -358,15 +358,8 @@ bool TriangleList::intersection(const ConvexHull & hull,
 
 	double maxDist = -std::numeric_limits<double>::max();
 
-	for (const auto & t : triangles) {
-		for (const auto & v : hull.getVertices()) {
-			Vec3 q;
-			double d = 0;
-
-			if (t.intersectRay(v, n, q, d) && d > maxDist) {
-				maxDist = d;
-			}
-		}
+	for (const auto & v : hull.getVertices()) {
+		depthAlongRay(v, n, maxDist);
 	}
 
 	if (maxDist == -std::numeric_limits<double>::max()) {
@@ -412,14 +405,14 @@ bool TriangleList::rayIntersection(const Ray & ray, Vec3 & point,
 
 	int negativeDistanceCount = 0;
 
-	for (const auto & t : triangles) {
+	auto test = [&](const Triangle & t) {
 		Vec3 p;
 		double d;
 
 		if (t.intersectsExtendedLineSegment(ray.getStart(), ray.getEnd(), p, d)
 				== false) {
 			// no intersection
-			continue;
+			return;
 		}
 
 		if (d < 0.0) {
@@ -434,6 +427,20 @@ bool TriangleList::rayIntersection(const Ray & ray, Vec3 & point,
 				minPositivePoint = p;
 			}
 		}
+	};
+
+	if (bvh != nullptr) {
+		// whole line, both directions
+		auto fn = [&](size_t index) {
+			test(triangles[index]);
+		};
+		bvh->intersectLine(ray.getStart(), ray.getEnd() - ray.getStart(),
+				-std::numeric_limits<double>::infinity(),
+				std::numeric_limits<double>::infinity(), fn);
+	} else {
+		for (const auto & t : triangles) {
+			test(t);
+		}
 	}
 
 	if (negativeDistanceCount % 2 == 1) {
@@ -458,3 +465,57 @@ bool TriangleList::rayIntersection(const Ray & ray, Vec3 & point,
 	return true;
 }
 
+
+/**
+ * get triangles whose bounds touch box, grown by clipping tolerance so no
+ * triangle clipping could keep is missed
+ *
+ * @param box  box to test
+ *
+ * @return     candidate triangles
+ */
+PRIVATE std::vector<Triangle> TriangleList::candidates(
+		const BoundingBox & box) const {
+	if (bvh == nullptr) {
+		return triangles;
+	}
+	Vec3 margin(e, e, e);
+	std::vector<Triangle> result;
+	auto fn = [&](size_t index) {
+		result.emplace_back(triangles[index]);
+	};
+	bvh->intersect(BoundingBox(box.getMin() - margin, box.getMax() + margin),
+			fn);
+	return result;
+}
+
+/**
+ * cast ray against triangles, keeping furthest hit distance
+ *
+ * @param p        start of ray
+ * @param n        direction of ray
+ * @param maxDist  furthest distance, updated if further hit
+ */
+PRIVATE void TriangleList::depthAlongRay(const Vec3 & p, const Normal & n,
+		double & maxDist) const {
+	auto test = [&](const Triangle & t) {
+		Vec3 q;
+		double d = 0;
+
+		if (t.intersectRay(p, n, q, d) && d > maxDist) {
+			maxDist = d;
+		}
+	};
+
+	if (bvh == nullptr) {
+		for (const auto & t : triangles) {
+			test(t);
+		}
+		return;
+	}
+	auto fn = [&](size_t index) {
+		test(triangles[index]);
+	};
+	bvh->intersectLine(p, Vec3(n.getX(), n.getY(), n.getZ()), 0,
+			std::numeric_limits<double>::infinity(), fn);
+}
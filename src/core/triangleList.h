@@ -2,10 +2,12 @@
 
 #include "triangle.h"
 
+#include <memory>
 #include <vector>
 
 class ConvexHull;
 class IndexArray;
+class TriangleBvh;
 class Vec3Array;
 
 class TriangleList {
@@ -31,8 +33,14 @@ public:
 	 */
 	TriangleList(const IndexArray & indices, const Vec3Array & vertices);
 
+	/**
+	 * add triangle, list built this way is queried without hierarchy
+	 *
+	 * @param triangle  triangle to add
+	 */
 	inline void add(const Triangle & triangle) {
 		triangles.emplace_back(triangle);
+		bvh = nullptr;
 	}
 
 	inline std::vector<Triangle>::const_iterator begin() const {
@@ -101,5 +109,12 @@ public:
 
 private:
 	std::vector<Triangle> triangles;
+	/** built on construction, shared between copies */
+	std::shared_ptr<const TriangleBvh> bvh;
+
+	std::vector<Triangle> candidates(const BoundingBox & box) const;
+
+	void depthAlongRay(const Vec3 & p, const Normal & n,
+			double & maxDist) const;
 };
 
@@ -30,7 +30,7 @@ namespace {
 			double y = getNumericArg(stack,2);
 			double z = getNumericArg(stack,3);
 
-			stack.emplace(std::make_shared<Vec3>(x, y, z));
+			stack.emplace(std::make_shared<ScriptVec3>(Vec3(x, y, z)));
 		}
 	};
 
@@ -42,11 +42,11 @@ namespace {
 				std::stack<ScriptObjectPtr> & stack) const override {
 			checkNumArgs(nArgs, 1);
 
-			auto vec3Ptr = std::static_pointer_cast<Vec3>(self);
+			const auto & vec3 = ScriptType<Vec3>::get(self);
 
 			auto other = getArg<Vec3>("vec3", stack, 1);
 
-			stack.emplace(std::make_shared<Vec3>(*vec3Ptr + other));
+			stack.emplace(std::make_shared<ScriptVec3>(vec3 + other));
 		}
 	};
 
@@ -58,19 +58,19 @@ namespace {
 				std::stack<ScriptObjectPtr> & stack) const override {
 			checkNumArgs(nArgs, 1);
 
-			auto vec3Ptr = std::static_pointer_cast<Vec3>(self);
+			const auto & vec3 = ScriptType<Vec3>::get(self);
 
 			auto arg = stack.top();
 			stack.pop();
 
-			if (typeid(*arg) == typeid(Vec3)) {
-				auto v = *std::static_pointer_cast<Vec3>(arg);
+			if (typeid(*arg) == typeid(ScriptVec3)) {
+				auto v = ScriptType<Vec3>::get(arg);
 
-				stack.emplace(std::make_shared<Vec3>(vec3Ptr->cross(v)));
-			} else if (typeid(*arg) == typeid(Normal)) {
-				auto n = *std::static_pointer_cast<Normal>(arg);
+				stack.emplace(std::make_shared<ScriptVec3>(vec3.cross(v)));
+			} else if (typeid(*arg) == typeid(ScriptNormal)) {
+				auto n = ScriptType<Normal>::get(arg);
 
-				stack.emplace(std::make_shared<Vec3>(vec3Ptr->cross(n)));
+				stack.emplace(std::make_shared<ScriptVec3>(vec3.cross(n)));
 			} else {
 				scriptExecutionAssert(false,
 						"Require Vec3 or Normal as argument to cross");
@@ -86,11 +86,11 @@ namespace {
 				std::stack<ScriptObjectPtr> & stack) const override {
 			checkNumArgs(nArgs, 1);
 
-			auto vec3Ptr = std::static_pointer_cast<Vec3>(self);
+			const auto & vec3 = ScriptType<Vec3>::get(self);
 
 			auto scale = getNumericArg(stack, 1);
 
-			stack.emplace(std::make_shared<Vec3>(*vec3Ptr / scale));
+			stack.emplace(std::make_shared<ScriptVec3>(vec3 / scale));
 		}
 	};
 
@@ -102,11 +102,11 @@ namespace {
 				std::stack<ScriptObjectPtr> & stack) const override {
 			checkNumArgs(nArgs, 1);
 
-			auto vec3Ptr = std::static_pointer_cast<Vec3>(self);
+			const auto & vec3 = ScriptType<Vec3>::get(self);
 
 			auto other = getArg<Vec3>("vec3", stack, 1);
 
-			stack.emplace(std::make_shared<Real>(vec3Ptr->dot(other)));
+			stack.emplace(std::make_shared<Real>(vec3.dot(other)));
 		}
 	};
 
@@ -119,7 +119,7 @@ namespace {
 			checkNumArgs(nArgs, 1);
 
 			auto target = getArg<Vec3>("Vec3", stack, 1);
-			auto vec = *std::static_pointer_cast<Vec3>(self) - target;
+			auto vec = ScriptType<Vec3>::get(self) - target;
 
 			Normal fwd(0.f, 1.f, 0.f);
 			if (vec.length() != 0) {
@@ -133,7 +133,7 @@ namespace {
 					fwd.getY(), right.getZ(), up.getZ(), fwd.getZ());
 			auto r = m.asQuat();
 
-			stack.push(std::make_shared<Quat>(r));
+			stack.push(std::make_shared<ScriptQuat>(r));
 		}
 	};
 
@@ -145,9 +145,9 @@ namespace {
 				std::stack<ScriptObjectPtr> & stack) const override {
 			checkNumArgs(nArgs, 0);
 
-			auto vec3Ptr = std::static_pointer_cast<Vec3>(self);
+			const auto & vec3 = ScriptType<Vec3>::get(self);
 
-			stack.emplace(std::make_shared<Real>(vec3Ptr->length()));
+			stack.emplace(std::make_shared<Real>(vec3.length()));
 		}
 	};
 
@@ -159,11 +159,11 @@ namespace {
 				std::stack<ScriptObjectPtr> & stack) const override {
 			checkNumArgs(nArgs, 1);
 
-			auto vec3Ptr = std::static_pointer_cast<Vec3>(self);
+			const auto & vec3 = ScriptType<Vec3>::get(self);
 
 			auto scale = getNumericArg(stack, 1);
 
-			stack.emplace(std::make_shared<Vec3>(*vec3Ptr * scale));
+			stack.emplace(std::make_shared<ScriptVec3>(vec3 * scale));
 		}
 	};
 
@@ -175,11 +175,11 @@ namespace {
 				std::stack<ScriptObjectPtr> & stack) const override {
 			checkNumArgs(nArgs, 1);
 
-			auto vec3Ptr = std::static_pointer_cast<Vec3>(self);
+			const auto & vec3 = ScriptType<Vec3>::get(self);
 
 			auto other = getArg<Vec3>("vec3", stack, 1);
 
-			stack.emplace(std::make_shared<Vec3>(*vec3Ptr - other));
+			stack.emplace(std::make_shared<ScriptVec3>(vec3 - other));
 		}
 	};
 }
@@ -199,7 +199,7 @@ Vec3::Vec3(double x, double y, double z) :
  *
  * @return           script object represented by name
  */
-OVERRIDE ScriptObjectPtr Vec3::getMember(ScriptExecutionState & execState,
+OVERRIDE ScriptObjectPtr ScriptVec3::getMember(ScriptExecutionState & execState,
 		const std::string & name) const {
 	static std::unordered_map<std::string, ScriptObjectPtr> members = {
 			{"__add__", std::make_shared<Add>() },
@@ -212,11 +212,11 @@ OVERRIDE ScriptObjectPtr Vec3::getMember(ScriptExecutionState & execState,
 			{"__sub__", std::make_shared<Sub>() } };
 
 	if (name == "x") {
-		return std::make_shared<Real>(m_x);
+		return std::make_shared<Real>(m_value.getX());
 	} else if (name == "y") {
-		return std::make_shared<Real>(m_y);
+		return std::make_shared<Real>(m_value.getY());
 	} else if (name == "z") {
-		return std::make_shared<Real>(m_z);
+		return std::make_shared<Real>(m_value.getZ());
 	}
 
 	auto entry = members.find(name);
@@ -293,14 +293,14 @@ void Vec3::scaleAdd(double s, const Vec3 & v) {
  * @param name   name of member
  * @param value  desired value
  */
-OVERRIDE void Vec3::setMember(const std::string & name,
+OVERRIDE void ScriptVec3::setMember(const std::string & name,
 		const ScriptObjectPtr & value) {
 	if (name == "x") {
-		m_x = std::static_pointer_cast<Real>(value)->getValue();
+		m_value.setX(std::static_pointer_cast<Real>(value)->getValue());
 	} else if (name == "y") {
-		m_y = std::static_pointer_cast<Real>(value)->getValue();
+		m_value.setY(std::static_pointer_cast<Real>(value)->getValue());
 	} else if (name == "z") {
-		m_z = std::static_pointer_cast<Real>(value)->getValue();
+		m_value.setZ(std::static_pointer_cast<Real>(value)->getValue());
 	} else {
 		scriptExecutionAssert(false, "Can't set member '" + name + "'");
 	}
@@ -311,7 +311,7 @@ OVERRIDE void Vec3::setMember(const std::string & name,
  *
  * @return  Vec3 factory
  */
-STATIC const ScriptObjectPtr & Vec3::getFactory() {
+STATIC const ScriptObjectPtr & ScriptVec3::getFactory() {
 	static auto factory = std::static_pointer_cast<ScriptObject>(
 			std::make_shared<Factory>());
 	return factory;
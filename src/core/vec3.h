@@ -3,10 +3,14 @@
 #include "normal.h"
 
 #include "../scripting/scriptObject.h"
+#include "../scripting/scriptType.h"
 
 #include <string>
 
-class Vec3: public ScriptObject {
+/**
+ * plain vector value, ScriptVec3 represents it in scripts
+ */
+class Vec3 {
 public:
 
 	Vec3(double x, double y, double z);
@@ -15,12 +19,11 @@ public:
 			m_x(0), m_y(0), m_z(0) {
 	}
 
-	inline Vec3(const Vec3 & v) :
-			m_x(v.m_x), m_y(v.m_y), m_z(v.m_z) {
-	}
+	Vec3(const Vec3 &) = default;
 
-	inline ~Vec3() {
-	}
+	~Vec3() = default;
+
+	Vec3 & operator=(const Vec3 &) = default;
 
 	inline Vec3 cross(const Normal & n) const {
 		return Vec3(m_y * n.getZ() - m_z * n.getY(),
@@ -52,17 +55,6 @@ public:
 		return m_x * other.m_x + m_y * other.m_y + m_z * other.m_z;
 	}
 
-	/**
-	 * get named script object member
-	 *
-	 * @param execState  current script execution state
-	 * @param name       name of member
-	 *
-	 * @return           script object represented by name
-	 */
-	ScriptObjectPtr getMember(ScriptExecutionState & execState,
-			const std::string & name) const override;
-
 	inline double getX() const {
 		return m_x;
 	}
@@ -149,15 +141,6 @@ public:
 		m_z = z;
 	}
 
-	/**
-	 * set named script object member
-	 *
-	 * @param name   name of member
-	 * @param value  desired value
-	 */
-	void setMember(const std::string & name, const ScriptObjectPtr & value)
-			override;
-
 	inline void setX(double x) {
 		m_x = x;
 	}
@@ -170,11 +153,55 @@ public:
 		m_z = z;
 	}
 
-	inline std::string toString() const override {
+	inline std::string toString() const {
 		return "Vec3( " + std::to_string(m_x) + ", " + std::to_string(m_y) + ","
 				+ std::to_string(m_z) + " )";
 	}
 
+private:
+	double m_x;
+	double m_y;
+	double m_z;
+};
+
+/**
+ * script object holding Vec3
+ */
+class ScriptVec3 final: public ScriptObject {
+public:
+
+	inline explicit ScriptVec3(const Vec3 & value) :
+			m_value(value) {
+	}
+
+	inline const Vec3 & getValue() const {
+		return m_value;
+	}
+
+	/**
+	 * get named script object member
+	 *
+	 * @param execState  current script execution state
+	 * @param name       name of member
+	 *
+	 * @return           script object represented by name
+	 */
+	ScriptObjectPtr getMember(ScriptExecutionState & execState,
+			const std::string & name) const override;
+
+	/**
+	 * set named script object member
+	 *
+	 * @param name   name of member
+	 * @param value  desired value
+	 */
+	void setMember(const std::string & name, const ScriptObjectPtr & value)
+			override;
+
+	inline std::string toString() const override {
+		return m_value.toString();
+	}
+
 	/**
 	 * get script object factory for Vec3
 	 *
@@ -183,7 +210,14 @@ public:
 	static const ScriptObjectPtr & getFactory();
 
 private:
-	double m_x;
-	double m_y;
-	double m_z;
+	Vec3 m_value;
+};
+
+template<>
+struct ScriptType<Vec3> {
+	typedef ScriptVec3 Object;
+
+	static inline const Vec3 & get(const ScriptObjectPtr & obj) {
+		return std::static_pointer_cast<ScriptVec3>(obj)->getValue();
+	}
 };
@@ -4,6 +4,8 @@
 #include "binaryFileCache.h"
 #include "boundingBox.h"
 #include "mat4.h"
+#include "normal.h"
+#include "simd.h"
 #include "transform.h"
 #include "vec3.h"
 
@@ -17,8 +19,10 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cassert>
 #include <cstring>
 #include <limits>
+#include <mutex>
 #include <vector>
 
 namespace {
@@ -48,7 +52,7 @@ namespace {
 				for (const auto & e : list) {
 					scriptExecutionAssertType<Vec3>(e, "Require vertex list");
 
-					vertices.emplace_back(*std::static_pointer_cast<Vec3>(e));
+					vertices.emplace_back(ScriptType<Vec3>::get(e));
 				}
 
 				stack.emplace(std::make_shared<Vec3Array>(vertices));
@@ -73,11 +77,452 @@ namespace {
 							count->getInt32()));
 		}
 	};
+
+	/*
+	 * kernels over structure of arrays vertex coordinates, directions and
+	 * matrices in double so results match Vec3 arithmetic exactly
+	 */
+	struct Kernels {
+		void (*minMax)(const double * x, const double * y, const double * z,
+				size_t n, const double * d, double & minDist,
+				double & maxDist);
+		void (*argMinMax)(const double * x, const double * y,
+				const double * z, size_t n, const double * d, size_t & minIdx,
+				size_t & maxIdx, double & minDist, double & maxDist);
+		void (*bounds)(const double * x, const double * y, const double * z,
+				size_t n, double * lo, double * hi);
+		void (*transform)(const double * m, const double * x,
+				const double * y, const double * z, size_t n, double * ox,
+				double * oy, double * oz);
+	};
+
+	/*
+	 * scalar min and max distance, from vertex 'i' onwards
+	 */
+	void minMaxScalar(const double * x, const double * y, const double * z,
+			size_t i, size_t n, const double * d, double & minDist,
+			double & maxDist) {
+		for (; i < n; ++i) {
+			double dist = x[i] * d[0] + y[i] * d[1] + z[i] * d[2];
+			minDist = std::min(minDist, dist);
+			maxDist = std::max(maxDist, dist);
+		}
+	}
+
+	/*
+	 * scalar index of first min and max distance, from vertex 'i' onwards
+	 */
+	void argMinMaxScalar(const double * x, const double * y,
+			const double * z, size_t i, size_t n, const double * d,
+			size_t & minIdx, size_t & maxIdx, double & minDist,
+			double & maxDist) {
+		for (; i < n; ++i) {
+			double dist = x[i] * d[0] + y[i] * d[1] + z[i] * d[2];
+			if (dist < minDist) {
+				minDist = dist;
+				minIdx = i;
+			}
+			if (dist > maxDist) {
+				maxDist = dist;
+				maxIdx = i;
+			}
+		}
+	}
+
+	/*
+	 * scalar bounds, from vertex 'i' onwards
+	 */
+	void boundsScalar(const double * x, const double * y, const double * z,
+			size_t i, size_t n, double * lo, double * hi) {
+		for (; i < n; ++i) {
+			lo[0] = std::min(lo[0], x[i]);
+			lo[1] = std::min(lo[1], y[i]);
+			lo[2] = std::min(lo[2], z[i]);
+			hi[0] = std::max(hi[0], x[i]);
+			hi[1] = std::max(hi[1], y[i]);
+			hi[2] = std::max(hi[2], z[i]);
+		}
+	}
+
+	/*
+	 * scalar transform by row major 4x4 matrix, from vertex 'i' onwards
+	 */
+	void transformScalar(const double * m, const double * x,
+			const double * y, const double * z, size_t i, size_t n,
+			double * ox, double * oy, double * oz) {
+		for (; i < n; ++i) {
+			double tx = m[0] * x[i] + m[1] * y[i] + m[2] * z[i] + m[3];
+			double ty = m[4] * x[i] + m[5] * y[i] + m[6] * z[i] + m[7];
+			double tz = m[8] * x[i] + m[9] * y[i] + m[10] * z[i] + m[11];
+			double tw = m[12] * x[i] + m[13] * y[i] + m[14] * z[i] + m[15];
+			double s = 1.0 / tw;
+			ox[i] = tx * s;
+			oy[i] = ty * s;
+			oz[i] = tz * s;
+		}
+	}
+
+	const Kernels scalarKernels = {
+			[](const double * x, const double * y, const double * z, size_t n,
+					const double * d, double & minDist, double & maxDist) {
+				minMaxScalar(x, y, z, 0, n, d, minDist, maxDist);
+			},
+			[](const double * x, const double * y, const double * z, size_t n,
+					const double * d, size_t & minIdx, size_t & maxIdx,
+					double & minDist, double & maxDist) {
+				argMinMaxScalar(x, y, z, 0, n, d, minIdx, maxIdx, minDist,
+						maxDist);
+			},
+			[](const double * x, const double * y, const double * z, size_t n,
+					double * lo, double * hi) {
+				boundsScalar(x, y, z, 0, n, lo, hi);
+			},
+			[](const double * m, const double * x, const double * y,
+					const double * z, size_t n, double * ox, double * oy,
+					double * oz) {
+				transformScalar(m, x, y, z, 0, n, ox, oy, oz);
+			} };
+
+#ifdef SIMD_X86
+	/*
+	 * reduce lanes to first min and max, lower index wins ties
+	 */
+	void reduceArgMinMax(const double * minLanes, const double * minIdxLanes,
+			const double * maxLanes, const double * maxIdxLanes,
+			unsigned nLanes, size_t & minIdx, size_t & maxIdx,
+			double & minDist, double & maxDist) {
+		double minI = 0;
+		double maxI = 0;
+		for (unsigned l = 0; l < nLanes; ++l) {
+			if (minLanes[l] < minDist
+					|| (minLanes[l] == minDist && minIdxLanes[l] < minI)) {
+				minDist = minLanes[l];
+				minI = minIdxLanes[l];
+			}
+			if (maxLanes[l] > maxDist
+					|| (maxLanes[l] == maxDist && maxIdxLanes[l] < maxI)) {
+				maxDist = maxLanes[l];
+				maxI = maxIdxLanes[l];
+			}
+		}
+		minIdx = static_cast<size_t>(minI);
+		maxIdx = static_cast<size_t>(maxI);
+	}
+
+	/*
+	 * sse2, two vertices at a time
+	 */
+	SIMD_TARGET_SSE2 void minMaxSse2(const double * x, const double * y,
+			const double * z, size_t n, const double * d, double & minDist,
+			double & maxDist) {
+		__m128d dx = _mm_set1_pd(d[0]);
+		__m128d dy = _mm_set1_pd(d[1]);
+		__m128d dz = _mm_set1_pd(d[2]);
+		__m128d lo = _mm_set1_pd(minDist);
+		__m128d hi = _mm_set1_pd(maxDist);
+		size_t i = 0;
+		for (; i + 2 <= n; i += 2) {
+			__m128d dist = _mm_add_pd(
+					_mm_add_pd(_mm_mul_pd(_mm_loadu_pd(x + i), dx),
+							_mm_mul_pd(_mm_loadu_pd(y + i), dy)),
+					_mm_mul_pd(_mm_loadu_pd(z + i), dz));
+			lo = _mm_min_pd(lo, dist);
+			hi = _mm_max_pd(hi, dist);
+		}
+		double l[2], h[2];
+		_mm_storeu_pd(l, lo);
+		_mm_storeu_pd(h, hi);
+		minDist = std::min(l[0], l[1]);
+		maxDist = std::max(h[0], h[1]);
+		minMaxScalar(x, y, z, i, n, d, minDist, maxDist);
+	}
+
+	/*
+	 * sse2, two vertices at a time
+	 */
+	SIMD_TARGET_SSE2 void argMinMaxSse2(const double * x, const double * y,
+			const double * z, size_t n, const double * d, size_t & minIdx,
+			size_t & maxIdx, double & minDist, double & maxDist) {
+		__m128d dx = _mm_set1_pd(d[0]);
+		__m128d dy = _mm_set1_pd(d[1]);
+		__m128d dz = _mm_set1_pd(d[2]);
+		__m128d lo = _mm_set1_pd(minDist);
+		__m128d hi = _mm_set1_pd(maxDist);
+		__m128d loIdx = _mm_setzero_pd();
+		__m128d hiIdx = _mm_setzero_pd();
+		__m128d idx = _mm_set_pd(1, 0);
+		__m128d step = _mm_set1_pd(2);
+		size_t i = 0;
+		for (; i + 2 <= n; i += 2) {
+			__m128d dist = _mm_add_pd(
+					_mm_add_pd(_mm_mul_pd(_mm_loadu_pd(x + i), dx),
+							_mm_mul_pd(_mm_loadu_pd(y + i), dy)),
+					_mm_mul_pd(_mm_loadu_pd(z + i), dz));
+			__m128d lt = _mm_cmplt_pd(dist, lo);
+			lo = _mm_or_pd(_mm_and_pd(lt, dist), _mm_andnot_pd(lt, lo));
+			loIdx = _mm_or_pd(_mm_and_pd(lt, idx), _mm_andnot_pd(lt, loIdx));
+			__m128d gt = _mm_cmpgt_pd(dist, hi);
+			hi = _mm_or_pd(_mm_and_pd(gt, dist), _mm_andnot_pd(gt, hi));
+			hiIdx = _mm_or_pd(_mm_and_pd(gt, idx), _mm_andnot_pd(gt, hiIdx));
+			idx = _mm_add_pd(idx, step);
+		}
+		if (i > 0) {
+			double l[2], li[2], h[2], hii[2];
+			_mm_storeu_pd(l, lo);
+			_mm_storeu_pd(li, loIdx);
+			_mm_storeu_pd(h, hi);
+			_mm_storeu_pd(hii, hiIdx);
+			reduceArgMinMax(l, li, h, hii, 2, minIdx, maxIdx, minDist,
+					maxDist);
+		}
+		argMinMaxScalar(x, y, z, i, n, d, minIdx, maxIdx, minDist, maxDist);
+	}
+
+	/*
+	 * sse2, two vertices at a time
+	 */
+	SIMD_TARGET_SSE2 void boundsSse2(const double * x, const double * y,
+			const double * z, size_t n, double * lo, double * hi) {
+		__m128d lx = _mm_set1_pd(lo[0]);
+		__m128d ly = _mm_set1_pd(lo[1]);
+		__m128d lz = _mm_set1_pd(lo[2]);
+		__m128d hx = _mm_set1_pd(hi[0]);
+		__m128d hy = _mm_set1_pd(hi[1]);
+		__m128d hz = _mm_set1_pd(hi[2]);
+		size_t i = 0;
+		for (; i + 2 <= n; i += 2) {
+			__m128d vx = _mm_loadu_pd(x + i);
+			__m128d vy = _mm_loadu_pd(y + i);
+			__m128d vz = _mm_loadu_pd(z + i);
+			lx = _mm_min_pd(lx, vx);
+			ly = _mm_min_pd(ly, vy);
+			lz = _mm_min_pd(lz, vz);
+			hx = _mm_max_pd(hx, vx);
+			hy = _mm_max_pd(hy, vy);
+			hz = _mm_max_pd(hz, vz);
+		}
+		double a[2];
+		_mm_storeu_pd(a, lx);
+		lo[0] = std::min(a[0], a[1]);
+		_mm_storeu_pd(a, ly);
+		lo[1] = std::min(a[0], a[1]);
+		_mm_storeu_pd(a, lz);
+		lo[2] = std::min(a[0], a[1]);
+		_mm_storeu_pd(a, hx);
+		hi[0] = std::max(a[0], a[1]);
+		_mm_storeu_pd(a, hy);
+		hi[1] = std::max(a[0], a[1]);
+		_mm_storeu_pd(a, hz);
+		hi[2] = std::max(a[0], a[1]);
+		boundsScalar(x, y, z, i, n, lo, hi);
+	}
+
+	/*
+	 * sse2, two vertices at a time
+	 */
+	SIMD_TARGET_SSE2 void transformSse2(const double * m, const double * x,
+			const double * y, const double * z, size_t n, double * ox,
+			double * oy, double * oz) {
+		__m128d one = _mm_set1_pd(1);
+		size_t i = 0;
+		for (; i + 2 <= n; i += 2) {
+			__m128d vx = _mm_loadu_pd(x + i);
+			__m128d vy = _mm_loadu_pd(y + i);
+			__m128d vz = _mm_loadu_pd(z + i);
+			__m128d r[4];
+			for (int row = 0; row < 4; ++row) {
+				const double * mr = m + row * 4;
+				r[row] = _mm_add_pd(
+						_mm_add_pd(
+								_mm_add_pd(_mm_mul_pd(_mm_set1_pd(mr[0]), vx),
+										_mm_mul_pd(_mm_set1_pd(mr[1]), vy)),
+								_mm_mul_pd(_mm_set1_pd(mr[2]), vz)),
+						_mm_set1_pd(mr[3]));
+			}
+			__m128d s = _mm_div_pd(one, r[3]);
+			_mm_storeu_pd(ox + i, _mm_mul_pd(r[0], s));
+			_mm_storeu_pd(oy + i, _mm_mul_pd(r[1], s));
+			_mm_storeu_pd(oz + i, _mm_mul_pd(r[2], s));
+		}
+		transformScalar(m, x, y, z, i, n, ox, oy, oz);
+	}
+
+	/*
+	 * avx2, four vertices at a time
+	 */
+	SIMD_TARGET_AVX2 void minMaxAvx2(const double * x, const double * y,
+			const double * z, size_t n, const double * d, double & minDist,
+			double & maxDist) {
+		__m256d dx = _mm256_set1_pd(d[0]);
+		__m256d dy = _mm256_set1_pd(d[1]);
+		__m256d dz = _mm256_set1_pd(d[2]);
+		__m256d lo = _mm256_set1_pd(minDist);
+		__m256d hi = _mm256_set1_pd(maxDist);
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4) {
+			__m256d dist = _mm256_add_pd(
+					_mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(x + i), dx),
+							_mm256_mul_pd(_mm256_loadu_pd(y + i), dy)),
+					_mm256_mul_pd(_mm256_loadu_pd(z + i), dz));
+			lo = _mm256_min_pd(lo, dist);
+			hi = _mm256_max_pd(hi, dist);
+		}
+		double l[4], h[4];
+		_mm256_storeu_pd(l, lo);
+		_mm256_storeu_pd(h, hi);
+		minDist = std::min(std::min(l[0], l[1]), std::min(l[2], l[3]));
+		maxDist = std::max(std::max(h[0], h[1]), std::max(h[2], h[3]));
+		minMaxScalar(x, y, z, i, n, d, minDist, maxDist);
+	}
+
+	/*
+	 * avx2, four vertices at a time
+	 */
+	SIMD_TARGET_AVX2 void argMinMaxAvx2(const double * x, const double * y,
+			const double * z, size_t n, const double * d, size_t & minIdx,
+			size_t & maxIdx, double & minDist, double & maxDist) {
+		__m256d dx = _mm256_set1_pd(d[0]);
+		__m256d dy = _mm256_set1_pd(d[1]);
+		__m256d dz = _mm256_set1_pd(d[2]);
+		__m256d lo = _mm256_set1_pd(minDist);
+		__m256d hi = _mm256_set1_pd(maxDist);
+		__m256d loIdx = _mm256_setzero_pd();
+		__m256d hiIdx = _mm256_setzero_pd();
+		__m256d idx = _mm256_set_pd(3, 2, 1, 0);
+		__m256d step = _mm256_set1_pd(4);
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4) {
+			__m256d dist = _mm256_add_pd(
+					_mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(x + i), dx),
+							_mm256_mul_pd(_mm256_loadu_pd(y + i), dy)),
+					_mm256_mul_pd(_mm256_loadu_pd(z + i), dz));
+			__m256d lt = _mm256_cmp_pd(dist, lo, _CMP_LT_OQ);
+			lo = _mm256_blendv_pd(lo, dist, lt);
+			loIdx = _mm256_blendv_pd(loIdx, idx, lt);
+			__m256d gt = _mm256_cmp_pd(dist, hi, _CMP_GT_OQ);
+			hi = _mm256_blendv_pd(hi, dist, gt);
+			hiIdx = _mm256_blendv_pd(hiIdx, idx, gt);
+			idx = _mm256_add_pd(idx, step);
+		}
+		if (i > 0) {
+			double l[4], li[4], h[4], hii[4];
+			_mm256_storeu_pd(l, lo);
+			_mm256_storeu_pd(li, loIdx);
+			_mm256_storeu_pd(h, hi);
+			_mm256_storeu_pd(hii, hiIdx);
+			reduceArgMinMax(l, li, h, hii, 4, minIdx, maxIdx, minDist,
+					maxDist);
+		}
+		argMinMaxScalar(x, y, z, i, n, d, minIdx, maxIdx, minDist, maxDist);
+	}
+
+	/*
+	 * avx2, four vertices at a time
+	 */
+	SIMD_TARGET_AVX2 void boundsAvx2(const double * x, const double * y,
+			const double * z, size_t n, double * lo, double * hi) {
+		__m256d lx = _mm256_set1_pd(lo[0]);
+		__m256d ly = _mm256_set1_pd(lo[1]);
+		__m256d lz = _mm256_set1_pd(lo[2]);
+		__m256d hx = _mm256_set1_pd(hi[0]);
+		__m256d hy = _mm256_set1_pd(hi[1]);
+		__m256d hz = _mm256_set1_pd(hi[2]);
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4) {
+			__m256d vx = _mm256_loadu_pd(x + i);
+			__m256d vy = _mm256_loadu_pd(y + i);
+			__m256d vz = _mm256_loadu_pd(z + i);
+			lx = _mm256_min_pd(lx, vx);
+			ly = _mm256_min_pd(ly, vy);
+			lz = _mm256_min_pd(lz, vz);
+			hx = _mm256_max_pd(hx, vx);
+			hy = _mm256_max_pd(hy, vy);
+			hz = _mm256_max_pd(hz, vz);
+		}
+		double a[4];
+		_mm256_storeu_pd(a, lx);
+		lo[0] = std::min(std::min(a[0], a[1]), std::min(a[2], a[3]));
+		_mm256_storeu_pd(a, ly);
+		lo[1] = std::min(std::min(a[0], a[1]), std::min(a[2], a[3]));
+		_mm256_storeu_pd(a, lz);
+		lo[2] = std::min(std::min(a[0], a[1]), std::min(a[2], a[3]));
+		_mm256_storeu_pd(a, hx);
+		hi[0] = std::max(std::max(a[0], a[1]), std::max(a[2], a[3]));
+		_mm256_storeu_pd(a, hy);
+		hi[1] = std::max(std::max(a[0], a[1]), std::max(a[2], a[3]));
+		_mm256_storeu_pd(a, hz);
+		hi[2] = std::max(std::max(a[0], a[1]), std::max(a[2], a[3]));
+		boundsScalar(x, y, z, i, n, lo, hi);
+	}
+
+	/*
+	 * avx2, four vertices at a time
+	 */
+	SIMD_TARGET_AVX2 void transformAvx2(const double * m, const double * x,
+			const double * y, const double * z, size_t n, double * ox,
+			double * oy, double * oz) {
+		__m256d one = _mm256_set1_pd(1);
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4) {
+			__m256d vx = _mm256_loadu_pd(x + i);
+			__m256d vy = _mm256_loadu_pd(y + i);
+			__m256d vz = _mm256_loadu_pd(z + i);
+			__m256d r[4];
+			for (int row = 0; row < 4; ++row) {
+				const double * mr = m + row * 4;
+				r[row] = _mm256_add_pd(
+						_mm256_add_pd(
+								_mm256_add_pd(
+										_mm256_mul_pd(_mm256_set1_pd(mr[0]),
+												vx),
+										_mm256_mul_pd(_mm256_set1_pd(mr[1]),
+												vy)),
+								_mm256_mul_pd(_mm256_set1_pd(mr[2]), vz)),
+						_mm256_set1_pd(mr[3]));
+			}
+			__m256d s = _mm256_div_pd(one, r[3]);
+			_mm256_storeu_pd(ox + i, _mm256_mul_pd(r[0], s));
+			_mm256_storeu_pd(oy + i, _mm256_mul_pd(r[1], s));
+			_mm256_storeu_pd(oz + i, _mm256_mul_pd(r[2], s));
+		}
+		transformScalar(m, x, y, z, i, n, ox, oy, oz);
+	}
+
+	const Kernels sse2Kernels = { minMaxSse2, argMinMaxSse2, boundsSse2,
+			transformSse2 };
+
+	const Kernels avx2Kernels = { minMaxAvx2, argMinMaxAvx2, boundsAvx2,
+			transformAvx2 };
+#endif
+
+	/*
+	 * kernels for best instruction set supported
+	 */
+	const Kernels & kernels() {
+#ifdef SIMD_X86
+		switch (Simd::getLevel()) {
+		case Simd::Level::AVX2:
+			return avx2Kernels;
+		case Simd::Level::SSE2:
+			return sse2Kernels;
+		case Simd::Level::SCALAR:
+			break;
+		}
+#endif
+		return scalarKernels;
+	}
 }
 
 struct Vec3Array::impl {
+	// coordinates as structure of arrays for simd kernels
+	std::vector<double> m_x;
+	std::vector<double> m_y;
+	std::vector<double> m_z;
+	// vertex objects, built from coordinates on demand
 	std::vector<Vec3> m_vertices;
+	std::atomic<bool> m_haveVertices;
 	std::unique_ptr<BoundingBox> m_bounds;
+	std::mutex m_lock;
 	std::shared_ptr<BinaryFile> m_binaryFile;
 	int m_offset;
 	int m_count;
@@ -87,19 +532,73 @@ struct Vec3Array::impl {
 	 *
 	 */
 	impl(const std::vector<Vec3> & vertices) :
-			m_vertices(vertices), m_offset(0), m_count(0), m_valid(true) {
+					m_vertices(vertices),
+					m_haveVertices(true),
+					m_offset(0),
+					m_count(0),
+					m_valid(true) {
+		m_x.reserve(vertices.size());
+		m_y.reserve(vertices.size());
+		m_z.reserve(vertices.size());
+		for (const auto & v : vertices) {
+			m_x.emplace_back(v.getX());
+			m_y.emplace_back(v.getY());
+			m_z.emplace_back(v.getZ());
+		}
+	}
+
+	/*
+	 *
+	 */
+	impl(size_t n) :
+					m_x(n),
+					m_y(n),
+					m_z(n),
+					m_haveVertices(false),
+					m_offset(0),
+					m_count(0),
+					m_valid(true) {
 	}
 
 	/*
 	 *
 	 */
 	impl(const std::shared_ptr<BinaryFile> & binaryFile, int offset, int count) :
+					m_haveVertices(false),
 					m_binaryFile(std::move(binaryFile)),
 					m_offset(offset),
 					m_count(count),
 					m_valid(false) {
 	}
 
+	/*
+	 * vertex objects, built on first use
+	 */
+	const std::vector<Vec3> & getVertices() {
+		if (m_haveVertices == false && m_valid) {
+			std::lock_guard<std::mutex> locker(m_lock);
+			if (m_haveVertices == false) {
+				m_vertices.reserve(m_x.size());
+				for (size_t i = 0, n = m_x.size(); i < n; ++i) {
+					m_vertices.emplace_back(m_x[i], m_y[i], m_z[i]);
+				}
+				m_haveVertices = true;
+			}
+		}
+		return m_vertices;
+	}
+
+	/*
+	 * transform into new array by row major 4x4 matrix
+	 */
+	std::shared_ptr<impl> transformed(const double * m) const {
+		size_t n = m_x.size();
+		auto result = std::make_shared<impl>(n);
+		kernels().transform(m, m_x.data(), m_y.data(), m_z.data(), n,
+				result->m_x.data(), result->m_y.data(), result->m_z.data());
+		return result;
+	}
+
 	/*
 	 *
 	 */
@@ -108,17 +607,18 @@ struct Vec3Array::impl {
 			return true;
 		}
 		if (m_binaryFile->valid()) {
-			m_vertices.reserve(m_count);
+			m_x.reserve(m_count);
+			m_y.reserve(m_count);
+			m_z.reserve(m_count);
 
 			const float * floats =
 					reinterpret_cast<const float *>(m_binaryFile->getData()
 							+ m_offset);
 
 			for (int i = 0; i < m_count; ++i) {
-				double x = *floats++;
-				double y = *floats++;
-				double z = *floats++;
-				m_vertices.emplace_back(x, y, z);
+				m_x.emplace_back(*floats++);
+				m_y.emplace_back(*floats++);
+				m_z.emplace_back(*floats++);
 			}
 
 			// no longer needed
@@ -153,6 +653,13 @@ Vec3Array::Vec3Array(const std::shared_ptr<BinaryFile> & binaryFile, int offset,
 		pimpl(std::make_shared<impl>(binaryFile, offset, count)) {
 }
 
+/*
+ *
+ */
+PRIVATE Vec3Array::Vec3Array(const std::shared_ptr<impl> & pimpl) :
+		pimpl(pimpl) {
+}
+
 /*
  *
  */
@@ -165,59 +672,54 @@ Vec3Array::~Vec3Array() {
  * @param v  vertex to add
  */
 void Vec3Array::add(const Vec3 & v) {
+	pimpl->getVertices();
 	pimpl->m_vertices.emplace_back(v);
+	pimpl->m_x.emplace_back(v.getX());
+	pimpl->m_y.emplace_back(v.getY());
+	pimpl->m_z.emplace_back(v.getZ());
 }
 
 /*
  *
  */
 std::vector<Vec3>::const_iterator Vec3Array::begin() const {
-	return pimpl->m_vertices.cbegin();
+	return pimpl->getVertices().cbegin();
 }
 
 /*
  *
  */
 std::vector<Vec3>::const_iterator Vec3Array::end() const {
-	return pimpl->m_vertices.cend();
+	return pimpl->getVertices().cend();
 }
 
 /*
  *
  */
 const Vec3 & Vec3Array::get(size_t idx) const {
-	return pimpl->m_vertices[idx];
+	return pimpl->getVertices()[idx];
 }
 
 /**
- * calculate bounds
+ * calculate bounds, empty if no vertices
  *
  * @return  bounds
  */
 const BoundingBox & Vec3Array::getBounds() const {
-	if (pimpl->m_bounds == nullptr && pimpl->m_vertices.size() > 0) {
-		const auto & first = pimpl->m_vertices[0];
-
-		double minx = first.getX();
-		double miny = first.getY();
-		double minz = first.getZ();
-
-		double maxx = first.getX();
-		double maxy = first.getY();
-		double maxz = first.getZ();
+	std::lock_guard<std::mutex> locker(pimpl->m_lock);
+	if (pimpl->m_bounds == nullptr) {
+		if (pimpl->m_x.empty()) {
+			return BoundingBox::empty();
+		}
+		double lo[3] = { pimpl->m_x[0], pimpl->m_y[0], pimpl->m_z[0] };
+		double hi[3] = { pimpl->m_x[0], pimpl->m_y[0], pimpl->m_z[0] };
 
-		for (const auto & v : pimpl->m_vertices) {
-			minx = std::min(minx, v.getX());
-			miny = std::min(miny, v.getY());
-			minz = std::min(minz, v.getZ());
+		kernels().bounds(pimpl->m_x.data(), pimpl->m_y.data(),
+				pimpl->m_z.data(), pimpl->m_x.size(), lo, hi);
 
-			maxx = std::max(maxx, v.getX());
-			maxy = std::max(maxy, v.getY());
-			maxz = std::max(maxz, v.getZ());
-		}
 		pimpl->m_bounds = std::unique_ptr<BoundingBox>(
-				new BoundingBox(Vec3(minx, miny, minz),
-						Vec3(maxx, maxy, maxz)));
+				new BoundingBox(Vec3(lo[0], lo[1], lo[2]),
+						Vec3(hi[0], hi[1], hi[2])));
 	}
 	return *pimpl->m_bounds;
 }
@@ -234,12 +736,10 @@ void Vec3Array::getDirectionMinMax(const Normal & direction, double & minDist,
 	minDist = std::numeric_limits<double>::max();
 	maxDist = -std::numeric_limits<double>::max();
 
-	for (const auto & v : pimpl->m_vertices) {
-		double d = v.dot(direction);
+	double d[3] = { direction.getX(), direction.getY(), direction.getZ() };
 
-		minDist = std::min(minDist, d);
-		maxDist = std::max(maxDist, d);
-	}
+	kernels().minMax(pimpl->m_x.data(), pimpl->m_y.data(), pimpl->m_z.data(),
+			pimpl->m_x.size(), d, minDist, maxDist);
 }
 
 /**
@@ -256,18 +756,43 @@ void Vec3Array::getDirectionMinMax(const Normal & direction, Vec3 & minPoint,
 	minDist = std::numeric_limits<double>::max();
 	maxDist = -std::numeric_limits<double>::max();
 
-	for (const auto & v : pimpl->m_vertices) {
-		double d = v.dot(direction);
-
-		if (d < minDist) {
-			minDist = d;
-			minPoint = v;
-		}
-		if (d > maxDist) {
-			maxDist = d;
-			maxPoint = v;
-		}
+	size_t n = pimpl->m_x.size();
+	if (n == 0) {
+		return;
 	}
+
+	double d[3] = { direction.getX(), direction.getY(), direction.getZ() };
+	size_t minIdx = 0;
+	size_t maxIdx = 0;
+
+	kernels().argMinMax(pimpl->m_x.data(), pimpl->m_y.data(),
+			pimpl->m_z.data(), n, d, minIdx, maxIdx, minDist, maxDist);
+
+	minPoint.set(pimpl->m_x[minIdx], pimpl->m_y[minIdx], pimpl->m_z[minIdx]);
+	maxPoint.set(pimpl->m_x[maxIdx], pimpl->m_y[maxIdx], pimpl->m_z[maxIdx]);
+}
+
+/**
+ * get vertex furthest in given direction
+ *
+ * @param direction  direction to search, need not be normalized
+ *
+ * @return           furthest vertex in direction
+ */
+Vec3 Vec3Array::getSupport(const Vec3 & direction) const {
+	size_t n = pimpl->m_x.size();
+	assert(n > 0);
+
+	double d[3] = { direction.getX(), direction.getY(), direction.getZ() };
+	size_t minIdx = 0;
+	size_t maxIdx = 0;
+	double minDist = std::numeric_limits<double>::max();
+	double maxDist = -std::numeric_limits<double>::max();
+
+	kernels().argMinMax(pimpl->m_x.data(), pimpl->m_y.data(),
+			pimpl->m_z.data(), n, d, minIdx, maxIdx, minDist, maxDist);
+
+	return Vec3(pimpl->m_x[maxIdx], pimpl->m_y[maxIdx], pimpl->m_z[maxIdx]);
 }
 
 /**
@@ -277,22 +802,15 @@ void Vec3Array::getDirectionMinMax(const Normal & direction, Vec3 & minPoint,
  * @return          rotated array
  */
 Vec3Array Vec3Array::rotated(const Quat & rotation) const {
-	std::vector<Vec3> a;
-	a.reserve(pimpl->m_vertices.size());
-
 	Mat3 r(rotation);
 
-	for (const auto & v : pimpl->m_vertices) {
-		double x = r.get(0, 0) * v.getX() + r.get(0, 1) * v.getY()
-				+ r.get(0, 2) * v.getZ();
-		double y = r.get(1, 0) * v.getX() + r.get(1, 1) * v.getY()
-				+ r.get(1, 2) * v.getZ();
-		double z = r.get(2, 0) * v.getX() + r.get(2, 1) * v.getY()
-				+ r.get(2, 2) * v.getZ();
-		a.emplace_back(x, y, z);
-	}
+	double m[16] = {
+			r.get(0, 0), r.get(0, 1), r.get(0, 2), 0,
+			r.get(1, 0), r.get(1, 1), r.get(1, 2), 0,
+			r.get(2, 0), r.get(2, 1), r.get(2, 2), 0,
+			0, 0, 0, 1 };
 
-	return Vec3Array(a);
+	return Vec3Array(pimpl->transformed(m));
 }
 
 /**
@@ -303,14 +821,13 @@ Vec3Array Vec3Array::rotated(const Quat & rotation) const {
  * @return   scaled vertices
  */
 Vec3Array Vec3Array::scaled(float s) const {
-	std::vector<Vec3> a;
-	a.reserve(pimpl->m_vertices.size());
-
-	for (const auto & point : pimpl->m_vertices) {
-		a.emplace_back(point * s);
-	}
+	double m[16] = {
+			s, 0, 0, 0,
+			0, s, 0, 0,
+			0, 0, s, 0,
+			0, 0, 0, 1 };
 
-	return Vec3Array(a);
+	return Vec3Array(pimpl->transformed(m));
 }
 
 /**
@@ -319,7 +836,7 @@ Vec3Array Vec3Array::scaled(float s) const {
  * @return  number of vertices
  */
 size_t Vec3Array::size() const {
-	return pimpl->m_vertices.size();
+	return pimpl->m_x.size();
 }
 
 /**
@@ -331,7 +848,7 @@ OVERRIDE std::string Vec3Array::toString() const {
 
 	bool first = false;
 
-	for (const auto & v : pimpl->m_vertices) {
+	for (const auto & v : pimpl->getVertices()) {
 		if (first == false) {
 			str += ",\n";
 		}
@@ -350,16 +867,14 @@ OVERRIDE std::string Vec3Array::toString() const {
  * @return        transformed vertices
  */
 Vec3Array Vec3Array::transformed(const Mat4 & m) const {
-	std::vector<Vec3> a;
-	a.reserve(pimpl->m_vertices.size());
-
-	for (const auto & point : pimpl->m_vertices) {
-		Vec3 p = point;
-		m.transform(p);
-		a.emplace_back(p);
+	double mat[16];
+	for (unsigned row = 0; row < 4; ++row) {
+		for (unsigned column = 0; column < 4; ++column) {
+			mat[row * 4 + column] = m.get(row, column);
+		}
 	}
 
-	return Vec3Array(a);
+	return Vec3Array(pimpl->transformed(mat));
 }
 
 /**
@@ -373,20 +888,13 @@ Vec3Array Vec3Array::transformed(const Transform & transform) const {
 	Mat3 r = transform.getRotationMatrix();
 	Vec3 t = transform.getTranslation();
 
-	std::vector<Vec3> a;
-	a.reserve(pimpl->m_vertices.size());
+	double m[16] = {
+			r.get(0, 0), r.get(0, 1), r.get(0, 2), t.getX(),
+			r.get(1, 0), r.get(1, 1), r.get(1, 2), t.getY(),
+			r.get(2, 0), r.get(2, 1), r.get(2, 2), t.getZ(),
+			0, 0, 0, 1 };
 
-	for (const auto & v : pimpl->m_vertices) {
-		double x = r.get(0, 0) * v.getX() + r.get(0, 1) * v.getY()
-				+ r.get(0, 2) * v.getZ() + t.getX();
-		double y = r.get(1, 0) * v.getX() + r.get(1, 1) * v.getY()
-				+ r.get(1, 2) * v.getZ() + t.getY();
-		double z = r.get(2, 0) * v.getX() + r.get(2, 1) * v.getY()
-				+ r.get(2, 2) * v.getZ() + t.getZ();
-
-		a.emplace_back(x, y, z);
-	}
-	return Vec3Array(a);
+	return Vec3Array(pimpl->transformed(m));
 }
 
 /**
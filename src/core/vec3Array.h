@@ -40,7 +40,7 @@ public:
 	const Vec3 & get(size_t idx) const;
 
 	/**
-	 * calculate bounds
+	 * calculate bounds, empty if no vertices
 	 *
 	 * @return  bounds
 	 */
@@ -68,6 +68,15 @@ public:
 	void getDirectionMinMax(const Normal & direction, Vec3 & minPoint,
 			Vec3 & maxPoint, double & minDist, double & maxDist) const;
 
+	/**
+	 * get vertex furthest in given direction
+	 *
+	 * @param direction  direction to search, need not be normalized
+	 *
+	 * @return           furthest vertex in direction
+	 */
+	Vec3 getSupport(const Vec3 & direction) const;
+
 	/**
 	 * Produce a rotated version of this array
 	 *
@@ -135,4 +144,6 @@ public:
 private:
 	struct impl;
 	std::shared_ptr<impl> pimpl;
+
+	explicit Vec3Array(const std::shared_ptr<impl> & pimpl);
 };
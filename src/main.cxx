@@ -59,6 +59,15 @@ namespace{
 		Config::getInstance().set("width", std::make_shared<Real>(0));
 		Config::getInstance().set("height", std::make_shared<Real>(0));
 		Config::getInstance().set("debugPort", std::make_shared<Real>(-1));
+		Config::getInstance().set("workerThreads", std::make_shared<Real>(0));
+		Config::getInstance().set("animationLod", Bool::True());
+		Config::getInstance().set("animationLodSize",
+			std::make_shared<Real>(0.1));
+		Config::getInstance().set("animationLodInterval",
+			std::make_shared<Real>(4));
+		Config::getInstance().set("showFrustumStats", Bool::False());
+		Config::getInstance().set("visibilityCacheFrames",
+			std::make_shared<Real>(8));
 		Config::getInstance().set("home", std::make_shared<String>(getHomeDirectory()));
 
 		// load config
@@ -33,6 +33,8 @@ namespace {
 	auto proj_matrixUID = Uniform::getUID("proj_matrix");
 	auto mvp_matrixUID = Uniform::getUID("mvp_matrix");
 	auto modelView_matricesUID = Uniform::getUID("modelView_matrices");
+	auto modelView_matrices0UID = Uniform::getUID("modelView_matrices[0]");
+	auto normal_matrices0UID = Uniform::getUID("normal_matrices[0]");
 	auto colorUID = Uniform::getUID("color");
 	auto color0UID = Uniform::getUID("u_color0");
 	auto color1UID = Uniform::getUID("u_color1");
@@ -74,27 +76,19 @@ namespace {
 					maxInstances) {
 				auto nInstances = n - i < maxInstances ? n - i : maxInstances;
 
-				for (size_t j = 0; j < nInstances; ++j) {
-					Transform modelToView = worldToView;
-					modelToView.transform(transforms[i + j]);
-					Mat4 modelViewMatrix = modelToView.asMat4();
-
-					// TODO normal matrix is inverse transpose model view matrix
-					Mat3 normalMatrix = modelViewMatrix.getRotationScale();
-
-					state.addUniform(
-							Uniform(
-									Uniform::getUID(
-											"modelView_matrices["
-													+ std::to_string(j) + "]"),
-									modelViewMatrix));
-					state.addUniform(
-							Uniform(
-									Uniform::getUID(
-											"normal_matrices["
-													+ std::to_string(j) + "]"),
-									normalMatrix));
-				}
+				// rigid transforms, so normal matrix is the rotation
+				std::vector<float> modelViewMatrices(nInstances * 16);
+				std::vector<float> normalMatrices(nInstances * 9);
+				Transform::toViewMatrices(worldToView, &transforms[i],
+						nInstances, modelViewMatrices.data(),
+						normalMatrices.data());
+
+				state.addUniform(
+						Uniform(modelView_matrices0UID, 4,
+								std::move(modelViewMatrices)));
+				state.addUniform(
+						Uniform(normal_matrices0UID, 3,
+								std::move(normalMatrices)));
 
 				state.bindUniforms();
 				state.bindVertexAttributes();
@@ -110,14 +104,17 @@ namespace {
 	 */
 	struct PointNode {
 		RenderState state;
-		std::vector<Vec3> points;
+		/** packed x, y, z floats */
+		std::vector<float> points;
 
 		PointNode(const RenderState & state) :
 				state(state) {
 		}
 
 		void addPoint(const Vec3 & point) {
-			points.emplace_back(point);
+			points.emplace_back(static_cast<float>(point.getX()));
+			points.emplace_back(static_cast<float>(point.getY()));
+			points.emplace_back(static_cast<float>(point.getZ()));
 		}
 
 		void execute(UniformArray uniforms) {
@@ -143,9 +140,9 @@ namespace {
 				assert(false);
 			}
 
-			assert(sizeof(Vec3) == 12); // ensure Vec3 is 3 floats
 			glVertexAttribPointer(posIdx, 3, GL_FLOAT, false, 0, points.data());
-			glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(points.size()));
+			glDrawArrays(GL_POINTS, 0,
+					static_cast<GLsizei>(points.size() / 3));
 
 			// disable attributes
 			state.unbindShader();
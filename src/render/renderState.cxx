@@ -17,7 +17,6 @@
 #include "../core/vec3.h"
 
 #include <cassert>
-#include <array>
 
 using namespace render;
 
@@ -25,6 +24,7 @@ namespace {
 
 	auto LightMapUID = Uniform::getUID("LightMap");
 	auto LumaMapUID = Uniform::getUID("LumaMap");
+	auto SkinningMatricesUID = Uniform::getUID("SkinningMatrices[0]");
 
 	auto lightMapFlag = ShaderFlag::valueOf("LIGHTMAP");
 	auto lumaMapFlag = ShaderFlag::valueOf("LUMAMAP");
@@ -54,7 +54,7 @@ struct RenderState::impl {
 	BlendFlag m_blend;
 	std::shared_ptr<UniformArray> m_uniforms;
 	std::shared_ptr<VertexAttributeArray> m_vertexAttributes;
-	std::shared_ptr<std::array<Mat4, 32>> m_skinningMatrices;
+	std::shared_ptr<const std::vector<float>> m_skinningMatrices;
 	std::shared_ptr<Lighting> m_lighting;
 
 	impl(const Lighting & lighting, const ShaderTag & tag) :
@@ -279,14 +279,17 @@ void RenderState::setBlend(const BlendFlag & blend) {
 	pimpl->m_blend = blend;
 }
 
-/*
+/**
+ * set skinning matrices, bound as one array uniform
  *
+ * @param matrices  4x4 matrices of palette packed column major,
+ *                  shared as is, not copied
  */
-void RenderState::setSkinningMatrix(int index, const Transform & transform) {
+void RenderState::setSkinningMatrices(
+		const std::shared_ptr<const std::vector<float>> & matrices) {
 	makeUnique(pimpl);
-	makeUnique2(pimpl->m_skinningMatrices);
 
-	(*pimpl->m_skinningMatrices)[index] = transform.asMat4();
+	pimpl->m_skinningMatrices = matrices;
 }
 
 /*
@@ -297,12 +300,7 @@ void RenderState::setupSkinning() {
 		return;
 	}
 
-	for (size_t i = 0, n = pimpl->m_skinningMatrices->size(); i < n; ++i) {
-		auto name = "SkinningMatrices[" + std::to_string(i) + "]";
-		addUniform(
-				Uniform(Uniform::getUID(name),
-						(*pimpl->m_skinningMatrices)[i]));
-	}
+	addUniform(Uniform(SkinningMatricesUID, 4, pimpl->m_skinningMatrices));
 }
 
 /*
@@ -6,6 +6,7 @@
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 class BoundingBox;
 class Quat;
@@ -83,7 +84,14 @@ namespace render {
 
 		void setBlend(const BlendFlag & blend);
 
-		void setSkinningMatrix(int index, const Transform & transform);
+		/**
+		 * set skinning matrices, bound as one array uniform
+		 *
+		 * @param matrices  4x4 matrices of palette packed column major,
+		 *                  shared as is, not copied
+		 */
+		void setSkinningMatrices(
+				const std::shared_ptr<const std::vector<float>> & matrices);
 
 		void setupSkinning();
 
@@ -13,6 +13,7 @@
 #include "../core/transform.h"
 
 #include <unordered_map>
+#include <vector>
 
 #include <GL/glew.h>
 
@@ -23,6 +24,7 @@ namespace {
 
 	auto worldView_matrixUID = Uniform::getUID("worldView_matrix");
 	auto proj_matrixUID = Uniform::getUID("proj_matrix");
+	auto modelView_matrices0UID = Uniform::getUID("modelView_matrices[0]");
 
 	struct Node {
 		RenderState state;
@@ -39,24 +41,21 @@ namespace {
 			transforms.emplace_back(transform);
 		}
 
-		void execute(const Mat4 & worldToViewMatrix,
+		void execute(const Transform & worldToView,
+				const Mat4 & worldToViewMatrix,
 				const UniformArray & globalUniforms) {
 			state.addUniforms(globalUniforms);
 
 			for (size_t i = 0, n = transforms.size(); i < n; i += maxInstances) {
 				auto nInstances = n - i < maxInstances ? n - i : maxInstances;
 
-				for (size_t j = 0; j < nInstances; ++j) {
-					Mat4 modelMatrix = transforms.at(i + j).asMat4();
-
-					Mat4 modelViewMatrix;
-					modelViewMatrix.mul(worldToViewMatrix, modelMatrix);
-
-					// model to view matrix
-					auto uid = Uniform::getUID(
-							"modelView_matrices[" + std::to_string(j) + "]");
-					state.addUniform(Uniform(uid, modelViewMatrix));
-				}
+				// model to view matrices
+				std::vector<float> modelViewMatrices(nInstances * 16);
+				Transform::toViewMatrices(worldToView, &transforms[i],
+						nInstances, modelViewMatrices.data(), nullptr);
+				state.addUniform(
+						Uniform(modelView_matrices0UID, 4,
+								std::move(modelViewMatrices)));
 
 				// world to view matrix
 				state.addUniform(
@@ -257,7 +256,7 @@ OVERRIDE void ShadowView::execute(Canvas & canvas) {
 		shader->bind();
 
 		for (auto & node : e.second) {
-			node.execute(worldToViewMatrix, globalUniforms);
+			node.execute(worldToView, worldToViewMatrix, globalUniforms);
 		}
 
 		shader->unbind();
@@ -5,7 +5,6 @@
 #include "textureManager.h"
 
 #include "../core/animation.h"
-#include "../core/bezier.h"
 #include "../core/bone.h"
 #include "../core/color.h"
 #include "../core/mat3.h"
@@ -49,21 +48,18 @@ namespace {
 				auto arg = stack.top();
 				stack.pop();
 
-				if (typeid(*arg) == typeid(Mat3)) {
-					auto mat = std::static_pointer_cast<Mat3>(arg);
-					stack.push(std::make_shared<Uniform>(id, *mat));
-				} else if (typeid(*arg) == typeid(Texture)) {
+				if (typeid(*arg) == typeid(Texture)) {
 					auto tex = std::static_pointer_cast<Texture>(arg);
 					stack.push(std::make_shared<Uniform>(id, tex));
-				} else if (typeid(*arg) == typeid(Vec3)) {
-					auto vec = std::static_pointer_cast<Vec3>(arg);
-					stack.push(std::make_shared<Uniform>(id, *vec));
+				} else if (typeid(*arg) == typeid(ScriptVec3)) {
+					const auto & vec = ScriptType<Vec3>::get(arg);
+					stack.push(std::make_shared<Uniform>(id, vec));
 				} else if (typeid(*arg) == typeid(Real)) {
 					auto num = std::static_pointer_cast<Real>(arg);
 					stack.push(std::make_shared<Uniform>(id, num->getFloat()));
 				} else {
 					scriptExecutionAssert(false,
-							"Require Mat3, Texture, Vec3 or number for argument 2");
+							"Require Texture, Vec3 or number for argument 2");
 				}
 			} else if (nArgs == 4) {
 				float x = static_cast<float>(getNumericArg(stack, 2));
@@ -106,39 +102,32 @@ struct Uniform::impl {
 	int type;
 	std::vector<int> ints;
 	std::vector<float> floats;
+	/** floats shared with owner instead, if not null */
+	std::shared_ptr<const std::vector<float>> sharedFloats;
 	std::shared_ptr<Texture> texture;
 
 	impl(const Animation & animation, float frame) :
 			uid(Uniform::getUID(animation.getName())) {
 
-		const auto & curves = animation.getBone();
-		switch (curves.size()) {
-		case 1: {
-			floats.emplace_back(curves.get(0).getY(frame));
+		// single bone, so its curves are the animation's channels
+		assert(animation.getBones().size() == 1);
+		auto count = animation.getChannelCount();
+		floats.resize(count);
+		animation.sample(frame, 0, count, floats.data());
+
+		switch (count) {
+		case 1:
 			type = GL_FLOAT;
 			break;
-		}
-		case 2: {
-			floats.emplace_back(curves.get(0).getY(frame));
-			floats.emplace_back(curves.get(1).getY(frame));
+		case 2:
 			type = GL_FLOAT_VEC2;
 			break;
-		}
-		case 3: {
-			floats.emplace_back(curves.get(0).getY(frame));
-			floats.emplace_back(curves.get(1).getY(frame));
-			floats.emplace_back(curves.get(2).getY(frame));
+		case 3:
 			type = GL_FLOAT_VEC3;
 			break;
-		}
-		case 4: {
-			floats.emplace_back(curves.get(0).getY(frame));
-			floats.emplace_back(curves.get(1).getY(frame));
-			floats.emplace_back(curves.get(2).getY(frame));
-			floats.emplace_back(curves.get(3).getY(frame));
+		case 4:
 			type = GL_FLOAT_VEC4;
 			break;
-		}
 		default:
 			assert(false);
 		}
@@ -184,6 +173,23 @@ struct Uniform::impl {
 							matrix.get(0, 3), matrix.get(1, 3), matrix.get(2, 3), matrix.get(3, 3) }) {
 	}
 
+	impl(size_t uid, size_t size, std::vector<float> && matrices) :
+					uid(uid),
+					type(size == 3 ? GL_FLOAT_MAT3 : GL_FLOAT_MAT4),
+					floats(std::move(matrices)) {
+		assert(size == 3 || size == 4);
+		assert(floats.size() % (size * size) == 0);
+	}
+
+	impl(size_t uid, size_t size,
+			const std::shared_ptr<const std::vector<float>> & matrices) :
+					uid(uid),
+					type(size == 3 ? GL_FLOAT_MAT3 : GL_FLOAT_MAT4),
+					sharedFloats(matrices) {
+		assert(size == 3 || size == 4);
+		assert(sharedFloats->size() % (size * size) == 0);
+	}
+
 	impl(size_t uid, const Normal & n) :
 					uid(uid),
 					type(GL_FLOAT_VEC3),
@@ -208,6 +214,13 @@ struct Uniform::impl {
 	impl(size_t uid, const std::array<float, 27> & coeffs) :
 			uid(uid), type(GL_FLOAT_VEC3), floats(coeffs.begin(), coeffs.end()) {
 	}
+
+	/*
+	 * floats of uniform, own or shared
+	 */
+	const std::vector<float> & getFloats() const {
+		return sharedFloats != nullptr ? *sharedFloats : floats;
+	}
 };
 
 /**
@@ -296,6 +309,31 @@ Uniform::Uniform(size_t uid, const Mat4 & matrix) :
 		pimpl(std::make_shared<impl>(uid, matrix)) {
 }
 
+/**
+ * construct uniform array of square matrices, bound in one call
+ *
+ * @param uid       uniform id of first element of array
+ * @param size      3 or 4, for array of 3x3 or 4x4 matrices
+ * @param matrices  matrices packed column major
+ */
+Uniform::Uniform(size_t uid, size_t size, std::vector<float> && matrices) :
+		pimpl(std::make_shared<impl>(uid, size, std::move(matrices))) {
+}
+
+/**
+ * construct uniform array of square matrices, bound in one call, sharing
+ * matrices rather than copying them
+ *
+ * @param uid       uniform id of first element of array
+ * @param size      3 or 4, for array of 3x3 or 4x4 matrices
+ * @param matrices  matrices packed column major, not to be changed while
+ *                  uniform is in use
+ */
+Uniform::Uniform(size_t uid, size_t size,
+		const std::shared_ptr<const std::vector<float>> & matrices) :
+		pimpl(std::make_shared<impl>(uid, size, matrices)) {
+}
+
 /**
  * construct uniform from normal
  *
@@ -351,33 +389,34 @@ Uniform::Uniform(size_t uid, const std::array<float, 27> & coeffs) :
  * @param location  bind location
  */
 void Uniform::bind(int location) const {
+	const auto & floats = pimpl->getFloats();
 	switch (pimpl->type) {
 	case GL_INT:
 		glUniform1i(location, pimpl->ints[0]);
 		break;
 	case GL_FLOAT:
-		glUniform1f(location, pimpl->floats[0]);
+		glUniform1f(location, floats[0]);
 		break;
 	case GL_FLOAT_VEC2:
-		glUniform2f(location, pimpl->floats[0], pimpl->floats[1]);
+		glUniform2f(location, floats[0], floats[1]);
 		break;
 	case GL_FLOAT_VEC3:
-		glUniform3fv(location, static_cast<GLsizei>(pimpl->floats.size() / 3),
-				pimpl->floats.data());
+		glUniform3fv(location, static_cast<GLsizei>(floats.size() / 3),
+				floats.data());
 		break;
 	case GL_FLOAT_VEC4:
-		glUniform4f(location, pimpl->floats[0], pimpl->floats[1],
-				pimpl->floats[2], pimpl->floats[3]);
+		glUniform4f(location, floats[0], floats[1],
+				floats[2], floats[3]);
 		break;
 	case GL_FLOAT_MAT3:
 		glUniformMatrix3fv(location,
-				static_cast<GLsizei>(pimpl->floats.size() / 9), false,
-				pimpl->floats.data());
+				static_cast<GLsizei>(floats.size() / 9), false,
+				floats.data());
 		break;
 	case GL_FLOAT_MAT4:
 		glUniformMatrix4fv(location,
-				static_cast<GLsizei>(pimpl->floats.size() / 16), false,
-				pimpl->floats.data());
+				static_cast<GLsizei>(floats.size() / 16), false,
+				floats.data());
 		break;
 	default:
 		assert(false);
@@ -416,7 +455,7 @@ void Uniform::dump() const {
 	case GL_FLOAT_VEC4:
 	case GL_FLOAT_MAT3:
 	case GL_FLOAT_MAT4:
-		for (auto f : pimpl->floats) {
+		for (auto f : pimpl->getFloats()) {
 			std::cout << ", " << f;
 		}
 		break;
@@ -491,7 +530,7 @@ bool Uniform::operator==(const Uniform & other) const {
 		return pimpl->texture == other.pimpl->texture;
 	}
 
-	return pimpl->floats == other.pimpl->floats;
+	return pimpl->getFloats() == other.pimpl->getFloats();
 }
 
 /**
@@ -5,6 +5,7 @@
 #include <array>
 #include <memory>
 #include <string>
+#include <vector>
 
 class Animation;
 class Color;
@@ -90,6 +91,27 @@ namespace render {
 		 */
 		Uniform(size_t uid, const Mat4 & matrix);
 
+		/**
+		 * construct uniform array of square matrices, bound in one call
+		 *
+		 * @param uid       uniform id of first element of array
+		 * @param size      3 or 4, for array of 3x3 or 4x4 matrices
+		 * @param matrices  matrices packed column major
+		 */
+		Uniform(size_t uid, size_t size, std::vector<float> && matrices);
+
+		/**
+		 * construct uniform array of square matrices, bound in one call,
+		 * sharing matrices rather than copying them
+		 *
+		 * @param uid       uniform id of first element of array
+		 * @param size      3 or 4, for array of 3x3 or 4x4 matrices
+		 * @param matrices  matrices packed column major, not to be changed
+		 *                  while uniform is in use
+		 */
+		Uniform(size_t uid, size_t size,
+				const std::shared_ptr<const std::vector<float>> & matrices);
+
 		/**
 		 * construct uniform from normal
 		 *
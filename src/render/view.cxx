@@ -5,6 +5,7 @@
 
 #include "../core/aspect.h"
 #include "../core/boundingBox.h"
+#include "../core/frustumCuller.h"
 #include "../core/intersection.h"
 #include "../core/transform.h"
 
@@ -12,6 +13,20 @@
 
 using namespace render;
 
+namespace {
+	/*
+	 * clip planes of aspect in camera space, as hull planes are
+	 */
+	std::vector<Plane> cameraClipPlanes(const Aspect & aspect) {
+		auto worldToCamera = aspect.getRotTrans().inverse();
+		auto planes = aspect.getClipPlanes();
+		for (auto & plane : planes) {
+			plane.transform(worldToCamera);
+		}
+		return planes;
+	}
+}
+
 struct View::impl {
 	Aspect aspect;
 	Aspect lodAspect;
@@ -20,6 +35,9 @@ struct View::impl {
 	Cull cull;
 	DepthCompare depthCompare;
 	ModifierSet modifiers;
+	/** hull and clip planes in camera space */
+	FrustumCuller culler;
+	FrustumStats frustumStats;
 
 	impl(const Aspect & aspect, const Aspect & lodAspect,
 			const UniformArray & uniforms, const ShaderTag & shader, Cull cull,
@@ -30,10 +48,15 @@ struct View::impl {
 					shaderTag(shader),
 					cull(cull),
 					depthCompare(depthCompare),
-					modifiers(modifiers) {
+					modifiers(modifiers),
+					culler(aspect.getConvexHull().getPlanes(),
+							cameraClipPlanes(aspect)),
+					frustumStats() {
 	}
 };
 
+const uint32_t View::culled = FrustumCuller::outside;
+
 View::View(const std::string & name, const Aspect & aspect,
 		const Aspect & lodAspect,
 		const std::vector<std::shared_ptr<Texture>> & textures,
@@ -63,6 +86,65 @@ View::View(const std::string & name, const Aspect & aspect,
 View::~View() {
 }
 
+/**
+ * Test boxes sharing transform against view frustum together. Each box is
+ * tested against planes given only, so boxes within a box are left out of
+ * tests of planes it lies wholly inside of
+ *
+ * @param boxes       boxes to test
+ * @param n           number of boxes
+ * @param boxToWorld  transform to take boxes from local to world space
+ * @param enclosing   result of box enclosing boxes, or getFrustumRoot
+ * @param results     result of each box, planes culled if not visible,
+ *                    written
+ */
+void View::cullFrustum(const BoundingBox * const * boxes, size_t n,
+		const Transform & boxToWorld, const FrustumCuller::Result & enclosing,
+		FrustumCuller::Result * results) {
+	// model to camera space
+	auto m2c = boxToWorld.to(pimpl->aspect.getRotTrans());
+	pimpl->culler.cull(boxes, n, m2c, enclosing, results);
+
+	auto & stats = pimpl->frustumStats;
+	size_t planes = 0;
+	for (uint32_t m = enclosing.planes & pimpl->culler.getMask(); m != 0;
+			m &= m - 1) {
+		++planes;
+	}
+	size_t allPlanes = 0;
+	for (uint32_t m = pimpl->culler.getMask(); m != 0; m &= m - 1) {
+		++allPlanes;
+	}
+	stats.boxes += n;
+	stats.planeTests += n * planes;
+	stats.planeTestsSkipped += n * (allPlanes - planes);
+
+	for (size_t i = 0; i < n; ++i) {
+		auto & result = results[i];
+		//
+		// box straddling hull with centre outside may lie off its corners and
+		// edges, so compare hull to box
+		//
+		if ((result.planes & FrustumCuller::centreOutside) != 0
+				&& (result.planes & FrustumCuller::outside) == 0) {
+			++stats.hullTests;
+			Intersection intxn;
+			if (pimpl->aspect.getConvexHull().collide(*boxes[i], m2c, intxn)
+					== false) {
+				// outside, though by no distance known
+				result.planes = culled;
+				result.margin = 0;
+			}
+		}
+		if ((result.planes & FrustumCuller::outside) != 0) {
+			result.planes = culled;
+			++stats.culled;
+		} else {
+			result.planes &= ~FrustumCuller::centreOutside;
+		}
+	}
+}
+
 /**
  * get aspect for view
  *
@@ -90,6 +172,25 @@ View::DepthCompare View::getDepthCompare() const {
 	return pimpl->depthCompare;
 }
 
+/**
+ * get frustum result for box enclosing everything, so boxes within are
+ * tested against all planes of view frustum
+ *
+ * @return  result enclosing everything
+ */
+FrustumCuller::Result View::getFrustumRoot() const {
+	return pimpl->culler.getRoot();
+}
+
+/**
+ * get counts of frustum tests of boxes made building view
+ *
+ * @return  frustum test counts
+ */
+const View::FrustumStats & View::getFrustumStats() const {
+	return pimpl->frustumStats;
+}
+
 /**
  * get lod aspect for view
  *
@@ -137,51 +238,8 @@ const UniformArray & View::getUniforms() const {
  * @return true if box intersects frustum, false otherwise
  */
 bool View::isVisible(const BoundingBox & box, const Transform & boxToWorld) {
-	//
-	// first test box as sphere against hull. If centre is more than radius
-	// from plane it is outside and can be dropped
-	//
-
-	// model to camera space
-	auto m2c = boxToWorld.to(pimpl->aspect.getRotTrans());
-	// box centre to camera space
-	auto centre = box.getCentre();
-	m2c.transformPoint(centre);
-	// radius
-	double radius = box.getRadius();
-	// box centre inside or on hull flag
-	bool inside = true;
-
-	for (const auto & p : pimpl->aspect.getConvexHull().getPlanes()) {
-		double d = p.distanceTo(centre);
-		if (d > radius) {
-			return false;
-		}
-		inside = inside && (d <= 0);
-	}
-
-	//
-	// further testing if centre not inside, compare hull to box
-	//
-	if (inside == false) {
-		Intersection intxn;
-		if (pimpl->aspect.getConvexHull().collide(box, m2c, intxn) == false) {
-			return false;
-		}
-	}
-
-	//
-	// clip plane test
-	//
-	Transform worldToBoxSpace = boxToWorld.inverse();
-	for (const auto & plane : pimpl->aspect.getClipPlanes()) {
-		// world space plane in model space
-		auto p = plane;
-		p.transform(worldToBoxSpace);
-		if (p.isAbove(box)) {
-			return false;
-		}
-	}
-
-	return true;
+	const BoundingBox * boxes[] = { &box };
+	FrustumCuller::Result result;
+	cullFrustum(boxes, 1, boxToWorld, getFrustumRoot(), &result);
+	return result.planes != culled;
 }
@@ -2,7 +2,10 @@
 
 #include "renderTask.h"
 
+#include "../core/frustumCuller.h"
+
 #include <bitset>
+#include <cstdint>
 
 class Aspect;
 class BoundingBox;
@@ -35,6 +38,25 @@ namespace render {
 			LESS, GREATER
 		};
 
+		/*
+		 * counts of frustum tests of boxes while view is built
+		 */
+		struct FrustumStats {
+			/** boxes tested */
+			size_t boxes;
+			/** boxes culled */
+			size_t culled;
+			/** tests of box against plane made */
+			size_t planeTests;
+			/** tests of box against plane left out, box within plane */
+			size_t planeTestsSkipped;
+			/** boxes straddling hull tested against it exactly */
+			size_t hullTests;
+		};
+
+		/** result of frustum test of box not visible */
+		static const uint32_t culled;
+
 		View(const std::string & name, const Aspect & aspect,
 				const Aspect & lodAspect,
 				const std::vector<std::shared_ptr<Texture>> & textures,
@@ -73,6 +95,23 @@ namespace render {
 		virtual void addVolumetric(const RenderState & state,
 				const IndexedTriangles & indices) = 0;
 
+		/**
+		 * Test boxes sharing transform against view frustum together. Each
+		 * box is tested against planes given only, so boxes within a box
+		 * are left out of tests of planes it lies wholly inside of
+		 *
+		 * @param boxes       boxes to test
+		 * @param n           number of boxes
+		 * @param boxToWorld  transform to take boxes from local to world space
+		 * @param enclosing   result of box enclosing boxes, or getFrustumRoot
+		 * @param results     result of each box, planes culled if not
+		 *                    visible, written
+		 */
+		void cullFrustum(const BoundingBox * const * boxes, size_t n,
+				const Transform & boxToWorld,
+				const FrustumCuller::Result & enclosing,
+				FrustumCuller::Result * results);
+
 		virtual void execute(Canvas & canvas) override = 0;
 
 		/**
@@ -96,6 +135,21 @@ namespace render {
 		 */
 		DepthCompare getDepthCompare() const;
 
+		/**
+		 * get frustum result for box enclosing everything, so boxes within
+		 * are tested against all planes of view frustum
+		 *
+		 * @return  result enclosing everything
+		 */
+		FrustumCuller::Result getFrustumRoot() const;
+
+		/**
+		 * get counts of frustum tests of boxes made building view
+		 *
+		 * @return  frustum test counts
+		 */
+		const FrustumStats & getFrustumStats() const;
+
 		/**
 		 * get lod aspect for view
 		 *
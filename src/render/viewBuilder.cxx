@@ -9,6 +9,7 @@
 #include "uniform.h"
 #include "uniformArray.h"
 #include "view.h"
+#include "visibilityCache.h"
 
 #include "../core/aspect.h"
 #include "../core/boundingBox.h"
@@ -19,12 +20,16 @@
 #include "../core/perspectiveCamera.h"
 #include "../core/plane.h"
 
+#include <algorithm>
 #include <cmath>
 #include <stack>
 
 using namespace render;
 
 namespace {
+	/** most boxes tested against view frustum together */
+	const size_t cullBatch = 8;
+
 	struct Mirror {
 		Plane plane;
 		Uniform uniform;
@@ -66,6 +71,11 @@ namespace {
 struct ViewBuilder::impl {
 	std::shared_ptr<View> currentView;
 	std::stack<RenderState> stateStack;
+	/** frustum result of box enclosing state, pushed with state */
+	std::stack<FrustumCuller::Result> frustumResults;
+	/** results of earlier frames of view, null if not kept */
+	std::shared_ptr<VisibilityCache> visibilityCache;
+	size_t cachedBoxes;
 
 	std::vector<std::shared_ptr<View>> additionalViewTasks;
 
@@ -83,8 +93,9 @@ struct ViewBuilder::impl {
 	impl(const std::shared_ptr<View> & view,
 			const std::vector<std::shared_ptr<View>> & additionalViewTasks) :
 					currentView(view),
+					cachedBoxes(0),
 					additionalViewTasks(additionalViewTasks),
-					occlusionMap(view->getAspect(), 32, 32),
+					occlusionMap(view->getAspect(), 256, 128),
 					numPolygons(0),
 					showCollisions(
 							Config::getInstance().getBoolean("showCollisions")),
@@ -102,6 +113,13 @@ ViewBuilder::ViewBuilder(const std::shared_ptr<View> & view,
 	const auto & camera = view->getAspect().getCamera();
 
 	pimpl->stateStack.emplace(lighting, view->getShaderTag());
+	pimpl->frustumResults.push(view->getFrustumRoot());
+	int frames = Config::getInstance().getInteger("visibilityCacheFrames");
+	if (frames > 0) {
+		pimpl->visibilityCache = VisibilityCache::acquire(view->getName());
+		pimpl->visibilityCache->begin(view->getAspect(),
+				static_cast<unsigned>(frames));
+	}
 	// camera uniforms
 	getState().addUniform(Uniform(nearUID, camera->getNear()));
 	getState().addUniform(Uniform(farUID, camera->getFar()));
@@ -133,6 +151,10 @@ ViewBuilder::ViewBuilder(const std::shared_ptr<View> & view,
  * destructor
  */
 ViewBuilder::~ViewBuilder() {
+	if (pimpl->visibilityCache != nullptr) {
+		VisibilityCache::release(pimpl->currentView->getName(),
+				pimpl->visibilityCache);
+	}
 }
 
 void ViewBuilder::addAlphaIndexedTriangles(const IndexedTriangles & indices,
@@ -301,6 +323,57 @@ void ViewBuilder::applyRefraction(const std::string & name,
 	pimpl->refractions.emplace_back(worldPlane, uniform);
 }
 
+/**
+ * Test boxes in current transform for visibility together, against planes of
+ * view frustum current frustum result straddles and then occlusion geometry.
+ * Results of boxes kept from earlier frames of view are used while they hold,
+ * so boxes found visible that way aren't tested against occlusion geometry
+ *
+ * @param keys     key of each box, such as its node, kept with result
+ * @param boxes    boxes to test
+ * @param n        number of boxes
+ * @param results  result of each box, planes View::culled if not visible,
+ *                 written
+ */
+void ViewBuilder::cull(const void * const * keys,
+		const BoundingBox * const * boxes, size_t n,
+		FrustumCuller::Result * results) {
+	const auto & boxToWorld = getState().getTransform();
+	const auto & cache = pimpl->visibilityCache;
+	const BoundingBox * tested[cullBatch];
+	size_t indices[cullBatch];
+	FrustumCuller::Result testedResults[cullBatch];
+	for (size_t first = 0; first < n; first += cullBatch) {
+		size_t nTested = 0;
+		for (size_t i = first, last = std::min(n, first + cullBatch);
+				i < last; ++i) {
+			if (cache != nullptr && cache->find(keys[i], *boxes[i],
+					boxToWorld, results[i])) {
+				++pimpl->cachedBoxes;
+			} else {
+				indices[nTested] = i;
+				tested[nTested++] = boxes[i];
+			}
+		}
+		if (nTested == 0) {
+			continue;
+		}
+
+		pimpl->currentView->cullFrustum(tested, nTested, boxToWorld,
+				pimpl->frustumResults.top(), testedResults);
+		for (size_t j = 0; j < nTested; ++j) {
+			auto & result = testedResults[j];
+			if (result.planes != View::culled && isOccluded(*tested[j])) {
+				// occluders move, so boxes they hide aren't kept
+				result.planes = View::culled;
+			} else if (cache != nullptr) {
+				cache->store(keys[indices[j]], *tested[j], boxToWorld, result);
+			}
+			results[indices[j]] = result;
+		}
+	}
+}
+
 /**
  * get additional view tasks for view
  *
@@ -310,6 +383,25 @@ const std::vector<std::shared_ptr<View>> & ViewBuilder::getAdditionalViewTasks()
 	return pimpl->additionalViewTasks;
 }
 
+/**
+ * get number of boxes whose result was kept from an earlier frame
+ *
+ * @return  boxes found in cache
+ */
+size_t ViewBuilder::getCachedBoxCount() const {
+	return pimpl->cachedBoxes;
+}
+
+/**
+ * get frustum result of box enclosing current state, giving planes boxes
+ * within it are tested against
+ *
+ * @return  frustum result
+ */
+const FrustumCuller::Result & ViewBuilder::getFrustumResult() const {
+	return pimpl->frustumResults.top();
+}
+
 size_t ViewBuilder::getPolyCount() const {
 	return pimpl->numPolygons;
 }
@@ -335,6 +427,17 @@ void ViewBuilder::incPolyCount(size_t n) {
 	pimpl->numPolygons += n;
 }
 
+/**
+ * Check bounding box is hidden by occlusion geometry
+ *
+ * @param box  box in current transform
+ *
+ * @return     true if box is hidden
+ */
+bool ViewBuilder::isOccluded(const BoundingBox & box) const {
+	return pimpl->occlusionMap.isOccluded(getState().getTransform(), box);
+}
+
 /**
  * Check bounding box is visible, by first checking for intersection with
  * camera frustum, and then testing against occlusion geometry
@@ -343,16 +446,18 @@ void ViewBuilder::incPolyCount(size_t n) {
  * @return
  */
 bool ViewBuilder::isVisible(const BoundingBox & box) const {
-	const auto transform = getState().getTransform();
-
-	if (pimpl->currentView->isVisible(box, transform) == false) {
+	const BoundingBox * boxes[] = { &box };
+	FrustumCuller::Result result;
+	pimpl->currentView->cullFrustum(boxes, 1, getState().getTransform(),
+			getFrustumResult(), &result);
+	if (result.planes == View::culled) {
 		return false;
 	}
 
 	//
 	// occlusion test
 	//
-	if (pimpl->occlusionMap.isOccluded(transform, ConvexHull(box))) {
+	if (isOccluded(box)) {
 		return false;
 	}
 
@@ -364,6 +469,7 @@ bool ViewBuilder::isVisible(const BoundingBox & box) const {
  */
 void ViewBuilder::popState() {
 	pimpl->stateStack.pop();
+	pimpl->frustumResults.pop();
 }
 
 /**
@@ -371,6 +477,16 @@ void ViewBuilder::popState() {
  */
 void ViewBuilder::pushState() {
 	pimpl->stateStack.emplace(pimpl->stateStack.top());
+	pimpl->frustumResults.push(pimpl->frustumResults.top());
+}
+
+/**
+ * set frustum result of box enclosing current state, until state is popped
+ *
+ * @param result  frustum result of box enclosing state
+ */
+void ViewBuilder::setFrustumResult(const FrustumCuller::Result & result) {
+	pimpl->frustumResults.top() = result;
 }
 
 /**
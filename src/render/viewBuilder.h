@@ -1,5 +1,8 @@
 #pragma once
 
+#include "../core/frustumCuller.h"
+
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -81,6 +84,22 @@ namespace render {
 		void applyRefraction(const std::string & name,
 				const Plane & worldPlane);
 
+		/**
+		 * Test boxes in current transform for visibility together, against
+		 * planes of view frustum current frustum result straddles and then
+		 * occlusion geometry. Results of boxes kept from earlier frames of
+		 * view are used while they hold, so boxes found visible that way
+		 * aren't tested against occlusion geometry
+		 *
+		 * @param keys     key of each box, such as its node, kept with result
+		 * @param boxes    boxes to test
+		 * @param n        number of boxes
+		 * @param results  result of each box, planes View::culled if not
+		 *                 visible, written
+		 */
+		void cull(const void * const * keys, const BoundingBox * const * boxes,
+				size_t n, FrustumCuller::Result * results);
+
 		/**
 		 * get additional view tasks for view
 		 *
@@ -88,6 +107,21 @@ namespace render {
 		 */
 		const std::vector<std::shared_ptr<View>> & getAdditionalViewTasks() const;
 
+		/**
+		 * get number of boxes whose result was kept from an earlier frame
+		 *
+		 * @return  boxes found in cache
+		 */
+		size_t getCachedBoxCount() const;
+
+		/**
+		 * get frustum result of box enclosing current state, giving planes
+		 * boxes within it are tested against
+		 *
+		 * @return  frustum result
+		 */
+		const FrustumCuller::Result & getFrustumResult() const;
+
 		size_t getPolyCount() const;
 
 		/**
@@ -103,6 +137,15 @@ namespace render {
 
 		void incPolyCount(size_t n);
 
+		/**
+		 * Check bounding box is hidden by occlusion geometry
+		 *
+		 * @param box  box in current transform
+		 *
+		 * @return     true if box is hidden
+		 */
+		bool isOccluded(const BoundingBox & box) const;
+
 		/**
 		 * Check bounding box is visible, by first checking for intersection with
 		 * camera frustum, and then testing against occlusion geometry
@@ -122,6 +165,14 @@ namespace render {
 		 */
 		void pushState();
 
+		/**
+		 * set frustum result of box enclosing current state, until state is
+		 * popped
+		 *
+		 * @param result  frustum result of box enclosing state
+		 */
+		void setFrustumResult(const FrustumCuller::Result & result);
+
 		/**
 		 * Show collisions
 		 */
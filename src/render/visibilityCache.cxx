@@ -0,0 +1,205 @@
+#include "visibilityCache.h"
+
+#include "../core/aspect.h"
+#include "../core/boundingBox.h"
+#include "../core/plane.h"
+#include "../core/transform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace render;
+
+namespace {
+	/*
+	 * result of box, with camera it was tested from
+	 */
+	struct Entry {
+		Vec3 min;
+		Vec3 max;
+		Transform boxToWorld;
+		Transform camera;
+		/** furthest distance of box from camera */
+		float reach;
+		FrustumCuller::Result result;
+		/** frame result is dropped on */
+		unsigned expires;
+	};
+
+	/*
+	 * caches of views not being built, by name of view
+	 */
+	std::mutex registryLock;
+	std::unordered_map<std::string, std::shared_ptr<VisibilityCache>> registry;
+}
+
+struct VisibilityCache::impl {
+	std::unordered_map<const void *, Entry> entries;
+	/** planes of view frustum results were found against */
+	std::vector<Plane> hull;
+	std::vector<Plane> clip;
+	Transform camera;
+	unsigned frame;
+	unsigned frames;
+
+	impl() :
+			frame(0), frames(0) {
+	}
+};
+
+/**
+ * constructor, no results
+ */
+VisibilityCache::VisibilityCache() :
+		pimpl(new impl()) {
+}
+
+/**
+ * destructor
+ */
+VisibilityCache::~VisibilityCache() {
+}
+
+/**
+ * take cache of view to use while building it, until given back by release.
+ * A view of the same name built meanwhile gets a new cache
+ *
+ * @param name  name of view
+ *
+ * @return      cache of view
+ */
+STATIC std::shared_ptr<VisibilityCache> VisibilityCache::acquire(
+		const std::string & name) {
+	std::lock_guard<std::mutex> locker(registryLock);
+	auto it = registry.find(name);
+	if (it == registry.end()) {
+		return std::make_shared<VisibilityCache>();
+	}
+	auto cache = it->second;
+	registry.erase(it);
+	return cache;
+}
+
+/**
+ * begin frame of view, dropping all results if view frustum changed shape
+ *
+ * @param aspect  aspect of view
+ * @param frames  most frames results are kept for
+ */
+void VisibilityCache::begin(const Aspect & aspect, unsigned frames) {
+	++pimpl->frame;
+	pimpl->camera = aspect.getRotTrans();
+
+	const auto & hull = aspect.getConvexHull().getPlanes();
+	const auto & clip = aspect.getClipPlanes();
+	if (frames != pimpl->frames || hull != pimpl->hull
+			|| clip != pimpl->clip) {
+		pimpl->entries.clear();
+		pimpl->hull = hull;
+		pimpl->clip = clip;
+		pimpl->frames = frames;
+	} else if (frames != 0 && pimpl->frame % frames == 0) {
+		// drop results of boxes no longer visited
+		for (auto it = pimpl->entries.begin(); it != pimpl->entries.end();) {
+			if (it->second.expires <= pimpl->frame) {
+				it = pimpl->entries.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+}
+
+/**
+ * find result of box stored in earlier frame, still holding from camera now
+ *
+ * @param key         key of box, such as its node
+ * @param box         box to find result of
+ * @param boxToWorld  transform to take box from local to world space
+ * @param result      result, margin lessened by camera movement, written if
+ *                    found
+ *
+ * @return            true if result found
+ */
+bool VisibilityCache::find(const void * key, const BoundingBox & box,
+		const Transform & boxToWorld, FrustumCuller::Result & result) const {
+	auto it = pimpl->entries.find(key);
+	if (it == pimpl->entries.end()) {
+		return false;
+	}
+	const auto & entry = it->second;
+	if (entry.expires <= pimpl->frame || entry.boxToWorld != boxToWorld
+			|| !(entry.min == box.getMin()) || !(entry.max == box.getMax())) {
+		return false;
+	}
+
+	//
+	// points of box move in camera space by no more than camera translation,
+	// and the chord of camera rotation at their distance from camera
+	//
+	const auto & camera = pimpl->camera;
+	float moved = static_cast<float>((camera.getTranslation()
+			- entry.camera.getTranslation()).length());
+	auto q = camera.getRotation();
+	auto r = entry.camera.getRotation();
+	float cosHalf = q.getX() * r.getX() + q.getY() * r.getY()
+			+ q.getZ() * r.getZ() + q.getW() * r.getW();
+	moved += 2 * std::sqrt(std::max(0.0f, 1 - cosHalf * cosHalf))
+			* entry.reach;
+	if (moved > entry.result.margin) {
+		return false;
+	}
+
+	result = entry.result;
+	result.margin -= moved;
+	return true;
+}
+
+/**
+ * give back cache of view taken by acquire
+ *
+ * @param name   name of view
+ * @param cache  cache of view
+ */
+STATIC void VisibilityCache::release(const std::string & name,
+		const std::shared_ptr<VisibilityCache> & cache) {
+	std::lock_guard<std::mutex> locker(registryLock);
+	registry[name] = cache;
+}
+
+/**
+ * store result of box tested this frame, if it can be carried on to later
+ * frames. Results of boxes straddling planes aren't
+ *
+ * @param key         key of box, such as its node
+ * @param box         box tested
+ * @param boxToWorld  transform to take box from local to world space
+ * @param result      result of frustum test of box
+ */
+void VisibilityCache::store(const void * key, const BoundingBox & box,
+		const Transform & boxToWorld, const FrustumCuller::Result & result) {
+	if (pimpl->frames == 0 || ((result.planes & FrustumCuller::outside) == 0
+			&& result.planes != 0)) {
+		return;
+	}
+
+	auto & entry = pimpl->entries[key];
+	entry.min = box.getMin();
+	entry.max = box.getMax();
+	entry.boxToWorld = boxToWorld;
+	entry.camera = pimpl->camera;
+	Vec3 centre = box.getCentre();
+	boxToWorld.transformPoint(centre);
+	entry.reach = static_cast<float>(
+			(centre - pimpl->camera.getTranslation()).length()
+					+ box.getRadius());
+	entry.result = result;
+	// spread expiry by key, so boxes stored together are retested apart
+	auto spread = static_cast<unsigned>(
+			reinterpret_cast<uintptr_t>(key) >> 4) % ((pimpl->frames + 1) / 2);
+	entry.expires = pimpl->frame + pimpl->frames - spread;
+}
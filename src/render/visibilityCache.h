@@ -0,0 +1,96 @@
+#pragma once
+
+#include "../core/frustumCuller.h"
+
+#include <memory>
+#include <string>
+
+class Aspect;
+class BoundingBox;
+class Transform;
+
+namespace render {
+
+	/*
+	 * Frustum results of boxes carried from frame to frame of a view. A box
+	 * left where it was keeps its result while the camera has moved less than
+	 * the margin of the result, so only boxes near planes of the view frustum
+	 * or moved are retested. Results are kept a number of frames at most,
+	 * after which boxes are retested in full
+	 */
+	class VisibilityCache final {
+	public:
+
+		/**
+		 * constructor, no results
+		 */
+		VisibilityCache();
+
+		/**
+		 * destructor
+		 */
+		~VisibilityCache();
+
+		/**
+		 * take cache of view to use while building it, until given back by
+		 * release. A view of the same name built meanwhile gets a new cache
+		 *
+		 * @param name  name of view
+		 *
+		 * @return      cache of view
+		 */
+		static std::shared_ptr<VisibilityCache> acquire(
+				const std::string & name);
+
+		/**
+		 * begin frame of view, dropping all results if view frustum changed
+		 * shape
+		 *
+		 * @param aspect  aspect of view
+		 * @param frames  most frames results are kept for
+		 */
+		void begin(const Aspect & aspect, unsigned frames);
+
+		/**
+		 * find result of box stored in earlier frame, still holding from
+		 * camera now
+		 *
+		 * @param key         key of box, such as its node
+		 * @param box         box to find result of
+		 * @param boxToWorld  transform to take box from local to world space
+		 * @param result      result, margin lessened by camera movement,
+		 *                    written if found
+		 *
+		 * @return            true if result found
+		 */
+		bool find(const void * key, const BoundingBox & box,
+				const Transform & boxToWorld,
+				FrustumCuller::Result & result) const;
+
+		/**
+		 * give back cache of view taken by acquire
+		 *
+		 * @param name   name of view
+		 * @param cache  cache of view
+		 */
+		static void release(const std::string & name,
+				const std::shared_ptr<VisibilityCache> & cache);
+
+		/**
+		 * store result of box tested this frame, if it can be carried on to
+		 * later frames. Results of boxes straddling planes aren't
+		 *
+		 * @param key         key of box, such as its node
+		 * @param box         box tested
+		 * @param boxToWorld  transform to take box from local to world space
+		 * @param result      result of frustum test of box
+		 */
+		void store(const void * key, const BoundingBox & box,
+				const Transform & boxToWorld,
+				const FrustumCuller::Result & result);
+
+	private:
+		struct impl;
+		std::unique_ptr<impl> pimpl;
+	};
+}
@@ -36,6 +36,9 @@ struct Builder::impl {
 	std::stack<Transform> transformStack;
 	int id;
 	size_t polyCount;
+	size_t boxesTested;
+	size_t boxesCulled;
+	size_t boxesCached;
 	std::vector<DebugGeometry> debugGeometry;
 
 	std::deque<std::thread> threads;
@@ -46,6 +49,9 @@ struct Builder::impl {
 					renderGraph(std::make_shared<RenderGraph>()),
 					id(++uid),
 					polyCount(0),
+					boxesTested(0),
+					boxesCulled(0),
+					boxesCached(0),
 					debugGeometry(debug) {
 
 	}
@@ -124,6 +130,33 @@ std::shared_ptr<render::RenderGraph> & Builder::execute() {
 	return pimpl->renderGraph;
 }
 
+/**
+ * get number of boxes whose visibility was kept from earlier frames
+ *
+ * @return  boxes found in visibility caches
+ */
+size_t Builder::getBoxesCached() const {
+	return pimpl->boxesCached;
+}
+
+/**
+ * get number of boxes culled by view frustums
+ *
+ * @return  boxes culled
+ */
+size_t Builder::getBoxesCulled() const {
+	return pimpl->boxesCulled;
+}
+
+/**
+ * get number of boxes tested against view frustums
+ *
+ * @return  boxes tested
+ */
+size_t Builder::getBoxesTested() const {
+	return pimpl->boxesTested;
+}
+
 /**
  * get debug geometry
  *
@@ -178,6 +211,20 @@ const Transform & Builder::getTransform() const {
 	return pimpl->transformStack.top();
 }
 
+/**
+ * increment counts of boxes tested against view frustums
+ *
+ * @param tested  number of extra boxes tested
+ * @param culled  number of extra boxes culled
+ * @param cached  number of extra boxes found in visibility caches
+ */
+void Builder::incBoxCounts(size_t tested, size_t culled, size_t cached) {
+	std::lock_guard<std::mutex> locker(pimpl->m_lock);
+	pimpl->boxesTested += tested;
+	pimpl->boxesCulled += culled;
+	pimpl->boxesCached += cached;
+}
+
 /**
  * increment pass polygon count
  *
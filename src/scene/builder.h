@@ -53,6 +53,27 @@ public:
 	 */
 	const std::vector<DebugGeometry> & getDebugGeometry() const;
 
+	/**
+	 * get number of boxes whose visibility was kept from earlier frames
+	 *
+	 * @return  boxes found in visibility caches
+	 */
+	size_t getBoxesCached() const;
+
+	/**
+	 * get number of boxes culled by view frustums
+	 *
+	 * @return  boxes culled
+	 */
+	size_t getBoxesCulled() const;
+
+	/**
+	 * get number of boxes tested against view frustums
+	 *
+	 * @return  boxes tested
+	 */
+	size_t getBoxesTested() const;
+
 	/**
 	 * get builder id
 	 *
@@ -88,6 +109,15 @@ public:
 	 */
 	const Transform & getTransform() const;
 
+	/**
+	 * increment counts of boxes tested against view frustums
+	 *
+	 * @param tested  number of extra boxes tested
+	 * @param culled  number of extra boxes culled
+	 * @param cached  number of extra boxes found in visibility caches
+	 */
+	void incBoxCounts(size_t tested, size_t culled, size_t cached);
+
 	/**
 	 * increment pass polygon count
 	 *
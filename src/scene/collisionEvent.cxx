@@ -65,7 +65,8 @@ namespace {
 			auto collisionEvent = std::static_pointer_cast<CollisionEvent>(
 					self);
 
-			stack.push(std::make_shared<Normal>(collisionEvent->getNormal()));
+			stack.push(std::make_shared<ScriptNormal>(
+					collisionEvent->getNormal()));
 		}
 	};
 
@@ -80,7 +81,8 @@ namespace {
 			auto collisionEvent = std::static_pointer_cast<CollisionEvent>(
 					self);
 
-			stack.push(std::make_shared<Vec3>(collisionEvent->getPoint()));
+			stack.push(
+					std::make_shared<ScriptVec3>(collisionEvent->getPoint()));
 		}
 	};
 
@@ -98,7 +100,7 @@ namespace {
 			auto normal = collisionEvent->getNormal();
 			collisionEvent->getBody0Transform().rotate(normal);
 
-			stack.push(std::make_shared<Normal>(normal));
+			stack.push(std::make_shared<ScriptNormal>(normal));
 		}
 	};
 
@@ -116,7 +118,7 @@ namespace {
 			auto normal = -collisionEvent->getNormal();
 			collisionEvent->getBody0Transform().rotate(normal);
 
-			stack.push(std::make_shared<Normal>(normal));
+			stack.push(std::make_shared<ScriptNormal>(normal));
 		}
 	};
 
@@ -134,7 +136,7 @@ namespace {
 			auto point = collisionEvent->getPoint();
 			collisionEvent->getBody0Transform().transformPoint(point);
 
-			stack.push(std::make_shared<Vec3>(point));
+			stack.push(std::make_shared<ScriptVec3>(point));
 		}
 	};
 
@@ -154,7 +156,7 @@ namespace {
 			point.scaleAdd(collisionEvent->getDepth(),
 					collisionEvent->getNormal(), point);
 
-			stack.push(std::make_shared<Vec3>(point));
+			stack.push(std::make_shared<ScriptVec3>(point));
 		}
 	};
 }
@@ -216,3 +218,89 @@ OVERRIDE ScriptObjectPtr CollisionEvent::getMember(
 	}
 	return ScriptObject::getMember(execState, name);
 }
+
+/**
+ * reuse event for another contact
+ *
+ * @param bodyName0        name of first body
+ * @param bodyName1        name of second body
+ * @param body0Transform   transform from first body space to world
+ * @param intersection     intersection in first body space
+ */
+void CollisionEvent::set(const std::string & bodyName0,
+		const std::string & bodyName1, const Transform & body0Transform,
+		const Intersection & intersection) {
+	body0 = bodyName0;
+	body1 = bodyName1;
+	this->body0Transform = body0Transform;
+	normal = intersection.getNormal();
+	point = intersection.getPoint();
+	depth = intersection.getDepth();
+}
+
+/**
+ * constructor
+ */
+CollisionEventPool::CollisionEventPool() :
+		m_acquired(0) {
+}
+
+/**
+ * destructor
+ */
+CollisionEventPool::~CollisionEventPool() {
+}
+
+/**
+ * get event for contact, reusing a released event if any
+ *
+ * @param bodyName0        name of first body
+ * @param bodyName1        name of second body
+ * @param body0Transform   transform from first body space to world
+ * @param intersection     intersection in first body space
+ *
+ * @return                 event
+ */
+std::shared_ptr<CollisionEvent> CollisionEventPool::acquire(
+		const std::string & bodyName0, const std::string & bodyName1,
+		const Transform & body0Transform, const Intersection & intersection) {
+	++m_acquired;
+	if (m_free.empty()) {
+		m_events.emplace_back(std::make_shared<CollisionEvent>(bodyName0,
+				bodyName1, body0Transform, intersection));
+		return m_events.back();
+	}
+	const auto & event = m_events[m_free.back()];
+	m_free.pop_back();
+	event->set(bodyName0, bodyName1, body0Transform, intersection);
+	return event;
+}
+
+/**
+ * find events released since last recycle, ready to be acquired, keeping no
+ * more of them than were acquired since last recycle
+ */
+void CollisionEventPool::recycle() {
+	// drop released events beyond recent use, keeping order of the rest
+	size_t kept = 0;
+	size_t released = 0;
+	for (size_t i = 0, n = m_events.size(); i < n; ++i) {
+		// only held by pool
+		if (m_events[i].use_count() == 1 && released++ >= m_acquired) {
+			continue;
+		}
+		if (kept != i) {
+			m_events[kept] = std::move(m_events[i]);
+		}
+		++kept;
+	}
+	m_events.resize(kept);
+	m_acquired = 0;
+
+	m_free.clear();
+	for (size_t i = m_events.size(); i-- > 0;) {
+		if (m_events[i].use_count() == 1) {
+			m_free.emplace_back(i);
+		}
+	}
+}
@@ -6,7 +6,9 @@
 
 #include "../scripting/scriptObject.h"
 
+#include <memory>
 #include <string>
+#include <vector>
 
 class Intersection;
 
@@ -62,6 +64,18 @@ public:
 		return point;
 	}
 
+	/**
+	 * reuse event for another contact
+	 *
+	 * @param bodyName0        name of first body
+	 * @param bodyName1        name of second body
+	 * @param body0Transform   transform from first body space to world
+	 * @param intersection     intersection in first body space
+	 */
+	void set(const std::string & bodyName0, const std::string & bodyName1,
+			const Transform & body0Transform,
+			const Intersection & intersection);
+
 private:
 	std::string body0;
 	std::string body1;
@@ -71,3 +85,49 @@ private:
 	double depth;
 };
 
+/*
+ * Collision events kept across updates, so events no longer held by scripts
+ * are reused rather than allocated again. Released events beyond those
+ * acquired since last recycle are dropped, so the pool follows recent use
+ * rather than its largest
+ */
+class CollisionEventPool final {
+public:
+
+	/**
+	 * constructor
+	 */
+	CollisionEventPool();
+
+	/**
+	 * destructor
+	 */
+	~CollisionEventPool();
+
+	/**
+	 * get event for contact, reusing a released event if any
+	 *
+	 * @param bodyName0        name of first body
+	 * @param bodyName1        name of second body
+	 * @param body0Transform   transform from first body space to world
+	 * @param intersection     intersection in first body space
+	 *
+	 * @return                 event
+	 */
+	std::shared_ptr<CollisionEvent> acquire(const std::string & bodyName0,
+			const std::string & bodyName1, const Transform & body0Transform,
+			const Intersection & intersection);
+
+	/**
+	 * find events released since last recycle, ready to be acquired,
+	 * keeping no more of them than were acquired since last recycle
+	 */
+	void recycle();
+
+private:
+	std::vector<std::shared_ptr<CollisionEvent>> m_events;
+	/** indices of released events */
+	std::vector<size_t> m_free;
+	/** events acquired since last recycle */
+	size_t m_acquired;
+};
@@ -0,0 +1,238 @@
+#include "collisionWorld.h"
+
+#include "../core/aabbTree.h"
+#include "../core/boundingBox.h"
+#include "../core/ray.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+	/** fattening of bounds in hierarchy, so small movements are free */
+	const double margin = .1;
+
+	/*
+	 * objects sharing name, matched to entries by order
+	 */
+	struct NameEntry {
+		std::vector<size_t> slots;
+		unsigned commitId;
+		size_t next;
+
+		NameEntry() :
+				commitId(0), next(0) {
+		}
+	};
+
+	/*
+	 * are bounds of hierarchies the same
+	 */
+	bool sameBounds(const CollisionHierarchy & a,
+			const CollisionHierarchy & b) {
+		const auto & ba = a.getBounds();
+		const auto & bb = b.getBounds();
+		return ba.getMin() == bb.getMin() && ba.getMax() == bb.getMax();
+	}
+}
+
+const uint32_t CollisionWorld::defaultLayers = 1;
+const uint32_t CollisionWorld::allLayers = 0xffffffff;
+
+struct CollisionWorld::impl {
+	AabbTree tree;
+	/** object slots, slots with null proxy are free */
+	std::vector<Object> objects;
+	std::vector<int> proxies;
+	/** commit each slot was last matched in */
+	std::vector<unsigned> committed;
+	std::vector<size_t> freeSlots;
+	std::unordered_map<std::string, NameEntry> names;
+	std::vector<size_t> moved;
+	unsigned commitId;
+	size_t count;
+
+	impl() :
+			tree(margin), commitId(0), count(0) {
+	}
+
+	/*
+	 * add object to free or new slot
+	 */
+	size_t add(const Entry & s) {
+		size_t slot;
+		if (freeSlots.empty()) {
+			slot = objects.size();
+			objects.emplace_back(s.name, s.current, s.hierarchy, s.group,
+					s.mask);
+			proxies.emplace_back(AabbTree::nullNode);
+			committed.emplace_back(0);
+		} else {
+			slot = freeSlots.back();
+			freeSlots.pop_back();
+			objects[slot] = Object(s.name, s.current, s.hierarchy, s.group,
+					s.mask);
+		}
+		proxies[slot] = tree.insert(
+				s.hierarchy.getBounds().transformed(s.current), slot);
+		++count;
+		return slot;
+	}
+
+	/*
+	 * remove object from hierarchy and free its slot
+	 */
+	void remove(size_t slot) {
+		tree.remove(proxies[slot]);
+		proxies[slot] = AabbTree::nullNode;
+		freeSlots.emplace_back(slot);
+		--count;
+
+		auto it = names.find(objects[slot].name);
+		auto & slots = it->second.slots;
+		slots.erase(std::find(slots.begin(), slots.end(), slot));
+		if (slots.empty()) {
+			names.erase(it);
+		}
+	}
+};
+
+/**
+ * constructor
+ */
+CollisionWorld::CollisionWorld() :
+		pimpl(new impl()) {
+}
+
+/**
+ * destructor
+ */
+CollisionWorld::~CollisionWorld() {
+}
+
+/**
+ * replace objects with collisions of an update, objects are matched by
+ * name and order, unmatched objects are removed
+ *
+ * @param entries  collisions of update
+ */
+void CollisionWorld::commit(const std::vector<Entry> & entries) {
+	++pimpl->commitId;
+
+	for (auto slot : pimpl->moved) {
+		pimpl->objects[slot].moved = false;
+	}
+	pimpl->moved.clear();
+
+	size_t seen = 0;
+	for (const auto & s : entries) {
+		auto & entry = pimpl->names[s.name];
+		if (entry.commitId != pimpl->commitId) {
+			entry.commitId = pimpl->commitId;
+			entry.next = 0;
+		}
+
+		size_t slot;
+		if (entry.next < entry.slots.size()) {
+			slot = entry.slots[entry.next];
+			auto & object = pimpl->objects[slot];
+			// refit only if world bounds could have changed
+			if (object.transform != s.current
+					|| sameBounds(object.hierarchy, s.hierarchy) == false) {
+				object.transform = s.current;
+				pimpl->tree.move(pimpl->proxies[slot],
+						s.hierarchy.getBounds().transformed(s.current));
+			}
+			object.hierarchy = s.hierarchy;
+			object.group = s.group;
+			object.mask = s.mask;
+		} else {
+			slot = pimpl->add(s);
+			entry.slots.emplace_back(slot);
+		}
+		++entry.next;
+		++seen;
+		pimpl->committed[slot] = pimpl->commitId;
+
+		if (s.previous != s.current) {
+			pimpl->objects[slot].moved = true;
+			pimpl->moved.emplace_back(slot);
+		}
+	}
+
+	// remove objects no longer in scene
+	if (seen != pimpl->count) {
+		for (size_t slot = 0, n = pimpl->objects.size(); slot < n; ++slot) {
+			if (pimpl->proxies[slot] != AabbTree::nullNode
+					&& pimpl->committed[slot] != pimpl->commitId) {
+				pimpl->remove(slot);
+			}
+		}
+	}
+}
+
+/**
+ * call function for every committed object
+ *
+ * @param fn  function taking object index
+ */
+void CollisionWorld::forEach(const std::function<void(size_t)> & fn) const {
+	for (size_t slot = 0, n = pimpl->objects.size(); slot < n; ++slot) {
+		if (pimpl->proxies[slot] != AabbTree::nullNode) {
+			fn(slot);
+		}
+	}
+}
+
+/**
+ * get indices of objects that moved during last committed update
+ *
+ * @return  list of object indices
+ */
+const std::vector<size_t> & CollisionWorld::getMoved() const {
+	return pimpl->moved;
+}
+
+/**
+ * get committed object
+ *
+ * @param index  object index
+ *
+ * @return       object
+ */
+const CollisionWorld::Object & CollisionWorld::getObject(size_t index) const {
+	return pimpl->objects[index];
+}
+
+/**
+ * call function for every committed object whose bounds may intersect
+ * given bounds
+ *
+ * @param bounds  world space bounds
+ * @param fn      function taking object index
+ */
+void CollisionWorld::query(const BoundingBox & bounds,
+		const std::function<void(size_t)> & fn) const {
+	const auto & tree = pimpl->tree;
+	auto leaf = [&](int proxy) {
+		fn(tree.getData(proxy));
+	};
+	tree.query(bounds, leaf);
+}
+
+/**
+ * call function for every committed object whose bounds ray passes
+ * through before limit, nearer objects first. Function returns new
+ * limit, negative to stop
+ *
+ * @param ray    world space ray, extending beyond its end
+ * @param limit  distance along ray to stop at, may be infinite
+ * @param fn     function taking object index, returning limit
+ */
+void CollisionWorld::rayCast(const Ray & ray, double limit,
+		const std::function<double(size_t)> & fn) const {
+	const auto & tree = pimpl->tree;
+	auto leaf = [&](int proxy) {
+		return fn(tree.getData(proxy));
+	};
+	tree.rayCast(ray.getStart(), ray.getDirection(), limit, leaf);
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "../core/collisionHierarchy.h"
+#include "../core/transform.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class BoundingBox;
+class Ray;
+
+/*
+ * Static and kinematic collision objects, kept in a bounding volume hierarchy
+ * that persists across updates. Each update's collisions are committed when
+ * physics is resolved, and only objects whose transform changed touch the
+ * hierarchy
+ */
+class CollisionWorld {
+public:
+
+	/*
+	 * collision as added during an update
+	 */
+	struct Entry {
+		std::string name;
+		Transform previous;
+		Transform current;
+		CollisionHierarchy hierarchy;
+		/** bitmask of layers collision is in */
+		uint32_t group;
+		/** bitmask of layers collision collides with */
+		uint32_t mask;
+
+		Entry(const std::string & name, const Transform & previous,
+				const Transform & current,
+				const CollisionHierarchy & hierarchy, uint32_t group,
+				uint32_t mask) :
+						name(name),
+						previous(previous),
+						current(current),
+						hierarchy(hierarchy),
+						group(group),
+						mask(mask) {
+		}
+	};
+
+	struct Object {
+		std::string name;
+		Transform transform;
+		CollisionHierarchy hierarchy;
+		/** bitmask of layers object is in */
+		uint32_t group;
+		/** bitmask of layers object collides with */
+		uint32_t mask;
+		/** moved during last committed update */
+		bool moved;
+
+		Object(const std::string & name, const Transform & transform,
+				const CollisionHierarchy & hierarchy, uint32_t group,
+				uint32_t mask) :
+						name(name),
+						transform(transform),
+						hierarchy(hierarchy),
+						group(group),
+						mask(mask),
+						moved(false) {
+		}
+	};
+
+	/** layers of collisions not given any */
+	static const uint32_t defaultLayers;
+	/** layer mask of queries and collisions not given any */
+	static const uint32_t allLayers;
+
+	/**
+	 * constructor
+	 */
+	CollisionWorld();
+
+	/**
+	 * destructor
+	 */
+	~CollisionWorld();
+
+	/**
+	 * replace objects with collisions of an update, objects are matched by
+	 * name and order, unmatched objects are removed
+	 *
+	 * @param entries  collisions of update
+	 */
+	void commit(const std::vector<Entry> & entries);
+
+	/**
+	 * call function for every committed object
+	 *
+	 * @param fn  function taking object index
+	 */
+	void forEach(const std::function<void(size_t)> & fn) const;
+
+	/**
+	 * get indices of objects that moved during last committed update
+	 *
+	 * @return  list of object indices
+	 */
+	const std::vector<size_t> & getMoved() const;
+
+	/**
+	 * get committed object
+	 *
+	 * @param index  object index
+	 *
+	 * @return       object
+	 */
+	const Object & getObject(size_t index) const;
+
+	/**
+	 * call function for every committed object whose bounds may intersect
+	 * given bounds
+	 *
+	 * @param bounds  world space bounds
+	 * @param fn      function taking object index
+	 */
+	void query(const BoundingBox & bounds,
+			const std::function<void(size_t)> & fn) const;
+
+	/**
+	 * call function for every committed object whose bounds ray passes
+	 * through before limit, nearer objects first. Function returns new
+	 * limit, negative to stop
+	 *
+	 * @param ray    world space ray, extending beyond its end
+	 * @param limit  distance along ray to stop at, may be infinite
+	 * @param fn     function taking object index, returning limit
+	 */
+	void rayCast(const Ray & ray, double limit,
+			const std::function<double(size_t)> & fn) const;
+
+private:
+	struct impl;
+	std::unique_ptr<impl> pimpl;
+};
+
@@ -1,61 +1,688 @@
 #include "physics.h"
 
 #include "collisionEvent.h"
+#include "collisionWorld.h"
 
+#include "../core/aabbTree.h"
 #include "../core/boundingBox.h"
 #include "../core/bucket3d.h"
 #include "../core/collisionHierarchy.h"
 #include "../core/constraint.h"
+#include "../core/contactManifold.h"
 #include "../core/endEffector.h"
 #include "../core/intersection.h"
+#include "../core/quat.h"
 #include "../core/ray.h"
 #include "../core/rigidBody.h"
+#include "../core/sphere.h"
+#include "../core/threadPool.h"
 
+#include "../scripting/executable.h"
+#include "../scripting/parameters.h"
 #include "../scripting/real.h"
 #include "../scripting/string.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <unordered_set>
 
 namespace {
-	struct CollisionObject {
-		std::string name;
+	/*
+	 * contacts of pair, with transform of first of pair, names outlive
+	 * contacts
+	 */
+	struct PairContacts {
+		const std::string * name0;
+		const std::string * name1;
 		Transform transform;
-		CollisionHierarchy hierarchy;
-		bool moved;
+		ContactManifold contacts;
 
-		CollisionObject(const std::string & name, const Transform & previous,
-				const Transform & current, const CollisionHierarchy & hierarchy) :
-						name(name),
-						transform(current),
-						hierarchy(hierarchy),
-						moved(previous != current) {
+		PairContacts(const std::string & name0, const std::string & name1,
+				const Transform & transform,
+				const ContactManifold & contacts) :
+						name0(&name0),
+						name1(&name1),
+						transform(transform),
+						contacts(contacts) {
 		}
 	};
 
+	/*
+	 * does each of pair collide with layers other is in
+	 */
+	bool layersCollide(uint32_t group0, uint32_t mask0, uint32_t group1,
+			uint32_t mask1) {
+		return (group0 & mask1) != 0 && (group1 & mask0) != 0;
+	}
+
+	/*
+	 * constraint with its bodies resolved to indices
+	 */
+	struct Joint {
+		size_t constraint;
+		size_t body0;
+		size_t body1;
+
+		Joint(size_t constraint, size_t body0, size_t body1) :
+				constraint(constraint), body0(body0), body1(body1) {
+		}
+	};
+
+	/*
+	 * body of chain rotated about pivot of constraint joining it to next
+	 * body toward root
+	 */
+	struct IkLink {
+		size_t body;
+		size_t constraint;
+
+		IkLink(size_t body, size_t constraint) :
+				body(body), constraint(constraint) {
+		}
+	};
+
+	/*
+	 * end effector with body resolved to index, and links from that body
+	 * toward root of its chain
+	 */
+	struct IkChain {
+		size_t effector;
+		size_t body;
+		std::vector<IkLink> links;
+
+		IkChain(size_t effector, size_t body) :
+				effector(effector), body(body) {
+		}
+	};
+
+	/** distance of end of chain from goal that inverse kinematics accepts */
+	const double ikTolerance = 1e-3;
+	/** most a link turns toward goal per step, radians */
+	const double maxIkRotation = .01;
+
+	/*
+	 * pairs of bodies, by index, that never collide, from joints and no
+	 * collide names. Names are looked up once per resolve, so testing a
+	 * pair needs no strings
+	 */
+	class Exclusions {
+	public:
+		Exclusions(const std::vector<RigidBody> & bodies,
+				const std::unordered_map<std::string, size_t> & indices,
+				const std::vector<Joint> & joints) :
+				excluding(bodies.size(), false) {
+			for (const auto & joint : joints) {
+				add(joint.body0, joint.body1);
+			}
+			for (size_t i = 0, n = bodies.size(); i < n; ++i) {
+				for (const auto & name : bodies[i].getNoCollide()) {
+					auto it = indices.find(name);
+					if (it != indices.end()) {
+						add(i, it->second);
+					}
+				}
+			}
+		}
+
+		/*
+		 * is pair of bodies excluded from colliding
+		 */
+		bool excluded(size_t a, size_t b) const {
+			if (excluding[a] == false || excluding[b] == false) {
+				return false;
+			}
+			return pairs.find(key(a, b)) != pairs.end();
+		}
+
+	private:
+		std::unordered_set<uint64_t> pairs;
+		/** body is in at least one excluded pair */
+		std::vector<bool> excluding;
+
+		static uint64_t key(size_t a, size_t b) {
+			return (static_cast<uint64_t>(std::min(a, b)) << 32)
+					| static_cast<uint64_t>(std::max(a, b));
+		}
+
+		void add(size_t a, size_t b) {
+			pairs.emplace(key(a, b));
+			excluding[a] = true;
+			excluding[b] = true;
+		}
+	};
+
+	/*
+	 * do pair of bodies collide with each other? not if both are static, ie
+	 * infinite mass, not if either misses layers of other, and not
+	 * if excluded
+	 */
+	bool collidable(const std::vector<RigidBody> & bodies,
+			const Exclusions & exclusions, size_t a, size_t b) {
+		const auto & rba = bodies[a];
+		const auto & rbb = bodies[b];
+		if (rba.getInverseMass() == 0 && rbb.getInverseMass() == 0) {
+			return false;
+		}
+		if (layersCollide(rba.getCollisionGroup(), rba.getCollisionMask(),
+				rbb.getCollisionGroup(), rbb.getCollisionMask()) == false) {
+			return false;
+		}
+		return exclusions.excluded(a, b) == false;
+	}
+
 	struct BodyCol {
-		RigidBody body;
-		std::vector<ScriptObjectPtr> & collisionEvents;
+		const CollisionWorld & world;
+		const RigidBody & body;
+		std::vector<PairContacts> & pairs;
 
-		BodyCol(const RigidBody & body,
-				std::vector<ScriptObjectPtr> & collisionEvents) :
-				body(body), collisionEvents(collisionEvents) {
+		BodyCol(const CollisionWorld & world, const RigidBody & body,
+				std::vector<PairContacts> & pairs) :
+				world(world), body(body), pairs(pairs) {
 		}
 
-		void operator()(const CollisionObject & collision) {
+		void operator()(size_t index) {
+			const auto & collision = world.getObject(index);
+			if (layersCollide(body.getCollisionGroup(),
+					body.getCollisionMask(), collision.group,
+					collision.mask) == false) {
+				return;
+			}
 			if (body.noCollide(collision.name)) {
 				return;
 			}
-			Transform transform = body.getTransform();
+			const auto & transform = body.getTransform();
 
-			auto intersections = body.getCollision().collide(
-					collision.hierarchy, collision.transform.to(transform));
-			for (const auto & intersection : intersections) {
-				collisionEvents.emplace_back(
-						std::make_shared<CollisionEvent>(body.getName(),
-								collision.name, transform, intersection));
+			ContactManifold contacts;
+			body.getCollision().collide(collision.hierarchy,
+					collision.transform.to(transform), contacts);
+			if (contacts.empty() == false) {
+				pairs.emplace_back(body.getName(), collision.name, transform,
+						contacts);
 			}
 		}
 	};
+
+	/*
+	 * result of resolving collision between pair of bodies
+	 */
+	struct PairResult {
+		ContactManifold contacts;
+		/** transform of first body after resolution */
+		Transform transform;
+	};
+
+	/*
+	 * acquire event for each contact of each pair
+	 */
+	void addEvents(const std::vector<PairContacts> & pairs,
+			CollisionEventPool & eventPool,
+			std::vector<ScriptObjectPtr> & collisionEvents) {
+		for (const auto & pair : pairs) {
+			for (const auto & contact : pair.contacts) {
+				collisionEvents.emplace_back(eventPool.acquire(*pair.name0,
+						*pair.name1, pair.transform, contact));
+			}
+		}
+	}
+
+	/*
+	 * world space bounds of collision object
+	 */
+	BoundingBox getBounds(const CollisionWorld::Object & object) {
+		return object.hierarchy.getBounds().transformed(object.transform);
+	}
+
+	/*
+	 * collide moved collision objects against overlapping collision objects,
+	 * each pair tested once, earlier object first
+	 */
+	void collideMoved(const CollisionWorld & world, ThreadPool & pool,
+			std::vector<PairContacts> & pairs) {
+		const auto & moved = world.getMoved();
+		std::vector<std::vector<PairContacts>> movedPairs(moved.size());
+		pool.parallelFor(moved.size(), [&](size_t k) {
+			size_t i = moved[k];
+			world.query(getBounds(world.getObject(i)), [&](size_t j) {
+				if (j == i || (j < i && world.getObject(j).moved)) {
+					// self, or tested from other side
+					return;
+				}
+				const auto & a = world.getObject(std::min(i, j));
+				const auto & b = world.getObject(std::max(i, j));
+				if (layersCollide(a.group, a.mask, b.group, b.mask) == false) {
+					return;
+				}
+				ContactManifold contacts;
+				a.hierarchy.collide(b.hierarchy, b.transform.to(a.transform),
+						contacts);
+				if (contacts.empty() == false) {
+					movedPairs[k].emplace_back(a.name, b.name, a.transform,
+							contacts);
+				}
+			});
+		});
+		for (const auto & list : movedPairs) {
+			pairs.insert(pairs.end(), list.begin(), list.end());
+		}
+	}
+
+	/** sweep samples per sphere radius, so gaps between samples are small */
+	const double sweepSamplesPerRadius = 2;
+	/** most samples of sweep, very long sweeps are sampled more coarsely */
+	const unsigned maxSweepSamples = 1024;
+	/** bisections refining time of first contact of sweep */
+	const unsigned sweepBisections = 8;
+	/**
+	 * deepening, as part of radius, of contact body starts step in that is
+	 * taken as moving into other body
+	 */
+	const double sweepDeepening = 1e-3;
+
+	/*
+	 * deepest contact of shape, moved by offset, with collision object, in
+	 * world space
+	 */
+	bool deepestContact(const CollisionWorld::Object & object,
+			const CollisionHierarchy & shape, const Vec3 & offset,
+			Intersection & contact) {
+		Transform toWorld(offset, Quat(0, 0, 0, 1));
+		ContactManifold contacts;
+		object.hierarchy.collide(shape, toWorld.to(object.transform),
+				contacts);
+		if (contacts.empty()) {
+			return false;
+		}
+		contact = contacts.getDeepest();
+		contact.transform(object.transform);
+		return true;
+	}
+
+	/*
+	 * first contact of shape swept by delta with collision object, found by
+	 * sampling along sweep then bisecting between last clear sample and
+	 * first contact, t is fraction of sweep
+	 */
+	bool firstContact(const CollisionWorld::Object & object,
+			const CollisionHierarchy & shape, const Vec3 & delta,
+			unsigned nSamples, double & t, Intersection & contact) {
+		if (deepestContact(object, shape, Vec3(), contact)) {
+			t = 0;
+			return true;
+		}
+		for (unsigned i = 1; i <= nSamples; ++i) {
+			double s = static_cast<double>(i) / nSamples;
+			if (deepestContact(object, shape, delta * s, contact)) {
+				double lo = static_cast<double>(i - 1) / nSamples;
+				double hi = s;
+				for (unsigned j = 0; j < sweepBisections; ++j) {
+					double mid = .5 * (lo + hi);
+					Intersection c;
+					if (deepestContact(object, shape, delta * mid, c)) {
+						hi = mid;
+						contact = c;
+					} else {
+						lo = mid;
+					}
+				}
+				t = hi;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/*
+	 * are bounding spheres of bodies overlapping
+	 */
+	bool spheresOverlap(const RigidBody & a, const RigidBody & b) {
+		auto dp = a.getTranslation() - b.getTranslation();
+		auto r = a.getRadius() + b.getRadius();
+		return dp.dot(dp) <= r * r;
+	}
+
+	/** most an unswept body moves per step, as fraction of its radius */
+	const double maxStepTravel = .5;
+	/** fewest steps of resolve */
+	const int minSteps = 2;
+	/**
+	 * most steps of resolve, always taken by scenes without swept bodies and
+	 * by jointed scenes
+	 */
+	const int maxSteps = 10;
+
+	/*
+	 * steps needed so no unswept body moves further than fraction of its
+	 * radius in a step, by translation or by turning. Only scenes with swept
+	 * bodies take fewer steps than most, as stepping is otherwise fixed.
+	 * Joints and end effectors converge over steps, so jointed scenes take
+	 * all steps
+	 */
+	int countSteps(const std::vector<RigidBody> & bodies, double time,
+			bool swept, bool jointed) {
+		if (swept == false || jointed) {
+			return maxSteps;
+		}
+		double steps = minSteps;
+		for (const auto & body : bodies) {
+			if (body.isContinuous() && body.getInverseMass() > 0) {
+				continue;
+			}
+			// points of body move by turning as much as radius times angle
+			double travel = (body.getLinearVelocity().length()
+					+ body.getAngularVelocity().length() * body.getRadius())
+					* time;
+			if (body.getInverseMass() > 0) {
+				travel += body.getGravity().length() * time * time * .5;
+			}
+			if (travel == 0) {
+				continue;
+			}
+			if (body.getRadius() <= 0) {
+				return maxSteps;
+			}
+			steps = std::max(steps,
+					std::ceil(travel / (body.getRadius() * maxStepTravel)));
+			if (steps >= maxSteps) {
+				return maxSteps;
+			}
+		}
+		return static_cast<int>(steps);
+	}
+
+	/*
+	 * deepest penetration of body into other at their current transforms,
+	 * negative if not touching
+	 */
+	double penetration(const RigidBody & a, const RigidBody & b) {
+		if (spheresOverlap(a, b) == false) {
+			return -1;
+		}
+		ContactManifold contacts;
+		a.getCollision().collide(b.getCollision(),
+				b.getTransform().to(a.getTransform()), contacts);
+		return contacts.empty() ? -1 : contacts.getDeepest().getDepth();
+	}
+
+	/*
+	 * body near path of sweep, with depth of contact at start of step,
+	 * negative if not touching, and earliest time of step it was seen clear
+	 * of it
+	 */
+	struct SweepCandidate {
+		size_t body;
+		double startDepth;
+		double clearAt;
+
+		SweepCandidate(size_t body, double startDepth) :
+						body(body),
+						startDepth(startDepth),
+						clearAt(startDepth < 0 ? 0 :
+								std::numeric_limits<double>::infinity()) {
+		}
+	};
+
+	/*
+	 * move swept body back along its last step to where it first hits
+	 * another body, found by sampling step then bisecting between last clear
+	 * sample and first hit. A body touched at start of step is hit once the
+	 * sweep was clear of it, or contact deepens, so a body resting against a
+	 * thin one can't pass through it. Body is left just touching, so
+	 * resolving its collisions stops it. Only translation is swept, rotation
+	 * is that at end of step
+	 */
+	void sweepBody(std::vector<RigidBody> & bodies,
+			const Exclusions & exclusions, size_t index) {
+		auto & body = bodies[index];
+		Vec3 start = body.getLastPosition();
+		Vec3 end = body.getTranslation();
+		Vec3 delta = end - start;
+		double length = delta.length();
+		if (length <= body.getRadius() * maxStepTravel) {
+			// short enough for discrete collision
+			return;
+		}
+
+		// bodies near path
+		std::vector<SweepCandidate> candidates;
+		body.setTranslation(start);
+		for (size_t j = 0, n = bodies.size(); j < n; ++j) {
+			if (j == index
+					|| collidable(bodies, exclusions, index, j) == false) {
+				continue;
+			}
+			auto centre = bodies[j].getTranslation();
+			double t = std::max(0., std::min(1.,
+					(centre - start).dot(delta) / (length * length)));
+			Vec3 offset = start + delta * t - centre;
+			double r = body.getRadius() + bodies[j].getRadius();
+			if (offset.dot(offset) <= r * r) {
+				candidates.emplace_back(j, penetration(body, bodies[j]));
+			}
+		}
+		if (candidates.empty()) {
+			body.setTranslation(end);
+			return;
+		}
+
+		double deepening = body.getRadius() * sweepDeepening;
+		auto hitAt = [&](double t) {
+			body.setTranslation(start + delta * t);
+			bool hit = false;
+			for (auto & candidate : candidates) {
+				double depth = penetration(body, bodies[candidate.body]);
+				if (depth < 0) {
+					candidate.clearAt = std::min(candidate.clearAt, t);
+				} else if (t > candidate.clearAt
+						|| depth > candidate.startDepth + deepening) {
+					hit = true;
+				}
+			}
+			return hit;
+		};
+
+		double samples = std::ceil(
+				length * sweepSamplesPerRadius / body.getRadius());
+		auto nSamples = static_cast<unsigned>(std::min<double>(
+				maxSweepSamples, samples));
+		double lo = 0;
+		double hi = -1;
+		for (unsigned i = 1; i <= nSamples; ++i) {
+			double t = i / static_cast<double>(nSamples);
+			if (hitAt(t)) {
+				hi = t;
+				break;
+			}
+			lo = t;
+		}
+		if (hi < 0) {
+			body.setTranslation(end);
+			return;
+		}
+		for (unsigned i = 0; i < sweepBisections; ++i) {
+			double mid = (lo + hi) * .5;
+			if (hitAt(mid)) {
+				hi = mid;
+			} else {
+				lo = mid;
+			}
+		}
+		body.setTranslation(start + delta * hi);
+	}
+
+	/*
+	 * find root of set, halving path on the way
+	 */
+	size_t findRoot(std::vector<size_t> & parent, size_t i) {
+		while (parent[i] != i) {
+			parent[i] = parent[parent[i]];
+			i = parent[i];
+		}
+		return i;
+	}
+
+	/**
+	 * Group pairs into islands, pairs in different islands share no body with
+	 * non zero inverse mass, so islands can be solved independently. Static
+	 * bodies are only read when resolving so don't join islands. Islands are
+	 * ordered by first pair, and pairs within island keep their order.
+	 *
+	 * @param bodies  bodies indexed by pairs
+	 * @param pairs   pairs of body indices
+	 *
+	 * @return        list of pair indices for each island
+	 */
+	std::vector<std::vector<size_t>> buildIslands(
+			const std::vector<RigidBody> & bodies,
+			const std::vector<std::pair<size_t, size_t>> & pairs) {
+		std::vector<size_t> parent(bodies.size());
+		std::iota(parent.begin(), parent.end(), 0);
+
+		for (const auto & pair : pairs) {
+			if (bodies[pair.first].getInverseMass() == 0
+					|| bodies[pair.second].getInverseMass() == 0) {
+				continue;
+			}
+			auto a = findRoot(parent, pair.first);
+			auto b = findRoot(parent, pair.second);
+			if (a != b) {
+				parent[std::max(a, b)] = std::min(a, b);
+			}
+		}
+
+		std::vector<std::vector<size_t>> islands;
+		std::vector<size_t> islandIndex(bodies.size(), pairs.size());
+		for (size_t p = 0, n = pairs.size(); p < n; ++p) {
+			// at least one body is not static
+			auto body = pairs[p].first;
+			if (bodies[body].getInverseMass() == 0) {
+				body = pairs[p].second;
+			}
+			auto root = findRoot(parent, body);
+			if (islandIndex[root] == pairs.size()) {
+				islandIndex[root] = islands.size();
+				islands.emplace_back();
+			}
+			islands[islandIndex[root]].emplace_back(p);
+		}
+		return islands;
+	}
+
+	/*
+	 * get index argument, in range
+	 */
+	size_t getIndexArg(std::stack<ScriptObjectPtr> & stack, int argNum,
+			size_t size) {
+		auto index = getInt32Arg(stack, argNum);
+		scriptExecutionAssert(index >= 0 && static_cast<size_t>(index) < size,
+				"Index out of bounds");
+		return static_cast<size_t>(index);
+	}
+
+	/*
+	 * ray and shape hits script functions, hits by index, or hits of ray by
+	 * ray index
+	 */
+	class GetCount: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			checkNumArgs(nArgs, 1);
+			auto hits = std::static_pointer_cast<Physics::RayHits>(self);
+			auto ray = getIndexArg(stack, 1, hits->getRayCount());
+			stack.push(std::make_shared<Real>(
+					static_cast<double>(hits->getCount(ray))));
+		}
+	};
+
+	class GetDepth: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			checkNumArgs(nArgs, 1);
+			auto hits = std::static_pointer_cast<Physics::ShapeHits>(self);
+			auto index = getIndexArg(stack, 1, hits->size());
+			stack.push(std::make_shared<Real>(hits->get(index).depth));
+		}
+	};
+
+	template<typename HITS>
+	class GetDistance: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			checkNumArgs(nArgs, 1);
+			auto hits = std::static_pointer_cast<HITS>(self);
+			auto index = getIndexArg(stack, 1, hits->size());
+			stack.push(std::make_shared<Real>(hits->get(index).distance));
+		}
+	};
+
+	class GetFirst: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			checkNumArgs(nArgs, 1);
+			auto hits = std::static_pointer_cast<Physics::RayHits>(self);
+			auto ray = getIndexArg(stack, 1, hits->getRayCount());
+			stack.push(std::make_shared<Real>(
+					static_cast<double>(hits->getFirst(ray))));
+		}
+	};
+
+	template<typename HITS>
+	class GetName: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			checkNumArgs(nArgs, 1);
+			auto hits = std::static_pointer_cast<HITS>(self);
+			auto index = getIndexArg(stack, 1, hits->size());
+			stack.push(std::make_shared<String>(hits->get(index).name));
+		}
+	};
+
+	class GetNormal: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			checkNumArgs(nArgs, 1);
+			auto hits = std::static_pointer_cast<Physics::ShapeHits>(self);
+			auto index = getIndexArg(stack, 1, hits->size());
+			stack.push(std::make_shared<ScriptNormal>(hits->get(index).normal));
+		}
+	};
+
+	template<typename HITS>
+	class GetPoint: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			checkNumArgs(nArgs, 1);
+			auto hits = std::static_pointer_cast<HITS>(self);
+			auto index = getIndexArg(stack, 1, hits->size());
+			stack.push(std::make_shared<ScriptVec3>(hits->get(index).point));
+		}
+	};
+
+	class GetRay: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			checkNumArgs(nArgs, 1);
+			auto hits = std::static_pointer_cast<Physics::RayHits>(self);
+			auto index = getIndexArg(stack, 1, hits->size());
+			stack.push(std::make_shared<Real>(
+					static_cast<double>(hits->get(index).ray)));
+		}
+	};
+
+	template<typename HITS>
+	class Size: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			checkNumArgs(nArgs, 0);
+			auto hits = std::static_pointer_cast<HITS>(self);
+			stack.push(std::make_shared<Real>(
+					static_cast<double>(hits->size())));
+		}
+	};
 }
 
 /**
@@ -71,110 +698,321 @@ OVERRIDE ScriptObjectPtr Physics::RayIntersection::getMember(
 	if (name2 == "name") {
 		return std::make_shared<String>(name);
 	} else if (name2 == "point") {
-		return std::make_shared<Vec3>(point);
+		return std::make_shared<ScriptVec3>(point);
 	} else if (name2 == "distance") {
 		return std::make_shared<Real>(distance);
 	}
 	return ScriptObject::getMember(execState, name2);
 }
 
+/**
+ * constructor
+ *
+ * @param nRays  number of rays in batch
+ * @param hits   hits grouped by ray in ray order
+ */
+Physics::RayHits::RayHits(size_t nRays, std::vector<RayHit> && hits) :
+		hits(std::move(hits)), first(nRays + 1, 0) {
+	for (const auto & hit : this->hits) {
+		++first[hit.ray + 1];
+	}
+	std::partial_sum(first.begin(), first.end(), first.begin());
+}
+
+/**
+ * get named script object member
+ *
+ * @param execState  current script execution state
+ * @param name       name of member
+ *
+ * @return           script object represented by name
+ */
+OVERRIDE ScriptObjectPtr Physics::RayHits::getMember(
+		ScriptExecutionState & execState, const std::string & name) const {
+	static std::unordered_map<std::string, ScriptObjectPtr> members = {
+			{ "getCount", std::make_shared<GetCount>() },
+			{ "getDistance", std::make_shared<GetDistance<RayHits>>() },
+			{ "getFirst", std::make_shared<GetFirst>() },
+			{ "getName", std::make_shared<GetName<RayHits>>() },
+			{ "getPoint", std::make_shared<GetPoint<RayHits>>() },
+			{ "getRay", std::make_shared<GetRay>() },
+			{ "size", std::make_shared<Size<RayHits>>() } };
+
+	auto entry = members.find(name);
+	if (entry != members.end()) {
+		return entry->second;
+	}
+	return ScriptObject::getMember(execState, name);
+}
+
+/**
+ * constructor
+ *
+ * @param hits  contacts
+ */
+EXPLICIT Physics::ShapeHits::ShapeHits(std::vector<ShapeHit> && hits) :
+		hits(std::move(hits)) {
+}
+
+/**
+ * get named script object member
+ *
+ * @param execState  current script execution state
+ * @param name       name of member
+ *
+ * @return           script object represented by name
+ */
+OVERRIDE ScriptObjectPtr Physics::ShapeHits::getMember(
+		ScriptExecutionState & execState, const std::string & name) const {
+	static std::unordered_map<std::string, ScriptObjectPtr> members = {
+			{ "getDepth", std::make_shared<GetDepth>() },
+			{ "getDistance", std::make_shared<GetDistance<ShapeHits>>() },
+			{ "getName", std::make_shared<GetName<ShapeHits>>() },
+			{ "getNormal", std::make_shared<GetNormal>() },
+			{ "getPoint", std::make_shared<GetPoint<ShapeHits>>() },
+			{ "size", std::make_shared<Size<ShapeHits>>() } };
+
+	auto entry = members.find(name);
+	if (entry != members.end()) {
+		return entry->second;
+	}
+	return ScriptObject::getMember(execState, name);
+}
+
 struct Physics::impl {
 
-	std::unordered_map<std::string, RigidBody> bodies;
+	/** bodies in order added, addressed by index */
+	std::vector<RigidBody> bodies;
+	std::unordered_map<std::string, size_t> bodyIndices;
 	std::vector<Constraint> constraints;
-	std::unordered_map<std::string, std::unordered_set<std::string>> constraintMap;
-	std::vector<CollisionObject> collisions;
+	/** constraints between added bodies, resolved by link */
+	std::vector<Joint> joints;
+	/** end effectors on added bodies, resolved by link */
+	std::vector<IkChain> ikChains;
+	std::vector<CollisionWorld::Entry> collisions;
 	std::vector<EndEffector> endEffectors;
+	std::shared_ptr<CollisionWorld> world;
+	std::shared_ptr<CollisionEventPool> eventPool;
+	/** bodies for ray casts, built on first cast after bodies change */
+	AabbTree bodyTree;
+	std::vector<const RigidBody *> bodyTreeBodies;
+	bool bodyTreeValid;
+	std::mutex bodyTreeLock;
+
+	impl(const std::shared_ptr<CollisionWorld> & world,
+			const std::shared_ptr<CollisionEventPool> & eventPool) :
+					world(world),
+					eventPool(eventPool),
+					bodyTree(0),
+					bodyTreeValid(false) {
+	}
 
 	/**
-	 * Are named bodies locked in a constraint
-	 *
-	 * @param a  name of first body
-	 * @param b  name of second body
-	 * @return   true if bodies constrained, false otherwise
+	 * bring hierarchy of bodies up to date with bodies
 	 */
-	bool constrained(const std::string & a, const std::string & b) {
-		auto it = constraintMap.find(a);
-		if (it == constraintMap.end()) {
-			return false;
+	void buildBodyTree() {
+		std::lock_guard<std::mutex> lock(bodyTreeLock);
+		if (bodyTreeValid) {
+			return;
+		}
+		bodyTreeValid = true;
+		bodyTree = AabbTree(0);
+		bodyTreeBodies.clear();
+		for (const auto & body : bodies) {
+			Vec3 r(body.getRadius(), body.getRadius(), body.getRadius());
+			bodyTree.insert(BoundingBox(body.getTranslation() - r,
+					body.getTranslation() + r), bodyTreeBodies.size());
+			bodyTreeBodies.emplace_back(&body);
 		}
-		return it->second.find(b) != it->second.end();
 	}
 
 	/**
-	 * Do named bodies collide with each other? not if they are both static, ie
-	 * infinite mass, and not if they are members of a constraint
+	 * Intersect ray against bodies and then collisions, nearer candidates
+	 * first, appending hits
 	 *
-	 * @param a
-	 *            first name
-	 * @param b
-	 *            second name
-	 * @return true if collision allowed, false if not allowed
+	 * @param ray    ray to intersect
+	 * @param index  index of ray in batch
+	 * @param query  which hits to report
+	 * @param hits   hits to append to
 	 */
-	bool collidable(const RigidBody & rba, const RigidBody & rbb) {
-		if (rba.getInverseMass() == 0 && rbb.getInverseMass() == 0) {
-			return false;
+	void rayCast(const Ray & ray, size_t index, RayQuery query,
+			std::vector<RayHit> & hits) const {
+		const auto & start = ray.getStart();
+		const auto & direction = ray.getDirection();
+		auto first = hits.size();
+		double limit = std::numeric_limits<double>::infinity();
+
+		// record hit, giving new limit for traversal
+		auto hit = [&](const std::string & name, const Vec3 & point) {
+			// distance from point, as shapes differ in how they measure it
+			double distance = (point - start).dot(direction);
+			if (distance < 0) {
+				return limit;
+			}
+			switch (query) {
+			case RayQuery::CLOSEST:
+				if (distance < limit) {
+					if (hits.size() == first) {
+						hits.emplace_back(index, name, point, distance);
+					} else {
+						hits.back() = RayHit(index, name, point, distance);
+					}
+					limit = distance;
+				}
+				return limit;
+			case RayQuery::ANY:
+				hits.emplace_back(index, name, point, distance);
+				return -1.;
+			case RayQuery::ALL:
+				break;
+			}
+			hits.emplace_back(index, name, point, distance);
+			return limit;
+		};
+
+		auto bodyFn = [&](int proxy) {
+			const auto & body = *bodyTreeBodies[bodyTree.getData(proxy)];
+			Vec3 p;
+			double d;
+			if (body.rayIntersection(ray, p, d)) {
+				return hit(body.getName(), p);
+			}
+			return limit;
+		};
+		bodyTree.rayCast(start, direction, limit, bodyFn);
+		if (query == RayQuery::ANY && hits.size() != first) {
+			return;
 		}
-		if (rba.noCollide(rbb.getName()) || rbb.noCollide(rba.getName())) {
-			return false;
+
+		world->rayCast(ray, limit, [&](size_t i) {
+			const auto & collision = world->getObject(i);
+			Ray rayInCollisionSpace = ray;
+			rayInCollisionSpace.transform(collision.transform.inverse());
+			Vec3 p;
+			double d;
+			if (collision.hierarchy.rayIntersection(rayInCollisionSpace, p,
+					d)) {
+				// transform point out of collision space
+				collision.transform.transformPoint(p);
+				return hit(collision.name, p);
+			}
+			return limit;
+		});
+
+		if (query == RayQuery::ALL) {
+			std::stable_sort(hits.begin() + first, hits.end(),
+					[](const RayHit & a, const RayHit & b) {
+						return a.distance < b.distance;
+					});
 		}
-		return !constrained(rba.getName(), rbb.getName());
 	}
 
 	/**
-	 * Build map of constraints for fast checking
+	 * Resolve constraints and end effectors to indices of bodies, dropping
+	 * any naming bodies not added, and build chain of each end effector by
+	 * following constraints from its body toward root
 	 */
-	void buildConstraintMap() {
-		for (const auto & constraint : constraints) {
-			constraintMap[constraint.getBodyName0()].emplace(
-					constraint.getBodyName1());
-			constraintMap[constraint.getBodyName1()].emplace(
-					constraint.getBodyName0());
+	void link() {
+		joints.clear();
+		std::vector<std::vector<size_t>> parentJoints(bodies.size());
+		for (size_t i = 0, n = constraints.size(); i < n; ++i) {
+			auto a = bodyIndices.find(constraints[i].getBodyName0());
+			auto b = bodyIndices.find(constraints[i].getBodyName1());
+			if (a == bodyIndices.end() || b == bodyIndices.end()) {
+				continue;
+			}
+			parentJoints[b->second].emplace_back(joints.size());
+			joints.emplace_back(i, a->second, b->second);
+		}
+
+		ikChains.clear();
+		std::vector<bool> visited(bodies.size());
+		for (size_t i = 0, n = endEffectors.size(); i < n; ++i) {
+			auto it = bodyIndices.find(endEffectors[i].getParent());
+			if (it == bodyIndices.end()) {
+				continue;
+			}
+			ikChains.emplace_back(i, it->second);
+			std::fill(visited.begin(), visited.end(), false);
+			visited[it->second] = true;
+			addLinks(it->second, parentJoints, visited,
+					ikChains.back().links);
 		}
 	}
 
-	// inverse kinematics using jacobian transpose
-	void ik(const std::string & parent, const Vec3 & end, const Vec3 & goal,
-			float s) {
-		auto it = bodies.find(parent);
-		if (it == bodies.end()) {
-			return;
+	/**
+	 * Append links of chain from body toward root, depth first, visiting
+	 * each body once
+	 *
+	 * @param body          body to append links of
+	 * @param parentJoints  indices of joints toward root, for each body
+	 * @param visited       bodies already in chain
+	 * @param links         links to append to
+	 */
+	void addLinks(size_t body,
+			const std::vector<std::vector<size_t>> & parentJoints,
+			std::vector<bool> & visited, std::vector<IkLink> & links) const {
+		for (auto j : parentJoints[body]) {
+			const auto & joint = joints[j];
+			links.emplace_back(body, joint.constraint);
+			if (visited[joint.body0] == false) {
+				visited[joint.body0] = true;
+				addLinks(joint.body0, parentJoints, visited, links);
+			}
 		}
-		auto & body = it->second;
+	}
 
-		Vec3 delta = (goal - end) * s;
+	/**
+	 * Inverse kinematics by cyclic coordinate descent, turning each link of
+	 * chain in turn, nearest end first, so end approaches goal. Stops once
+	 * end is within tolerance of goal
+	 *
+	 * @param links  links of chain, nearest end first
+	 * @param end    world space end of chain
+	 * @param goal   world space goal
+	 * @param rate   part of angle to goal each link turns, before limit
+	 */
+	void ik(const std::vector<IkLink> & links, Vec3 end, const Vec3 & goal,
+			double rate) {
+		for (const auto & link : links) {
+			Vec3 offset = goal - end;
+			if (offset.dot(offset) < ikTolerance * ikTolerance) {
+				return;
+			}
+			auto & body = bodies[link.body];
+			body.setAngularVelocity(0.0, 0.0, 0.0);
+			body.setLinearVelocity(0.0, 0.0, 0.0);
 
-		for (const auto & c : constraints) {
-			if (c.getBodyName1() == parent) {
-				body.setAngularVelocity(0.0, 0.0, 0.0);
-				body.setLinearVelocity(0.0, 0.0, 0.0);
-				// rotation
-				Vec3 t = c.getPivot1Pos();
-				Transform bodyTransform = body.getTransform();
-				bodyTransform.transformPoint(t);
-				Vec3 u = end - t;
-				Vec3 v = goal - t;
-				Vec3 w = u.cross(v);
-				Normal axis = w.normalized();
-				v.cross(axis, u);
-				double d = v.dot(delta);
-				d = std::max(-0.01, std::min(0.01, d));
-				Quat r(axis, (float) d);
-				r *= body.getRotation();
-				body.setRotation(r);
-				// next
-				ik(c.getBodyName0(), end, goal, s);
+			// pivot in world space
+			Vec3 t = constraints[link.constraint].getPivot1Pos();
+			body.getTransform().transformPoint(t);
+			Vec3 u = end - t;
+			Vec3 v = goal - t;
+			Vec3 w = u.cross(v);
+			double sine = w.length();
+			if (sine == 0) {
+				// end, pivot and goal in line
+				continue;
 			}
+			double angle = std::min(maxIkRotation,
+					rate * std::atan2(sine, u.dot(v)));
+			Quat r(w.normalized(), static_cast<float>(angle));
+			end = t + r.rotate(u);
+			r *= body.getRotation();
+			body.setRotation(r);
 		}
 	}
-
 };
 
 /**
  * constructor
+ *
+ * @param world      static and kinematic collisions, shared across updates
+ * @param eventPool  collision events, shared across updates
  */
-Physics::Physics() :
-		pimpl(new impl()) {
+Physics::Physics(const std::shared_ptr<CollisionWorld> & world,
+		const std::shared_ptr<CollisionEventPool> & eventPool) :
+		pimpl(new impl(world, eventPool)) {
 }
 
 /**
@@ -188,11 +1026,16 @@ Physics::~Physics() {
  */
 std::unordered_map<std::string, std::vector<ScriptObjectPtr>> Physics::resolve(
 		float speed, float timeStep) {
-	pimpl->buildConstraintMap();
+	pimpl->bodyTreeValid = false;
+
+	auto & world = *pimpl->world;
+	world.commit(pimpl->collisions);
+
+	auto & eventPool = *pimpl->eventPool;
+	eventPool.recycle();
 
 	// wait for all bodies to be loaded
-	for (auto & entry : pimpl->bodies) {
-		auto & body = entry.second;
+	for (auto & body : pimpl->bodies) {
 		if (body.validate() == false) {
 			return std::unordered_map<std::string, std::vector<ScriptObjectPtr>>();
 		}
@@ -202,34 +1045,59 @@ std::unordered_map<std::string, std::vector<ScriptObjectPtr>> Physics::resolve(
 	double maxRadius = 0;
 
 	// size up bucket
-	for (const auto & entry : pimpl->bodies) {
-		const auto & body = entry.second;
+	for (const auto & body : pimpl->bodies) {
 		bounds += body.getTranslation();
 		maxRadius = std::max(maxRadius, body.getRadius());
 	}
-	for (const auto & collision : pimpl->collisions) {
-		bounds += collision.transform.getTranslation();
-		maxRadius = std::max(maxRadius,
-				collision.hierarchy.getBounds().getRadius());
-	}
 
-	// nothing to do
+	auto & pool = ThreadPool::getInstance();
+
+	// no bodies, only moved collisions to collide
 	if (bounds.isEmpty()) {
-		return std::unordered_map<std::string, std::vector<ScriptObjectPtr>>();
+		std::vector<PairContacts> movedContacts;
+		collideMoved(world, pool, movedContacts);
+		if (movedContacts.empty()) {
+			return std::unordered_map<std::string,
+					std::vector<ScriptObjectPtr>>();
+		}
+		std::vector<ScriptObjectPtr> collisionEvents;
+		addEvents(movedContacts, eventPool, collisionEvents);
+		std::unordered_map<std::string, std::vector<ScriptObjectPtr>> events;
+		events["collision"] = collisionEvents;
+		return events;
 	}
 
-	std::vector<ScriptObjectPtr> collisionEvents;
+	// bodies addressed by index from here on
+	pimpl->link();
+	auto & bodyList = pimpl->bodies;
+	auto nBodies = bodyList.size();
+	Exclusions exclusions(bodyList, pimpl->bodyIndices, pimpl->joints);
 
-	for (int iter = 0, n = 10; iter < n; ++iter) {
-		float ts = speed * timeStep / static_cast<float>(n);
+	// contacts of body pairs, one manifold per pair from latest step
+	std::vector<PairContacts> pairContacts;
+	std::unordered_map<uint64_t, size_t> pairIndex;
+
+	// swept bodies
+	std::vector<size_t> continuous;
+	for (size_t i = 0; i < nBodies; ++i) {
+		const auto & body = bodyList[i];
+		if (body.isContinuous() && body.getInverseMass() > 0) {
+			continuous.emplace_back(i);
+		}
+	}
+
+	bool jointed = pimpl->joints.empty() == false
+			|| pimpl->ikChains.empty() == false;
+	int nSteps = countSteps(bodyList, speed * timeStep,
+			continuous.empty() == false, jointed);
+
+	for (int iter = 0; iter < nSteps; ++iter) {
+		float ts = speed * timeStep / static_cast<float>(nSteps);
 
 		// inverse kinematics
-		for (const auto & e : pimpl->endEffectors) {
-			auto it = pimpl->bodies.find(e.getParent());
-			if (it == pimpl->bodies.end()) {
-				continue;
-			}
-			auto body = it->second;
+		for (const auto & chain : pimpl->ikChains) {
+			const auto & e = pimpl->endEffectors[chain.effector];
+			auto & body = bodyList[chain.body];
 
 			Transform pivotToWorld = body.getTransform();
 			pivotToWorld.transform(e.getPivot());
@@ -257,35 +1125,33 @@ std::unordered_map<std::string, std::vector<ScriptObjectPtr>> Physics::resolve(
 			body.setRotation(r);
 
 			// joints
-			pimpl->ik(e.getParent(), end, e.getGoalTranslation(),
-					std::min(.0005f, ts * e.getConvergence()));
+			pimpl->ik(chain.links, end, e.getGoalTranslation(),
+					std::min(1.f, ts * e.getConvergence()));
 		}
 
-		// create bodies bucket
-		Bucket3d<RigidBody> bodies(bounds, maxRadius);
+		// step bodies
+		pool.parallelFor(nBodies, [&](size_t i) {
+			bodyList[i].step(ts);
+		});
 
-		for (auto & entry : pimpl->bodies) {
-			auto & body = entry.second;
-			// step
-			body.step(ts);
+		// swept bodies back to first contact, in order as they may meet
+		for (auto i : continuous) {
+			sweepBody(bodyList, exclusions, i);
+		}
+
+		// create bodies bucket
+		Bucket3d<size_t> bodies(bounds, maxRadius);
 
-			// insert into bucket
-			bodies.insert(body, body.getTranslation(), body.getRadius());
+		for (size_t i = 0; i < nBodies; ++i) {
+			const auto & body = bodyList[i];
+			bodies.insert(i, body.getTranslation(), body.getRadius());
 		}
 
 		// constraints
-		for (const auto & constraint : pimpl->constraints) {
-			auto it = pimpl->bodies.find(constraint.getBodyName0());
-			if (it == pimpl->bodies.end()) {
-				continue;
-			}
-			auto & a = it->second;
-
-			it = pimpl->bodies.find(constraint.getBodyName1());
-			if (it == pimpl->bodies.end()) {
-				continue;
-			}
-			auto & b = it->second;
+		for (const auto & joint : pimpl->joints) {
+			const auto & constraint = pimpl->constraints[joint.constraint];
+			auto & a = bodyList[joint.body0];
+			auto & b = bodyList[joint.body1];
 
 			if ((constraint.getLimitFlags() & 7) != 0) {
 				a.fixConstraintTranslation(b, constraint);
@@ -296,108 +1162,210 @@ std::unordered_map<std::string, std::vector<ScriptObjectPtr>> Physics::resolve(
 			}
 		}
 
-		for (auto & objs : bodies.getBuckets()) {
-			// collisions
-			for (size_t i = 0, nBodies = objs.size(); i < nBodies; ++i) {
-				auto & iBody = objs[i];
-				for (size_t j = i + 1; j < nBodies; ++j) {
-					auto & jBody = objs[j];
-					assert (iBody != jBody);
+		// candidate pairs, in bucket order
+		std::vector<std::pair<size_t, size_t>> pairs;
+		for (const auto & objs : bodies.getBuckets()) {
+			for (size_t i = 0, n = objs.size(); i < n; ++i) {
+				const auto & iBody = bodyList[objs[i]];
+				for (size_t j = i + 1; j < n; ++j) {
+					const auto & jBody = bodyList[objs[j]];
+					assert(iBody != jBody);
 
-					if (pimpl->collidable(iBody, jBody) == false) {
+					if (collidable(bodyList, exclusions, objs[i], objs[j])
+							== false) {
 						// not collidable
 						continue;
 					}
-
-					auto intersections = iBody.resolveCollision(jBody);
-					if (intersections.size() == 0) {
-						// no collision
+					if (spheresOverlap(iBody, jBody) == false) {
+						// too far apart
 						continue;
 					}
-
-					for (const auto & intersection : intersections) {
-						collisionEvents.emplace_back(
-								std::make_shared<CollisionEvent>(
-										iBody.getName(), jBody.getName(),
-										iBody.getTransform(), intersection));
-					}
+					pairs.emplace_back(objs[i], objs[j]);
 				}
 			}
 		}
-	}
 
-	// create collisions bucket
-	Bucket3d<CollisionObject> collisions(bounds, maxRadius);
+		// islands of pairs sharing non static bodies
+		auto islands = buildIslands(bodyList, pairs);
 
-	for (const auto & collision : pimpl->collisions) {
-		collisions.insert(collision, collision.transform.getTranslation(),
-				collision.hierarchy.getBounds().getRadius());
-	}
+		// solve islands in parallel, pairs within island in order
+		std::vector<PairResult> results(pairs.size());
+		pool.parallelFor(islands.size(), [&](size_t k) {
+			for (auto p : islands[k]) {
+				auto & a = bodyList[pairs[p].first];
+				auto & b = bodyList[pairs[p].second];
+				a.resolveCollision(b, results[p].contacts);
+				if (results[p].contacts.empty() == false) {
+					results[p].transform = a.getTransform();
+				}
+			}
+		});
 
-	// collisions
-	for (const auto & entry : pimpl->bodies) {
-		const auto & body = entry.second;
-		if (body.getInverseMass() == 0) {
-			continue;
+		// pair's manifold is that of latest step it touched in, with body
+		// transform of that step, so events never mix contacts found at
+		// different body positions
+		for (size_t p = 0, n = pairs.size(); p < n; ++p) {
+			const auto & result = results[p];
+			if (result.contacts.empty()) {
+				continue;
+			}
+			auto key = (static_cast<uint64_t>(pairs[p].first) << 32)
+					| static_cast<uint64_t>(pairs[p].second);
+			auto it = pairIndex.find(key);
+			if (it == pairIndex.end()) {
+				const auto & a = bodyList[pairs[p].first];
+				const auto & b = bodyList[pairs[p].second];
+				it = pairIndex.emplace(key, pairContacts.size()).first;
+				pairContacts.emplace_back(a.getName(), b.getName(),
+						result.transform, result.contacts);
+				continue;
+			}
+			auto & latest = pairContacts[it->second];
+			latest.transform = result.transform;
+			latest.contacts = result.contacts;
 		}
-		BodyCol cb(body, collisionEvents);
-		collisions.intersection(body.getTranslation(), body.getRadius(), cb);
 	}
 
-	for (auto & objs : collisions.getBuckets()) {
-		for (size_t i = 0, n = objs.size(); i < n; ++i) {
-			auto & a = objs[i];
-			for (size_t j = i + 1; j < n; ++j) {
-				auto & b = objs[j];
-				if (a.moved == false && b.moved == false) {
-					continue;
-				}
-				auto intersections = a.hierarchy.collide(b.hierarchy,
-						b.transform.to(a.transform));
-				for (const auto & intersection : intersections) {
-					collisionEvents.emplace_back(
-							std::make_shared<CollisionEvent>(a.name, b.name,
-									a.transform, intersection));
-				}
-			}
+	std::vector<ScriptObjectPtr> collisionEvents;
+	addEvents(pairContacts, eventPool, collisionEvents);
+
+	// bodies against collisions, one contact list per body
+	std::vector<std::vector<PairContacts>> bodyContacts(nBodies);
+	pool.parallelFor(nBodies, [&](size_t i) {
+		const auto & body = bodyList[i];
+		if (body.getInverseMass() == 0) {
+			return;
 		}
+		BodyCol cb(world, body, bodyContacts[i]);
+		Vec3 r(body.getRadius(), body.getRadius(), body.getRadius());
+		world.query(BoundingBox(body.getTranslation() - r,
+				body.getTranslation() + r), cb);
+	});
+	for (const auto & contacts : bodyContacts) {
+		addEvents(contacts, eventPool, collisionEvents);
 	}
 
+	// moved collisions against collisions
+	std::vector<PairContacts> movedContacts;
+	collideMoved(world, pool, movedContacts);
+	addEvents(movedContacts, eventPool, collisionEvents);
+
 	std::unordered_map<std::string, std::vector<ScriptObjectPtr>> events;
 	events["collision"] = collisionEvents;
 	return events;
 }
 
 /**
- * Intersect ray against rigid bodies
+ * Intersect batch of rays against rigid bodies and collisions, through
+ * hierarchies of both. Rays extend beyond their ends, hits behind ray
+ * starts are ignored
  *
- * @param ray       ray to intersect
- * @param callback  callback for when an intersection occurs
+ * @param rays      rays to intersect
+ * @param query     which hits of each ray to report
+ * @param parallel  spread rays across thread pool
+ *
+ * @return          hits grouped by ray
  */
-void Physics::rayIntersection(const Ray & ray,
-		RayIntersectionCallback & callback) {
-	for (const auto & entry : pimpl->bodies) {
-		const auto & body = entry.second;
-		Vec3 p;
-		double d;
-		if (body.rayIntersection(ray, p, d)) {
-			callback.addIntersection(
-					std::make_shared<RayIntersection>(body.getName(), p, d));
-		}
-	}
-
-	for (const auto & collision : pimpl->collisions) {
-		Ray rayInCollisionSpace = ray;
-		rayInCollisionSpace.transform(collision.transform.inverse());
-		Vec3 p;
-		double d;
-		if (collision.hierarchy.rayIntersection(rayInCollisionSpace, p, d)) {
-			// transfrom point out of collision space
-			collision.transform.transformPoint(p);
-			callback.addIntersection(
-					std::make_shared<RayIntersection>(collision.name, p, d));
+std::shared_ptr<Physics::RayHits> Physics::rayCast(
+		const std::vector<Ray> & rays, RayQuery query, bool parallel) {
+	pimpl->buildBodyTree();
+
+	std::vector<RayHit> hits;
+	if (parallel && rays.size() > 1) {
+		std::vector<std::vector<RayHit>> rayHits(rays.size());
+		ThreadPool::getInstance().parallelFor(rays.size(), [&](size_t i) {
+			pimpl->rayCast(rays[i], i, query, rayHits[i]);
+		});
+		for (auto & list : rayHits) {
+			hits.insert(hits.end(), list.begin(), list.end());
+		}
+	} else {
+		for (size_t i = 0, n = rays.size(); i < n; ++i) {
+			pimpl->rayCast(rays[i], i, query, hits);
 		}
 	}
+	return std::make_shared<RayHits>(rays.size(), std::move(hits));
+}
+
+/**
+ * Find contacts of shape with collisions in any of given layers, through
+ * hierarchy of collisions
+ *
+ * @param shape    shape to test
+ * @param toWorld  from shape space to world space
+ * @param layers   bitmask of layers to test against
+ *
+ * @return         contacts
+ */
+std::shared_ptr<Physics::ShapeHits> Physics::overlap(
+		const CollisionHierarchy & shape, const Transform & toWorld,
+		uint32_t layers) {
+	const auto & world = *pimpl->world;
+	std::vector<ShapeHit> hits;
+	world.query(shape.getBounds().transformed(toWorld), [&](size_t i) {
+		const auto & object = world.getObject(i);
+		if ((object.group & layers) == 0) {
+			return;
+		}
+		ContactManifold contacts;
+		object.hierarchy.collide(shape, toWorld.to(object.transform),
+				contacts);
+		// transform contacts out of collision space
+		contacts.transform(object.transform);
+		for (const auto & contact : contacts) {
+			hits.emplace_back(object.name, contact.getPoint(),
+					contact.getNormal(), contact.getDepth(), 0);
+		}
+	});
+	return std::make_shared<ShapeHits>(std::move(hits));
+}
+
+/**
+ * Sweep sphere to end point, finding first contact with each collision
+ * in any of given layers
+ *
+ * @param sphere  sphere at start of sweep
+ * @param end     centre of sphere at end of sweep
+ * @param layers  bitmask of layers to test against
+ *
+ * @return        first contact with each collision, nearest first
+ */
+std::shared_ptr<Physics::ShapeHits> Physics::sweepSphere(
+		const std::shared_ptr<Sphere> & sphere, const Vec3 & end,
+		uint32_t layers) {
+	std::vector<CollisionHierarchy> children;
+	CollisionHierarchy shape(sphere, children);
+	auto delta = end - sphere->getPoint();
+	double length = delta.length();
+
+	// sample finely enough that sphere can't pass between samples
+	double spacing = sphere->getRadius() / sweepSamplesPerRadius;
+	double samples = spacing > 0 ? std::ceil(length / spacing) : 1;
+	auto nSamples = static_cast<unsigned>(std::max(1.,
+			std::min(samples, static_cast<double>(maxSweepSamples))));
+
+	auto bounds = sphere->getBounds();
+	bounds += BoundingBox(bounds.getMin() + delta, bounds.getMax() + delta);
+
+	const auto & world = *pimpl->world;
+	std::vector<ShapeHit> hits;
+	world.query(bounds, [&](size_t i) {
+		const auto & object = world.getObject(i);
+		if ((object.group & layers) == 0) {
+			return;
+		}
+		double t;
+		Intersection contact;
+		if (firstContact(object, shape, delta, nSamples, t, contact)) {
+			hits.emplace_back(object.name, contact.getPoint(),
+					contact.getNormal(), contact.getDepth(), t * length);
+		}
+	});
+	std::stable_sort(hits.begin(), hits.end(),
+			[](const ShapeHit & a, const ShapeHit & b) {
+				return a.distance < b.distance;
+			});
+	return std::make_shared<ShapeHits>(std::move(hits));
 }
 
 /**
@@ -407,19 +1375,29 @@ void Physics::rayIntersection(const Ray & ray,
  *            body to add
  */
 void Physics::addRigidBody(const RigidBody & rigidBody) {
-	pimpl->bodies.emplace(
-			std::pair<std::string, RigidBody>(rigidBody.getName(), rigidBody));
+	pimpl->bodyTreeValid = false;
+	// first body added of name is kept
+	if (pimpl->bodyIndices.emplace(rigidBody.getName(),
+			pimpl->bodies.size()).second) {
+		pimpl->bodies.emplace_back(rigidBody);
+	}
 }
 
 /**
  * Add collision to state
  *
- * @param collision
- *            collision to add
+ * @param name       name of collision
+ * @param previous   transform last update
+ * @param current    transform this update
+ * @param collision  collision to add
+ * @param group      bitmask of layers collision is in
+ * @param mask       bitmask of layers collision collides with
  */
 void Physics::addCollision(const std::string & name, const Transform & previous,
-		const Transform & current, const CollisionHierarchy & collision) {
-	pimpl->collisions.emplace_back(name, previous, current, collision);
+		const Transform & current, const CollisionHierarchy & collision,
+		uint32_t group, uint32_t mask) {
+	pimpl->collisions.emplace_back(name, previous, current, collision, group,
+			mask);
 }
 
 /**
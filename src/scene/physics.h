@@ -1,20 +1,25 @@
 #pragma once
 
+#include "../core/normal.h"
 #include "../core/vec3.h"
 
 #include "../scripting/scriptObject.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+class CollisionEventPool;
 class CollisionHierarchy;
+class CollisionWorld;
 class Constraint;
 class DebugGeometry;
 class EndEffector;
 class Ray;
 class RigidBody;
+class Sphere;
 class Transform;
 
 class Physics {
@@ -53,19 +58,193 @@ public:
 		double distance;
 	};
 
-	class RayIntersectionCallback {
+	/**
+	 * which hits of each ray a ray cast reports
+	 */
+	enum class RayQuery {
+		/** nearest hit */
+		CLOSEST,
+		/** first hit found, not necessarily nearest, cheapest to find */
+		ANY,
+		/** every hit, nearest first */
+		ALL
+	};
+
+	/*
+	 * hit of ray, distance is along ray in world units
+	 */
+	struct RayHit {
+		/** index of ray in batch */
+		size_t ray;
+		/** name of body or collision hit */
+		std::string name;
+		Vec3 point;
+		double distance;
+
+		RayHit(size_t ray, const std::string & name, const Vec3 & point,
+				double distance) :
+				ray(ray), name(name), point(point), distance(distance) {
+		}
+	};
+
+	/*
+	 * hits of batch of rays packed together, grouped by ray in ray order
+	 */
+	class RayHits: public ScriptObject {
 	public:
-		inline virtual ~RayIntersectionCallback() {
+		/**
+		 * constructor
+		 *
+		 * @param nRays  number of rays in batch
+		 * @param hits   hits grouped by ray in ray order
+		 */
+		RayHits(size_t nRays, std::vector<RayHit> && hits);
+
+		/**
+		 * get hit
+		 *
+		 * @param index  index of hit
+		 *
+		 * @return       hit
+		 */
+		inline const RayHit & get(size_t index) const {
+			return hits[index];
+		}
+
+		/**
+		 * get number of hits of ray
+		 *
+		 * @param ray  index of ray in batch
+		 *
+		 * @return     number of hits
+		 */
+		inline size_t getCount(size_t ray) const {
+			return first[ray + 1] - first[ray];
+		}
+
+		/**
+		 * get index of first hit of ray
+		 *
+		 * @param ray  index of ray in batch
+		 *
+		 * @return     index of first hit
+		 */
+		inline size_t getFirst(size_t ray) const {
+			return first[ray];
 		}
 
-		virtual void addIntersection(
-				const std::shared_ptr<RayIntersection> & intersection)=0;
+		/**
+		 * get number of rays in batch
+		 *
+		 * @return  number of rays
+		 */
+		inline size_t getRayCount() const {
+			return first.size() - 1;
+		}
+
+		/**
+		 * get named script object member
+		 *
+		 * @param execState  current script execution state
+		 * @param name       name of member
+		 *
+		 * @return           script object represented by name
+		 */
+		ScriptObjectPtr getMember(ScriptExecutionState & execState,
+				const std::string & name) const override;
+
+		/**
+		 * get total number of hits
+		 *
+		 * @return  number of hits
+		 */
+		inline size_t size() const {
+			return hits.size();
+		}
+
+	private:
+		std::vector<RayHit> hits;
+		/** index of first hit of each ray, and total */
+		std::vector<size_t> first;
+	};
+
+	/*
+	 * contact of shape query with collision, in world space. Distance is how
+	 * far a swept shape travelled before contact, zero for overlaps
+	 */
+	struct ShapeHit {
+		/** name of collision hit */
+		std::string name;
+		Vec3 point;
+		Normal normal;
+		double depth;
+		double distance;
+
+		ShapeHit(const std::string & name, const Vec3 & point,
+				const Normal & normal, double depth, double distance) :
+						name(name),
+						point(point),
+						normal(normal),
+						depth(depth),
+						distance(distance) {
+		}
+	};
+
+	/*
+	 * contacts of shape query packed together
+	 */
+	class ShapeHits: public ScriptObject {
+	public:
+		/**
+		 * constructor
+		 *
+		 * @param hits  contacts
+		 */
+		explicit ShapeHits(std::vector<ShapeHit> && hits);
+
+		/**
+		 * get contact
+		 *
+		 * @param index  index of contact
+		 *
+		 * @return       contact
+		 */
+		inline const ShapeHit & get(size_t index) const {
+			return hits[index];
+		}
+
+		/**
+		 * get named script object member
+		 *
+		 * @param execState  current script execution state
+		 * @param name       name of member
+		 *
+		 * @return           script object represented by name
+		 */
+		ScriptObjectPtr getMember(ScriptExecutionState & execState,
+				const std::string & name) const override;
+
+		/**
+		 * get number of contacts
+		 *
+		 * @return  number of contacts
+		 */
+		inline size_t size() const {
+			return hits.size();
+		}
+
+	private:
+		std::vector<ShapeHit> hits;
 	};
 
 	/**
 	 * constructor
+	 *
+	 * @param world      static and kinematic collisions, shared across updates
+	 * @param eventPool  collision events, shared across updates
 	 */
-	Physics();
+	Physics(const std::shared_ptr<CollisionWorld> & world,
+			const std::shared_ptr<CollisionEventPool> & eventPool);
 
 	/**
 	 * destructor
@@ -75,11 +254,16 @@ public:
 	/**
 	 * Add collision to state
 	 *
-	 * @param collision
-	 *            collision to add
+	 * @param name       name of collision
+	 * @param previous   transform last update
+	 * @param current    transform this update
+	 * @param collision  collision to add
+	 * @param group      bitmask of layers collision is in
+	 * @param mask       bitmask of layers collision collides with
 	 */
 	void addCollision(const std::string & name, const Transform & previous,
-			const Transform & current, const CollisionHierarchy & collision);
+			const Transform & current, const CollisionHierarchy & collision,
+			uint32_t group, uint32_t mask);
 
 	/**
 	 * Add constraint to state
@@ -106,12 +290,31 @@ public:
 	void addRigidBody(const RigidBody & rigidBody);
 
 	/**
-	 * Intersect ray against rigid bodies
+	 * Find contacts of shape with collisions in any of given layers, through
+	 * hierarchy of collisions
 	 *
-	 * @param ray       ray to intersect
-	 * @param callback  callback for when an intersection occurs
+	 * @param shape    shape to test
+	 * @param toWorld  from shape space to world space
+	 * @param layers   bitmask of layers to test against
+	 *
+	 * @return         contacts
 	 */
-	void rayIntersection(const Ray & ray, RayIntersectionCallback & callback);
+	std::shared_ptr<ShapeHits> overlap(const CollisionHierarchy & shape,
+			const Transform & toWorld, uint32_t layers);
+
+	/**
+	 * Intersect batch of rays against rigid bodies and collisions, through
+	 * hierarchies of both. Rays extend beyond their ends, hits behind ray
+	 * starts are ignored
+	 *
+	 * @param rays      rays to intersect
+	 * @param query     which hits of each ray to report
+	 * @param parallel  spread rays across thread pool
+	 *
+	 * @return          hits grouped by ray
+	 */
+	std::shared_ptr<RayHits> rayCast(const std::vector<Ray> & rays,
+			RayQuery query, bool parallel);
 
 	/**
 	 * Resolve collisions and constraints
@@ -119,6 +322,20 @@ public:
 	std::unordered_map<std::string, std::vector<ScriptObjectPtr>> resolve(
 			float speed, float timeStep);
 
+	/**
+	 * Sweep sphere to end point, finding first contact with each collision
+	 * in any of given layers
+	 *
+	 * @param sphere  sphere at start of sweep
+	 * @param end     centre of sphere at end of sweep
+	 * @param layers  bitmask of layers to test against
+	 *
+	 * @return        first contact with each collision, nearest first
+	 */
+	std::shared_ptr<ShapeHits> sweepSphere(
+			const std::shared_ptr<Sphere> & sphere, const Vec3 & end,
+			uint32_t layers);
+
 private:
 	struct impl;
 	std::unique_ptr<impl> pimpl;
@@ -5,7 +5,9 @@
 #include "../core/animation.h"
 #include "../core/bone.h"
 #include "../core/config.h"
+#include "../core/pose.h"
 #include "../core/quat.h"
+#include "../core/skeleton.h"
 #include "../core/transform.h"
 #include "../core/vec3.h"
 
@@ -15,7 +17,9 @@
 #include "../scripting/parameters.h"
 #include "../scripting/string.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 namespace {
 
@@ -47,9 +51,8 @@ namespace {
 
 			auto dt = static_cast<float>(getNumericArg( stack, 2));
 
-			stack.push(
-					std::make_shared<Vec3>(
-							sgAnimator->getDeltaTranslation(bone, dt)));
+			stack.push(std::make_shared<ScriptVec3>(
+					sgAnimator->getDeltaTranslation(bone, dt)));
 		}
 	};
 
@@ -65,7 +68,8 @@ namespace {
 
 			auto bone = getArg<String>("string", stack, 1).getValue();
 
-			stack.push(std::make_shared<Quat>(sgAnimator->getRotation(bone)));
+			stack.push(std::make_shared<ScriptQuat>(
+					sgAnimator->getRotation(bone)));
 		}
 	};
 
@@ -75,17 +79,15 @@ namespace {
 	class GetTransform: public Executable {
 		void execute(const ScriptObjectPtr & self, unsigned nArgs,
 				std::stack<ScriptObjectPtr> & stack) const override {
-			checkNumArgs(nArgs, 0);
+			checkNumArgs(nArgs, 1);
 
 			auto sgAnimator = std::static_pointer_cast<SgAnimator>(self);
 
 			auto bone = getArg<String>("string", stack, 1).getValue();
 
-			const auto & transforms = sgAnimator->getTransforms();
-
-			const auto & it = transforms.find(bone);
-			if (it != transforms.end()) {
-				stack.push(std::make_shared<Transform>(it->second));
+			if (sgAnimator->hasBone(bone)) {
+				stack.push(std::make_shared<ScriptTransform>(
+						sgAnimator->getTransform(bone)));
 			} else {
 				stack.push(None::none());
 			}
@@ -104,8 +106,24 @@ namespace {
 
 			auto bone = getArg<String>("string", stack, 1).getValue();
 
-			stack.push(
-					std::make_shared<Vec3>(sgAnimator->getTranslation(bone)));
+			stack.push(std::make_shared<ScriptVec3>(
+					sgAnimator->getTranslation(bone)));
+		}
+	};
+
+	/*
+	 * remove named layer
+	 */
+	class RemoveLayer: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			checkNumArgs(nArgs, 1);
+
+			auto sgAnimator = std::static_pointer_cast<SgAnimator>(self);
+
+			auto name = getArg<String>("string", stack, 1).getValue();
+
+			sgAnimator->removeLayer(name);
 		}
 	};
 
@@ -136,13 +154,85 @@ namespace {
 	class SetAnimation: public Executable {
 		void execute(const ScriptObjectPtr & self, unsigned nArgs,
 				std::stack<ScriptObjectPtr> & stack) const override {
-			checkNumArgs(nArgs, 1);
+			if (nArgs != 2) {
+				checkNumArgs(nArgs, 1);
+			}
 
 			auto sgAnimator = std::static_pointer_cast<SgAnimator>(self);
 
 			auto animation = getArg<Animation>("Animation", stack, 1);
 
-			sgAnimator->setAnimation(animation);
+			float fadeTime = 0;
+			if (nArgs == 2) {
+				fadeTime = static_cast<float>(getNumericArg(stack, 2));
+			}
+
+			sgAnimator->setAnimation(animation, fadeTime);
+		}
+	};
+
+	/*
+	 * add or replace named layer, of animation and whether additive
+	 */
+	class SetLayer: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			if (nArgs != 3) {
+				checkNumArgs(nArgs, 2);
+			}
+
+			auto sgAnimator = std::static_pointer_cast<SgAnimator>(self);
+
+			auto name = getArg<String>("string", stack, 1).getValue();
+
+			auto animation = getArg<Animation>("Animation", stack, 2);
+
+			bool additive = false;
+			if (nArgs == 3) {
+				additive = getBoolArg(stack, 3);
+			}
+
+			sgAnimator->setLayer(name, animation, additive);
+		}
+	};
+
+	/*
+	 * set weight of bone in named layer
+	 */
+	class SetLayerMask: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			checkNumArgs(nArgs, 3);
+
+			auto sgAnimator = std::static_pointer_cast<SgAnimator>(self);
+
+			auto name = getArg<String>("string", stack, 1).getValue();
+
+			auto bone = getArg<String>("string", stack, 2).getValue();
+
+			auto weight = static_cast<float>(getNumericArg(stack, 3));
+
+			scriptExecutionAssert(sgAnimator->setLayerMask(name, bone, weight),
+					"Unknown layer '" + name + "'");
+		}
+	};
+
+	/*
+	 * set weight of named layer
+	 */
+	class SetLayerWeight: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			checkNumArgs(nArgs, 2);
+
+			auto sgAnimator = std::static_pointer_cast<SgAnimator>(self);
+
+			auto name = getArg<String>("string", stack, 1).getValue();
+
+			auto weight = static_cast<float>(getNumericArg(stack, 2));
+
+			scriptExecutionAssert(sgAnimator->setLayerWeight(name, weight),
+					"Unknown layer '" + name + "'");
 		}
 	};
 
@@ -181,43 +271,354 @@ namespace {
 			sgAnimator->setTranslation(bone, t);
 		}
 	};
+
+	/*
+	 * animation played into pose
+	 */
+	struct Track {
+		Animation animation;
+		float frame;
+		/** index in pose of each bone of animation, in order of its bones */
+		std::vector<size_t> bones;
+
+		explicit Track(const Animation & animation) :
+				animation(animation), frame(0) {
+		}
+	};
+
+	/*
+	 * animation blended over base animation, or added to it, by weight
+	 */
+	struct Layer {
+		std::string name;
+		Track track;
+		bool additive;
+		float weight;
+		/** weights of named bones, other bones weigh 1 */
+		std::unordered_map<std::string, float> mask;
+		/** mask weight of each bone of animation, in order of its bones */
+		std::vector<float> boneMask;
+		Pose pose;
+
+		Layer(const std::string & name, const Animation & animation,
+				bool additive,
+				const std::shared_ptr<const Skeleton> & skeleton) :
+						name(name),
+						track(animation),
+						additive(additive),
+						weight(1),
+						pose(skeleton) {
+		}
+	};
 }
 
 struct SgAnimator::impl {
 
-	Animation animation;
-	std::unordered_map<std::string, Transform> transforms;
-	float frame;
+	Track base;
+	/** bones set so far, shared with update states until next changed */
+	std::shared_ptr<Pose> pose;
+	/** animation faded out from, while fadeTime < fadeDuration */
+	Track fading;
+	Pose fadingPose;
+	float fadeTime;
+	float fadeDuration;
+	std::vector<Layer> layers;
+	/** base pose with fade and layers blended in, for update states */
+	std::shared_ptr<Pose> blended;
+	/** weight of each bone of pose, of layer blending in */
+	std::vector<float> weights;
+	/** channels of animation sampled at frame */
+	std::vector<float> values;
+	/** pose last evaluated is blended rather than base pose */
+	bool isBlended;
+	/** frames between poses evaluated when last evaluated, 0 if held */
+	unsigned lodInterval;
+	/** frames since pose last evaluated */
+	unsigned lodFrame;
+	/** time passed since pose last evaluated */
+	float lodTime;
+	/** pose shown when last evaluated, interpolated from to evaluated pose */
+	Pose from;
+	/** pose between from and evaluated pose, while rate reduced */
+	std::shared_ptr<Pose> interpolated;
+	/** pose given to update states last, pose, blended or interpolated */
+	const std::shared_ptr<Pose> * shown;
 
 	impl(const Animation & active) :
-			animation(active), frame(0) {
+					base(active),
+					pose(std::make_shared<Pose>(std::make_shared<Skeleton>(
+							std::vector<std::string>()))),
+					fading(active),
+					fadingPose(pose->getSkeleton()),
+					fadeTime(0),
+					fadeDuration(0),
+					isBlended(false),
+					lodInterval(0),
+					lodFrame(0),
+					lodTime(0),
+					from(pose->getSkeleton()),
+					shown(&pose) {
+	}
+
+	/*
+	 * add bones not yet in skeleton, carrying over poses of others
+	 */
+	void addBones(const std::vector<std::string> & names) {
+		const auto & skeleton = pose->getSkeleton();
+		auto allNames = skeleton->getNames();
+		for (const auto & name : names) {
+			if (skeleton->getIndex(name) == Skeleton::npos) {
+				allNames.emplace_back(name);
+			}
+		}
+		if (allNames.size() == skeleton->size()) {
+			return;
+		}
+		std::shared_ptr<const Skeleton> newSkeleton = std::make_shared<
+				Skeleton>(allNames);
+		pose = std::make_shared<Pose>(newSkeleton, *pose);
+		fadingPose = Pose(newSkeleton, fadingPose);
+		for (auto & layer : layers) {
+			layer.pose = Pose(newSkeleton, layer.pose);
+		}
+	}
+
+	/*
+	 * get layer by name, null if none
+	 */
+	Layer * findLayer(const std::string & name) {
+		for (auto & layer : layers) {
+			if (layer.name == name) {
+				return &layer;
+			}
+		}
+		return nullptr;
+	}
+
+	/*
+	 * get index of bone in pose, adding bone if not yet in skeleton
+	 */
+	size_t getOrAddBone(const std::string & name) {
+		size_t index = pose->getSkeleton()->getIndex(name);
+		if (index == Skeleton::npos) {
+			addBones( { name });
+			index = pose->getSkeleton()->getIndex(name);
+		}
+		return index;
 	}
 
-	Transform getTransform(const std::string & name) {
-		Transform transform;
-		auto it = transforms.find(name);
-		if (it != transforms.end()) {
-			transform = it->second;
+	size_t getBone(const std::string & name) const {
+		return pose->getSkeleton()->getIndex(name);
+	}
+
+	Transform getTransform(const std::string & name) const {
+		size_t index = getBone(name);
+		return index != Skeleton::npos ? pose->get(index) : Transform();
+	}
+
+	/*
+	 * get pose to change, copied first if update state still shares it
+	 */
+	Pose & modifyPose() {
+		if (pose.use_count() > 1) {
+			pose = std::make_shared<Pose>(*pose);
 		}
-		return transform;
+		return *pose;
 	}
 
 	Transform peek(const std::string & name, float step) {
 		float speed = Config::getInstance().getFloat("simulationSpeed");
 		float dt = speed * step;
 
+		const auto & animation = base.animation;
 		if (animation.validate() == false) {
 			return Transform();
 		}
 
-		float frame2 = animation.nextFrame(frame, dt);
+		float frame2 = animation.nextFrame(base.frame, dt);
 		float frameStep = animation.getFrameStep(dt);
 
 		if (animation.hasBone(name) == false) {
-			return transforms.at(name);
+			return getTransform(name);
 		}
 		const auto & bone = animation.getBone(name);
-		return bone.getTransform(getTransform(name), frame2, frameStep);
+		std::vector<float> boneValues(bone.size());
+		animation.sample(frame2, animation.getFirstChannel(name), bone.size(),
+				boneValues.data());
+		return bone.getTransform(getTransform(name), boneValues.data(),
+				frameStep);
+	}
+
+	/*
+	 * advance animation of track, validated and resolved, and pose its bones
+	 */
+	void play(Track & track, Pose & target, float dt) {
+		const auto & animation = track.animation;
+		track.frame = animation.nextFrame(track.frame, dt);
+		float frameStep = animation.getFrameStep(dt);
+
+		// all channels at once, bones take theirs in order
+		values.resize(animation.getChannelCount());
+		animation.sample(track.frame, 0, values.size(), values.data());
+
+		size_t channel = 0;
+		auto index = track.bones.begin();
+		for (const auto & boneEntry : animation.getBones()) {
+			const auto & bone = boneEntry.second;
+			target.set(*index, bone.getTransform(target.get(*index),
+					values.data() + channel, frameStep));
+			channel += bone.size();
+			++index;
+		}
+	}
+
+	/*
+	 * evaluate pose of animations, fade and layers, dt on from last
+	 */
+	void evaluate(float dt) {
+		// find bones of everything first, as new bones replace poses
+		resolve(base);
+		bool isFading = fadeDuration > 0 && fading.animation.validate();
+		if (isFading) {
+			resolve(fading);
+		}
+		for (auto & layer : layers) {
+			if (layer.track.animation.validate()) {
+				resolve(layer);
+			}
+		}
+
+		play(base, modifyPose(), dt);
+
+		isBlended = isFading || layers.empty() == false;
+		if (isBlended == false) {
+			return;
+		}
+
+		auto & blended = startBlend();
+
+		if (isFading) {
+			play(fading, fadingPose, dt);
+			fadeTime += dt;
+			float t = std::min(fadeTime / fadeDuration, 1.f);
+			blended.interpolate(fadingPose, 1 - t);
+			if (t == 1) {
+				fadeDuration = 0;
+			}
+		}
+
+		for (auto & layer : layers) {
+			if (layer.track.animation.validate() == false) {
+				continue;
+			}
+			// layers play on at no weight, to stay in step
+			play(layer.track, layer.pose, dt);
+			if (layer.weight == 0) {
+				continue;
+			}
+
+			weights.assign(blended.size(), 0);
+			for (size_t i = 0, n = layer.track.bones.size(); i < n; ++i) {
+				weights[layer.track.bones[i]] = layer.weight
+						* layer.boneMask[i];
+			}
+			if (layer.additive) {
+				blended.add(layer.pose, weights.data());
+			} else {
+				blended.interpolate(layer.pose, weights.data());
+			}
+		}
+	}
+
+	/*
+	 * get pose last evaluated
+	 */
+	const std::shared_ptr<Pose> & getEvaluated() const {
+		return isBlended ? blended : pose;
+	}
+
+	/*
+	 * get frames between poses evaluated for size on screen, 0 to hold pose
+	 * while not seen
+	 */
+	static unsigned getInterval(float screenSize) {
+		const auto & config = Config::getInstance();
+		if (config.getBoolean("animationLod") == false) {
+			return 1;
+		}
+		if (screenSize < 0) {
+			return 0;
+		}
+		float lodSize = config.getFloat("animationLodSize");
+		if (screenSize >= lodSize) {
+			return 1;
+		}
+		auto most = static_cast<unsigned>(std::max(
+				config.getInteger("animationLodInterval"), 1));
+		float interval = std::ceil(lodSize / screenSize);
+		return interval < static_cast<float>(most) ?
+				static_cast<unsigned>(interval) : most;
+	}
+
+	/*
+	 * interpolate from pose shown when last evaluated to evaluated pose
+	 */
+	void interpolate(float t) {
+		if (interpolated == nullptr || interpolated.use_count() > 1) {
+			interpolated = std::make_shared<Pose>(from);
+		} else {
+			*interpolated = from;
+		}
+		interpolated->interpolate(*getEvaluated(), t);
+	}
+
+	/*
+	 * find indices in pose of bones of animation of track, once loaded
+	 *
+	 * @return  true if bones found now, false if found already
+	 */
+	bool resolve(Track & track) {
+		const auto & bones = track.animation.getBones();
+		if (track.bones.size() == bones.size()) {
+			return false;
+		}
+		std::vector<std::string> names;
+		for (const auto & boneEntry : bones) {
+			names.emplace_back(boneEntry.first);
+		}
+		addBones(names);
+		track.bones.clear();
+		for (const auto & name : names) {
+			track.bones.emplace_back(getBone(name));
+		}
+		return true;
+	}
+
+	/*
+	 * resolve bones of layer and find their mask weights
+	 */
+	void resolve(Layer & layer) {
+		if (resolve(layer.track) == false) {
+			return;
+		}
+		layer.boneMask.clear();
+		for (const auto & boneEntry : layer.track.animation.getBones()) {
+			auto it = layer.mask.find(boneEntry.first);
+			layer.boneMask.emplace_back(it != layer.mask.end() ?
+					it->second : 1.f);
+		}
+	}
+
+	/*
+	 * get pose to blend fade and layers into, starting as base pose
+	 */
+	Pose & startBlend() {
+		if (blended == nullptr || blended.use_count() > 1) {
+			blended = std::make_shared<Pose>(*pose);
+		} else {
+			*blended = *pose;
+		}
+		return *blended;
 	}
 };
 
@@ -242,10 +643,9 @@ SgAnimator::~SgAnimator() {
  */
 Vec3 SgAnimator::getDeltaTranslation(const std::string & bone, float dt) const {
 	Vec3 t;
-	auto it = pimpl->transforms.find(bone);
-	if (it != pimpl->transforms.end()) {
+	if (hasBone(bone)) {
 		t = pimpl->peek(bone, dt).getTranslation()
-				- it->second.getTranslation();
+				- pimpl->getTransform(bone).getTranslation();
 	}
 	return t;
 }
@@ -265,8 +665,12 @@ OVERRIDE ScriptObjectPtr SgAnimator::getMember(ScriptExecutionState & execState,
 			{ "getRotation", std::make_shared<GetRotation>() },
 			{ "getTransform", std::make_shared<GetTransform>() },
 			{ "getTranslation", std::make_shared<GetTranslation>() },
+			{ "removeLayer", std::make_shared<RemoveLayer>() },
 			{ "rotZ", std::make_shared<RotZ>() },
 			{ "setAnimation", std::make_shared<SetAnimation>() },
+			{ "setLayer", std::make_shared<SetLayer>() },
+			{ "setLayerMask", std::make_shared<SetLayerMask>() },
+			{ "setLayerWeight", std::make_shared<SetLayerWeight>() },
 			{ "setRotation", std::make_shared<SetRotation>() },
 			{ "setTranslation", std::make_shared<SetTranslation>() } };
 
@@ -285,20 +689,18 @@ OVERRIDE ScriptObjectPtr SgAnimator::getMember(ScriptExecutionState & execState,
  * @return      rotation for requested bone
  */
 Quat SgAnimator::getRotation(const std::string & bone) const {
-	Quat r(0, 0, 0, 1);
-	const auto & it = pimpl->transforms.find(bone);
-	if (it != pimpl->transforms.end()) {
-		r = it->second.getRotation();
-	}
-	return r;
+	return pimpl->getTransform(bone).getRotation();
 }
 
 /**
+ * get transform of named bone
  *
- * @return
+ * @param bone  name of bone
+ *
+ * @return      transform of bone, untransformed if bone not set
  */
-const std::unordered_map<std::string, Transform> & SgAnimator::getTransforms() const {
-	return pimpl->transforms;
+Transform SgAnimator::getTransform(const std::string & bone) const {
+	return pimpl->getTransform(bone);
 }
 
 /**
@@ -309,12 +711,33 @@ const std::unordered_map<std::string, Transform> & SgAnimator::getTransforms() c
  * @return      translation for requested bone
  */
 Vec3 SgAnimator::getTranslation(const std::string & bone) const {
-	Vec3 t;
-	const auto & it = pimpl->transforms.find(bone);
-	if (it != pimpl->transforms.end()) {
-		t = it->second.getTranslation();
+	return pimpl->getTransform(bone).getTranslation();
+}
+
+/**
+ * check whether named bone has been set, by animation or otherwise
+ *
+ * @param bone  name of bone
+ *
+ * @return      true if bone set
+ */
+bool SgAnimator::hasBone(const std::string & bone) const {
+	return pimpl->getBone(bone) != Skeleton::npos;
+}
+
+/**
+ * remove named layer, if any
+ *
+ * @param name  name of layer
+ */
+void SgAnimator::removeLayer(const std::string & name) {
+	auto & layers = pimpl->layers;
+	for (auto it = layers.begin(); it != layers.end(); ++it) {
+		if (it->name == name) {
+			layers.erase(it);
+			return;
+		}
 	}
-	return t;
 }
 
 /**
@@ -323,21 +746,91 @@ Vec3 SgAnimator::getTranslation(const std::string & bone) const {
  * @param rotation
  */
 bool SgAnimator::rotate(const std::string & bone, const Quat & rotation) {
-	const auto & it = pimpl->transforms.find(bone);
-	if (it != pimpl->transforms.end()) {
-		it->second.rotate(rotation);
-		return true;
+	size_t index = pimpl->getBone(bone);
+	if (index == Skeleton::npos) {
+		return false;
 	}
-	return false;
+	auto & pose = pimpl->modifyPose();
+	auto t = pose.get(index);
+	t.rotate(rotation);
+	pose.set(index, t);
+	return true;
 }
 
 /**
+ * set base animation, crossfading from current one over fadeTime
  *
- * @param name
- * @return
+ * @param animation  animation to play
+ * @param fadeTime   time to fade over, 0 to switch at once
  */
-void SgAnimator::setAnimation(const Animation & animation) {
-	pimpl->animation = animation;
+void SgAnimator::setAnimation(const Animation & animation, float fadeTime) {
+	pimpl->fadeTime = 0;
+	pimpl->fadeDuration = 0;
+	if (fadeTime > 0 && pimpl->base.animation.validate()) {
+		pimpl->fading = pimpl->base;
+		pimpl->fadingPose = *pimpl->pose;
+		pimpl->fadeDuration = fadeTime;
+	}
+	pimpl->base.animation = animation;
+	pimpl->base.bones.clear();
+}
+
+/**
+ * add or replace named layer. Layers blend in by weight and bone mask, in
+ * order added, over base animation, additive layers adding to it instead
+ *
+ * @param name       name of layer
+ * @param animation  animation of layer
+ * @param additive   true to add to pose beneath rather than blend over it
+ */
+void SgAnimator::setLayer(const std::string & name,
+		const Animation & animation, bool additive) {
+	auto layer = pimpl->findLayer(name);
+	if (layer != nullptr) {
+		layer->track = Track(animation);
+		layer->additive = additive;
+	} else {
+		pimpl->layers.emplace_back(name, animation, additive,
+				pimpl->pose->getSkeleton());
+	}
+}
+
+/**
+ * set weight of bone in named layer, bones not set weigh 1
+ *
+ * @param name    name of layer
+ * @param bone    name of bone
+ * @param weight  weight of bone in layer
+ *
+ * @return        false if layer unknown
+ */
+bool SgAnimator::setLayerMask(const std::string & name,
+		const std::string & bone, float weight) {
+	auto layer = pimpl->findLayer(name);
+	if (layer == nullptr) {
+		return false;
+	}
+	layer->mask[bone] = weight;
+	// resolved again with mask next update
+	layer->track.bones.clear();
+	return true;
+}
+
+/**
+ * set weight of named layer, 0 leaves pose beneath unchanged
+ *
+ * @param name    name of layer
+ * @param weight  weight of layer
+ *
+ * @return        false if layer unknown
+ */
+bool SgAnimator::setLayerWeight(const std::string & name, float weight) {
+	auto layer = pimpl->findLayer(name);
+	if (layer == nullptr) {
+		return false;
+	}
+	layer->weight = weight;
+	return true;
 }
 
 /**
@@ -346,13 +839,10 @@ void SgAnimator::setAnimation(const Animation & animation) {
  * @param rotation
  */
 void SgAnimator::setRotation(const std::string & bone, const Quat & rotation) {
-	const auto & it = pimpl->transforms.find(bone);
-	if (it != pimpl->transforms.end()) {
-		it->second.setRotation(rotation);
-	} else {
-		pimpl->transforms.emplace(bone, Transform(Vec3(), rotation));
-	}
+	size_t index = pimpl->getOrAddBone(bone);
+	pimpl->modifyPose().setRotation(index, rotation);
 }
+
 /**
  *
  * @param bone
@@ -360,37 +850,66 @@ void SgAnimator::setRotation(const std::string & bone, const Quat & rotation) {
  */
 void SgAnimator::setTranslation(const std::string & bone,
 		const Vec3 & translation) {
-	const auto & it = pimpl->transforms.find(bone);
-	if (it != pimpl->transforms.end()) {
-		it->second.setTranslation(translation);
-	} else {
-		pimpl->transforms.emplace(bone,
-				Transform(translation, Quat(0, 0, 0, 1)));
-	}
+	size_t index = pimpl->getOrAddBone(bone);
+	pimpl->modifyPose().setTranslation(index, translation);
 }
 
 /**
+ * Advance animations and give pose to update state. Animators not seen last
+ * update hold their pose, and those small on screen evaluate it every few
+ * updates, interpolating in between. Interpolation runs from the pose shown
+ * towards the one evaluated, so trails it by up to the interval
  *
- * @param state
+ * @param state  current update state
  */
 OVERRIDE void SgAnimator::update(UpdateState & state) {
-	if (pimpl->animation.validate() == false) {
+	if (pimpl->base.animation.validate() == false) {
 		return;
 	}
 
 	float speed = Config::getInstance().getFloat("simulationSpeed");
-	float dt = speed * state.getTimeStep();
-
-	pimpl->frame = pimpl->animation.nextFrame(pimpl->frame, dt);
-	float frameStep = pimpl->animation.getFrameStep(dt);
+	pimpl->lodTime += speed * state.getTimeStep();
+
+	unsigned interval = impl::getInterval(state.getScreenSize());
+	if (interval == 0) {
+		// time kept, so animations catch up once seen
+		pimpl->lodInterval = 0;
+		state.countAnimator(false, true);
+		state.setBonePose(*pimpl->shown);
+		return;
+	}
 
-	for (const auto & boneEntry : pimpl->animation.getBones()) {
-		const auto & t = boneEntry.second.getTransform(
-				pimpl->getTransform(boneEntry.first), pimpl->frame, frameStep);
-		pimpl->transforms[boneEntry.first] = t;
+	// evaluated again as soon as interval changes, to interpolate from
+	// pose shown
+	if (interval != pimpl->lodInterval || pimpl->lodFrame >= interval
+			|| pimpl->from.getSkeleton()
+					!= pimpl->getEvaluated()->getSkeleton()) {
+		if (interval > 1) {
+			pimpl->from = **pimpl->shown;
+		}
+		pimpl->evaluate(pimpl->lodTime);
+		pimpl->lodTime = 0;
+		pimpl->lodInterval = interval;
+		pimpl->lodFrame = 0;
+		state.countAnimator(true, false);
+
+		const auto & skeleton = pimpl->getEvaluated()->getSkeleton();
+		if (interval > 1 && pimpl->from.getSkeleton() != skeleton) {
+			pimpl->from = Pose(skeleton, pimpl->from);
+		}
+	} else {
+		state.countAnimator(false, false);
 	}
 
-	state.setBoneTransforms(pimpl->transforms);
+	++pimpl->lodFrame;
+	if (pimpl->lodFrame < interval) {
+		pimpl->interpolate(static_cast<float>(pimpl->lodFrame)
+				/ static_cast<float>(interval));
+		pimpl->shown = &pimpl->interpolated;
+	} else {
+		pimpl->shown = &pimpl->getEvaluated();
+	}
+	state.setBonePose(*pimpl->shown);
 }
 
 /**
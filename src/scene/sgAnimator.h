@@ -56,10 +56,13 @@ public:
 	Quat getRotation(const std::string & bone) const;
 
 	/**
+	 * get transform of named bone
 	 *
-	 * @return
+	 * @param bone  name of bone
+	 *
+	 * @return      transform of bone, untransformed if bone not set
 	 */
-	const std::unordered_map<std::string, Transform> & getTransforms() const;
+	Transform getTransform(const std::string & bone) const;
 
 	/**
 	 * get translation of named bone
@@ -70,6 +73,22 @@ public:
 	 */
 	Vec3 getTranslation(const std::string & bone) const;
 
+	/**
+	 * check whether named bone has been set, by animation or otherwise
+	 *
+	 * @param bone  name of bone
+	 *
+	 * @return      true if bone set
+	 */
+	bool hasBone(const std::string & bone) const;
+
+	/**
+	 * remove named layer, if any
+	 *
+	 * @param name  name of layer
+	 */
+	void removeLayer(const std::string & name);
+
 	/**
 	 *
 	 * @param bone
@@ -78,11 +97,45 @@ public:
 	bool rotate(const std::string & bone, const Quat & rotation);
 
 	/**
+	 * set base animation, crossfading from current one over fadeTime
 	 *
-	 * @param name
-	 * @return
+	 * @param animation  animation to play
+	 * @param fadeTime   time to fade over, 0 to switch at once
+	 */
+	void setAnimation(const Animation & animation, float fadeTime);
+
+	/**
+	 * add or replace named layer. Layers blend in by weight and bone mask, in
+	 * order added, over base animation, additive layers adding to it instead
+	 *
+	 * @param name       name of layer
+	 * @param animation  animation of layer
+	 * @param additive   true to add to pose beneath rather than blend over it
+	 */
+	void setLayer(const std::string & name, const Animation & animation,
+			bool additive);
+
+	/**
+	 * set weight of bone in named layer, bones not set weigh 1
+	 *
+	 * @param name    name of layer
+	 * @param bone    name of bone
+	 * @param weight  weight of bone in layer
+	 *
+	 * @return        false if layer unknown
+	 */
+	bool setLayerMask(const std::string & name, const std::string & bone,
+			float weight);
+
+	/**
+	 * set weight of named layer, 0 leaves pose beneath unchanged
+	 *
+	 * @param name    name of layer
+	 * @param weight  weight of layer
+	 *
+	 * @return        false if layer unknown
 	 */
-	void setAnimation(const Animation & animation);
+	bool setLayerWeight(const std::string & name, float weight);
 
 	/**
 	 *
@@ -99,8 +152,13 @@ public:
 	void setTranslation(const std::string & bone, const Vec3 & translation);
 
 	/**
+	 * Advance animations and give pose to update state. Animators not seen
+	 * last update hold their pose, and those small on screen evaluate it
+	 * every few updates, interpolating in between. Interpolation runs from
+	 * the pose shown towards the one evaluated, so trails it by up to the
+	 * interval
 	 *
-	 * @param state
+	 * @param state  current update state
 	 */
 	void update(UpdateState & state) override;
 
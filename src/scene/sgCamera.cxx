@@ -82,7 +82,7 @@ namespace {
 			auto cam = std::static_pointer_cast<SgCamera>(self);
 
 			stack.push(
-					std::make_shared<Quat>(
+					std::make_shared<ScriptQuat>(
 							cam->getAspect()->getRotTrans().getRotation()));
 		}
 	};
@@ -95,7 +95,7 @@ namespace {
 			auto cam = std::static_pointer_cast<SgCamera>(self);
 
 			stack.push(
-					std::make_shared<Vec3>(
+					std::make_shared<ScriptVec3>(
 							cam->getAspect()->getRotTrans().getTranslation()));
 		}
 	};
@@ -1,5 +1,6 @@
 #include "sgCollision.h"
 
+#include "collisionWorld.h"
 #include "updateState.h"
 
 #include "../core/collisionHierarchy.h"
@@ -15,18 +16,30 @@
 
 namespace {
 	/*
-	 *
+	 * name, collision, optional bitmask of layers collision is in and
+	 * optional bitmask of layers it collides with
 	 */
 	struct Factory: public Executable {
 
 		void execute(const ScriptObjectPtr &, unsigned nArgs,
 				std::stack<ScriptObjectPtr> & stack) const override {
-			checkNumArgs(nArgs, 2);
+			if (nArgs != 3 && nArgs != 4) {
+				checkNumArgs(nArgs, 2);
+			}
 
 			auto name = getArg<String>("string", stack, 1).getValue();
 			auto collision = getArg<CollisionHierarchy>("collision", stack, 2);
+			auto group = CollisionWorld::defaultLayers;
+			auto mask = CollisionWorld::allLayers;
+			if (nArgs >= 3) {
+				group = static_cast<uint32_t>(getInt32Arg(stack, 3));
+			}
+			if (nArgs == 4) {
+				mask = static_cast<uint32_t>(getInt32Arg(stack, 4));
+			}
 
-			stack.push(std::make_shared<SgCollision>(name, collision));
+			stack.push(std::make_shared<SgCollision>(name, collision, group,
+					mask));
 		}
 	};
 }
@@ -34,12 +47,20 @@ namespace {
 struct SgCollision::impl {
 	std::string name;
 	CollisionHierarchy collision;
+	uint32_t group;
+	uint32_t mask;
 	Transform transform;
 	bool first;
 	bool valid;
 
-	impl(const std::string & name, const CollisionHierarchy & collision) :
-			name(name), collision(collision), first(true), valid(false) {
+	impl(const std::string & name, const CollisionHierarchy & collision,
+			uint32_t group, uint32_t mask) :
+					name(name),
+					collision(collision),
+					group(group),
+					mask(mask),
+					first(true),
+					valid(false) {
 	}
 };
 
@@ -48,10 +69,12 @@ struct SgCollision::impl {
  *
  * @param name
  * @param collision
+ * @param group      bitmask of layers collision is in
+ * @param mask       bitmask of layers collision collides with
  */
 SgCollision::SgCollision(const std::string & name,
-		const CollisionHierarchy & collision) :
-		pimpl(new impl(name, collision)) {
+		const CollisionHierarchy & collision, uint32_t group, uint32_t mask) :
+		pimpl(new impl(name, collision, group, mask)) {
 }
 
 /**
@@ -73,7 +96,7 @@ OVERRIDE void SgCollision::update(UpdateState & state) {
 	pimpl->valid = pimpl->collision.validate();
 	if (pimpl->valid) {
 		state.addCollision(pimpl->name, pimpl->transform, newTransform,
-				pimpl->collision);
+				pimpl->collision, pimpl->group, pimpl->mask);
 		pimpl->transform = newTransform;
 	}
 }
@@ -5,6 +5,8 @@
 
 #include "../scripting/scriptObject.h"
 
+#include <cstdint>
+
 class CollisionHierarchy;
 
 class SgCollision: public ScriptObject, public UpdateNode, public VisualizeNode {
@@ -15,8 +17,11 @@ public:
 	 *
 	 * @param name
 	 * @param collision
+	 * @param group      bitmask of layers collision is in
+	 * @param mask       bitmask of layers collision collides with
 	 */
-	SgCollision(const std::string & name, const CollisionHierarchy & collision);
+	SgCollision(const std::string & name, const CollisionHierarchy & collision,
+			uint32_t group, uint32_t mask);
 
 	/**
 	 * destructor
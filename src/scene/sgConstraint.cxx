@@ -20,10 +20,10 @@ namespace {
 			Parameter<Vec3>("pivot1Pos", nullptr),
 			Parameter<Quat>("pivot1Rot", nullptr),
 			Parameter<Real>("limitFlags", nullptr),
-			Parameter<Vec3>("minPos", std::make_shared<Vec3>()),
-			Parameter<Vec3>("maxPos", std::make_shared<Vec3>()),
-			Parameter<Vec3>("minRot", std::make_shared<Vec3>()),
-			Parameter<Vec3>("maxRot", std::make_shared<Vec3>()),
+			Parameter<Vec3>("minPos", std::make_shared<ScriptVec3>(Vec3())),
+			Parameter<Vec3>("maxPos", std::make_shared<ScriptVec3>(Vec3())),
+			Parameter<Vec3>("minRot", std::make_shared<ScriptVec3>(Vec3())),
+			Parameter<Vec3>("maxRot", std::make_shared<ScriptVec3>(Vec3())),
 			Parameter<Real>("springyness", std::make_shared<Real>(0)),
 			Parameter<Real>("stiffness", std::make_shared<Real>(0)) };
 
@@ -44,27 +44,27 @@ namespace {
 			auto body0 =
 					std::static_pointer_cast<String>(args["body0"])->getValue();
 
-			auto pivot0Pos = *std::static_pointer_cast<Vec3>(args["pivot0Pos"]);
+			auto pivot0Pos = ScriptType<Vec3>::get(args["pivot0Pos"]);
 
-			auto pivot0Rot = *std::static_pointer_cast<Quat>(args["pivot0Rot"]);
+			auto pivot0Rot = ScriptType<Quat>::get(args["pivot0Rot"]);
 
 			auto body1 =
 					std::static_pointer_cast<String>(args["body1"])->getValue();
 
-			auto pivot1Pos = *std::static_pointer_cast<Vec3>(args["pivot1Pos"]);
+			auto pivot1Pos = ScriptType<Vec3>::get(args["pivot1Pos"]);
 
-			auto pivot1Rot = *std::static_pointer_cast<Quat>(args["pivot1Rot"]);
+			auto pivot1Rot = ScriptType<Quat>::get(args["pivot1Rot"]);
 
 			int limitFlags =
 					std::static_pointer_cast<Real>(args["limitFlags"])->getInt32();
 
-			auto minPos = *std::static_pointer_cast<Vec3>(args["minPos"]);
+			auto minPos = ScriptType<Vec3>::get(args["minPos"]);
 
-			auto maxPos = *std::static_pointer_cast<Vec3>(args["maxPos"]);
+			auto maxPos = ScriptType<Vec3>::get(args["maxPos"]);
 
-			auto minRot = *std::static_pointer_cast<Vec3>(args["minRot"]);
+			auto minRot = ScriptType<Vec3>::get(args["minRot"]);
 
-			auto maxRot = *std::static_pointer_cast<Vec3>(args["maxRot"]);
+			auto maxRot = ScriptType<Vec3>::get(args["maxRot"]);
 
 			float springyness = std::static_pointer_cast<Real>(
 					args["springyness"])->getFloat();
@@ -92,7 +92,7 @@ namespace {
 			auto & constraint =
 					std::static_pointer_cast<SgConstraint>(self)->getConstraint();
 
-			stack.push(std::make_shared<Vec3>(constraint.getPivot0Pos()));
+			stack.push(std::make_shared<ScriptVec3>(constraint.getPivot0Pos()));
 		}
 	};
 
@@ -34,10 +34,10 @@ namespace {
 			const auto & parent = std::static_pointer_cast<String>(
 					args["parent"])->getValue();
 
-			const auto & pivotPos = *std::static_pointer_cast<Vec3>(
+			const auto & pivotPos = ScriptType<Vec3>::get(
 					args["pivotPos"]);
 
-			const auto & pivotRot = *std::static_pointer_cast<Quat>(
+			const auto & pivotRot = ScriptType<Quat>::get(
 					args["pivotRot"]);
 
 			stack.push(
@@ -39,10 +39,10 @@ namespace {
 	 */
 	std::vector<BaseParameter> params = {
 			Parameter<String>("file", std::make_shared<String>("")),
-			Parameter<Vec3>("extents", std::make_shared<Vec3>(
+			Parameter<Vec3>("extents", std::make_shared<ScriptVec3>(Vec3(
 					std::numeric_limits<double>::max(),
 					std::numeric_limits<double>::max(),
-					std::numeric_limits<double>::max())),
+					std::numeric_limits<double>::max()))),
 			Parameter<Vec3>("size", nullptr),
 			Parameter<List>("values", std::make_shared<List>()) };
 
@@ -86,10 +86,10 @@ namespace {
 			const auto & file =
 					std::static_pointer_cast<String>(args["file"])->getValue();
 
-			const auto & extents = *std::static_pointer_cast<Vec3>(
+			const auto & extents = ScriptType<Vec3>::get(
 					args["extents"]);
 
-			const auto & size = *std::static_pointer_cast<Vec3>(args["size"]);
+			const auto & size = ScriptType<Vec3>::get(args["size"]);
 			auto sx = static_cast<int>(size.getX());
 			auto sy = static_cast<int>(size.getY());
 			auto sz = static_cast<int>(size.getZ());
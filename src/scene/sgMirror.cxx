@@ -63,9 +63,9 @@ namespace {
 			const auto & name =
 					std::static_pointer_cast<String>(args["name"])->getValue();
 
-			const auto & point = *std::static_pointer_cast<Vec3>(args["point"]);
+			const auto & point = ScriptType<Vec3>::get(args["point"]);
 
-			const auto & normal = *std::static_pointer_cast<Normal>(
+			const auto & normal = ScriptType<Normal>::get(
 					args["normal"]);
 
 			float reflect =
@@ -3,23 +3,30 @@
 #include "builder.h"
 #include "updateState.h"
 
+#include "../core/aspect.h"
 #include "../core/boundingBox.h"
 #include "../core/color.h"
 #include "../core/debugGeometry.h"
 
 #include "../render/renderState.h"
+#include "../render/view.h"
 #include "../render/viewBuilder.h"
 
 #include "../scripting/executable.h"
 #include "../scripting/parameters.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <limits>
 #include <mutex>
 
 using namespace render;
 
 namespace {
+	/** child nodes tested against view frustum together */
+	const size_t cullBatch = 8;
+
 	struct Factory: public Executable {
 
 		void execute(const ScriptObjectPtr &, unsigned nArgs,
@@ -33,8 +40,9 @@ namespace {
 				auto arg = stack.top();
 				stack.pop();
 
-				if (typeid(*arg) == typeid(BoundingBox)) {
-					bounds = std::static_pointer_cast<BoundingBox>(arg);
+				if (typeid(*arg) == typeid(ScriptBoundingBox)) {
+					bounds = std::make_shared<BoundingBox>(
+							ScriptType<BoundingBox>::get(arg));
 				} else {
 					auto unode = std::dynamic_pointer_cast<UpdateNode>(arg);
 					auto tnode = std::dynamic_pointer_cast<TaskInitNode>(arg);
@@ -119,7 +127,7 @@ namespace {
 			auto node = std::static_pointer_cast<SgNode>(self);
 
 			assert(node->getBounds() != nullptr);
-			stack.push(std::make_shared<BoundingBox>(*node->getBounds()));
+			stack.push(std::make_shared<ScriptBoundingBox>(*node->getBounds()));
 		}
 	};
 
@@ -159,9 +167,16 @@ struct SgNode::impl {
 	std::vector<std::shared_ptr<UpdateNode>> updateNodes;
 	std::vector<std::shared_ptr<TaskInitNode>> taskInitNodes;
 	std::vector<std::shared_ptr<VisualizeNode>> visualizeNodes;
+	/** visualize nodes that are nodes with bounds, null for others */
+	std::vector<SgNode *> boundedNodes;
 	std::vector<ScriptObjectPtr> addNodes;
 	std::vector<ScriptObjectPtr> delNodes;
 	bool enabled;
+	/**
+	 * largest size on screen of bounds in views since last update, negative
+	 * if not seen. Views are built in parallel, so atomic
+	 */
+	std::atomic<float> screenSize;
 
 	impl(const std::shared_ptr<BoundingBox> & bounds,
 			const std::vector<std::shared_ptr<UpdateNode>> & updateNodes,
@@ -173,8 +188,9 @@ struct SgNode::impl {
 					updateNodes(updateNodes),
 					taskInitNodes(taskInitNodes),
 					visualizeNodes(visualizeNodes),
-					enabled(true) {
-
+					enabled(true),
+					screenSize(std::numeric_limits<float>::infinity()) {
+		findBoundedNodes();
 	}
 
 	void debugBounds(ViewBuilder & vb) {
@@ -182,6 +198,97 @@ struct SgNode::impl {
 		debug.emplace_back(vb.getState().getTransform(), Color::red(), *bounds);
 		vb.addDebugGeometry(debug);
 	}
+
+	/*
+	 * find visualize nodes with bounds, when visualize nodes change
+	 */
+	void findBoundedNodes() {
+		boundedNodes.clear();
+		for (const auto & node : visualizeNodes) {
+			auto sgNode = dynamic_cast<SgNode *>(node.get());
+			boundedNodes.emplace_back(
+					sgNode != nullptr && sgNode->pimpl->bounds != nullptr ?
+							sgNode : nullptr);
+		}
+	}
+
+	/*
+	 * record size on screen of bounds in view, as fraction of view height,
+	 * keeping largest of all views
+	 */
+	void seen(ViewBuilder & vb) {
+		const auto & aspect = vb.getView()->getLodAspect();
+		const auto & projection = aspect.getCamera()->getProjectionMatrix();
+
+		// bounds centre in view space
+		auto centre = bounds->getCentre();
+		vb.getState().getTransform().transformPoint(centre);
+		aspect.getRotTrans().inverseTransformPoint(centre);
+
+		// w of clip space, distance for perspective and 1 for orthographic
+		double w = projection.get(3, 0) * centre.getX()
+				+ projection.get(3, 1) * centre.getY()
+				+ projection.get(3, 2) * centre.getZ() + projection.get(3, 3);
+		float size = std::numeric_limits<float>::infinity();
+		if (w > 0) {
+			size = static_cast<float>(bounds->getRadius()
+					* projection.get(1, 1) / w);
+		}
+
+		float largest = screenSize.load();
+		while (size > largest
+				&& screenSize.compare_exchange_weak(largest, size) == false) {
+		}
+	}
+
+	/*
+	 * visualize node found visible, with frustum result of its bounds. Child
+	 * nodes with bounds are tested against planes its bounds straddle in
+	 * batches, each batch of those next in turn
+	 */
+	void visualize(ViewBuilder & vb, const FrustumCuller::Result & frustum) {
+		vb.pushState();
+		vb.setFrustumResult(frustum);
+		if (bounds != nullptr) {
+			seen(vb);
+			vb.getState().clipLights(*bounds);
+		}
+
+		const void * keys[cullBatch];
+		const BoundingBox * boxes[cullBatch];
+		FrustumCuller::Result results[cullBatch];
+		size_t batched = 0;
+		size_t used = 0;
+		for (size_t i = 0, n = visualizeNodes.size(); i < n; ++i) {
+			SgNode * child = boundedNodes[i];
+			if (child == nullptr) {
+				visualizeNodes[i]->visualize(vb);
+				continue;
+			}
+			if (child->pimpl->enabled == false) {
+				continue;
+			}
+
+			if (used == batched) {
+				batched = 0;
+				used = 0;
+				for (size_t j = i; j < n && batched < cullBatch; ++j) {
+					SgNode * next = boundedNodes[j];
+					if (next != nullptr && next->pimpl->enabled) {
+						keys[batched] = next;
+						boxes[batched++] = next->pimpl->bounds.get();
+					}
+				}
+				vb.cull(keys, boxes, batched, results);
+			}
+
+			const auto & result = results[used++];
+			if (result.planes != View::culled) {
+				child->pimpl->visualize(vb, result);
+			}
+		}
+		vb.popState();
+	}
 };
 
 /**
@@ -369,6 +476,8 @@ OVERRIDE void SgNode::update(UpdateState & state) {
 
 	{
 		std::lock_guard<std::mutex> locker(pimpl->lock);
+		bool changed = pimpl->addNodes.empty() == false
+				|| pimpl->delNodes.empty() == false;
 
 		for (const auto & e : pimpl->addNodes) {
 			auto unode = std::dynamic_pointer_cast<UpdateNode>(e);
@@ -410,9 +519,17 @@ OVERRIDE void SgNode::update(UpdateState & state) {
 			}
 		}
 		pimpl->delNodes.clear();
+
+		if (changed) {
+			pimpl->findBoundedNodes();
+		}
 	}
 
 	state.pushState();
+	if (pimpl->bounds != nullptr) {
+		// seen in views since last update, not seen until views say so
+		state.setScreenSize(pimpl->screenSize.exchange(-1));
+	}
 	for (const auto & node : pimpl->updateNodes) {
 		node->update(state);
 	}
@@ -427,18 +544,18 @@ OVERRIDE void SgNode::visualize(render::ViewBuilder & vb) {
 	if (pimpl->enabled == false) {
 		return;
 	}
-	if (pimpl->bounds != nullptr && vb.isVisible(*pimpl->bounds) == false) {
-		return;
-	}
 
-	vb.pushState();
+	auto frustum = vb.getFrustumResult();
 	if (pimpl->bounds != nullptr) {
-		vb.getState().clipLights(*pimpl->bounds);
-	}
-	for (const auto & node : pimpl->visualizeNodes) {
-		node->visualize(vb);
+		const void * keys[] = { this };
+		const BoundingBox * boxes[] = { pimpl->bounds.get() };
+		vb.cull(keys, boxes, 1, &frustum);
+		if (frustum.planes == View::culled) {
+			return;
+		}
 	}
-	vb.popState();
+
+	pimpl->visualize(vb, frustum);
 }
 
 /**
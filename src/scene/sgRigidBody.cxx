@@ -35,13 +35,28 @@ namespace {
 			Parameter<Real>("inverseMass", nullptr),
 			Parameter<Vec3>("translation", nullptr),
 			Parameter<Quat>("rotation", nullptr),
-			Parameter<Vec3>("velocity", std::make_shared<Vec3>()),
-			Parameter<Vec3>("angularVelocity", std::make_shared<Vec3>()),
-			Parameter<Vec3>("gravity", std::make_shared<Vec3>(0, 0, -9.8)),
+			Parameter<Vec3>("velocity", std::make_shared<ScriptVec3>(Vec3())),
+			Parameter<Vec3>("angularVelocity",
+					std::make_shared<ScriptVec3>(Vec3())),
+			Parameter<Vec3>("gravity",
+					std::make_shared<ScriptVec3>(Vec3(0, 0, -9.8))),
 			Parameter<CollisionHierarchy>("collision", nullptr),
 			Parameter<List>("nocollide", std::make_shared<List>()),
 			Parameter<Bool>("friction", Bool::False()),
-			Parameter<SgNode>("model", None::none()) };
+			Parameter<SgNode>("model", None::none()),
+			Parameter<Real>("group", std::make_shared<Real>(1)),
+			Parameter<Real>("mask", std::make_shared<Real>(-1)),
+			Parameter<Bool>("continuous", Bool::False()) };
+
+	/*
+	 * bitmask argument, 32 bit integer with all bits used
+	 */
+	uint32_t getBitmask(const ScriptObjectPtr & arg, const std::string & name) {
+		auto num = std::static_pointer_cast<Real>(arg);
+		scriptExecutionAssert(num->isInt32(),
+				"Require 32 bit integer for " + name);
+		return static_cast<uint32_t>(num->getInt32());
+	}
 
 	/*
 	 *
@@ -63,17 +78,17 @@ namespace {
 			float inverseMass = std::static_pointer_cast<Real>(
 					args["inverseMass"])->getFloat();
 
-			auto translation = std::static_pointer_cast<Vec3>(
+			const auto & translation = ScriptType<Vec3>::get(
 					args["translation"]);
 
-			auto rotation = std::static_pointer_cast<Quat>(args["rotation"]);
+			const auto & rotation = ScriptType<Quat>::get(args["rotation"]);
 
-			auto velocity = std::static_pointer_cast<Vec3>(args["velocity"]);
+			const auto & velocity = ScriptType<Vec3>::get(args["velocity"]);
 
-			auto angularVelocity = std::static_pointer_cast<Vec3>(
+			const auto & angularVelocity = ScriptType<Vec3>::get(
 					args["angularVelocity"]);
 
-			auto gravity = std::static_pointer_cast<Vec3>(args["gravity"]);
+			const auto & gravity = ScriptType<Vec3>::get(args["gravity"]);
 
 			auto collision = std::static_pointer_cast<CollisionHierarchy>(
 					args["collision"]);
@@ -90,15 +105,20 @@ namespace {
 			bool doFriction = std::static_pointer_cast<Bool>(args["friction"])
 					== Bool::True();
 
+			auto group = getBitmask(args["group"], "group");
+			auto mask = getBitmask(args["mask"], "mask");
+
 			auto model = args["model"];
 
 			double sgp = 0;
 
-			Transform rotTrans(*translation, *rotation);
+			Transform rotTrans(translation, rotation);
 
-			RigidBody body(name, inverseMass, rotTrans, *velocity,
-					*angularVelocity, *collision, *gravity, sgp, nocollide,
-					doFriction);
+			RigidBody body(name, inverseMass, rotTrans, velocity,
+					angularVelocity, *collision, gravity, sgp, nocollide, group,
+					mask, doFriction);
+			body.setContinuous(std::static_pointer_cast<Bool>(
+					args["continuous"]) == Bool::True());
 
 			stack.push(std::make_shared<SgRigidBody>(body, model));
 		}
@@ -121,13 +141,16 @@ namespace {
 			}
 
 			stack.push(std::make_shared<String>("translation"));
-			stack.push(std::make_shared<Vec3>(rigidBody.getTranslation()));
+			stack.push(
+					std::make_shared<ScriptVec3>(rigidBody.getTranslation()));
 			stack.push(std::make_shared<String>("rotation"));
-			stack.push(std::make_shared<Quat>(rigidBody.getRotation()));
+			stack.push(std::make_shared<ScriptQuat>(rigidBody.getRotation()));
 			stack.push(std::make_shared<String>("velocity"));
-			stack.push(std::make_shared<Vec3>(rigidBody.getLinearVelocity()));
+			stack.push(std::make_shared<ScriptVec3>(
+					rigidBody.getLinearVelocity()));
 			stack.push(std::make_shared<String>("angularVelocity"));
-			stack.push(std::make_shared<Vec3>(rigidBody.getAngularVelocity()));
+			stack.push(std::make_shared<ScriptVec3>(
+					rigidBody.getAngularVelocity()));
 		}
 	};
 
@@ -211,7 +234,8 @@ namespace {
 			const auto & rigidBody =
 					std::static_pointer_cast<SgRigidBody>(self)->getRigidBody();
 
-			stack.push(std::make_shared<Transform>(rigidBody.getTransform()));
+			stack.push(std::make_shared<ScriptTransform>(
+					rigidBody.getTransform()));
 		}
 	};
 
@@ -243,7 +267,8 @@ namespace {
 			const auto & rigidBody =
 					std::static_pointer_cast<SgRigidBody>(self)->getRigidBody();
 
-			stack.push(std::make_shared<Vec3>(rigidBody.getTranslation()));
+			stack.push(
+					std::make_shared<ScriptVec3>(rigidBody.getTranslation()));
 		}
 	};
 
@@ -272,7 +297,7 @@ namespace {
 			const auto & rigidBody =
 					std::static_pointer_cast<SgRigidBody>(self)->getRigidBody();
 
-			stack.push(std::make_shared<Quat>(rigidBody.getRotation()));
+			stack.push(std::make_shared<ScriptQuat>(rigidBody.getRotation()));
 		}
 	};
 
@@ -301,7 +326,8 @@ namespace {
 			const auto & rigidBody =
 					std::static_pointer_cast<SgRigidBody>(self)->getRigidBody();
 
-			stack.push(std::make_shared<Vec3>(rigidBody.getLinearVelocity()));
+			stack.push(std::make_shared<ScriptVec3>(
+					rigidBody.getLinearVelocity()));
 		}
 	};
 
@@ -332,7 +358,8 @@ namespace {
 			const auto & rigidBody =
 					std::static_pointer_cast<SgRigidBody>(self)->getRigidBody();
 
-			stack.push(std::make_shared<Vec3>(rigidBody.getAngularVelocity()));
+			stack.push(std::make_shared<ScriptVec3>(
+					rigidBody.getAngularVelocity()));
 		}
 	};
 
@@ -361,7 +388,7 @@ namespace {
 					std::static_pointer_cast<SgRigidBody>(self)->getRigidBody();
 
 			stack.push(
-					std::make_shared<BoundingBox>(
+					std::make_shared<ScriptBoundingBox>(
 							rigidBody.getCollision().getBounds()));
 		}
 	};
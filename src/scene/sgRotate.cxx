@@ -29,7 +29,7 @@ namespace {
 
 			auto sgRotate = std::static_pointer_cast<SgRotate>(self);
 
-			stack.push(std::make_shared<Quat>(sgRotate->getRotation()));
+			stack.push(std::make_shared<ScriptQuat>(sgRotate->getRotation()));
 		}
 	};
 
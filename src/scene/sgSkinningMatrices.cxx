@@ -2,6 +2,9 @@
 
 #include "updateState.h"
 
+#include "../core/config.h"
+#include "../core/pose.h"
+#include "../core/skeleton.h"
 #include "../core/skinningMatrix.h"
 #include "../core/transform.h"
 
@@ -11,6 +14,9 @@
 #include "../scripting/executable.h"
 #include "../scripting/parameters.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 namespace {
 
 	/*
@@ -30,10 +36,118 @@ namespace {
 }
 
 struct SgSkinningMatrices::impl {
-	std::vector<SkinningMatrix> m_matrices;
+	/** matrices held member by member, in order given */
+	std::vector<std::string> bones;
+	std::vector<int> indices;
+	std::vector<int> parents;
+	std::vector<Transform> fromParents;
+	std::vector<Transform> toRestPoses;
+	/** matrices with parents before children, to compute in turn */
+	std::vector<size_t> order;
+	/** index of bone of each matrix in skeleton posed, npos if absent */
+	std::vector<size_t> poseBones;
+	/** skeleton poseBones were found in */
+	std::shared_ptr<const Skeleton> skeleton;
+	/** pose matrices are computed from */
+	std::shared_ptr<const Pose> pose;
+	/** update matrices were last computed in */
+	int updateId;
+	std::vector<Transform> hierarchy;
+	/** final transform of each palette index, identity if unused */
+	std::vector<Transform> final;
+	/** final transforms as 4x4 matrices packed column major */
+	std::shared_ptr<std::vector<float>> palette;
 
 	impl(const std::vector<SkinningMatrix> & matrices) :
-			m_matrices(matrices) {
+					poseBones(matrices.size(), Skeleton::npos),
+					updateId(-1),
+					hierarchy(matrices.size()) {
+		int size = 0;
+		for (const auto & m : matrices) {
+			bones.emplace_back(m.getBone());
+			indices.emplace_back(m.getIndex());
+			parents.emplace_back(m.getParent());
+			fromParents.emplace_back(m.getFromParent());
+			toRestPoses.emplace_back(m.getToRestPose());
+			size = std::max(size, m.getIndex() + 1);
+		}
+		final.resize(size);
+		sortOrder();
+	}
+
+	/*
+	 * compute hierarchy and final transforms of pose and pack them
+	 */
+	void compute() {
+		resolveBones(pose != nullptr ? pose->getSkeleton() : nullptr);
+
+		for (size_t i : order) {
+			Transform transform;
+			int parent = parents[i];
+			if (parent >= 0) {
+				transform = hierarchy[parent];
+			}
+			transform.transform(fromParents[i]);
+			size_t bone = poseBones[i];
+			if (bone != Skeleton::npos) {
+				transform.transform(pose->get(bone));
+			}
+			hierarchy[i] = transform;
+
+			transform.transform(toRestPoses[i]);
+			final[indices[i]] = transform;
+		}
+
+		// palette of last frame may still be drawn, so not written over
+		if (palette == nullptr || palette.unique() == false) {
+			palette = std::make_shared<std::vector<float>>(final.size() * 16);
+		}
+		Transform::toViewMatrices(Transform(), final.data(), final.size(),
+				palette->data(), nullptr);
+	}
+
+	/*
+	 * find bones of matrices in skeleton, when skeleton changes
+	 */
+	void resolveBones(const std::shared_ptr<const Skeleton> & newSkeleton) {
+		if (newSkeleton == skeleton) {
+			return;
+		}
+		skeleton = newSkeleton;
+		for (size_t i = 0, n = bones.size(); i < n; ++i) {
+			poseBones[i] = skeleton != nullptr ?
+					skeleton->getIndex(bones[i]) : Skeleton::npos;
+		}
+	}
+
+	/*
+	 * order matrices by depth in hierarchy, so parents come before children
+	 * whatever order matrices were given in
+	 */
+	void sortOrder() {
+		size_t n = bones.size();
+		for (int parent : parents) {
+			if (parent >= static_cast<int>(n)) {
+				throw std::out_of_range("skinning matrix parent out of range");
+			}
+		}
+
+		std::vector<size_t> depths(n, 0);
+		for (size_t i = 0; i < n; ++i) {
+			// parents looping back on themselves end at n
+			for (int p = parents[i]; p >= 0 && depths[i] < n; p = parents[p]) {
+				++depths[i];
+			}
+		}
+
+		order.resize(n);
+		for (size_t i = 0; i < n; ++i) {
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(),
+				[&depths](size_t a, size_t b) {
+					return depths[a] < depths[b];
+				});
 	}
 };
 
@@ -42,7 +156,7 @@ struct SgSkinningMatrices::impl {
  */
 SgSkinningMatrices::SgSkinningMatrices(
 		const std::vector<SkinningMatrix> & matrices) :
-		pimpl(new impl(matrices)) {
+		pimpl(std::make_shared<impl>(matrices)) {
 }
 
 /**
@@ -55,20 +169,21 @@ SgSkinningMatrices::~SgSkinningMatrices(){
  *
  */
 OVERRIDE void SgSkinningMatrices::update(UpdateState & state) {
-	for (auto & m : pimpl->m_matrices) {
-		Transform hierarchy;
-		if (m.getParent() >= 0) {
-			hierarchy =
-					pimpl->m_matrices.at(m.getParent()).getHierarchyTransform();
-		}
-		hierarchy.transform(m.getFromParent());
-		auto bone = state.getBoneTransform(m.getBone());
-		hierarchy.transform(bone);
-		m.setHierarchyTransform(hierarchy);
-
-		auto final = hierarchy;
-		final.transform(m.getToRestPose());
-		m.setFinalTransform(final);
+	// matrices not drawn unless seen, so left until seen again
+	if (state.getScreenSize() < 0
+			&& Config::getInstance().getBoolean("animationLod")) {
+		return;
+	}
+
+	// computed with matrices of all other characters across worker threads,
+	// once per frame from pose of its last update
+	pimpl->pose = state.getBonePose();
+	if (pimpl->updateId != state.getUpdateId()) {
+		pimpl->updateId = state.getUpdateId();
+		auto matrices = pimpl;
+		state.addParallelUpdate([matrices]() {
+			matrices->compute();
+		});
 	}
 }
 
@@ -76,8 +191,8 @@ OVERRIDE void SgSkinningMatrices::update(UpdateState & state) {
  *
  */
 OVERRIDE void SgSkinningMatrices::visualize(render::ViewBuilder & vb) {
-	for (const auto & m : pimpl->m_matrices) {
-		vb.getState().setSkinningMatrix(m.getIndex(), m.getFinalTransform());
+	if (pimpl->palette != nullptr) {
+		vb.getState().setSkinningMatrices(pimpl->palette);
 	}
 }
 
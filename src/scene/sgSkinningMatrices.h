@@ -43,6 +43,6 @@ public:
 
 private:
 	struct impl;
-	std::unique_ptr<impl> pimpl;
+	std::shared_ptr<impl> pimpl;
 };
 
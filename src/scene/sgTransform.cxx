@@ -39,10 +39,10 @@ namespace {
 			float pitch =
 					std::static_pointer_cast<Real>(args["pitch"])->getFloat();
 			float yaw = std::static_pointer_cast<Real>(args["yaw"])->getFloat();
-			auto translation = std::static_pointer_cast<Vec3>(
+			const auto & translation = ScriptType<Vec3>::get(
 					args["translation"]);
 
-			stack.push(std::make_shared<SgTransform>(pitch, yaw, *translation));
+			stack.push(std::make_shared<SgTransform>(pitch, yaw, translation));
 		}
 	};
 	/*
@@ -69,7 +69,8 @@ namespace {
 
 			auto sgTransform = std::static_pointer_cast<SgTransform>(self);
 
-			stack.emplace(std::make_shared<Quat>(sgTransform->getRotation()));
+			stack.emplace(
+					std::make_shared<ScriptQuat>(sgTransform->getRotation()));
 		}
 	};
 
@@ -83,8 +84,8 @@ namespace {
 
 			auto sgTransform = std::static_pointer_cast<SgTransform>(self);
 
-			stack.emplace(
-					std::make_shared<Vec3>(sgTransform->getTranslation()));
+			stack.emplace(std::make_shared<ScriptVec3>(
+					sgTransform->getTranslation()));
 		}
 	};
 
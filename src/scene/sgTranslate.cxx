@@ -30,7 +30,8 @@ namespace {
 
 			auto sgTranslate = std::static_pointer_cast<SgTranslate>(self);
 
-			stack.push(std::make_shared<Vec3>(sgTranslate->getTranslation()));
+			stack.push(std::make_shared<ScriptVec3>(
+					sgTranslate->getTranslation()));
 		}
 	};
 
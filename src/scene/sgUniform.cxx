@@ -1,6 +1,5 @@
 #include "sgUniform.h"
 
-#include "../core/mat3.h"
 #include "../core/mat4.h"
 #include "../core/vec3.h"
 
@@ -31,24 +30,21 @@ namespace {
 				auto arg = stack.top();
 				stack.pop();
 
-				if (typeid(*arg) == typeid(Mat3)) {
-					auto m = std::static_pointer_cast<Mat3>(arg);
-					stack.push(std::make_shared<SgUniform>(Uniform(id, *m)));
-				} else if (typeid(*arg) == typeid(Mat4)) {
-					auto m = std::static_pointer_cast<Mat4>(arg);
-					stack.push(std::make_shared<SgUniform>(Uniform(id, *m)));
+				if (typeid(*arg) == typeid(ScriptMat4)) {
+					const auto & m = ScriptType<Mat4>::get(arg);
+					stack.push(std::make_shared<SgUniform>(Uniform(id, m)));
 				} else if (typeid(*arg) == typeid(Texture)) {
 					auto tex = std::static_pointer_cast<Texture>(arg);
 					stack.push(std::make_shared<SgUniform>(Uniform(id, tex)));
-				} else if (typeid(*arg) == typeid(Vec3)) {
-					auto v = std::static_pointer_cast<Vec3>(arg);
-					stack.push(std::make_shared<SgUniform>(Uniform(id, *v)));
+				} else if (typeid(*arg) == typeid(ScriptVec3)) {
+					const auto & v = ScriptType<Vec3>::get(arg);
+					stack.push(std::make_shared<SgUniform>(Uniform(id, v)));
 				} else if (typeid(*arg) == typeid(Real)) {
 					float x = std::static_pointer_cast<Real>(arg)->getFloat();
 					stack.push(std::make_shared<SgUniform>(Uniform(id, x)));
 				} else {
 					scriptExecutionAssert(false,
-							"Require Mat3, Mat4, Texture, Vec3 or float");
+							"Require Mat4, Texture, Vec3 or float");
 				}
 			} else if (nArgs == 3) {
 				float x = static_cast<float>(getNumericArg(stack, 2));
@@ -94,24 +90,21 @@ namespace {
 				auto arg = stack.top();
 				stack.pop();
 
-				if (typeid(*arg) == typeid(Mat3)) {
-					auto m = std::static_pointer_cast<Mat3>(arg);
-					uniform->set(Uniform(id, *m));
-				} else if (typeid(*arg) == typeid(Mat4)) {
-					auto m = std::static_pointer_cast<Mat4>(arg);
-					uniform->set(Uniform(id, *m));
+				if (typeid(*arg) == typeid(ScriptMat4)) {
+					const auto & m = ScriptType<Mat4>::get(arg);
+					uniform->set(Uniform(id, m));
 				} else if (typeid(*arg) == typeid(Texture)) {
 					auto tex = std::static_pointer_cast<Texture>(arg);
 					uniform->set(Uniform(id, tex));
-				} else if (typeid(*arg) == typeid(Vec3)) {
-					auto v = std::static_pointer_cast<Vec3>(arg);
-					uniform->set(Uniform(id, *v));
+				} else if (typeid(*arg) == typeid(ScriptVec3)) {
+					const auto & v = ScriptType<Vec3>::get(arg);
+					uniform->set(Uniform(id, v));
 				} else if (typeid(*arg) == typeid(Real)) {
 					float x = std::static_pointer_cast<Real>(arg)->getFloat();
 					uniform->set(Uniform(id, x));
 				} else {
 					scriptExecutionAssert(false,
-							"Require Mat3, Mat4, Texture, Vec3 or float");
+							"Require Mat4, Texture, Vec3 or float");
 				}
 			} else if (nArgs == 3) {
 				float x = static_cast<float>(getNumericArg(stack, 2));
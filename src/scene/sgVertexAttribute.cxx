@@ -44,7 +44,7 @@ namespace {
 
 				auto list = getArg<List>("list", stack, 2);
 
-				if (typeid(*list.get(0)) == typeid(Vec3)) {
+				if (typeid(*list.get(0)) == typeid(ScriptVec3)) {
 					std::vector<Vec3> vertices;
 					vertices.reserve(list.size());
 
@@ -52,13 +52,13 @@ namespace {
 						scriptExecutionAssertType<Vec3>(e,
 								"List needs to be of one type");
 						vertices.emplace_back(
-								*std::static_pointer_cast<Vec3>(e));
+								ScriptType<Vec3>::get(e));
 					}
 					stack.push(
 							std::make_shared<SgVertexAttribute>(
 									VertexAttribute(label, vertices)));
 					return;
-				} else if (typeid(*list.get(0)) == typeid(Normal)) {
+				} else if (typeid(*list.get(0)) == typeid(ScriptNormal)) {
 					std::vector<Normal> normals;
 					normals.reserve(list.size());
 
@@ -66,7 +66,7 @@ namespace {
 						scriptExecutionAssertType<Normal>(e,
 								"List needs to be of one type");
 						normals.emplace_back(
-								*std::static_pointer_cast<Normal>(e));
+								ScriptType<Normal>::get(e));
 					}
 					stack.push(
 							std::make_shared<SgVertexAttribute>(
@@ -1,6 +1,8 @@
 #include "updateState.h"
 
 #include "builder.h"
+#include "collisionEvent.h"
+#include "collisionWorld.h"
 #include "physics.h"
 #include "sceneProgram.h"
 #include "system.h"
@@ -8,12 +10,18 @@
 #include "updateNode.h"
 #include "visualizeNode.h"
 
+#include "../core/boundingBox.h"
+#include "../core/collisionHierarchy.h"
 #include "../core/config.h"
 #include "../core/convexHull.h"
 #include "../core/debugGeometry.h"
 #include "../core/frameRate.h"
+#include "../core/pose.h"
 #include "../core/ray.h"
 #include "../core/rigidBody.h"
+#include "../core/skeleton.h"
+#include "../core/sphere.h"
+#include "../core/threadPool.h"
 #include "../core/timer.h"
 
 #include "../render/renderGraph.h"
@@ -26,6 +34,7 @@
 #include "../scripting/string.h"
 
 #include <cassert>
+#include <limits>
 #include <stack>
 #include <string>
 
@@ -34,22 +43,34 @@ namespace {
 
 	class State {
 	public:
-		State() = default;
+		State() :
+				m_screenSize(std::numeric_limits<float>::infinity()) {
+		}
 
 		State(const State &) = default;
 
-		Transform getBone(const std::string & name) {
-			auto it = m_bones.find(name);
-			if (it != m_bones.end()) {
-				return it->second;
+		Transform getBone(const std::string & name) const {
+			if (m_pose != nullptr) {
+				size_t index = m_pose->getSkeleton()->getIndex(name);
+				if (index != Skeleton::npos) {
+					return m_pose->get(index);
+				}
 			}
 			return Transform();
 		}
 
+		const std::shared_ptr<const Pose> & getPose() const {
+			return m_pose;
+		}
+
 		Quat getRotation() const {
 			return m_transform.getRotation();
 		}
 
+		float getScreenSize() const {
+			return m_screenSize;
+		}
+
 		Transform getTransform() const {
 			return m_transform;
 		}
@@ -62,9 +83,12 @@ namespace {
 			m_transform.rotate(rotation);
 		}
 
-		void setBones(
-				const std::unordered_map<std::string, Transform> & bones) {
-			m_bones = bones;
+		void setPose(const std::shared_ptr<const Pose> & pose) {
+			m_pose = pose;
+		}
+
+		void setScreenSize(float screenSize) {
+			m_screenSize = screenSize;
 		}
 
 		void transform(Transform t) {
@@ -76,7 +100,18 @@ namespace {
 		}
 	private:
 		Transform m_transform;
-		std::unordered_map<std::string, Transform> m_bones;
+		std::shared_ptr<const Pose> m_pose;
+		/** largest size on screen last update, negative if not seen */
+		float m_screenSize;
+	};
+
+	/*
+	 * animators updated in an update, by how their pose was found
+	 */
+	struct AnimatorCounts {
+		size_t evaluated = 0;
+		size_t interpolated = 0;
+		size_t frozen = 0;
 	};
 
 	class AddTask: public Executable {
@@ -108,33 +143,149 @@ namespace {
 		}
 	};
 
-	struct SortedIntersections: public Physics::RayIntersectionCallback {
-		std::vector<double> distances;
-		std::vector<ScriptObjectPtr> intersections;
+	/*
+	 * check number of arguments of shape query, required arguments then
+	 * optional layer mask
+	 */
+	bool hasLayersArg(unsigned nArgs, unsigned required) {
+		if (nArgs == required + 1) {
+			return true;
+		}
+		checkNumArgs(nArgs, required);
+		return false;
+	}
+
+	/*
+	 * get layer mask argument of shape query, all layers if absent
+	 */
+	uint32_t getLayersArg(bool present, std::stack<ScriptObjectPtr> & stack,
+			int argNum) {
+		if (present == false) {
+			return CollisionWorld::allLayers;
+		}
+		return static_cast<uint32_t>(getInt32Arg(stack, argNum));
+	}
+
+	/*
+	 * get shape argument, shared rather than copied
+	 */
+	template<typename TYPE>
+	std::shared_ptr<TYPE> getShapeArg(const std::string & type,
+			std::stack<ScriptObjectPtr> & stack, int argNum) {
+		auto arg = stack.top();
+		stack.pop();
+		scriptExecutionAssert(typeid(*arg) == typeid(TYPE),
+				"Require " + type + " for argument " + std::to_string(argNum));
+		return std::static_pointer_cast<TYPE>(arg);
+	}
+
+	/*
+	 * contacts of world space box with collisions
+	 */
+	class OverlapBox: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			bool hasLayers = hasLayersArg(nArgs, 1);
+			auto box = std::make_shared<BoundingBox>(
+					getArg<BoundingBox>("BoundingBox", stack, 1));
+			auto layers = getLayersArg(hasLayers, stack, 2);
+
+			std::vector<CollisionHierarchy> children;
+			CollisionHierarchy shape(box, children);
+			auto updateState = std::static_pointer_cast<UpdateState>(self);
+			stack.push(updateState->overlap(shape, Transform(), layers));
+		}
+	};
+
+	/*
+	 * contacts of hull, placed by transform, with collisions
+	 */
+	class OverlapHull: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			bool hasLayers = hasLayersArg(nArgs, 2);
+			auto hull = getShapeArg<ConvexHull>("ConvexHull", stack, 1);
+			auto toWorld = getArg<Transform>("Transform", stack, 2);
+			auto layers = getLayersArg(hasLayers, stack, 3);
+
+			std::vector<CollisionHierarchy> children;
+			CollisionHierarchy shape(hull, children);
+			auto updateState = std::static_pointer_cast<UpdateState>(self);
+			stack.push(updateState->overlap(shape, toWorld, layers));
+		}
+	};
+
+	/*
+	 * contacts of world space sphere with collisions
+	 */
+	class OverlapSphere: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			bool hasLayers = hasLayersArg(nArgs, 1);
+			auto sphere = getShapeArg<Sphere>("Sphere", stack, 1);
+			auto layers = getLayersArg(hasLayers, stack, 2);
+
+			std::vector<CollisionHierarchy> children;
+			CollisionHierarchy shape(sphere, children);
+			auto updateState = std::static_pointer_cast<UpdateState>(self);
+			stack.push(updateState->overlap(shape, Transform(), layers));
+		}
+	};
+
+	/*
+	 * first contacts of world space sphere swept to end point
+	 */
+	class SweepSphere: public Executable {
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			bool hasLayers = hasLayersArg(nArgs, 2);
+			auto sphere = getShapeArg<Sphere>("Sphere", stack, 1);
+			auto end = getArg<Vec3>("vec3", stack, 2);
+			auto layers = getLayersArg(hasLayers, stack, 3);
 
-		~SortedIntersections() {
+			auto updateState = std::static_pointer_cast<UpdateState>(self);
+			stack.push(updateState->sweepSphere(sphere, end, layers));
 		}
+	};
 
-		void addIntersection(
-				const std::shared_ptr<Physics::RayIntersection> & intersection)
-						override {
-			if (intersection->getDistance() < 0) {
-				return;
+	/*
+	 * cast list of rays, reporting closest, any or all hits of each ray as
+	 * packed hits
+	 */
+	struct RayCast: public Executable {
+
+		void execute(const ScriptObjectPtr & self, unsigned nArgs,
+				std::stack<ScriptObjectPtr> & stack) const override {
+			checkNumArgs(nArgs, 2);
+			auto list = getArg<List>("list", stack, 1);
+			auto mode = getArg<String>("string", stack, 2).getValue();
+
+			Physics::RayQuery query;
+			if (mode == "closest") {
+				query = Physics::RayQuery::CLOSEST;
+			} else if (mode == "any") {
+				query = Physics::RayQuery::ANY;
+			} else {
+				scriptExecutionAssert(mode == "all",
+						"Require mode 'closest', 'any' or 'all'");
+				query = Physics::RayQuery::ALL;
 			}
-			for (size_t i = 0, n = distances.size(); i < n; ++i) {
-				if (intersection->getDistance() < distances[i]) {
-					intersections.insert(intersections.begin() + i,
-							intersection);
-					distances.insert(distances.begin() + i,
-							intersection->getDistance());
-					return;
-				}
+
+			std::vector<Ray> rays;
+			rays.reserve(list.size());
+			for (const auto & e : list) {
+				scriptExecutionAssertType<Ray>(e, "Require ray list");
+				rays.emplace_back(*std::static_pointer_cast<Ray>(e));
 			}
-			intersections.emplace_back(intersection);
-			distances.emplace_back(intersection->getDistance());
+
+			auto updateState = std::static_pointer_cast<UpdateState>(self);
+			stack.push(updateState->rayCast(rays, query, rays.size() > 1));
 		}
 	};
 
+	/*
+	 * all hits of ray as list of intersections, nearest first
+	 */
 	struct RayIntersection: public Executable {
 
 		void execute(const ScriptObjectPtr & self, unsigned nArgs,
@@ -142,11 +293,19 @@ namespace {
 			checkNumArgs(nArgs, 1);
 			auto ray = getArg<Ray>("Ray", stack, 1);
 
-			SortedIntersections callback;
 			auto updateState = std::static_pointer_cast<UpdateState>(self);
-			updateState->rayIntersection(ray, callback);
-
-			stack.push(std::make_shared<List>(callback.intersections));
+			auto hits = updateState->rayCast(std::vector<Ray>(1, ray),
+					Physics::RayQuery::ALL, false);
+
+			std::vector<ScriptObjectPtr> intersections;
+			intersections.reserve(hits->size());
+			for (size_t i = 0, n = hits->size(); i < n; ++i) {
+				const auto & hit = hits->get(i);
+				intersections.emplace_back(
+						std::make_shared<Physics::RayIntersection>(hit.name,
+								hit.point, hit.distance));
+			}
+			stack.push(std::make_shared<List>(intersections));
 		}
 	};
 }
@@ -162,6 +321,8 @@ struct UpdateState::impl {
 	/** tasks */
 	std::vector<std::shared_ptr<UpdateNode>> tasksRequiringUpdate;
 	std::vector<std::shared_ptr<TaskInitNode>> tasksRequiringInit;
+	/** work of nodes run in parallel once scene updated */
+	std::vector<std::function<void()>> parallelUpdates;
 
 	float timeStep;
 	Timer timer;
@@ -169,6 +330,18 @@ struct UpdateState::impl {
 	float frameRate;
 	float renderRate;
 	size_t lastPolyCount;
+	size_t lastBoxesTested;
+	size_t lastBoxesCulled;
+	size_t lastBoxesCached;
+	/** seconds taken resolving physics last update */
+	double lastPhysicsTime;
+	/** animators of this update, and of last for scripts */
+	AnimatorCounts animators;
+	AnimatorCounts lastAnimators;
+	/** static and kinematic collisions, persist across updates */
+	std::shared_ptr<CollisionWorld> collisionWorld;
+	/** collision events, reused once released by scripts */
+	std::shared_ptr<CollisionEventPool> collisionEvents;
 	std::unique_ptr<Physics> oldPhysics;
 	std::unique_ptr<Physics> physics;
 	unsigned width;
@@ -180,8 +353,14 @@ struct UpdateState::impl {
 					frameRate(0),
 					renderRate(0),
 					lastPolyCount(0),
-					oldPhysics(new Physics()),
-					physics(new Physics()),
+					lastBoxesTested(0),
+					lastBoxesCulled(0),
+					lastBoxesCached(0),
+					lastPhysicsTime(0),
+					collisionWorld(std::make_shared<CollisionWorld>()),
+					collisionEvents(std::make_shared<CollisionEventPool>()),
+					oldPhysics(new Physics(collisionWorld, collisionEvents)),
+					physics(new Physics(collisionWorld, collisionEvents)),
 					width(width),
 					height(height) {
 	}
@@ -217,6 +396,30 @@ struct UpdateState::impl {
 		// poly count
 		systemInstance->setMember("polyCount",
 				std::make_shared<Real>(static_cast<double>(lastPolyCount)));
+		// boxes tested against and culled by view frustums
+		systemInstance->setMember("boxesTested",
+				std::make_shared<Real>(static_cast<double>(lastBoxesTested)));
+		systemInstance->setMember("boxesCulled",
+				std::make_shared<Real>(static_cast<double>(lastBoxesCulled)));
+		// boxes whose visibility was kept from earlier frames
+		systemInstance->setMember("boxesCached",
+				std::make_shared<Real>(static_cast<double>(lastBoxesCached)));
+		// animators, skipped when interpolated or frozen
+		const auto & a = lastAnimators;
+		systemInstance->setMember("animators",
+				std::make_shared<Real>(static_cast<double>(
+						a.evaluated + a.interpolated + a.frozen)));
+		systemInstance->setMember("animatorsSkipped",
+				std::make_shared<Real>(static_cast<double>(
+						a.interpolated + a.frozen)));
+		systemInstance->setMember("animatorsFrozen",
+				std::make_shared<Real>(static_cast<double>(a.frozen)));
+		// physics, timed to measure scaling over worker threads
+		systemInstance->setMember("physicsTime",
+				std::make_shared<Real>(lastPhysicsTime));
+		systemInstance->setMember("workerThreads",
+				std::make_shared<Real>(static_cast<double>(
+						ThreadPool::getInstance().getThreadCount())));
 		// home
 		systemInstance->setMember("home",
 				std::make_shared<Path>(Config::getInstance().getString("home")));
@@ -242,12 +445,18 @@ UpdateState::~UpdateState() {
 /**
  * Add collision to state
  *
+ * @param name       name of collision
+ * @param previous   transform last update
+ * @param current    transform this update
  * @param collision  collision to add
+ * @param group      bitmask of layers collision is in
+ * @param mask       bitmask of layers collision collides with
  */
 void UpdateState::addCollision(const std::string & name,
 		const Transform & previous, const Transform & current,
-		const CollisionHierarchy & collision) {
-	pimpl->physics->addCollision(name, previous, current, collision);
+		const CollisionHierarchy & collision, uint32_t group, uint32_t mask) {
+	pimpl->physics->addCollision(name, previous, current, collision, group,
+			mask);
 }
 
 /**
@@ -281,6 +490,16 @@ void UpdateState::addEvents(
 	}
 }
 
+/**
+ * Add work to run across worker threads once scene is updated, before views
+ * are built. Work of different nodes must not share data
+ *
+ * @param work  work to run
+ */
+void UpdateState::addParallelUpdate(const std::function<void()> & work) {
+	pimpl->parallelUpdates.emplace_back(work);
+}
+
 /**
  * Add body to state
  *
@@ -321,6 +540,33 @@ Transform UpdateState::getBoneTransform(const std::string & name) const {
 	return pimpl->state.top().getBone(name);
 }
 
+/**
+ * count animator updated, for System.animators, animatorsSkipped and
+ * animatorsFrozen next update
+ *
+ * @param evaluated  true if pose evaluated, false if interpolated or frozen
+ * @param frozen     true if pose held, as not seen last update
+ */
+void UpdateState::countAnimator(bool evaluated, bool frozen) {
+	auto & counts = pimpl->animators;
+	if (evaluated) {
+		++counts.evaluated;
+	} else if (frozen) {
+		++counts.frozen;
+	} else {
+		++counts.interpolated;
+	}
+}
+
+/**
+ * get current bone pose
+ *
+ * @return  bone pose, null if none set
+ */
+const std::shared_ptr<const Pose> & UpdateState::getBonePose() const {
+	return pimpl->state.top().getPose();
+}
+
 /**
  * get events for named type
  *
@@ -355,7 +601,12 @@ std::shared_ptr<ScriptObject> UpdateState::getMember(
 	static std::unordered_map<std::string, ScriptObjectPtr> members = {
 			{ "addTask", std::make_shared<AddTask>() },
 			{ "getEvents", std::make_shared<GetEvents>() },
-			{ "rayIntersection", std::make_shared<RayIntersection>() } };
+			{ "overlapBox", std::make_shared<OverlapBox>() },
+			{ "overlapHull", std::make_shared<OverlapHull>() },
+			{ "overlapSphere", std::make_shared<OverlapSphere>() },
+			{ "rayCast", std::make_shared<RayCast>() },
+			{ "rayIntersection", std::make_shared<RayIntersection>() },
+			{ "sweepSphere", std::make_shared<SweepSphere>() } };
 	auto entry = members.find(name);
 	if (entry != members.end()) {
 		return entry->second;
@@ -372,6 +623,16 @@ Quat UpdateState::getRotation() const {
 	return pimpl->state.top().getRotation();
 }
 
+/**
+ * get largest size on screen, in any view last update, of innermost node
+ * with bounds, as fraction of view height
+ *
+ * @return  size on screen, negative if not seen, infinite if unknown
+ */
+float UpdateState::getScreenSize() const {
+	return pimpl->state.top().getScreenSize();
+}
+
 /**
  * get current time step
  *
@@ -406,6 +667,22 @@ void UpdateState::pushState() {
 	pimpl->state.push(State(pimpl->state.top()));
 }
 
+/**
+ * find contacts of shape with collisions of last update in any of given
+ * layers
+ *
+ * @param shape    shape to test
+ * @param toWorld  from shape space to world space
+ * @param layers   bitmask of layers to test against
+ *
+ * @return         contacts
+ */
+std::shared_ptr<Physics::ShapeHits> UpdateState::overlap(
+		const CollisionHierarchy & shape, const Transform & toWorld,
+		uint32_t layers) {
+	return pimpl->oldPhysics->overlap(shape, toWorld, layers);
+}
+
 /**
  * pop the current state
  */
@@ -414,13 +691,18 @@ void UpdateState::popState() {
 }
 
 /**
+ * cast batch of rays against physics of last update
+ *
+ * @param rays      rays to cast
+ * @param query     which hits of each ray to report
+ * @param parallel  spread rays across thread pool
  *
- * @param ray
- * @param callback
+ * @return          hits grouped by ray
  */
-void UpdateState::rayIntersection(const Ray & ray,
-		Physics::RayIntersectionCallback & callback) {
-	pimpl->oldPhysics->rayIntersection(ray, callback);
+std::shared_ptr<Physics::RayHits> UpdateState::rayCast(
+		const std::vector<Ray> & rays, Physics::RayQuery query,
+		bool parallel) {
+	return pimpl->oldPhysics->rayCast(rays, query, parallel);
 }
 
 /**
@@ -433,14 +715,23 @@ void UpdateState::rotate(const Quat & rotation) {
 }
 
 /**
- * Replace current bone transforms with new ones
+ * Replace current bone pose with new one, shared rather than copied, so
+ * pose must not be changed while state holds it
+ *
+ * @param pose  bone pose
+ */
+void UpdateState::setBonePose(const std::shared_ptr<const Pose> & pose) {
+	pimpl->state.top().setPose(pose);
+}
+
+/**
+ * set largest size on screen of current node last update
  *
- * @param transforms
- *            bone transforms
+ * @param screenSize  size on screen as fraction of view height, negative if
+ *                    not seen
  */
-void UpdateState::setBoneTransforms(
-		const std::unordered_map<std::string, Transform> & transforms) {
-	pimpl->state.top().setBones(transforms);
+void UpdateState::setScreenSize(float screenSize) {
+	pimpl->state.top().setScreenSize(screenSize);
 }
 
 /**
@@ -452,6 +743,21 @@ void UpdateState::setTimeStep(float timeStep) {
 	pimpl->timeStep = timeStep;
 }
 
+/**
+ * sweep sphere against collisions of last update in any of given layers
+ *
+ * @param sphere  sphere at start of sweep
+ * @param end     centre of sphere at end of sweep
+ * @param layers  bitmask of layers to test against
+ *
+ * @return        first contact with each collision, nearest first
+ */
+std::shared_ptr<Physics::ShapeHits> UpdateState::sweepSphere(
+		const std::shared_ptr<Sphere> & sphere, const Vec3 & end,
+		uint32_t layers) {
+	return pimpl->oldPhysics->sweepSphere(sphere, end, layers);
+}
+
 /**
  * set render rate ( for informational purposes )
  *
@@ -489,6 +795,8 @@ void UpdateState::translate(const Vec3 & translation) {
 std::shared_ptr<render::RenderGraph> UpdateState::update(
 		const std::shared_ptr<SceneProgram> & script) {
 	pimpl->updateId = ++counter;
+	pimpl->lastAnimators = pimpl->animators;
+	pimpl->animators = AnimatorCounts();
 
 	while (pimpl->state.empty() == false) {
 		pimpl->state.pop();
@@ -499,10 +807,12 @@ std::shared_ptr<render::RenderGraph> UpdateState::update(
 
 	// swap old and new physics
 	pimpl->physics.swap(pimpl->oldPhysics);
-	pimpl->physics = std::unique_ptr<Physics>(new Physics());
+	pimpl->physics = std::unique_ptr<Physics>(
+			new Physics(pimpl->collisionWorld, pimpl->collisionEvents));
 
 	pimpl->tasksRequiringUpdate.clear();
 	pimpl->tasksRequiringInit.clear();
+	pimpl->parallelUpdates.clear();
 
 	std::vector<DebugGeometry> debugGeometry;
 
@@ -520,8 +830,17 @@ std::shared_ptr<render::RenderGraph> UpdateState::update(
 			node->update(*this);
 		}
 
+		auto & work = pimpl->parallelUpdates;
+		ThreadPool::getInstance().parallelFor(work.size(), [&work](size_t i) {
+			work[i]();
+		});
+		work.clear();
+
 		float speed = Config::getInstance().getFloat("simulationSpeed");
-		addEvents(pimpl->physics->resolve(speed, pimpl->timeStep));
+		double physicsStart = pimpl->timer.get();
+		auto events = pimpl->physics->resolve(speed, pimpl->timeStep);
+		pimpl->lastPhysicsTime = pimpl->timer.get() - physicsStart;
+		addEvents(events);
 	}
 
 	assert(pimpl->state.size() == 1);
@@ -531,6 +850,9 @@ std::shared_ptr<render::RenderGraph> UpdateState::update(
 	Builder builder(debugGeometry, pimpl->tasksRequiringInit);
 	auto & rg = builder.execute();
 	pimpl->lastPolyCount = builder.getPolyCount();
+	pimpl->lastBoxesTested = builder.getBoxesTested();
+	pimpl->lastBoxesCulled = builder.getBoxesCulled();
+	pimpl->lastBoxesCached = builder.getBoxesCached();
 
 	return rg;
 }
@@ -8,6 +8,7 @@
 
 #include "../scripting/scriptObject.h"
 
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -16,9 +17,11 @@ class CollisionHierarchy;
 class Constraint;
 class ConvexHull;
 class EndEffector;
+class Pose;
 class Ray;
 class RigidBody;
 class SceneProgram;
+class Sphere;
 
 namespace render {
 	class RenderGraph;
@@ -44,10 +47,16 @@ public:
 	/**
 	 * Add collision to state
 	 *
+	 * @param name       name of collision
+	 * @param previous   transform last update
+	 * @param current    transform this update
 	 * @param collision  collision to add
+	 * @param group      bitmask of layers collision is in
+	 * @param mask       bitmask of layers collision collides with
 	 */
 	void addCollision(const std::string & name, const Transform & previous,
-			const Transform & current, const CollisionHierarchy & collision);
+			const Transform & current, const CollisionHierarchy & collision,
+			uint32_t group, uint32_t mask);
 
 	/**
 	 * Add constraint to state
@@ -71,6 +80,14 @@ public:
 	void addEvents(
 			const std::unordered_map<std::string, std::vector<ScriptObjectPtr>> & events);
 
+	/**
+	 * Add work to run across worker threads once scene is updated, before
+	 * views are built. Work of different nodes must not share data
+	 *
+	 * @param work  work to run
+	 */
+	void addParallelUpdate(const std::function<void()> & work);
+
 	/**
 	 * Add body to state
 	 *
@@ -85,6 +102,16 @@ public:
 	 */
 	void addTask(const ScriptObjectPtr & node);
 
+	/**
+	 * count animator updated, for System.animators, animatorsSkipped and
+	 * animatorsFrozen next update
+	 *
+	 * @param evaluated  true if pose evaluated, false if interpolated or
+	 *                   frozen
+	 * @param frozen     true if pose held, as not seen last update
+	 */
+	void countAnimator(bool evaluated, bool frozen);
+
 	/**
 	 * get named bone transform
 	 *
@@ -94,6 +121,13 @@ public:
 	 */
 	Transform getBoneTransform(const std::string & name) const;
 
+	/**
+	 * get current bone pose
+	 *
+	 * @return  bone pose, null if none set
+	 */
+	const std::shared_ptr<const Pose> & getBonePose() const;
+
 	/**
 	 * get events for named type
 	 *
@@ -122,6 +156,14 @@ public:
 	 */
 	Quat getRotation() const;
 
+	/**
+	 * get largest size on screen, in any view last update, of innermost
+	 * node with bounds, as fraction of view height
+	 *
+	 * @return  size on screen, negative if not seen, infinite if unknown
+	 */
+	float getScreenSize() const;
+
 	/**
 	 * get current time step
 	 *
@@ -150,6 +192,20 @@ public:
 	 */
 	int getUpdateId() const;
 
+	/**
+	 * find contacts of shape with collisions of last update in any of given
+	 * layers
+	 *
+	 * @param shape    shape to test
+	 * @param toWorld  from shape space to world space
+	 * @param layers   bitmask of layers to test against
+	 *
+	 * @return         contacts
+	 */
+	std::shared_ptr<Physics::ShapeHits> overlap(
+			const CollisionHierarchy & shape, const Transform & toWorld,
+			uint32_t layers);
+
 	/**
 	 * pop the current state
 	 */
@@ -161,12 +217,16 @@ public:
 	void pushState();
 
 	/**
+	 * cast batch of rays against physics of last update
+	 *
+	 * @param rays      rays to cast
+	 * @param query     which hits of each ray to report
+	 * @param parallel  spread rays across thread pool
 	 *
-	 * @param ray
-	 * @param callback
+	 * @return          hits grouped by ray
 	 */
-	void rayIntersection(const Ray & ray,
-			Physics::RayIntersectionCallback & callback);
+	std::shared_ptr<Physics::RayHits> rayCast(const std::vector<Ray> & rays,
+			Physics::RayQuery query, bool parallel);
 
 	/**
 	 * rotate current state
@@ -176,13 +236,12 @@ public:
 	void rotate(const Quat & rotation);
 
 	/**
-	 * Replace current bone transforms with new ones
+	 * Replace current bone pose with new one, shared rather than copied, so
+	 * pose must not be changed while state holds it
 	 *
-	 * @param transforms
-	 *            bone transforms
+	 * @param pose  bone pose
 	 */
-	void setBoneTransforms(
-			const std::unordered_map<std::string, Transform> & transforms);
+	void setBonePose(const std::shared_ptr<const Pose> & pose);
 
 	/**
 	 * set render rate ( for informational purposes )
@@ -191,6 +250,14 @@ public:
 	 */
 	void setRenderRate(float renderRate);
 
+	/**
+	 * set largest size on screen of current node last update
+	 *
+	 * @param screenSize  size on screen as fraction of view height,
+	 *                    negative if not seen
+	 */
+	void setScreenSize(float screenSize);
+
 	/**
 	 * set time step for physics
 	 *
@@ -198,6 +265,19 @@ public:
 	 */
 	void setTimeStep(float timeStep);
 
+	/**
+	 * sweep sphere against collisions of last update in any of given layers
+	 *
+	 * @param sphere  sphere at start of sweep
+	 * @param end     centre of sphere at end of sweep
+	 * @param layers  bitmask of layers to test against
+	 *
+	 * @return        first contact with each collision, nearest first
+	 */
+	std::shared_ptr<Physics::ShapeHits> sweepSphere(
+			const std::shared_ptr<Sphere> & sphere, const Vec3 & end,
+			uint32_t layers);
+
 	/**
 	 * transform current state
 	 *
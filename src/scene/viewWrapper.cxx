@@ -8,7 +8,11 @@
 #include "../render/view.h"
 #include "../render/viewBuilder.h"
 
+#include "../core/config.h"
+
 #include <cassert>
+#include <iostream>
+#include <sstream>
 
 using namespace render;
 
@@ -55,6 +59,23 @@ void ViewWrapper::init() {
 
 	builder.incPolyCount(vb.getPolyCount());
 
+	const auto & stats = view->getFrustumStats();
+	size_t cached = vb.getCachedBoxCount();
+	builder.incBoxCounts(stats.boxes, stats.culled, cached);
+	if (Config::getInstance().getBoolean("showFrustumStats")) {
+		// whole line at once, as views are built in parallel
+		size_t visited = stats.boxes + cached;
+		std::ostringstream line;
+		line << view->getName() << ": " << stats.boxes << " boxes, "
+				<< stats.culled << " culled, " << stats.planeTests
+				<< " plane tests, " << stats.planeTestsSkipped
+				<< " skipped, " << stats.hullTests << " hull tests, "
+				<< cached << " cached ("
+				<< (visited > 0 ? 100 * cached / visited : 0) << "% hits)"
+				<< std::endl;
+		std::cout << line.str();
+	}
+
 	// new tasks add during render pass
 	for (const auto & v : vb.getAdditionalViewTasks()) {
 		builder.addTask(std::make_shared<ViewWrapper>(builder, v, node));
@@ -4,6 +4,7 @@
 #include <string>
 
 #include "scriptObject.h"
+#include "scriptType.h"
 
 class BaseParameter {
 public:
@@ -39,6 +40,7 @@ template<typename TYPE>
 class Parameter: public BaseParameter {
 public:
 	inline Parameter(const std::string & name, ScriptObjectPtr value) :
-			BaseParameter(name, &typeid(TYPE), value) {
+			BaseParameter(name,
+					&typeid(typename ScriptType<TYPE>::Object), value) {
 	}
 };
@@ -4,6 +4,7 @@
 #include "parameter.h"
 #include "real.h"
 #include "scriptExecutionException.h"
+#include "scriptType.h"
 
 #include <memory>
 #include <vector>
@@ -39,12 +40,12 @@ inline TYPE getArg(const std::string & type,
 	auto arg = stack.top();
 	stack.pop();
 
-	if (typeid(*arg) != typeid(TYPE)) {
+	if (typeid(*arg) != typeid(typename ScriptType<TYPE>::Object)) {
 		throw ScriptExecutionException(
 				"Require " + type + " for argument " + std::to_string(argNum));
 	}
 
-	return *std::static_pointer_cast<TYPE>(arg);
+	return ScriptType<TYPE>::get(arg);
 }
 
 inline bool getBoolArg(std::stack<ScriptObjectPtr> & stack, int argNum) {
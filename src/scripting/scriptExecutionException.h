@@ -1,5 +1,7 @@
 #pragma once
 
+#include "scriptType.h"
+
 #include <exception>
 #include <string>
 
@@ -23,6 +25,8 @@ inline void scriptExecutionAssert(bool assertion, const std::string & msg) {
 }
 
 template<typename TYPE>
-void scriptExecutionAssertType(const ScriptObjectPtr & e, const std::string & msg) {
-	scriptExecutionAssert(typeid( *e ) == typeid(TYPE), msg);
+void scriptExecutionAssertType(const ScriptObjectPtr & e,
+		const std::string & msg) {
+	scriptExecutionAssert(
+			typeid( *e ) == typeid(typename ScriptType<TYPE>::Object), msg);
 }
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "scriptObject.h"
+
+/**
+ * Maps a type to the script object class representing it in scripts.
+ * Types that are script objects represent themselves, plain value types
+ * specialize this to name their wrapper.
+ */
+template<typename TYPE>
+struct ScriptType {
+	typedef TYPE Object;
+
+	/**
+	 * get value held by script object
+	 *
+	 * @param obj  script object, must be of type Object
+	 *
+	 * @return     value
+	 */
+	static inline const TYPE & get(const ScriptObjectPtr & obj) {
+		return *std::static_pointer_cast<TYPE>(obj);
+	}
+};